@@ -140,10 +140,11 @@ public:
 	 *
 	 * @param  name     Name
 	 * @param  m        Matrix
+	 * @return          Success
 	 */
-	template <class S> inline void 
+	template <class S> inline codeare::error_code
 	SetMatrix           (const std::string& name, Matrix<S>& m) const {
-		(m_ct == LOCAL) ?
+		return (m_ct == LOCAL) ?
 			( (LocalConnector*) m_conn)->SetMatrix(name, m):
 			((RemoteConnector*) m_conn)->SetMatrix(name, m);
 	}
@@ -164,6 +165,65 @@ public:
 			((RemoteConnector*) m_conn)->GetMatrix(name, m);
 	}
 		
+
+	/**
+	 * @brief           Preallocate measurement matrix for line by line
+	 *                  acquisition
+	 *
+	 *                  @see Workspace::OpenStream
+	 *
+	 * @param  name     Name
+	 * @param  dims     Dimensions (COL, CHA, loop counters ...)
+	 * @param  chunk    Lines per chunk handed to ProcessChunk (0: none)
+	 * @param  ring     Wrap loop counters (ring buffer)
+	 */
+	template <class S> inline void
+	OpenStream          (const std::string& name, const Vector<size_t>& dims,
+	                     const size_t& chunk = 0, const bool& ring = false) const {
+		(m_ct == LOCAL) ?
+			( (LocalConnector*) m_conn)->OpenStream<S>(name, dims, chunk, ring):
+			((RemoteConnector*) m_conn)->OpenStream<S>(name, dims, chunk, ring);
+	}
+
+
+	/**
+	 * @brief           Append acquisition line
+	 *
+	 *                  @see Workspace::AppendLine
+	 *                  @see RRStrategy::ReconStrategy::ProcessChunk
+	 *
+	 * @param  name     Name
+	 * @param  lc       Loop counters
+	 * @param  nlc      # of loop counters
+	 * @param  data     Samples, ns per channel, channels contiguous
+	 * @param  ns       # of samples per channel
+	 * @param  nc       # of channels (0: all)
+	 * @param  cha      First channel
+	 * @return          Error code
+	 */
+	template <class S> inline codeare::error_code
+	AppendLine          (const std::string& name, const uint16_t* lc, const size_t& nlc,
+	                     const S* data, const size_t& ns, const size_t& nc = 0,
+	                     const size_t& cha = 0) const {
+		return (m_ct == LOCAL) ?
+			( (LocalConnector*) m_conn)->AppendLine(name, lc, nlc, data, ns, nc, cha):
+			((RemoteConnector*) m_conn)->AppendLine(name, lc, nlc, data, ns, nc, cha);
+	}
+
+
+	/**
+	 * @brief           End of acquisition
+	 *
+	 * @param  name     Name
+	 * @return          Error code
+	 */
+	template <class S> inline codeare::error_code
+	CloseStream         (const std::string& name) const {
+		return (m_ct == LOCAL) ?
+			( (LocalConnector*) m_conn)->CloseStream<S>(name):
+			((RemoteConnector*) m_conn)->CloseStream<S>(name);
+	}
+		
 		
 	/**
 	 * @brief          Read configuration 
@@ -119,10 +119,12 @@ namespace RRClient {
 		 *
 		 * @param  name     Name
 		 * @param  m        Data
+		 * @return          Success
 		 */
-		template <class T> void 
+		template <class T> codeare::error_code
 		SetMatrix           (const std::string& name, Matrix<T>& m) const {			
 			Workspace::Instance().SetMatrix(name, m);
+			return codeare::OK;
 		}
 		
 		
@@ -138,6 +140,52 @@ namespace RRClient {
 		}
 		
 		
+
+		/**
+		 * @brief           Preallocate matrix for line by line acquisition
+		 *
+		 * @see             Workspace::OpenStream
+		 * @param  name     Name
+		 * @param  dims     Dimensions (COL, CHA, loop counters ...)
+		 * @param  chunk    Lines per chunk handed to ProcessChunk (0: none)
+		 * @param  ring     Wrap loop counters (ring buffer)
+		 */
+		template <class T> void
+		OpenStream          (const std::string& name, const Vector<size_t>& dims,
+		                     const size_t& chunk = 0, const bool& ring = false) const {
+			Workspace::Instance().OpenStream<T>(name, dims, chunk, ring);
+		}
+
+
+		/**
+		 * @brief           Append acquisition line. Completed chunks are
+		 *                  processed right away by the chain.
+		 *
+		 * @see             Workspace::AppendLine
+		 * @see             RRStrategy::ReconStrategy::ProcessChunk
+		 */
+		template <class T> codeare::error_code
+		AppendLine          (const std::string& name, const uint16_t* lc, const size_t& nlc,
+		                     const T* data, const size_t& ns, const size_t& nc = 0,
+		                     const size_t& cha = 0) {
+			codeare::error_code ec =
+				Workspace::Instance().AppendLine (name, lc, nlc, data, ns, nc, cha);
+			return (ec == codeare::OK) ? (codeare::error_code) ProcessChunks (name.c_str()) : ec;
+		}
+
+
+		/**
+		 * @brief           End of acquisition. Remaining lines are processed
+		 *                  as last chunk.
+		 *
+		 * @param  name     Name
+		 */
+		template <class T> codeare::error_code
+		CloseStream         (const std::string& name) {
+			codeare::error_code ec = Workspace::Instance().CloseStream (name);
+			return (ec == codeare::OK) ? (codeare::error_code) ProcessChunks (name.c_str()) : ec;
+		}
+
 		
 	private:
 		
@@ -20,6 +20,8 @@
 
 #include "ReconServant.hpp"
 #include "Workspace.hpp"
+#include "ExecutionContext.hpp"
+#include "FFTWTraits.hpp"
 
 using namespace RRStrategy;
 
@@ -32,6 +34,7 @@ namespace RRServer {
 	
     short
 	ReconServant::CleanUp () {
+		omni_mutex_lock lock (m_tlock); // Workspace::Finalise drops pending transfers
 		return Queue::CleanUp();
 	}
 
@@ -52,6 +55,17 @@ namespace RRServer {
 	
 	short
 	ReconServant::Init (const char* name, const char* config, const char* client_id) {
+		// Thread budget and placement of the chain apply where its modules run
+		if (m_contexts.empty() && m_config) {
+			TiXmlDocument doc;
+			doc.Parse (m_config);
+			TiXmlElement* chain = TiXmlHandle (&doc).FirstChild("config").FirstChild("chain").ToElement();
+			if (chain) {
+				ExecutionContext& ctx = ExecutionContext::Instance();
+				ctx.Configure (chain->Attribute("threads"), chain->Attribute("pin"), chain->Attribute("numa"));
+				std::cout << ctx << std::endl;
+			}
+		}
 		return Queue::Init(name, config, client_id);
 	}
 	
@@ -62,7 +76,11 @@ namespace RRServer {
 	
     short
 	ReconServant::Process  (const char* name) {
-		return Queue::Process(name);
+		short ret = Queue::Process(name);
+		// The ORB runs until the daemon is killed: keep wisdom of new plans
+		if (wspace.p.exists("wisdom"))
+			ExportWisdom (wspace.p.Get<std::string>("wisdom"));
+		return ret;
 	}
 	
 	short
@@ -131,6 +149,97 @@ namespace RRServer {
 	}
 
 
+	CORBA::LongLong
+	ReconServant::open_matrix (const char* name, const char* dtype, const RRSModule::longs& dims,
+			const RRSModule::floats& res, CORBA::Boolean resume) {
+		const std::string t (dtype);
+		if      (t == TypeTraits<cxfl>::Abbrev())   return OpenMatrix<cxfl>   (name, dims, res, resume);
+		else if (t == TypeTraits<cxdb>::Abbrev())   return OpenMatrix<cxdb>   (name, dims, res, resume);
+		else if (t == TypeTraits<float>::Abbrev())  return OpenMatrix<float>  (name, dims, res, resume);
+		else if (t == TypeTraits<double>::Abbrev()) return OpenMatrix<double> (name, dims, res, resume);
+		else if (t == TypeTraits<short>::Abbrev())  return OpenMatrix<short>  (name, dims, res, resume);
+		else if (t == TypeTraits<long>::Abbrev())   return OpenMatrix<long>   (name, dims, res, resume);
+		return -1;
+	}
+
+	CORBA::LongLong
+	ReconServant::put_chunk (const char* name, CORBA::LongLong offset, const RRSModule::octets& data) {
+		omni_mutex_lock lock (m_tlock);
+		Workspace& ws = Workspace::Instance();
+		if (offset < 0)
+			return ws.Received (name);
+		return ws.PutChunk (name, (size_t)offset, data.get_buffer(), data.length());
+	}
+
+	CORBA::LongLong
+	ReconServant::received (const char* name) {
+		omni_mutex_lock lock (m_tlock);
+		return Workspace::Instance().Received (name);
+	}
+
+	CORBA::LongLong
+	ReconServant::matrix_header (const char* name, const char* dtype, RRSModule::longs_out dims,
+			RRSModule::floats_out res) {
+		const std::string t (dtype);
+		if      (t == TypeTraits<cxfl>::Abbrev())   return MatrixHeader<cxfl>   (name, dims, res);
+		else if (t == TypeTraits<cxdb>::Abbrev())   return MatrixHeader<cxdb>   (name, dims, res);
+		else if (t == TypeTraits<float>::Abbrev())  return MatrixHeader<float>  (name, dims, res);
+		else if (t == TypeTraits<double>::Abbrev()) return MatrixHeader<double> (name, dims, res);
+		else if (t == TypeTraits<short>::Abbrev())  return MatrixHeader<short>  (name, dims, res);
+		else if (t == TypeTraits<long>::Abbrev())   return MatrixHeader<long>   (name, dims, res);
+		dims = new RRSModule::longs;
+		res  = new RRSModule::floats;
+		return -1;
+	}
+
+	RRSModule::octets*
+	ReconServant::get_chunk (const char* name, const char* dtype, CORBA::LongLong offset,
+			CORBA::LongLong length) {
+		const std::string t (dtype);
+		if      (t == TypeTraits<cxfl>::Abbrev())   return GetChunk<cxfl>   (name, offset, length);
+		else if (t == TypeTraits<cxdb>::Abbrev())   return GetChunk<cxdb>   (name, offset, length);
+		else if (t == TypeTraits<float>::Abbrev())  return GetChunk<float>  (name, offset, length);
+		else if (t == TypeTraits<double>::Abbrev()) return GetChunk<double> (name, offset, length);
+		else if (t == TypeTraits<short>::Abbrev())  return GetChunk<short>  (name, offset, length);
+		else if (t == TypeTraits<long>::Abbrev())   return GetChunk<long>   (name, offset, length);
+		return new RRSModule::octets;
+	}
+
+	short
+	ReconServant::open_stream (const char* name, const char* dtype, const RRSModule::longs& dims,
+			CORBA::LongLong chunk, CORBA::Boolean ring) {
+		const std::string t (dtype);
+		if      (t == TypeTraits<cxfl>::Abbrev())   return OpenStream<cxfl>   (name, dims, chunk, ring);
+		else if (t == TypeTraits<cxdb>::Abbrev())   return OpenStream<cxdb>   (name, dims, chunk, ring);
+		else if (t == TypeTraits<float>::Abbrev())  return OpenStream<float>  (name, dims, chunk, ring);
+		else if (t == TypeTraits<double>::Abbrev()) return OpenStream<double> (name, dims, chunk, ring);
+		else if (t == TypeTraits<short>::Abbrev())  return OpenStream<short>  (name, dims, chunk, ring);
+		else if (t == TypeTraits<long>::Abbrev())   return OpenStream<long>   (name, dims, chunk, ring);
+		return codeare::WRONG_MATRIX_TYPE;
+	}
+
+	short
+	ReconServant::append_lines (const char* name, const RRSModule::ushorts& lc, CORBA::Long nlc,
+			CORBA::Long ns, CORBA::Long nc, CORBA::Long cha, const RRSModule::octets& data) {
+		omni_mutex_lock lock (m_tlock);
+		Workspace& ws = Workspace::Instance();
+		if      (ws.Exists<cxfl>(name)   == codeare::OK) return AppendLines<cxfl>   (name, lc, nlc, ns, nc, cha, data);
+		else if (ws.Exists<cxdb>(name)   == codeare::OK) return AppendLines<cxdb>   (name, lc, nlc, ns, nc, cha, data);
+		else if (ws.Exists<float>(name)  == codeare::OK) return AppendLines<float>  (name, lc, nlc, ns, nc, cha, data);
+		else if (ws.Exists<double>(name) == codeare::OK) return AppendLines<double> (name, lc, nlc, ns, nc, cha, data);
+		else if (ws.Exists<short>(name)  == codeare::OK) return AppendLines<short>  (name, lc, nlc, ns, nc, cha, data);
+		else if (ws.Exists<long>(name)   == codeare::OK) return AppendLines<long>   (name, lc, nlc, ns, nc, cha, data);
+		return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+	}
+
+	short
+	ReconServant::close_stream (const char* name) {
+		omni_mutex_lock lock (m_tlock);
+		codeare::error_code ec = Workspace::Instance().CloseStream (name);
+		return (ec == codeare::OK) ? ProcessChunks (name) : (short) ec;
+	}
+
+
     void
     ReconServant::inform (omni::omniInterceptors::assignUpcallThread_T::info_T &info) {
         info.run();
@@ -23,6 +23,7 @@
 
 #include "RRSModule.hh"
 
+#include <algorithm>
 #include <string>
 #include <map>
 #include "ReconContext.hpp"
@@ -168,7 +169,7 @@ namespace RRServer {
 
 			typedef typename RemoteTraits<CORBA_Type>::Type T;
 
-			Matrix<T> tmp = Workspace::Instance().Get<T> (name);
+			const Matrix<T>& tmp = Workspace::Instance().Get<T> (name);
 			size_t cpsz = tmp.Size();
 			size_t nd = tmp.NDim();
 			c.dims.length(nd);
@@ -186,6 +187,225 @@ namespace RRServer {
 
 
 
+		/**
+		 * @brief       Preallocate workspace matrix for chunked transfer
+		 *
+		 * @see         RRSModule::RRSInterface::open_matrix
+		 * @see         Workspace::OpenTransfer
+		 */
+		template <class T> CORBA::LongLong
+		OpenMatrix (const char* name, const RRSModule::longs& dims, const RRSModule::floats& res,
+		            const bool& resume) {
+
+			size_t nd = dims.length();
+			Vector<size_t> mdims (nd);
+			Vector<float>  mress (nd, 1.);
+			for (size_t i = 0; i < nd; i++) {
+				mdims[i] = dims[i];
+				if (i < res.length())
+					mress[i] = res[i];
+			}
+
+			omni_mutex_lock lock (m_tlock);
+			return (CORBA::LongLong) Workspace::Instance().OpenTransfer<T> (name, mdims, mress, resume);
+
+		}
+
+
+		/**
+		 * @brief       Dimensions and byte size of workspace matrix
+		 *
+		 * @see         RRSModule::RRSInterface::matrix_header
+		 */
+		template <class T> CORBA::LongLong
+		MatrixHeader (const char* name, RRSModule::longs_out dims, RRSModule::floats_out res) {
+
+			Workspace& ws = Workspace::Instance();
+			RRSModule::longs*  d = new RRSModule::longs;
+			RRSModule::floats* r = new RRSModule::floats;
+			dims = d;
+			res  = r;
+			if (ws.Exists<T>(name) != codeare::OK)
+				return -1;
+
+			const Matrix<T>& m = ws.Get<T> (name);
+			size_t nd = m.NDim();
+			d->length (nd);
+			r->length (nd);
+			for (size_t j = 0; j < nd; j++) {
+				(*d)[j] = m.Dim(j);
+				(*r)[j] = m.Res(j);
+			}
+
+			return (CORBA::LongLong) (m.Size() * sizeof(T));
+
+		}
+
+
+		/**
+		 * @brief       Slab of workspace matrix, lent to the ORB without copy
+		 *
+		 * @see         RRSModule::RRSInterface::get_chunk
+		 */
+		template <class T> RRSModule::octets*
+		GetChunk (const char* name, const CORBA::LongLong& offset, const CORBA::LongLong& length) {
+
+			Workspace& ws = Workspace::Instance();
+			if (ws.Exists<T>(name) != codeare::OK)
+				return new RRSModule::octets;
+
+			Matrix<T>& m = ws.Get<T> (name);
+			const CORBA::LongLong size = m.Size() * sizeof(T);
+			if (offset < 0 || length < 0 || offset >= size)
+				return new RRSModule::octets;
+
+			const CORBA::ULong len = (CORBA::ULong) std::min (length, size - offset);
+			return new RRSModule::octets (len, len, (CORBA::Octet*) m.Ptr() + offset, false);
+
+		}
+
+
+		/**
+		 * @brief       Preallocate workspace matrix for line by line acquisition
+		 *
+		 * @see         RRSModule::RRSInterface::open_stream
+		 * @see         Workspace::OpenStream
+		 */
+		template <class T> short
+		OpenStream (const char* name, const RRSModule::longs& dims, const CORBA::LongLong& chunk,
+		            const bool& ring) {
+
+			size_t nd = dims.length();
+			Vector<size_t> mdims (nd);
+
+			for (size_t i = 0; i < nd; i++)
+				mdims[i] = dims[i];
+			if (nd < 2 || chunk < 0)
+				return codeare::UNSUPPORTED_DIMENSION;
+
+			omni_mutex_lock lock (m_tlock);
+			Workspace::Instance().OpenStream<T> (name, mdims, (size_t)chunk, ring);
+			return codeare::OK;
+
+		}
+
+
+		/**
+		 * @brief       Append lines to stream and hand completed chunks to
+		 *              the strategies (caller holds m_tlock)
+		 *
+		 * @see         RRSModule::RRSInterface::append_lines
+		 * @see         Workspace::AppendLine
+		 * @see         Queue::ProcessChunks
+		 */
+		template <class T> short
+		AppendLines (const char* name, const RRSModule::ushorts& lc, const CORBA::Long& nlc,
+		             const CORBA::Long& ns, const CORBA::Long& nc, const CORBA::Long& cha,
+		             const RRSModule::octets& data) {
+
+			Workspace& ws = Workspace::Instance();
+			const AcqStream* as = ws.Stream (name);
+
+			if (!as)
+				return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+			if (nlc < 0 || ns <= 0 || nc < 0 || cha < 0)
+				return codeare::UNSUPPORTED_DIMENSION;
+
+			// Lines of ns samples per channel, channels and lines contiguous
+			const size_t line = (size_t)ns * (nc ? (size_t)nc : as->dims[1]),
+				n = data.length() / (line * sizeof(T));
+			if (data.length() != n * line * sizeof(T) || lc.length() != n * (size_t)nlc)
+				return codeare::UNSUPPORTED_DIMENSION;
+
+			const T* x = (const T*) data.get_buffer();
+			codeare::error_code ec = codeare::OK;
+			for (size_t l = 0; l < n && ec == codeare::OK; ++l)
+				ec = ws.AppendLine (name, lc.get_buffer() + l*nlc, (size_t)nlc, x + l*line,
+				                    (size_t)ns, (size_t)nc, (size_t)cha);
+
+			return (ec == codeare::OK) ? ProcessChunks (name) : (short) ec;
+
+		}
+
+
+		/**
+		 * @brief       Announce chunked transfer
+		 *
+		 * @see         RRSModule::RRSInterface::open_matrix
+		 */
+		CORBA::LongLong
+		open_matrix   (const char* name, const char* dtype, const RRSModule::longs& dims,
+		               const RRSModule::floats& res, CORBA::Boolean resume);
+
+
+		/**
+		 * @brief       Receive slab of announced matrix
+		 *
+		 * @see         RRSModule::RRSInterface::put_chunk
+		 */
+		CORBA::LongLong
+		put_chunk     (const char* name, CORBA::LongLong offset, const RRSModule::octets& data);
+
+
+		/**
+		 * @brief       Bytes of announced matrix received so far
+		 *
+		 * @see         RRSModule::RRSInterface::received
+		 */
+		CORBA::LongLong
+		received      (const char* name);
+
+
+		/**
+		 * @brief       Matrix dimensions for chunked retrieval
+		 *
+		 * @see         RRSModule::RRSInterface::matrix_header
+		 */
+		CORBA::LongLong
+		matrix_header (const char* name, const char* dtype, RRSModule::longs_out dims,
+		               RRSModule::floats_out res);
+
+
+		/**
+		 * @brief       Slab of matrix for chunked retrieval
+		 *
+		 * @see         RRSModule::RRSInterface::get_chunk
+		 */
+		RRSModule::octets*
+		get_chunk     (const char* name, const char* dtype, CORBA::LongLong offset,
+		               CORBA::LongLong length);
+
+
+		/**
+		 * @brief       Preallocate matrix for line by line acquisition
+		 *
+		 * @see         RRSModule::RRSInterface::open_stream
+		 */
+		short
+		open_stream   (const char* name, const char* dtype, const RRSModule::longs& dims,
+		               CORBA::LongLong chunk, CORBA::Boolean ring);
+
+
+		/**
+		 * @brief       Append acquisition lines, process completed chunks
+		 *
+		 * @see         RRSModule::RRSInterface::append_lines
+		 */
+		short
+		append_lines  (const char* name, const RRSModule::ushorts& lc, CORBA::Long nlc,
+		               CORBA::Long ns, CORBA::Long nc, CORBA::Long cha,
+		               const RRSModule::octets& data);
+
+
+		/**
+		 * @brief       End of acquisition, process remaining lines
+		 *
+		 * @see         RRSModule::RRSInterface::close_stream
+		 */
+		short
+		close_stream  (const char* name);
+
+
 		/**
 		 * @brief       Retreive measurement data
 		 *
@@ -328,6 +548,12 @@ namespace RRServer {
         static void
         inform        (omni::omniInterceptors::assignUpcallThread_T::info_T &info);
 
+
+	private:
+
+
+		omni_mutex                     m_tlock;     /**< @brief Guards workspace transfers and streams */
+
 		
 	};
 
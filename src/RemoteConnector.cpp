@@ -32,7 +32,8 @@ namespace RRClient {
 
 
 	RemoteConnector::RemoteConnector  (int i, char** c, const std::string& service_id,
-			const std::string& debug_level, const std::string& client_id) {
+			const std::string& debug_level, const std::string& client_id) :
+		m_chunk (64 << 20), m_retries (3), m_progress (0) {
 		
 		try {
             if (!client_id.empty()) {
@@ -23,11 +23,15 @@
 
 #include "Configurable.hpp"
 #include "Connection.hpp"
+#include "ChunkedTransfer.hpp"
 #include "Matrix.hpp"
+#include "Workspace.hpp"
 
 #include "RRSModule.hh"
 
+#include <algorithm>
 #include <complex>
+#include <map>
 #include <vector>
 
 
@@ -99,6 +103,67 @@ namespace RRClient {
 	};
 
 
+	/**
+	 * @brief               Chunked transfer channel to remote service
+	 *
+	 * @see                 SendChunks
+	 */
+	struct RemoteChannel {
+
+		RemoteChannel (const RRSInterface_var& rrsi, const std::string& dtype,
+		               const longs& dims, const floats& res) :
+			m_rrsi (rrsi), m_dtype (dtype), m_dims (dims), m_res (res) {}
+
+		inline CORBA::LongLong
+		Open (const std::string& name, const bool& resume) {
+			try {
+				return m_rrsi->open_matrix (name.c_str(), m_dtype.c_str(), m_dims, m_res, resume);
+			} catch (const CORBA::TRANSIENT&) {
+				throw TransferLost();
+			} catch (const CORBA::COMM_FAILURE&) {
+				throw TransferLost();
+			}
+		}
+
+		inline CORBA::LongLong
+		Put (const std::string& name, const size_t& off, const char* data, const size_t& len) {
+			octets slab ((CORBA::ULong) len, (CORBA::ULong) len,
+			             (CORBA::Octet*) data, false); // borrowed, no copy
+			try {
+				return m_rrsi->put_chunk (name.c_str(), (CORBA::LongLong) off, slab);
+			} catch (const CORBA::TRANSIENT&) {
+				throw TransferLost();
+			} catch (const CORBA::COMM_FAILURE&) {
+				throw TransferLost();
+			}
+		}
+
+		const RRSInterface_var& m_rrsi;
+		const std::string       m_dtype;
+		const longs&            m_dims;
+		const floats&           m_res;
+
+	};
+
+
+	/**
+	 * @brief               Acquisition lines staged for one append_lines call
+	 */
+	struct RemoteStream {
+
+		RemoteStream () : channels(0), batch(0), lines(0), nlc(0), ns(0), nc(0), cha(0) {}
+
+		std::string                dtype;    /**< @brief Element type                   */
+		size_t                     channels; /**< @brief Channels of the stream matrix  */
+		size_t                     batch;    /**< @brief Lines per call (0: bytes only) */
+		size_t                     lines;    /**< @brief Lines staged                   */
+		CORBA::Long                nlc, ns, nc, cha; /**< @brief Layout of staged lines */
+		std::vector<CORBA::UShort> lc;       /**< @brief Staged loop counters           */
+		std::vector<CORBA::Octet>  data;     /**< @brief Staged samples                 */
+
+	};
+
+
 	/**
 	 * @brief               Remotely connected reconstruction client 
 	 */
@@ -166,38 +231,46 @@ namespace RRClient {
 		
 
 		/**
-		 * @brief           Transmit measurement data to remote service
+		 * @brief           Transmit measurement data to remote service<br/>
+		 *                  The matrix is preallocated in the remote workspace and
+		 *                  streamed in slabs of ChunkSize() bytes, each lent to the
+		 *                  ORB without copy. Broken transfers are resumed where the
+		 *                  service left off.
 		 *
 		 * @see             Workspace::SetMatrix
+		 * @see             SendChunks
 		 * @param  name     Name
 		 * @param  m        Complex data
+		 * @param  resume   Resume pending transfer of an earlier call
+		 * @return          Success
 		 */
-		template <class T> void 
-		SetMatrix           (const std::string& name, const Matrix<T>& m) const {
-
-			typename RemoteTraits<T>::CORBA_Type ct;
-
-			size_t ms = m.Size();
-			size_t nd = m.NDim();
-			ct.dims.length(nd);
-			ct.res.length(nd);
-
-			for (int j = 0; j < nd; j++) {
-				ct.dims[j] = m.Dim(j);
-				ct.res[j]  = m.Res(j);
+		template <class T> codeare::error_code
+		SetMatrix           (const std::string& name, const Matrix<T>& m,
+		                     const bool& resume = false) const {
+
+			const size_t nd = m.NDim(), size = m.Size() * sizeof(T);
+			longs  dims (nd);
+			floats res  (nd);
+			dims.length(nd);
+			res.length(nd);
+
+			for (size_t j = 0; j < nd; j++) {
+				dims[j] = m.Dim(j);
+				res[j]  = m.Res(j);
 			}
 
-			ct.vals.length(TypeTraits<T>::IsComplex() ? ms * 2 : ms);
-			memcpy (&ct.vals[0], m.Ptr(), ms * sizeof(T));
-
-			RemoteTraits<T>::Send(m_rrsi, name, ct);
+			RemoteChannel rc (m_rrsi, TypeTraits<T>::Abbrev(), dims, res);
+			return SendChunks (rc, name, (const char*) m.Ptr(), size, resume,
+			                   m_chunk, m_retries, m_progress);
 
 		}
 
 		
 		
 		/**
-		 * @brief           Retrieve manipulated data from remote service
+		 * @brief           Retrieve manipulated data from remote service<br/>
+		 *                  Slabs of ChunkSize() bytes are copied straight into
+		 *                  the preallocated matrix.
 		 *
 		 * @see             Workspace::GetMatrix
 		 * @param  name     Name
@@ -206,34 +279,212 @@ namespace RRClient {
 		template <class T> codeare::error_code
 		GetMatrix           (const std::string& name, Matrix<T>& m) const {
 
-			typename RemoteTraits<T>::CORBA_Type ct;
+			longs_var  dims;
+			floats_var res;
+			const std::string dtype = TypeTraits<T>::Abbrev();
 
-			RemoteTraits<T>::Retrieve (m_rrsi, name, ct);
-			size_t nd = ct.dims.length();
+			const CORBA::LongLong size = m_rrsi->matrix_header (name.c_str(), dtype.c_str(),
+				dims.out(), res.out());
+			if (size < 0)
+				return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
 
+			size_t nd = dims->length();
 			Vector<size_t> mdims (nd);
 			Vector<float>  mress (nd);
 
-			for (int j = 0; j < nd; j++) {
-				mdims[j] = ct.dims[j];
-				mress[j] = ct.res[j];
+			for (size_t j = 0; j < nd; j++) {
+				mdims[j] = dims[j];
+				mress[j] = res[j];
 			}
 
 			m = Matrix<T> (mdims, mress);
-			size_t ms = m.Size();
-			memcpy (&m[0], &ct.vals[0], ms * sizeof(T));
+			assert ((size_t)size == m.Size() * sizeof(T));
+
+			CORBA::Octet* p = (CORBA::Octet*) m.Ptr();
+			size_t off = 0, fails = 0;
+
+			while (off < (size_t)size) {
+				try {
+					octets_var slab = m_rrsi->get_chunk (name.c_str(), dtype.c_str(),
+						(CORBA::LongLong) off, (CORBA::LongLong) m_chunk);
+					if (slab->length() == 0)
+						return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+					memcpy (p + off, slab->get_buffer(), slab->length());
+					off  += slab->length();
+					fails = 0;
+				} catch (const CORBA::TRANSIENT&) {
+					if (++fails > m_retries)
+						throw;
+				} catch (const CORBA::COMM_FAILURE&) {
+					if (++fails > m_retries)
+						throw;
+				}
+				if (m_progress)
+					m_progress (name, off, (size_t)size);
+			}
 
 			return codeare::OK;
 
 		}
+
+
+		/**
+		 * @brief           Slab size of matrix transfers
+		 *
+		 * @param  bytes    Bytes per slab (default 64MB)
+		 */
+		inline void
+		ChunkSize           (const size_t& bytes) {
+			m_chunk = std::max (bytes, (size_t)1);
+		}
+
+
+		/**
+		 * @brief           Retries of a slab before giving up
+		 *
+		 * @param  n        # of retries (default 3)
+		 */
+		inline void
+		Retries             (const size_t& n) {
+			m_retries = n;
+		}
+
+
+		/**
+		 * @brief           Report transfer progress after every slab
+		 *
+		 * @param  p        Callback (0: none)
+		 */
+		inline void
+		Progress            (TransferProgress p) {
+			m_progress = p;
+		}
 		
 		
+
+		/**
+		 * @brief           Preallocate matrix for line by line acquisition in
+		 *                  the remote workspace. The stream is unknown to
+		 *                  AppendLine if the service refused it.
+		 *
+		 * @see             Workspace::OpenStream
+		 * @see             RRSModule::RRSInterface::open_stream
+		 */
+		template <class T> void
+		OpenStream          (const std::string& name, const Vector<size_t>& dims,
+		                     const size_t& chunk = 0, const bool& ring = false) {
+
+			const size_t nd = dims.size();
+			longs d (nd);
+			d.length(nd);
+			for (size_t j = 0; j < nd; j++)
+				d[j] = dims[j];
+
+			m_streams.erase (name);
+			if (m_rrsi->open_stream (name.c_str(), TypeTraits<T>::Abbrev().c_str(), d,
+			                         (CORBA::LongLong) chunk, ring) != codeare::OK)
+				return;
+
+			RemoteStream& rs = m_streams[name];
+			rs.dtype    = TypeTraits<T>::Abbrev();
+			rs.channels = dims[1];
+			rs.batch    = chunk;
+
+		}
+
+
+		/**
+		 * @brief           Append acquisition line<br/>
+		 *                  Lines are sent a chunk at a time (ChunkSize() bytes
+		 *                  at most), so that the service processes each chunk as
+		 *                  it completes.
+		 *
+		 * @see             Workspace::AppendLine
+		 * @see             RRSModule::RRSInterface::append_lines
+		 */
+		template <class T> codeare::error_code
+		AppendLine          (const std::string& name, const uint16_t* lc, const size_t& nlc,
+		                     const T* data, const size_t& ns, const size_t& nc = 0,
+		                     const size_t& cha = 0) {
+
+			std::map<std::string,RemoteStream>::iterator si = m_streams.find (name);
+			if (si == m_streams.end())
+				return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+			RemoteStream& rs = si->second;
+			if (rs.dtype != TypeTraits<T>::Abbrev())
+				return codeare::WRONG_MATRIX_TYPE;
+
+			// One call carries lines of one layout
+			codeare::error_code ec = codeare::OK;
+			if (rs.lines && (rs.nlc != (CORBA::Long)nlc || rs.ns != (CORBA::Long)ns ||
+			                 rs.nc != (CORBA::Long)nc || rs.cha != (CORBA::Long)cha) &&
+				(ec = Flush (name, rs)) != codeare::OK)
+				return ec;
+			rs.nlc = nlc; rs.ns = ns; rs.nc = nc; rs.cha = cha;
+
+			const CORBA::Octet* x = (const CORBA::Octet*) data;
+			rs.lc.insert   (rs.lc.end(), lc, lc + nlc);
+			rs.data.insert (rs.data.end(), x, x + ns * (nc ? nc : rs.channels) * sizeof(T));
+			++rs.lines;
+
+			return ((rs.batch && rs.lines >= rs.batch) || rs.data.size() >= m_chunk) ?
+				Flush (name, rs) : codeare::OK;
+
+		}
+
+
+		/**
+		 * @brief           End of acquisition. Send staged lines and let the
+		 *                  service process the remainder.
+		 *
+		 * @see             RRSModule::RRSInterface::close_stream
+		 * @param  name     Name
+		 * @return          Error code
+		 */
+		template <class T> codeare::error_code
+		CloseStream         (const std::string& name) {
+			std::map<std::string,RemoteStream>::iterator si = m_streams.find (name);
+			if (si == m_streams.end())
+				return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+			codeare::error_code ec = Flush (name, si->second);
+			m_streams.erase (si);
+			codeare::error_code cc = (codeare::error_code) m_rrsi->close_stream (name.c_str());
+			return (ec != codeare::OK) ? ec : cc;
+		}
+
 		
 	private:
 		
 		RRSInterface_var    m_rrsi;       /**< @brief Remote Recon interface               */
 		CORBA::ORB_var      m_orb;        /**< @brief Orb                                  */
         std::string         m_client_id;
+		size_t              m_chunk;      /**< @brief Bytes per slab of transfers      */
+		size_t              m_retries;    /**< @brief Retries per slab                 */
+		TransferProgress    m_progress;   /**< @brief Progress callback                */
+		std::map<std::string,RemoteStream> m_streams; /**< @brief Open acquisition streams */
+
+
+		/**
+		 * @brief           Send staged lines of a stream, lent to the ORB
+		 *                  without copy
+		 *
+		 * @param  name     Name
+		 * @param  rs       Stream
+		 * @return          Error code
+		 */
+		inline codeare::error_code
+		Flush               (const std::string& name, RemoteStream& rs) {
+			if (!rs.lines)
+				return codeare::OK;
+			ushorts lc   ((CORBA::ULong) rs.lc.size(), (CORBA::ULong) rs.lc.size(), rs.lc.data(), false);
+			octets  data ((CORBA::ULong) rs.data.size(), (CORBA::ULong) rs.data.size(), rs.data.data(), false);
+			codeare::error_code ec = (codeare::error_code) m_rrsi->append_lines (name.c_str(), lc,
+				rs.nlc, rs.ns, rs.nc, rs.cha, data);
+			rs.lc.clear();
+			rs.data.clear();
+			rs.lines = 0;
+			return ec;
+		}
 		
 		/**
 		 * @brief           Get size from dimensions (Needed internally)
@@ -20,6 +20,8 @@
 
 #include "codeare.hpp"
 #include "IOContext.hpp"
+#include "ExecutionContext.hpp"
+#include "FFTWTraits.hpp"
 #include <thread>
 
 using namespace codeare::matrix::io;
@@ -101,6 +103,19 @@ int main (int argc, char** argv) {
 			printf ("*** ERROR: Chain of modules must be specified. \n");
 			return codeare::CONFIG_MISSING_CHAIN;
 		}
+
+		// Thread budget and placement of the chain, e.g. <chain threads="16" pin="true" numa="scatter">
+		ExecutionContext& ctx = ExecutionContext::Instance();
+		ctx.Configure (chain->Attribute("threads"), chain->Attribute("pin"), chain->Attribute("numa"));
+		std::cout << ctx << std::endl;
+
+		// FFT planner rigour and wisdom of the chain, e.g. <chain fftw="measure" wisdom="fftw.wis">
+		const char* rigour = chain->Attribute("fftw");
+		const char* wisdom = chain->Attribute("wisdom");
+		PlannerRigour (rigour ? rigour : "estimate");
+		if (wisdom)
+			ImportWisdom (wisdom);
+
 	    TiXmlElement* module = chain->FirstChildElement();
 	    if (!module) {
 			printf ("*** ERROR: Chain of modules must have at least one element.\n");
@@ -133,6 +148,8 @@ int main (int argc, char** argv) {
 	    if (nmodules > 0) {
 	    	con.Prepare();
 	    	con.Process();
+	    	if (wisdom)
+	    		ExportWisdom (wisdom);
 	    } else {
 	    	printf ("Warning! No modules were found in the configuration file. Exiting\n");
 	    }
@@ -124,12 +124,22 @@ int main (int argc, char** argv) {
     }
     wspace.p["http_port"] = port;
 
+    // FFT plans of all services: planner rigour and accumulated wisdom
+    PlannerRigour (rigour);
+    if (strcmp(wisdom,EMPTY)) {
+        ImportWisdom (wisdom);
+        wspace.p["wisdom"] = std::string (wisdom); // Saved after every Process
+    }
+
     // Web service thread
     http_service ();
 
     // Corba service threads
     corba_service (argc, argv);
 
+    if (strcmp(wisdom,EMPTY))
+        ExportWisdom (wisdom);
+
     return 0;
     
 }
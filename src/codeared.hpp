@@ -40,13 +40,14 @@
 #endif
 
 #include "options.h"
+#include "FFTWTraits.hpp"
 #include "GitSHA1.hpp"
 
 #ifndef SVN_REVISION
     #define SVN_REVISION "unkown"
 #endif
 
-char  *name, *debug, *logfile, *port, *EMPTY = (char*)"", *FIVE = (char*)"5";
+char  *name, *debug, *logfile, *port, *wisdom, *rigour, *EMPTY = (char*)"", *FIVE = (char*)"5";
 
 using namespace std;
 using namespace RRServer;
@@ -81,6 +82,8 @@ bool init (int argc, char** argv) {
     opt->addUsage  (" -d, --debug    Debug level 0-40 (default: 5)");
     opt->addUsage  (" -l, --logfile  Log file (default: ./reconserver.log)");
     opt->addUsage  (" -p, --httpport http service port (default 8080)");
+    opt->addUsage  (" -w, --wisdom   FFTW wisdom file, loaded at start and saved after each Process");
+    opt->addUsage  (" -f, --fftw     FFTW planner: estimate|measure|patient|exhaustive (default: estimate)");
     opt->addUsage  ("");
     opt->addUsage  (" -h, --help     Print this help screen");
 
@@ -90,6 +93,8 @@ bool init (int argc, char** argv) {
     opt->setOption ("debug"   , 'd');
     opt->setOption ("name"    , 'n');
     opt->setOption ("httpport", 'p');
+    opt->setOption ("wisdom"  , 'w');
+    opt->setOption ("fftw"    , 'f');
 
 
     opt->processCommandArgs(argc, argv);
@@ -114,6 +119,12 @@ bool init (int argc, char** argv) {
     tmp = opt->getValue("httpport");
     port    = (tmp && atoi(tmp) >= 0 && atoi(tmp) <= 65536) ? tmp : (char*)"8080";
 
+    tmp = opt->getValue("wisdom");
+    wisdom  = (tmp && strcmp(tmp,EMPTY)) ? tmp : EMPTY;
+
+    tmp = opt->getValue("fftw");
+    rigour  = (tmp && strcmp(tmp,EMPTY)) ? tmp : (char*)"estimate";
+
     delete opt;
     return true;
 
@@ -0,0 +1,102 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __CHUNKED_TRANSFER_HPP__
+#define __CHUNKED_TRANSFER_HPP__
+
+#include "common.h"
+
+#include <algorithm>
+#include <string>
+
+/**
+ * @brief           Progress of chunked transfers (name, bytes done, bytes total)
+ */
+typedef void (*TransferProgress) (const std::string&, const size_t&, const size_t&);
+
+namespace RRClient {
+
+	/**
+	 * @brief       Thrown by transfer channels on a broken connection
+	 */
+	struct TransferLost {};
+
+
+	/**
+	 * @brief           Stream a matrix to a service in slabs<br/>
+	 *                  The channel's Open (name, resume) preallocates the matrix
+	 *                  and returns the bytes the service already holds (-1:
+	 *                  unknown type). Put (name, offset, data, bytes) hands over
+	 *                  one slab and returns the bytes received so far (-1: no
+	 *                  such transfer). Both throw TransferLost on a broken
+	 *                  connection, upon which the transfer is reopened for resume.
+	 *                  A service which completed or forgot the transfer starts
+	 *                  over.
+	 *
+	 * @param  c        Channel
+	 * @param  name     Name
+	 * @param  data     Matrix memory
+	 * @param  size     Bytes
+	 * @param  resume   Resume pending transfer of an earlier call
+	 * @param  chunk    Bytes per slab
+	 * @param  retries  Consecutive broken connections tolerated
+	 * @param  progress Called after every slab (0: none)
+	 * @return          Success
+	 */
+	template<class C> inline codeare::error_code
+	SendChunks (C& c, const std::string& name, const char* data, const size_t& size,
+	            bool resume, const size_t& chunk, const size_t& retries,
+	            TransferProgress progress = 0) {
+
+		long long off = 0;
+		size_t fails = 0;
+		bool   open  = true;
+
+		while (open || (size_t)off < size) {
+			try {
+				if (open) {
+					off  = c.Open (name, resume);
+					if (off < 0)
+						return codeare::WRONG_MATRIX_TYPE;
+					open = false;
+					continue;
+				}
+				const size_t len = std::min (chunk, size - (size_t)off);
+				off   = c.Put (name, (size_t)off, data + off, len);
+				if (off < 0)
+					return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+				fails = 0;
+			} catch (const TransferLost&) {
+				if (++fails > retries)
+					return codeare::GENERAL_IO_ERROR;
+				open = resume = true;
+				continue;
+			}
+			if (progress)
+				progress (name, (size_t)off, size);
+		}
+
+		return codeare::OK;
+
+	}
+
+}
+
+#endif // __CHUNKED_TRANSFER_HPP__
@@ -0,0 +1,337 @@
+/*
+ *  codeare Copyright (C) 2007-2015 Kaveh Vahedipour
+ *                                  NYU School of Madicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __EXECUTION_CONTEXT_HPP__
+#define __EXECUTION_CONTEXT_HPP__
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+#if defined (__linux__)
+#  include <sched.h>
+#  include <dirent.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Thread placement across NUMA nodes
+ */
+enum numa_policy {
+	NUMA_COMPACT,  /**< @brief Fill one node before the next (default) */
+	NUMA_SCATTER   /**< @brief Round robin over nodes (memory bandwidth) */
+};
+
+/**
+ * @brief Process wide execution context. Singleton.<br/>
+ *        Owns the thread budget of a recon chain and the placement of the one
+ *        OpenMP worker pool on the machine's NUMA nodes. Operators size their
+ *        FFTW, NFFT and OpenMP teams from it instead of the machine size, so
+ *        that nested regions share the budget rather than multiply it.<br/>
+ *        Configured from the chain element of the configuration, e.g.
+ *        &lt;chain threads="16" pin="true" numa="scatter"&gt;
+ */
+class ExecutionContext {
+
+public:
+
+	/**
+	 * @brief        Get reference to context instance
+	 */
+	static ExecutionContext& Instance () {
+		static ExecutionContext ctx;
+		return ctx;
+	}
+
+
+	/**
+	 * @brief        Set thread budget and placement. Pins the worker pool if
+	 *               requested and disables nested parallelism.
+	 *
+	 * @param  threads  Budget (0: all CPUs available to the process)
+	 * @param  pin      Bind workers to CPUs
+	 * @param  policy   Placement across NUMA nodes
+	 */
+	inline void Configure (int threads = 0, bool pin = false,
+	                       numa_policy policy = NUMA_COMPACT) {
+
+		m_policy  = policy;
+		Order ();
+		m_threads = (threads > 0) ? threads : (int)m_cpus.size();
+		m_pinned  = false;
+
+#ifdef _OPENMP
+		omp_set_dynamic (0);
+		omp_set_num_threads (m_threads);
+		omp_set_max_active_levels (1);
+#endif
+		if (pin)
+			Pin ();
+
+	}
+
+
+	/**
+	 * @brief        Configure from attribute strings of the chain element
+	 *
+	 * @param  threads  Budget (empty or "0": all CPUs)
+	 * @param  pin      "true"/"1" to bind workers to CPUs
+	 * @param  numa     "compact" or "scatter"
+	 */
+	inline void Configure (const char* threads, const char* pin, const char* numa) {
+		int nt = threads ? atoi (threads) : 0;
+		bool pn = pin && (std::string (pin) == "true" || std::string (pin) == "1");
+		numa_policy np = (numa && std::string (numa) == "scatter") ? NUMA_SCATTER : NUMA_COMPACT;
+		Configure (nt, pn, np);
+	}
+
+
+	/**
+	 * @brief        Thread budget
+	 */
+	inline int Threads () const { return m_threads; }
+
+
+	/**
+	 * @brief        Threads for each of n concurrent workers
+	 *
+	 * @param  n     # of workers sharing the budget
+	 * @return       max (1, budget/n)
+	 */
+	inline int Threads (size_t n) const {
+		return (n == 0) ? m_threads : std::max (1, m_threads / (int)n);
+	}
+
+
+	/**
+	 * @brief        Team size for n independent work items
+	 *
+	 * @param  n     # of work items
+	 * @return       min (n, budget)
+	 */
+	inline int Workers (size_t n) const {
+		return (int) std::max ((size_t)1, std::min (n, (size_t)m_threads));
+	}
+
+
+	/**
+	 * @brief        # of NUMA nodes available to the process
+	 */
+	inline size_t Nodes () const { return m_nodes.size(); }
+
+
+	/**
+	 * @brief        CPUs in placement order. Worker i runs on CPUs()[i % size].
+	 */
+	inline const std::vector<int>& CPUs () const { return m_cpus; }
+
+
+	/**
+	 * @brief        Workers are bound to CPUs
+	 */
+	inline bool Pinned () const { return m_pinned; }
+
+
+	/**
+	 * @brief        Bind OpenMP workers to CPUs in placement order. The pool
+	 *               is persistent, teams of up to Threads() reuse the bound
+	 *               workers. The master thread is restricted to the budget's
+	 *               CPUs only, as threads it spawns (FFTW, std::thread)
+	 *               inherit its mask.
+	 */
+	inline void Pin () {
+#if defined (__linux__)
+		bool ok = true;
+#pragma omp parallel num_threads (m_threads) reduction (&&:ok)
+		{
+#ifdef _OPENMP
+			int tid = omp_get_thread_num();
+#else
+			int tid = 0;
+#endif
+			cpu_set_t set;
+			CPU_ZERO (&set);
+			if (tid == 0)
+				for (int i = 0; i < std::min (m_threads, (int)m_cpus.size()); ++i)
+					CPU_SET (m_cpus[i], &set);
+			else
+				CPU_SET (m_cpus[tid % m_cpus.size()], &set);
+			ok = ok && (sched_setaffinity (0, sizeof(set), &set) == 0);
+		}
+		m_pinned = ok;
+		if (!ok)
+			printf ("  WARNING - ExecutionContext: Failed to bind workers to CPUs.\n");
+#else
+		printf ("  WARNING - ExecutionContext: Binding workers to CPUs not supported.\n");
+#endif
+	}
+
+
+	/**
+	 * @brief        Print context
+	 */
+	inline void Print (std::ostream& os) const {
+		os << "  execution context: threads(" << m_threads << ") nodes(" << Nodes()
+		   << ") cpus(" << m_cpus.size() << ") numa("
+		   << ((m_policy == NUMA_SCATTER) ? "scatter" : "compact") << ") pinned("
+		   << (m_pinned ? "true" : "false") << ")";
+	}
+
+
+private:
+
+	/**
+	 * @brief        Detect topology, budget defaults to all available CPUs
+	 */
+	ExecutionContext () : m_threads (1), m_pinned (false), m_policy (NUMA_COMPACT) {
+		Topology ();
+		Order ();
+		m_threads = (int) m_cpus.size();
+	}
+
+	ExecutionContext (const ExecutionContext&);
+	ExecutionContext& operator= (const ExecutionContext&);
+
+
+	/**
+	 * @brief        CPUs per NUMA node restricted to the process' affinity mask
+	 */
+	inline void Topology () {
+
+		m_nodes.clear();
+
+#if defined (__linux__)
+		cpu_set_t mask;
+		CPU_ZERO (&mask);
+		bool have_mask = (sched_getaffinity (0, sizeof(mask), &mask) == 0);
+
+		if (DIR* dir = opendir ("/sys/devices/system/node")) {
+			std::vector<int> ids;
+			while (struct dirent* e = readdir (dir)) {
+				std::string name (e->d_name);
+				if (name.compare (0, 4, "node") == 0 && name.size() > 4 &&
+					isdigit (name[4]))
+					ids.push_back (atoi (name.c_str()+4));
+			}
+			closedir (dir);
+			std::sort (ids.begin(), ids.end());
+			for (size_t i = 0; i < ids.size(); ++i) {
+				std::stringstream fn;
+				fn << "/sys/devices/system/node/node" << ids[i] << "/cpulist";
+				std::vector<int> cpus = CPUList (fn.str()), avail;
+				for (size_t j = 0; j < cpus.size(); ++j)
+					if (!have_mask || CPU_ISSET (cpus[j], &mask))
+						avail.push_back (cpus[j]);
+				if (!avail.empty())
+					m_nodes.push_back (avail);
+			}
+		}
+
+		if (m_nodes.empty() && have_mask) {
+			std::vector<int> avail;
+			for (int c = 0; c < CPU_SETSIZE; ++c)
+				if (CPU_ISSET (c, &mask))
+					avail.push_back (c);
+			if (!avail.empty())
+				m_nodes.push_back (avail);
+		}
+#endif
+
+		if (m_nodes.empty()) {
+			std::vector<int> all (std::max (1u, std::thread::hardware_concurrency()));
+			for (size_t c = 0; c < all.size(); ++c)
+				all[c] = (int)c;
+			m_nodes.push_back (all);
+		}
+
+	}
+
+
+	/**
+	 * @brief        Order CPUs according to placement policy
+	 */
+	inline void Order () {
+		m_cpus.clear();
+		if (m_policy == NUMA_COMPACT) {
+			for (size_t n = 0; n < m_nodes.size(); ++n)
+				m_cpus.insert (m_cpus.end(), m_nodes[n].begin(), m_nodes[n].end());
+		} else {
+			for (size_t i = 0, more = 1; more; ++i) {
+				more = 0;
+				for (size_t n = 0; n < m_nodes.size(); ++n)
+					if (i < m_nodes[n].size()) {
+						m_cpus.push_back (m_nodes[n][i]);
+						more = 1;
+					}
+			}
+		}
+	}
+
+
+	/**
+	 * @brief        Parse sysfs CPU list (e.g. "0-7,16-23")
+	 */
+	inline static std::vector<int> CPUList (const std::string& fname) {
+		std::vector<int> cpus;
+		std::ifstream ifs (fname.c_str());
+		std::string range;
+		while (std::getline (ifs, range, ',')) {
+			int a = 0, b = -1;
+			char dash;
+			std::stringstream ss (range);
+			if (!(ss >> a))
+				continue;
+			if (!(ss >> dash >> b))
+				b = a;
+			for (int c = a; c <= b; ++c)
+				cpus.push_back (c);
+		}
+		return cpus;
+	}
+
+
+	int                            m_threads;  /**< @brief Thread budget */
+	bool                           m_pinned;   /**< @brief Workers bound to CPUs */
+	numa_policy                    m_policy;   /**< @brief Placement */
+	std::vector<std::vector<int> > m_nodes;    /**< @brief Available CPUs per NUMA node */
+	std::vector<int>               m_cpus;     /**< @brief CPUs in placement order */
+
+};
+
+
+/**
+ * @brief        Dump execution context to output stream
+ */
+inline std::ostream& operator<< (std::ostream& os, const ExecutionContext& ctx) {
+	ctx.Print (os);
+	return os;
+}
+
+#endif
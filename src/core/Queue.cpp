@@ -68,6 +68,21 @@ short Queue::Process  (const char* name)       {
 }
 
 
+short Queue::ProcessChunks (const char* name) {
+    codeare::error_code ret = codeare::OK;
+    size_t first;
+    std::vector<AcqLine> lines;
+    Workspace& ws = Workspace::Instance();
+    while (ret == codeare::OK && ws.NextChunk (name, first, lines))
+        for (auto it = m_contexts.begin(); it != m_contexts.end(); ++it)
+            if ((ret = it->context->ProcessChunk (name, first, lines)) != codeare::OK) {
+                printf ("Procession of %s lines [%zu,%zu) failed\n", it->name.c_str(), first, first+lines.size());
+                break;
+            }
+	return (short)ret;
+}
+
+
 short Queue::Prepare  (const char* name)       {
 	short ret = 0;
 	for (auto it = m_contexts.begin(); it != m_contexts.end(); ++it)
@@ -59,6 +59,13 @@ public:
 	 */
 	virtual short Process (const char* name);
 	
+	/**
+	 * @brief      Hand all complete chunks of a stream to the chain
+	 * @param name Name of stream
+	 * @return     Sucess
+	 */
+	virtual short ProcessChunks (const char* name);
+	
 	/**
 	 * @brief      Prepare startegy (Needs initialisation @see Init)
 	 * @param name Name of library
@@ -64,6 +64,13 @@ ReconContext::Process          () {
 }
 
 
+codeare::error_code
+ReconContext::ProcessChunk     (const std::string& stream, const size_t& first,
+                                const std::vector<AcqLine>& lines) {
+    return (m_strategy) ? m_strategy->ProcessChunk(stream, first, lines) : codeare::NULL_STRATEGY;
+}
+
+
 codeare::error_code
 ReconContext::Init             () {
     return (m_strategy) ? m_strategy->Init() : codeare::NULL_STRATEGY;
@@ -72,6 +72,16 @@ namespace RRStrategy {
 		Process          ();
 		
 		
+		/**
+		 * @brief        Process chunk. @see ReconStrategy::ProcessChunk()
+		 *
+		 * @return       Success
+		 */
+		codeare::error_code
+		ProcessChunk     (const std::string& stream, const size_t& first,
+		                  const std::vector<AcqLine>& lines);
+		
+		
 		/**
 		 * @brief        Initialise. @see ReconStrategy::Init()
 		 *
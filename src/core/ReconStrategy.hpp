@@ -92,6 +92,27 @@ namespace RRStrategy {
 		}
 		
 
+		/**
+		 * @brief       Optional incremental procession of streamed acquisition
+		 *              lines while the scan is running. Lines
+		 *              [first, first+lines.size()) of stream have been appended
+		 *              to the workspace matrix of the same name at the offsets
+		 *              lines[i].slot according to their loop counters
+		 *              lines[i].lc. In ring mode the slots are valid until the
+		 *              counters wrap onto them again. @see Workspace::AppendLine
+		 *
+		 * @param  stream Name of stream
+		 * @param  first  First line in acquisition order
+		 * @param  lines  Loop counters and matrix offsets of the lines
+		 * @return        Success
+		 */
+		virtual codeare::error_code
+		ProcessChunk    (const std::string& stream, const size_t& first,
+		                 const std::vector<AcqLine>& lines) {
+			return codeare::OK;
+		}
+		
+
 		/**
 		 * @brief       Attach a name to the algorithm
 		 *
@@ -22,6 +22,8 @@ Workspace::Finalise () {
   		m_store.erase(m_store.find (nit->second[0]));
   		m_ref.erase(nit);
   	}
+	m_streams.clear();
+	m_transfers.clear();
     
 	return codeare::OK;
 	
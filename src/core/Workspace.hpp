@@ -19,6 +19,7 @@
 #endif
 
 #include <map>
+#include <stdint.h>
 
 #ifdef __APPLE__
   #include "AppleDigest.hpp"
@@ -37,6 +38,47 @@ typedef pair<string, boost::any> entry;
 template<class T> struct PrintTraits;
 
 
+/**
+ * @brief Placement of one streamed acquisition line
+ */
+struct AcqLine {
+	std::vector<uint16_t> lc;   /**< @brief Loop counters as acquired */
+	size_t                slot; /**< @brief Offset of the line's first sample in the stream matrix */
+};
+
+
+/**
+ * @brief Incremental acquisition into a preallocated workspace matrix<br/>
+ *        Lines of dims[0] samples and dims[1] channels are placed by their
+ *        loop counters into dimensions 2.. In ring mode counters wrap and
+ *        a line's slot stays valid only until its counters wrap onto it again.
+ */
+struct AcqStream {
+	Vector<size_t> dims;    /**< @brief Matrix dimensions (COL, CHA, counters ...) */
+	size_t         lines;   /**< @brief Lines appended so far */
+	size_t         emitted; /**< @brief Lines handed to chunk processing */
+	std::vector<AcqLine> pending; /**< @brief Placement of lines [emitted, lines) */
+	size_t         chunk;   /**< @brief Lines per chunk (0: no incremental processing) */
+	bool           ring;    /**< @brief Wrap counters modulo dimensions */
+	bool           done;    /**< @brief Acquisition complete */
+	AcqStream () : lines(0), emitted(0), chunk(0), ring(false), done(false) {}
+};
+
+
+/**
+ * @brief Chunked transfer of a client's matrix into a preallocated workspace
+ *        matrix. Slabs are accepted in order only, so a broken transfer
+ *        resumes at the bytes received.
+ */
+struct MatrixTransfer {
+	std::string    dtype;    /**< @brief Element type */
+	Vector<size_t> dims;     /**< @brief Dimensions */
+	size_t         size;     /**< @brief Bytes */
+	size_t         received; /**< @brief Contiguous bytes received */
+	MatrixTransfer () : size(0), received(0) {}
+};
+
+
 /**
  * @brief Global workspace. Singleton.
  */
@@ -226,6 +268,261 @@ class DLLEXPORT Workspace {
 		return AddMatrix(name, &m);
 	}
 	
+	/**
+	 * @brief        Preallocate a matrix for line by line acquisition
+	 *
+	 * @param  name  Name
+	 * @param  dims  Dimensions (COL, CHA, loop counters ...)
+	 * @param  chunk Lines per chunk handed to ProcessChunk (0: none)
+	 * @param  ring  Wrap loop counters modulo dimensions (ring buffer)
+	 * @return       Reference to zeroed matrix
+	 */
+	template<class T> inline Matrix<T>&
+	OpenStream       (const std::string& name, const Vector<size_t>& dims,
+	                  const size_t& chunk = 0, const bool& ring = false) {
+		AcqStream as;
+		as.dims  = dims;
+		as.chunk = chunk;
+		as.ring  = ring;
+		m_streams[name] = as;
+		Matrix<T>& m = AddMatrix<T>(name);
+		m = Matrix<T>(dims);
+		m.SetClassName(name.c_str());
+		return m;
+	}
+
+
+	/**
+	 * @brief        Append one acquisition line (all channels of one ADC)
+	 *
+	 * @param  name  Stream name
+	 * @param  lc    Loop counters (e.g. MDH LIN, AVE, SLC, PAR ...)
+	 * @param  nlc   # of loop counters
+	 * @param  data  Samples, ns per channel, channels contiguous
+	 * @param  ns    # of samples per channel (<= dims[0])
+	 * @param  nc    # of channels (0: dims[1])
+	 * @param  cha   First channel
+	 * @return       Success
+	 */
+	template<class T> inline codeare::error_code
+	AppendLine       (const std::string& name, const uint16_t* lc, const size_t& nlc,
+	                  const T* data, const size_t& ns, size_t nc = 0, const size_t& cha = 0) {
+
+		std::map<std::string,AcqStream>::iterator si = m_streams.find(name);
+		if (si == m_streams.end())
+			return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+		codeare::error_code ec = Exists<T>(name);
+		if (ec != codeare::OK)
+			return ec;
+
+		AcqStream& as = si->second;
+		const Vector<size_t>& d = as.dims;
+		if (nc == 0)
+			nc = d[1];
+		if (ns > d[0] || cha + nc > d[1] || nlc + 2 > d.size())
+			return codeare::UNSUPPORTED_DIMENSION;
+
+		size_t pos = 0;
+		for (size_t i = nlc; i > 0; --i) {
+			size_t c = lc[i-1];
+			if (c >= d[i+1]) {
+				if (!as.ring)
+					return codeare::UNSUPPORTED_DIMENSION;
+				c %= d[i+1];
+			}
+			pos = pos * d[i+1] + c;
+		}
+		pos = (pos * d[1] + cha) * d[0];
+
+		T* out = &Get<T>(name)[pos];
+		if (ns == d[0])
+			std::copy (data, data + ns*nc, out);
+		else
+			for (size_t c = 0; c < nc; ++c)
+				std::copy (data + c*ns, data + (c+1)*ns, out + c*d[0]);
+		++as.lines;
+
+		AcqLine al;
+		al.lc.assign (lc, lc + nlc);
+		al.slot = pos;
+		as.pending.push_back (al);
+
+		return codeare::OK;
+
+	}
+
+
+	/**
+	 * @brief        Take next complete chunk of a stream. The remainder is
+	 *               handed out once the stream is closed.
+	 *
+	 * @param  name  Stream name
+	 * @param  first First line of chunk in acquisition order
+	 * @param  lines Loop counters and matrix offsets of the chunk's lines
+	 * @return       A chunk is ready
+	 */
+	inline bool
+	NextChunk        (const std::string& name, size_t& first, std::vector<AcqLine>& lines) {
+		std::map<std::string,AcqStream>::iterator si = m_streams.find(name);
+		if (si == m_streams.end())
+			return false;
+		AcqStream& as = si->second;
+		size_t n = as.pending.size();
+		if (n == 0 || (!as.done && (as.chunk == 0 || n < as.chunk)))
+			return false;
+		if (as.chunk && n > as.chunk)
+			n = as.chunk;
+		first = as.emitted;
+		lines.assign (as.pending.begin(), as.pending.begin() + n);
+		as.pending.erase (as.pending.begin(), as.pending.begin() + n);
+		as.emitted += n;
+		return true;
+	}
+
+
+	/**
+	 * @brief        Mark acquisition complete
+	 *
+	 * @param  name  Stream name
+	 * @return       Success
+	 */
+	inline codeare::error_code
+	CloseStream      (const std::string& name) {
+		std::map<std::string,AcqStream>::iterator si = m_streams.find(name);
+		if (si == m_streams.end())
+			return codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+		si->second.done = true;
+		return codeare::OK;
+	}
+
+
+	/**
+	 * @brief        Forget stream state. The matrix is left untouched.
+	 *
+	 * @param  name  Stream name
+	 */
+	inline void
+	EraseStream      (const std::string& name) {
+		m_streams.erase (name);
+	}
+
+
+	/**
+	 * @brief        Stream state
+	 *
+	 * @param  name  Stream name
+	 * @return       State or 0 if no such stream
+	 */
+	inline const AcqStream*
+	Stream           (const std::string& name) const {
+		std::map<std::string,AcqStream>::const_iterator si = m_streams.find(name);
+		return (si == m_streams.end()) ? 0 : &si->second;
+	}
+
+
+	/**
+	 * @brief        Preallocate a matrix for chunked transfer
+	 *
+	 * @param  name   Name
+	 * @param  dims   Dimensions
+	 * @param  res    Resolutions
+	 * @param  resume Resume a pending transfer of same name, type and dimensions
+	 * @return        Bytes already received (0 unless resumed)
+	 */
+	template<class T> inline size_t
+	OpenTransfer     (const std::string& name, const Vector<size_t>& dims,
+	                  const Vector<float>& res, const bool& resume = false) {
+
+		std::map<std::string,MatrixTransfer>::iterator ti = m_transfers.find(name);
+		if (resume && ti != m_transfers.end() && Exists<T>(name) == codeare::OK &&
+			ti->second.dtype == TypeTraits<T>::Abbrev() && ti->second.dims == dims)
+			return ti->second.received;
+
+		Matrix<T>& m = AddMatrix<T>(name);
+		m = Matrix<T>(dims, res);
+		m.SetClassName(name.c_str());
+
+		MatrixTransfer mt;
+		mt.dtype = TypeTraits<T>::Abbrev();
+		mt.dims  = dims;
+		mt.size  = m.Size() * sizeof(T);
+		if (mt.size)
+			m_transfers[name] = mt;
+		else
+			m_transfers.erase(name);
+
+		return 0;
+
+	}
+
+
+	/**
+	 * @brief        Copy a slab into a pending transfer. The matrix memory is
+	 *               looked up anew for every slab. The transfer is forgotten
+	 *               once complete.
+	 *
+	 * @param  name   Name
+	 * @param  offset Byte offset (at most bytes received so far)
+	 * @param  data   Slab
+	 * @param  len    Bytes
+	 * @return        Bytes received so far, -1: no such transfer
+	 */
+	inline long long
+	PutChunk         (const std::string& name, const size_t& offset, const void* data,
+	                  const size_t& len) {
+
+		std::map<std::string,MatrixTransfer>::iterator ti = m_transfers.find(name);
+		if (ti == m_transfers.end())
+			return -1;
+		MatrixTransfer& mt = ti->second;
+
+		// Gaps are refused, the client resumes at what we have
+		if (offset > mt.received || offset + len > mt.size)
+			return (long long) mt.received;
+
+		char* dst = Bytes (name, mt.size);
+		if (dst == 0) { // Replaced or freed meanwhile
+			m_transfers.erase(ti);
+			return -1;
+		}
+		memcpy (dst + offset, data, len);
+
+		mt.received = std::max (mt.received, offset + len);
+		const long long received = mt.received;
+		if (mt.received == mt.size)
+			m_transfers.erase(ti);
+
+		return received;
+
+	}
+
+
+	/**
+	 * @brief        Bytes received of a pending transfer
+	 *
+	 * @param  name  Name
+	 * @return       Bytes received, -1: no such transfer
+	 */
+	inline long long
+	Received         (const std::string& name) const {
+		std::map<std::string,MatrixTransfer>::const_iterator ti = m_transfers.find(name);
+		return (ti == m_transfers.end()) ? -1 : (long long) ti->second.received;
+	}
+
+
+	/**
+	 * @brief        Transfer state
+	 *
+	 * @param  name  Name
+	 * @return       State or 0 if no such pending transfer
+	 */
+	inline const MatrixTransfer*
+	Transfer         (const std::string& name) const {
+		std::map<std::string,MatrixTransfer>::const_iterator ti = m_transfers.find(name);
+		return (ti == m_transfers.end()) ? 0 : &ti->second;
+	}
+
+
 	/**
 	 * @brief        Remove a complex double matrix
 	 *
@@ -353,9 +650,44 @@ class DLLEXPORT Workspace {
 	 */
 	Workspace        (const Workspace&) {};
 
+	/**
+	 * @brief        Memory of a matrix of known byte size
+	 *
+	 * @param  name  Name
+	 * @param  size  Expected bytes
+	 * @return       Matrix memory or 0 if no such matrix of that size
+	 */
+	template<class T> inline char*
+	MatrixBytes      (const std::string& name, const size_t& size) {
+		Matrix<T>& m = Get<T>(name);
+		return (m.Size() * sizeof(T) == size) ? (char*) m.Ptr() : 0;
+	}
+
+	/**
+	 * @brief        Memory of a matrix of known byte size, any element type
+	 *
+	 * @see          MatrixBytes
+	 */
+	inline char*
+	Bytes            (const std::string& name, const size_t& size) {
+        reflist::iterator nit = m_ref.find(name);
+        if (nit == m_ref.end())
+            return 0;
+        const std::string& t = nit->second[1];
+        if      (t.compare(typeid(cxfl).name())   == 0) return MatrixBytes<cxfl>   (name, size);
+        else if (t.compare(typeid(cxdb).name())   == 0) return MatrixBytes<cxdb>   (name, size);
+        else if (t.compare(typeid(float).name())  == 0) return MatrixBytes<float>  (name, size);
+        else if (t.compare(typeid(double).name()) == 0) return MatrixBytes<double> (name, size);
+        else if (t.compare(typeid(short).name())  == 0) return MatrixBytes<short>  (name, size);
+        else if (t.compare(typeid(long).name())   == 0) return MatrixBytes<long>   (name, size);
+        return 0;
+	}
+
 #pragma warning (disable : 4251)
     reflist m_ref;   /**< @brief Names and hash tags               */
 	store   m_store; /**< @brief Data pointers                     */
+	std::map<std::string,AcqStream> m_streams; /**< @brief Acquisition streams */
+	std::map<std::string,MatrixTransfer> m_transfers; /**< @brief Pending chunked transfers */
 #pragma warning (default : 4251)
 
 	static Workspace* m_inst; /**< @brief Single database instance */
@@ -25,6 +25,7 @@
 #define NOMINMAX
 
 #include <Matrix.hpp>
+#include <Permute.hpp>
 #include <math.h>
 #include <limits>
 #include <vector>
@@ -940,9 +941,10 @@ template<class T> inline static Matrix<T> squeeze (const View<T,true>& V) {
 	for (size_t i = 0; i < vdim.size(); ++i)
 		if (vdim[i] > 1)
 			dim.push_back(vdim[i]);
+    if (dim.empty())
+        dim.push_back(1);
     Matrix<T> ret(dim);
-    for (size_t i = 0; i < numel(V); ++i)
-        ret[i] = V[i];
+    V.Pull(ret.Ptr(), codeare::view::assign());
     return ret;
 }
 
@@ -962,55 +964,10 @@ template<class T> inline static Matrix<T> squeeze (const View<T,true>& V) {
 
 template<class T> inline static Matrix<T> permute (const Matrix<T>& M, const size_t& n0,
 		const size_t& n1, const size_t& n2) {
-	Vector<size_t> odims = size(M);
-	assert (numel(odims)==3); // Must be 3d
-	Matrix<T> ret(odims[n0], odims[n1], odims[n2]);
-
-	if        (n0 == 0) {
-		if (n1 == 1) {
-			assert (n2 == 2); // 0,1,2 : nothing to do
-			return M;
-		} else {
-			assert (n2 == 1); // 0,2,1 : n1*n2 copies
-			for (size_t k = 0; k < odims[n2]; ++k)
-				for (size_t j = 0; j < odims[n1]; ++j)
-					std::copy (&M(0,k,j), &M(0,k,j)+odims[0], &ret(0,j,k));
-		}
-	} else if (n0 == 1) {
-		if (n1 == 0) {
-			assert (n2 == 2); // 1,0,2
-			for (size_t k = 0; k < odims[n2]; ++k)
-				for (size_t j = 0; j < odims[n1]; ++j)
-					for (size_t i = 0; i < odims[n0]; ++i)
-						ret(i,j,k) = M(j,i,k);
-		} else {
-			assert (n2 == 0); // 1,2,0
-			for (size_t k = 0; k < odims[n2]; ++k)
-				for (size_t j = 0; j < odims[n1]; ++j)
-					for (size_t i = 0; i < odims[n0]; ++i)
-						ret(i,j,k) = M(k,i,j);
-		}
-	} else if (n0 == 2) {
-		if (n1 == 1) {
-			assert (n2 == 0); // 2,1,0
-			for (size_t k = 0; k < odims[n2]; ++k)
-				for (size_t j = 0; j < odims[n1]; ++j)
-					for (size_t i = 0; i < odims[n0]; ++i)
-						ret(i,j,k) = M(k,j,i);
-		} else {
-			assert (n2 == 1); // 2,0,1
-			for (size_t k = 0; k < odims[n2]; ++k)
-				for (size_t j = 0; j < odims[n1]; ++j)
-					for (size_t i = 0; i < odims[n0]; ++i)
-						ret(i,j,k) = M(j,k,i);
-		}
-	} else {
-
-		assert(false);
-	}
-
-	return ret;
-
+	assert (ndims(M)<=3); // At most 3d
+	Vector<size_t> perm (3);
+	perm[0] = n0; perm[1] = n1; perm[2] = n2;
+	return permute (M, perm);
 }
 
 
@@ -1030,24 +987,10 @@ template<class T> inline static Matrix<T> permute (const Matrix<T>& M, const siz
 
 template<class T> inline static Matrix<T> permute (const Matrix<T>& M, const size_t& n0,
 		const size_t& n1) {
-	Vector<size_t> odims = size(M);
-	assert (numel(odims)==2); // Must be 3d
-	Matrix<T> ret(odims[n0], odims[n1]);
-
-	if        (n0 == 0) {// 0,1: nothing to do
-		assert (n1 == 1);
-		return M;
-	} else if (n0 == 1) {// 1,0: transpose
-		assert (n1 == 0);
-		for (size_t j = 0; j < odims[n1]; ++j)
-			for (size_t i = 0; i < odims[n0]; ++i)
-				ret(i,j) = M(j,i);
-	} else { // We should never be here
-		assert(false);
-	}
-
-	return ret;
-
+	assert (ndims(M)<=2); // At most 2d
+	Vector<size_t> perm (2);
+	perm[0] = n0; perm[1] = n1;
+	return permute (M, perm);
 }
 
 
@@ -1065,15 +1008,14 @@ template<class T> inline static Matrix<T> permute (const Matrix<T>& M, const siz
  * @param   perm    New permuted dimensions
  * @return          Permuted matrix
  */
-//#include "Print.hpp"
 template <class T> inline static Matrix<T> permute (const Matrix<T>& M, const Vector<size_t>& perm) {
 	
 	// Check that perm only includes one number between 0 and INVALID_DIM once
 	size_t ndnew = perm.size(), i = 0;
 	size_t ndold = ndims (M); 
 
-	// Must have same number of dimensions
-	assert (ndnew == ndold);
+	// Must cover all non-singleton dimensions, others are singletons
+	assert (ndnew >= ndold);
 
 	// Every number between 0 and ndnew must appear exactly once
 	Vector<cbool> occupied;
@@ -1084,50 +1026,16 @@ template <class T> inline static Matrix<T> permute (const Matrix<T>& M, const Ve
 	}			
 
 	// Old and new sizes
-	Vector<size_t> so = size (M);
-	Vector<size_t> sn (16,1);
-
+	Vector<size_t> so = size (M), sn (ndnew);
 	for (i = 0; i < ndnew; ++i)
-		sn[i] = so[perm[i]];
+		sn[i] = (perm[i] < so.size()) ? so[perm[i]] : 1;
 	
-	// Allocate new matrix with permuted dimensions
-	Matrix<T> res(sn);
-
-	// Relation of old to new indices
-    Vector<size_t>  d(16), od(16);
-	for (i = 0; i < ndnew; ++i) od[i] = perm[i];
-	for (     ; i <    16; ++i)	od[i] =      i;
-
-	// Copy data accordingly
-	for (d[15] = 0; d[15] < size(M,15); d[15]++)
-		for (d[14] = 0; d[14] < size(M,14); d[14]++)
-			for (d[13] = 0; d[13] < size(M,13); d[13]++)
-				for (d[12] = 0; d[12] < size(M,12); d[12]++)
-					for (d[11] = 0; d[11] < size(M,11); d[11]++)
-						for (d[10] = 0; d[10] < size(M,10); d[10]++)
-							for (d[ 9] = 0; d[ 9] < size(M, 9); d[ 9]++)
-								for (d[ 8] = 0; d[ 8] < size(M, 8); d[ 8]++)
-									for (d[ 7] = 0; d[ 7] < size(M, 7); d[ 7]++)
-										for (d[ 6] = 0; d[ 6] < size(M, 6); d[ 6]++)
-											for (d[ 5] = 0; d[ 5] < size(M, 5); d[ 5]++)
-												for (d[ 4] = 0; d[ 4] < size(M, 4); d[ 4]++)
-													for (d[ 3] = 0; d[ 3] < size(M, 3); d[ 3]++)
-														for (d[ 2] = 0; d[ 2] < size(M, 2); d[ 2]++)
-															for (d[ 1] = 0; d[ 1] < size(M, 1); d[ 1]++)
-																for (d[ 0] = 0; d[ 0] < size(M, 0); d[ 0]++) 
-																	res (d[od[ 0]],d[od[ 1]],d[od[ 2]],d[od[ 3]], 
-																		 d[od[ 4]],d[od[ 5]],d[od[ 6]],d[od[ 7]], 
-																		 d[od[ 8]],d[od[ 9]],d[od[10]],d[od[11]],
-																		 d[od[12]],d[od[13]],d[od[14]],d[od[15]]) =
-																	  M (d[ 0],d[ 1],d[ 2],d[ 3],d[ 4],d[ 5],
-																		 d[ 6],d[ 7],d[ 8],d[ 9],d[10],d[11],
-																		 d[12],d[13],d[14],d[15]);
-
-    // Remove trailing singelton dimensions
-    sn.erase(sn.begin()+ndnew, sn.begin()+16);
-	return resize(res, sn);
-
-																		
+	// Blocked copy into matrix with permuted dimensions
+	Matrix<T> res (sn);
+	codeare::matrix::permute (M.Ptr(), so, perm, res.Ptr());
+
+	return res;
+
 }
 
 
@@ -0,0 +1,250 @@
+/*
+ * Expression.hpp
+ *
+ *  Lazy element-wise expressions over matrices
+ */
+
+#ifndef __EXPRESSION_HPP__
+#define __EXPRESSION_HPP__
+
+#include "SIMDTraits.hpp"
+#include "TypeTraits.hpp"
+
+#include <functional>
+#include <numeric>
+
+#ifndef EXPR_PARALLEL_THRESHOLD
+#  define EXPR_PARALLEL_THRESHOLD 65536
+#endif
+
+/**
+ * Chains of element-wise operations on lazy(M) build an expression tree which
+ * is evaluated on assignment in a single vectorised, OpenMP parallel pass
+ * without temporaries, e.g.
+ *
+ *   r -= t * lazy(q);                  // one pass, no allocation
+ *   p  = lazy(r) + beta * lazy(p);     // in place update of p
+ *
+ * Plain Matrix arithmetic is unaffected and stays eager.
+ */
+namespace codeare {
+namespace expr {
+
+	/**
+	 * @brief Expression base (CRTP)
+	 */
+	template<class T, class E> struct Expression {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline const E& Derived () const { return static_cast<const E&>(*this); }
+		inline T operator[] (const size_t& i) const { return Derived()[i]; }
+		inline reg_type Packed (const size_t& i) const { return Derived().Packed(i); }
+		inline size_t Size () const { return Derived().Size(); }
+		inline const Vector<size_t>& Dim () const { return Derived().Dim(); }
+		inline bool Aligned () const { return Derived().Aligned(); }
+	};
+
+	/**
+	 * @brief Matrix leaf
+	 */
+	template<class T> struct Terminal : public Expression<T, Terminal<T> > {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline Terminal (const T* p, const size_t& n, const Vector<size_t>& dim) :
+			_p(p), _n(n), _dim(dim) {}
+		inline T operator[] (const size_t& i) const { return _p[i]; }
+		inline reg_type Packed (const size_t& i) const { return ((const reg_type*)_p)[i]; }
+		inline size_t Size () const { return _n; }
+		inline const Vector<size_t>& Dim () const { return _dim; }
+		inline bool Aligned () const { return ((size_t)_p) % sizeof(reg_type) == 0; }
+		const T* _p;
+		size_t _n;
+		const Vector<size_t>& _dim;
+	};
+
+	/**
+	 * @brief Scalar leaf (broadcast)
+	 */
+	template<class T> struct Constant : public Expression<T, Constant<T> > {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline Constant (const T& s) : _s(s) {
+			Vector<T> b (VecTraits<T>::stride, s);
+			_v = *(const reg_type*)&b[0];
+		}
+		inline T operator[] (const size_t&) const { return _s; }
+		inline reg_type Packed (const size_t&) const { return _v; }
+		inline size_t Size () const { return 0; }
+		inline const Vector<size_t>& Dim () const { static const Vector<size_t> d; return d; }
+		inline bool Aligned () const { return true; }
+		T _s;
+		reg_type _v;
+	};
+
+	/**
+	 * @brief Binary node with codeare functor (plus, minus, multiplies, divides)
+	 */
+	template<class T, class L, class R, class Op>
+	struct Binary : public Expression<T, Binary<T,L,R,Op> > {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline Binary (const L& l, const R& r) : _l(l), _r(r) {
+			MATRIX_ASSERT (!_l.Size() || !_r.Size() || _l.Dim() == _r.Dim(),
+				DIMENSIONS_MUST_MATCH);
+		}
+		inline T operator[] (const size_t& i) const { return _op(_l[i], _r[i]); }
+		inline reg_type Packed (const size_t& i) const { return Op::packed(_l.Packed(i), _r.Packed(i)); }
+		inline size_t Size () const { return _l.Size() ? _l.Size() : _r.Size(); }
+		inline const Vector<size_t>& Dim () const { return _l.Size() ? _l.Dim() : _r.Dim(); }
+		inline bool Aligned () const { return _l.Aligned() && _r.Aligned(); }
+		const L _l;
+		const R _r;
+		Op _op;
+	};
+
+	/**
+	 * @brief Real scaling of real or complex expression (no complex multiply)
+	 */
+	template<class T, class E> struct Scale : public Expression<T, Scale<T,E> > {
+		typedef typename TypeTraits<T>::RT RT;
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline Scale (const RT& a, const E& e) : _a(a), _e(e), _v(VecTraits<RT>::setp(a)) {}
+		inline T operator[] (const size_t& i) const { return _a * _e[i]; }
+		inline reg_type Packed (const size_t& i) const {
+			return VecTraits<RT>::multiplies (_v, _e.Packed(i));
+		}
+		inline size_t Size () const { return _e.Size(); }
+		inline const Vector<size_t>& Dim () const { return _e.Dim(); }
+		inline bool Aligned () const { return _e.Aligned(); }
+		RT _a;
+		const E _e;
+		reg_type _v;
+	};
+
+	/**
+	 * @brief Assignment functor: a = b
+	 */
+	template<class T> struct assign {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		inline static reg_type packed (const reg_type&, const reg_type& b) { return b; }
+		inline T operator() (const T&, const T& b) const { return b; }
+	};
+
+	/**
+	 * @brief Non-deduced scalar parameters
+	 */
+	template<class T> struct Identity { typedef T type; };
+	template<class T> struct RealScalar { struct none {}; typedef none type; };
+	template<class T> struct RealScalar<std::complex<T> > { typedef T type; };
+
+	/**
+	 * @brief  Evaluate out[i] = op (out[i], e[i]) in one pass. Packed if
+	 *         output and all leaves are register aligned, element-wise
+	 *         otherwise (e.g. slabs at odd offsets).
+	 *
+	 * @param  out  Output (Size() elements)
+	 * @param  x    Expression
+	 * @param  op   Functor with packed and scalar application
+	 */
+	template<class T, class E, class Op>
+	inline void Evaluate (T* out, const Expression<T,E>& x, const Op& op) {
+		typedef typename VecTraits<T>::reg_type reg_type;
+		const E& e = x.Derived();
+		const size_t n = e.Size(), stride = VecTraits<T>::stride;
+		const long np = (((size_t)out) % sizeof(reg_type) == 0 && e.Aligned()) ? (long)(n/stride) : 0;
+		reg_type* vo = (reg_type*) out;
+#pragma omp parallel for schedule (static) if (n >= EXPR_PARALLEL_THRESHOLD)
+		for (long i = 0; i < np; ++i)
+			vo[i] = op.packed (vo[i], e.Packed(i));
+#pragma omp parallel for schedule (static) if (n - np*stride >= EXPR_PARALLEL_THRESHOLD)
+		for (long i = np*stride; i < (long)n; ++i)
+			out[i] = op (out[i], e[i]);
+	}
+
+	// Expression op Expression
+	template<class T, class L, class R> inline Binary<T,L,R,plus<T> >
+	operator+ (const Expression<T,L>& l, const Expression<T,R>& r) {
+		return Binary<T,L,R,plus<T> > (l.Derived(), r.Derived());
+	}
+	template<class T, class L, class R> inline Binary<T,L,R,minus<T> >
+	operator- (const Expression<T,L>& l, const Expression<T,R>& r) {
+		return Binary<T,L,R,minus<T> > (l.Derived(), r.Derived());
+	}
+	template<class T, class L, class R> inline Binary<T,L,R,multiplies<T> >
+	operator* (const Expression<T,L>& l, const Expression<T,R>& r) {
+		return Binary<T,L,R,multiplies<T> > (l.Derived(), r.Derived());
+	}
+	template<class T, class L, class R> inline Binary<T,L,R,divides<T> >
+	operator/ (const Expression<T,L>& l, const Expression<T,R>& r) {
+		return Binary<T,L,R,divides<T> > (l.Derived(), r.Derived());
+	}
+
+	// Expression op scalar / scalar op expression
+	template<class T, class E> inline Binary<T,E,Constant<T>,plus<T> >
+	operator+ (const Expression<T,E>& e, const typename Identity<T>::type& s) {
+		return Binary<T,E,Constant<T>,plus<T> > (e.Derived(), Constant<T>(s));
+	}
+	template<class T, class E> inline Binary<T,Constant<T>,E,plus<T> >
+	operator+ (const typename Identity<T>::type& s, const Expression<T,E>& e) {
+		return Binary<T,Constant<T>,E,plus<T> > (Constant<T>(s), e.Derived());
+	}
+	template<class T, class E> inline Binary<T,E,Constant<T>,minus<T> >
+	operator- (const Expression<T,E>& e, const typename Identity<T>::type& s) {
+		return Binary<T,E,Constant<T>,minus<T> > (e.Derived(), Constant<T>(s));
+	}
+	template<class T, class E> inline Binary<T,Constant<T>,E,minus<T> >
+	operator- (const typename Identity<T>::type& s, const Expression<T,E>& e) {
+		return Binary<T,Constant<T>,E,minus<T> > (Constant<T>(s), e.Derived());
+	}
+	template<class T, class E> inline Binary<T,E,Constant<T>,multiplies<T> >
+	operator* (const Expression<T,E>& e, const typename Identity<T>::type& s) {
+		return Binary<T,E,Constant<T>,multiplies<T> > (e.Derived(), Constant<T>(s));
+	}
+	template<class T, class E> inline Binary<T,Constant<T>,E,multiplies<T> >
+	operator* (const typename Identity<T>::type& s, const Expression<T,E>& e) {
+		return Binary<T,Constant<T>,E,multiplies<T> > (Constant<T>(s), e.Derived());
+	}
+	template<class T, class E> inline Binary<T,E,Constant<T>,divides<T> >
+	operator/ (const Expression<T,E>& e, const typename Identity<T>::type& s) {
+		return Binary<T,E,Constant<T>,divides<T> > (e.Derived(), Constant<T>(s));
+	}
+
+	// Complex expression scaled by real scalar
+	template<class T, class E> inline Scale<T,E>
+	operator* (const Expression<T,E>& e, const typename RealScalar<T>::type& a) {
+		return Scale<T,E> (a, e.Derived());
+	}
+	template<class T, class E> inline Scale<T,E>
+	operator* (const typename RealScalar<T>::type& a, const Expression<T,E>& e) {
+		return Scale<T,E> (a, e.Derived());
+	}
+	template<class T, class E> inline Scale<T,E>
+	operator/ (const Expression<T,E>& e, const typename RealScalar<T>::type& a) {
+		return Scale<T,E> (1./a, e.Derived());
+	}
+
+}}
+
+/**
+ * @brief       Lazy leaf of a matrix for fused element-wise expressions
+ *
+ * @param  M    Matrix
+ * @return      Expression leaf referring to M's data
+ */
+template<class T, paradigm P> inline codeare::expr::Terminal<T>
+lazy (const Matrix<T,P>& M) {
+	return codeare::expr::Terminal<T> (M.Ptr(), M.Size(), M.Dim());
+}
+
+/**
+ * @brief       Lazy leaf of a contiguous slab of a matrix, e.g. one channel
+ *
+ * @param  M    Matrix
+ * @param  off  First element of the slab
+ * @param  dim  Slab dimensions (must outlive the expression)
+ * @return      Expression leaf referring to the slab
+ */
+template<class T, paradigm P> inline codeare::expr::Terminal<T>
+lazy (const Matrix<T,P>& M, const size_t& off, const Vector<size_t>& dim) {
+	const size_t n = std::accumulate (dim.begin(), dim.end(), (size_t)1, std::multiplies<size_t>());
+	MATRIX_ASSERT (off + n <= M.Size(), DIMENSIONS_MUST_MATCH);
+	return codeare::expr::Terminal<T> (M.Ptr() + off, n, dim);
+}
+
+#endif /* __EXPRESSION_HPP__ */
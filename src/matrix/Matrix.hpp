@@ -155,6 +155,8 @@ inline static void report_and_throw (const char* fname, const size_t& lnumber,
 #    include "SIMD.hpp"
 #endif
 
+#include "Expression.hpp"
+
 /**
  * @brief   Matrix template.<br/>
  *          Core data structure
@@ -384,12 +386,26 @@ public:
         MATRIX_ASSERT(!_dim.empty(),DIMS_VECTOR_EMPTY);
         MATRIX_ASSERT(std::find(_dim.begin(),_dim.end(),size_t(0))==_dim.end(),
         		DIMS_VECTOR_CONTAINS_ZEROS);
+        _res.resize(_dim.size(),1.0);
         Allocate();
-        for (size_t i = 0; i < Size(); ++i)
-            _M[0] = *(v._pointers[i]);
+        v.Pull (_M.ptr(), codeare::view::assign());
     }
 #endif
 
+    /**
+     * @brief           Construct from lazy element-wise expression (single pass)
+     *
+     * @param  e        Expression
+     */
+    template<class E>
+    inline Matrix (const codeare::expr::Expression<T,E>& e) {
+		_dim = e.Dim();
+        MATRIX_ASSERT(!_dim.empty(),DIMS_VECTOR_EMPTY);
+        _res.resize(_dim.size(),1.0);
+        Allocate();
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::expr::assign<T>());
+    }
+
     //@}
 
 
@@ -1153,6 +1169,21 @@ public:
     }
 
 
+    /**
+     * @brief           Reshape in place to sizes of no more elements<br/>
+     *                  Leading elements are kept, storage is released
+     *
+     * @param  sz       New dimensions
+     */
+    inline void Reshape (const Vector<size_t>& sz) {
+        MATRIX_ASSERT(!sz.empty(), DIMS_VECTOR_EMPTY);
+        _dim = sz;
+        _res.resize(_dim.size(),1.0);
+        Allocate();
+        _M.shrink_to_fit();
+    }
+
+
 
     /**
      * @brief           Number of dimensions
@@ -1287,14 +1318,34 @@ public:
 #ifdef HAVE_CXX11_CONDITIONAL
     template<class S>
     inline Matrix<T,P>& operator= (const View<S,true>& v) {
+        if (v.Aliases(this)) { // e.g. A = A(CR(),CR(0,n-1))
+            Matrix<T,P> tmp (v._dim);
+            v.Pull (tmp._M.ptr(), codeare::view::assign());
+            return *this = tmp;
+        }
         _dim = v._dim;
         Allocate();
-        for (size_t i = 0; i < Size(); ++i)
-            _M[i] = v[i];
+        v.Pull (_M.ptr(), codeare::view::assign());
         return *this;
     }
 #endif
 
+    /**
+     * @brief           Assign lazy element-wise expression (single pass)
+     *
+     * @param  e        Expression
+     */
+    template<class E>
+    inline Matrix<T,P>& operator= (const codeare::expr::Expression<T,E>& e) {
+        if (_M.size() != e.Size()) // e may refer to our data
+            return *this = Matrix<T,P>(e);
+        _dim = e.Dim();
+        _res.resize(_dim.size(),1.0);
+        Allocate();
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::expr::assign<T>());
+        return *this;
+    }
+
 
     /**
      * @brief           Assignment operator. Sets all elements s.
@@ -1592,7 +1643,19 @@ public:
     }
     inline Matrix<T,P>& operator+= (const Matrix<T,P>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        Vec(_M, M._M, _M, codeare::plus<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(M), codeare::plus<T>());
+        return *this;
+    }
+
+    /**
+     * @brief           Elementwise addition and assignment with lazy expression
+     * @param  e        Expression
+     * @return          Result
+     */
+    template <class E>
+    inline Matrix<T,P>& operator+= (const codeare::expr::Expression<T,E>& e) {
+        MATRIX_ASSERT (_dim==e.Dim(), DIMENSIONS_MUST_MATCH);
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::plus<T>());
         return *this;
     }
 
@@ -1605,8 +1668,9 @@ public:
     template <class S>
     inline Matrix<T,P>& operator+= (const View<S,true>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        for (size_t i = 0; i < Size(); ++i)
-            _M[i] += M[i];
+        if (M.Aliases(this))
+            return *this += Matrix<S>(M);
+        M.Pull (_M.ptr(), codeare::view::plus());
         return *this;
     }
 
@@ -1616,7 +1680,7 @@ public:
      * @return          Result
      */
     inline Matrix<T,P>& operator+= (const T& t) {
-        Vec(_M, t, _M, codeare::plus<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(*this) + t, codeare::expr::assign<T>());
 		return *this;
     }
 
@@ -1646,7 +1710,19 @@ public:
     }
     inline Matrix<T,P>& operator-= (const Matrix<T,P>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        Vec(_M, M._M, _M, codeare::minus<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(M), codeare::minus<T>());
+        return *this;
+    }
+
+    /**
+     * @brief           Elementwise subtraction and assignment with lazy expression
+     * @param  e        Expression
+     * @return          Result
+     */
+    template <class E>
+    inline Matrix<T,P>& operator-= (const codeare::expr::Expression<T,E>& e) {
+        MATRIX_ASSERT (_dim==e.Dim(), DIMENSIONS_MUST_MATCH);
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::minus<T>());
         return *this;
     }
 
@@ -1659,8 +1735,9 @@ public:
     template <class S>
     inline Matrix<T,P>& operator-= (const View<S,true>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        for (size_t i = 0; i < Size(); ++i)
-            _M[i] -= M[i];
+        if (M.Aliases(this))
+            return *this -= Matrix<S>(M);
+        M.Pull (_M.ptr(), codeare::view::minus());
         return *this;
     }
 
@@ -1670,7 +1747,7 @@ public:
      * @return          Result
      */
     inline Matrix<T,P>& operator-= (const T& t) {
-        Vec(_M, t, _M, codeare::minus<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(*this) - t, codeare::expr::assign<T>());
 		return *this;
     }
 
@@ -1699,7 +1776,19 @@ public:
     }
     inline Matrix<T,P>& operator*= (const Matrix<T,P>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        Vec(_M, M._M, _M, codeare::multiplies<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(M), codeare::multiplies<T>());
+        return *this;
+    }
+
+    /**
+     * @brief           Elementwise multiplication and assignment with lazy expression
+     * @param  e        Expression
+     * @return          Result
+     */
+    template <class E>
+    inline Matrix<T,P>& operator*= (const codeare::expr::Expression<T,E>& e) {
+        MATRIX_ASSERT (_dim==e.Dim(), DIMENSIONS_MUST_MATCH);
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::multiplies<T>());
         return *this;
     }
 
@@ -1713,8 +1802,9 @@ public:
     template <class S>
     inline Matrix<T,P>& operator*= (const View<S,true>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        for (size_t i = 0; i < Size(); ++i)
-            _M[i] *= M[i];
+        if (M.Aliases(this))
+            return *this *= Matrix<S>(M);
+        M.Pull (_M.ptr(), codeare::view::multiplies());
         return *this;
     }
 
@@ -1724,7 +1814,7 @@ public:
      * @return          Result
      */
     inline Matrix<T,P>& operator*= (const T& t) {
-        Vec(_M, t, _M, codeare::multiplies<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(*this) * t, codeare::expr::assign<T>());
 		return *this;
     }
 
@@ -1753,7 +1843,19 @@ public:
     }
     inline Matrix<T,P>& operator/= (const Matrix<T,P>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        Vec(_M, M._M, _M, codeare::divides<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(M), codeare::divides<T>());
+        return *this;
+    }
+
+    /**
+     * @brief           Elementwise division and assignment with lazy expression
+     * @param  e        Expression
+     * @return          Result
+     */
+    template <class E>
+    inline Matrix<T,P>& operator/= (const codeare::expr::Expression<T,E>& e) {
+        MATRIX_ASSERT (_dim==e.Dim(), DIMENSIONS_MUST_MATCH);
+        codeare::expr::Evaluate (_M.ptr(), e, codeare::divides<T>());
         return *this;
     }
 
@@ -1766,8 +1868,9 @@ public:
     template <class S>
     inline Matrix<T,P>& operator/= (const View<S,true>& M) {
         MATRIX_ASSERT (_dim==M.Dim(), DIMENSIONS_MUST_MATCH);
-        for (size_t i = 0; i < Size(); ++i)
-            _M[i] /= M[i];
+        if (M.Aliases(this))
+            return *this /= Matrix<S>(M);
+        M.Pull (_M.ptr(), codeare::view::divides());
         return *this;
     }
 
@@ -1777,7 +1880,7 @@ public:
      * @return          Result
      */
     inline Matrix<T,P>& operator/= (const T& t) NOEXCEPT {
-        Vec(_M, t, _M, codeare::divides<T>());
+        codeare::expr::Evaluate (_M.ptr(), lazy(*this) / t, codeare::expr::assign<T>());
 		return *this;
     }
 
@@ -27,5 +27,10 @@ inline int  omp_get_thread_num () { return 0;}
 inline int  omp_get_num_threads () { return 1;}
 inline void omp_set_num_threads (const int) {}
 inline void omp_set_dynamic(const bool) {}
+#include <chrono>
+inline double omp_get_wtime () { // Wall time like OpenMP's, clock() would be CPU time
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 #endif
 #endif
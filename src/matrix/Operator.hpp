@@ -19,9 +19,35 @@ public:
 	virtual Matrix<T> operator* (const MatrixType<T>&) const { return Matrix<T>(); }
 	virtual Matrix<T> operator->* (const Matrix<T>&) const { return Matrix<T>(); }
 	virtual Matrix<T> operator/ (const MatrixType<T>&) const { return Matrix<T>(); }
+	/**
+	 * @brief Normal operator A^H A x (default: adjoint of forward)
+	 */
+	virtual Matrix<T> Normal (const MatrixType<T>& x) const { return *this / (*this * x); }
     virtual RT obj ( const Matrix<T>& x, const Matrix<T>& dx, const RT& t, RT& rmse) const {return 0.;}
+	/**
+	 * @brief Objective at step sizes t_i along dx (default: one obj each)
+	 */
+	virtual Vector<RT> obj (const Matrix<T>& x, const Matrix<T>& dx, const Vector<RT>& t,
+			Vector<RT>& rmse) const {
+		Vector<RT> f (t.size());
+		rmse.resize(t.size());
+		for (size_t i = 0; i < t.size(); ++i)
+			f[i] = obj (x, dx, t[i], rmse[i]);
+		return f;
+	}
     virtual Matrix<T> df (const Matrix<T>& x) {return Matrix<T>();}
     virtual void Update (const Matrix<T>& dx) {}
+	/**
+	 * @brief Splitting of the objective for proximal solvers:
+	 *        ||E x - b||^2 + sum_i w_i ||S_i x||_1
+	 */
+	virtual Matrix<T> NormalData (const Matrix<T>& /*x*/) const { return Matrix<T>(); } /**< E^H E x */
+	virtual Matrix<T> AdjointData () const { return Matrix<T>(); }                  /**< E^H b */
+	virtual size_t Terms () const { return 0; }                                       /**< # of L1 terms */
+	virtual RT TermWeight (const size_t& /*i*/) const { return 0.; }                  /**< w_i */
+	virtual RT TermNorm (const size_t& /*i*/) const { return 1.; }                    /**< Bound on ||S_i||^2 */
+	virtual Matrix<T> Sparse (const size_t& /*i*/, const Matrix<T>& x) const { return x; } /**< S_i x */
+	virtual Matrix<T> SparseAdjoint (const size_t& /*i*/, const Matrix<T>& y) const { return y; } /**< S_i^H y */
     virtual std::ostream& Print (std::ostream& os) const {
     	os << "  " << demangle(typeid(*this).name()).c_str() <<  std::endl;
 		return os;
@@ -0,0 +1,202 @@
+/*
+ * Permute.hpp
+ *
+ *  Cache blocked N-dimensional permutation and in-place axis rotation
+ */
+
+#ifndef __PERMUTE_HPP__
+#define __PERMUTE_HPP__
+
+#include "Vector.hpp"
+#include "OMP.hpp"
+#include "Expression.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Permutations are reduced to their essential structure first: singleton
+ * dimensions are dropped and output dimensions which are also adjacent in the
+ * input are merged. What is left is either a copy of contiguous runs or a
+ * transposition of the input's contiguous dimension with the output's, which
+ * is tiled and performed by register sized micro-transposes. Outer
+ * dimensions and tiles are distributed over OpenMP threads.
+ */
+namespace codeare {
+namespace matrix {
+
+	/**
+	 * @brief   Tile side (elements) of blocked transposes
+	 */
+	const static size_t PERMUTE_TILE = 64;
+
+
+	/**
+	 * @brief   K x K transpose: o[c*os + r] = i[r*is + c]
+	 */
+	template<class T, size_t K> inline static void
+	micro_transpose (const T* i, const size_t& is, T* o, const size_t& os) {
+		T t[K][K];
+		for (size_t r = 0; r < K; ++r)
+			for (size_t c = 0; c < K; ++c)
+				t[c][r] = i[r*is + c];
+		for (size_t c = 0; c < K; ++c)
+			for (size_t r = 0; r < K; ++r)
+				o[c*os + r] = t[c][r];
+	}
+
+
+	/**
+	 * @brief   na x nb transpose of a tile: o[b*os + a] = i[a*is + b]
+	 */
+	template<class T> inline static void
+	tile_transpose (const T* i, const size_t& is, T* o, const size_t& os,
+	                const size_t& na, const size_t& nb) {
+		const size_t K = (sizeof(T) <= 8) ? 8 : 4, ka = na - na % K, kb = nb - nb % K;
+		for (size_t b = 0; b < kb; b += K)
+			for (size_t a = 0; a < ka; a += K)
+				if (K == 8)
+					micro_transpose<T,8> (i + a*is + b, is, o + b*os + a, os);
+				else
+					micro_transpose<T,4> (i + a*is + b, is, o + b*os + a, os);
+		for (size_t b = 0; b < nb; ++b) // edges
+			for (size_t a = (b < kb) ? ka : 0; a < na; ++a)
+				o[b*os + a] = i[a*is + b];
+	}
+
+
+	/**
+	 * @brief   Offsets of multi-index q over dims (len) in input and output
+	 */
+	inline static void
+	offsets (size_t q, const Vector<size_t>& len, const Vector<size_t>& ist,
+	         const Vector<size_t>& ost, size_t& io, size_t& oo) {
+		io = 0; oo = 0;
+		for (size_t d = 0; d < len.size(); ++d) {
+			const size_t x = q % len[d];
+			q  /= len[d];
+			io += x * ist[d];
+			oo += x * ost[d];
+		}
+	}
+
+
+	/**
+	 * @brief   Permute dimensions: out(i_0,...) = in(i_perm[0],...)
+	 *
+	 * @param   in    Input data
+	 * @param   so    Input dimensions
+	 * @param   perm  Permutation (output dimension d is input dimension perm[d]).
+	 *                Input dimensions beyond perm stay in place, perm entries
+	 *                beyond so are singletons.
+	 * @param   out   Output data (numel(so))
+	 */
+	template<class T> inline static void
+	permute (const T* in, const Vector<size_t>& so, const Vector<size_t>& perm, T* out) {
+
+		const size_t nd = so.size(), np = std::max (nd, perm.size());
+		Vector<size_t> st (nd);
+		size_t n = 1;
+		for (size_t d = 0; d < nd; ++d) {
+			st[d] = n;
+			n    *= so[d];
+		}
+
+		// Output dims with input and output strides, singletons dropped, adjacent merged
+		Vector<size_t> len, ist, ost;
+		size_t os = 1;
+		for (size_t d = 0; d < np; ++d) {
+			const size_t p = (d < perm.size()) ? perm[d] : d;
+			if (p >= nd || so[p] == 1)
+				continue;
+			const size_t l = so[p], s = st[p];
+			if (!len.empty() && ist.back() * len.back() == s)
+				len.back() *= l;
+			else {
+				len.push_back (l);
+				ist.push_back (s);
+				ost.push_back (os);
+			}
+			os *= l;
+		}
+
+		const bool par = (n >= EXPR_PARALLEL_THRESHOLD);
+
+		if (len.size() <= 1) { // Identity
+			std::copy (in, in + n, out);
+			return;
+		}
+
+		if (ist[0] == 1) { // Contiguous runs of len[0]
+			const size_t run = len[0];
+			Vector<size_t> rl, ri, ro;
+			for (size_t d = 1; d < len.size(); ++d) {
+				rl.push_back (len[d]);
+				ri.push_back (ist[d]);
+				ro.push_back (ost[d]);
+			}
+			const long nr = (long) (n / run);
+#pragma omp parallel for schedule (static) if (par)
+			for (long q = 0; q < nr; ++q) {
+				size_t io, oo;
+				offsets (q, rl, ri, ro, io, oo);
+				std::copy (in + io, in + io + run, out + oo);
+			}
+			return;
+		}
+
+		// Transpose output dim 0 (a) with the input's contiguous dim (b)
+		size_t j = 1;
+		while (ist[j] != 1)
+			++j;
+		const size_t na = len[0], nb = len[j], ia = ist[0], ob = ost[j];
+		const size_t ta = (na + PERMUTE_TILE - 1) / PERMUTE_TILE, tb = (nb + PERMUTE_TILE - 1) / PERMUTE_TILE;
+		Vector<size_t> rl, ri, ro;
+		for (size_t d = 1; d < len.size(); ++d)
+			if (d != j) {
+				rl.push_back (len[d]);
+				ri.push_back (ist[d]);
+				ro.push_back (ost[d]);
+			}
+		const long nt = (long) (n / (na*nb) * ta * tb);
+
+#pragma omp parallel for schedule (static) if (par)
+		for (long t = 0; t < nt; ++t) {
+			const size_t a0 = (t % ta) * PERMUTE_TILE, b0 = ((t / ta) % tb) * PERMUTE_TILE;
+			size_t io, oo;
+			offsets (t / (ta*tb), rl, ri, ro, io, oo);
+			tile_transpose (in + io + a0*ia + b0, ia, out + oo + b0*ob + a0, ob,
+			                std::min (PERMUTE_TILE, na - a0), std::min (PERMUTE_TILE, nb - b0));
+		}
+
+	}
+
+
+	/**
+	 * @brief   Rotate in place along dimension dim by k: x(i) <- x(i+k mod n)<br/>
+	 *          Along dim, data of the dimensions below form contiguous chunks,
+	 *          so the rotation is one std::rotate of each outer slab.
+	 *
+	 * @param   x     Data
+	 * @param   dims  Dimensions
+	 * @param   dim   Dimension
+	 * @param   k     Shift (0 <= k < dims[dim])
+	 */
+	template<class T> inline static void
+	rotate (T* x, const Vector<size_t>& dims, const size_t& dim, const size_t& k) {
+		size_t inner = 1, outer = 1;
+		for (size_t d = 0; d < dim; ++d)
+			inner *= dims[d];
+		for (size_t d = dim+1; d < dims.size(); ++d)
+			outer *= dims[d];
+		const size_t slab = inner * dims[dim];
+		if (k == 0 || k >= dims[dim])
+			return;
+#pragma omp parallel for schedule (static) if (slab*outer >= EXPR_PARALLEL_THRESHOLD && outer > 1)
+		for (long o = 0; o < (long)outer; ++o)
+			std::rotate (x + o*slab, x + o*slab + k*inner, x + (o+1)*slab);
+	}
+
+}}
+
+#endif // __PERMUTE_HPP__
@@ -31,10 +31,13 @@ template<> struct VecTraits<float> {
     typedef __m256 reg_type;
     static const int stride = 8;
     inline static reg_type setp (const float& s) { return _mm256_set1_ps(s); }
+    inline static reg_type loadu (const float* p) { return _mm256_loadu_ps(p); }
+    inline static void storeu (float* p, const reg_type& a) { _mm256_storeu_ps(p, a); }
     inline static reg_type plus (const reg_type& a, const reg_type& b) {return _mm256_add_ps(a, b);}
     inline static reg_type minus (const reg_type& a, const reg_type& b) {return _mm256_sub_ps(a, b);}
     inline static reg_type multiplies (const reg_type& a, const reg_type& b) {return _mm256_mul_ps(a, b);}
     inline static reg_type divides (const reg_type& a, const reg_type& b) {return _mm256_div_ps(a, b);}
+    inline static reg_type sqrt (const reg_type& a) {return _mm256_sqrt_ps(a);}
     inline static reg_type conjugate (const reg_type& a) { return a; }
 };
 
@@ -42,10 +45,13 @@ template<> struct VecTraits<double> {
     typedef __m256d reg_type;
     static const int stride = 4;
     inline static reg_type setp (const double& s) { return _mm256_set1_pd(s); }
+    inline static reg_type loadu (const double* p) { return _mm256_loadu_pd(p); }
+    inline static void storeu (double* p, const reg_type& a) { _mm256_storeu_pd(p, a); }
     inline static reg_type plus (const reg_type& a, const reg_type& b) {return _mm256_add_pd(a, b);}
     inline static reg_type minus (const reg_type& a, const reg_type& b) {return _mm256_sub_pd(a, b);}
     inline static reg_type multiplies (const reg_type& a, const reg_type& b) {return _mm256_mul_pd(a, b);}
     inline static reg_type divides (const reg_type& a, const reg_type& b) {return _mm256_div_pd(a, b);}
+    inline static reg_type sqrt (const reg_type& a) {return _mm256_sqrt_pd(a);}
     inline static reg_type conjugate (const reg_type& a) { return a; }
 };
 
@@ -179,10 +185,14 @@ template <int i0, int i1> static inline __m128d change_sign(__m128d const & a) {
 template<> struct VecTraits<float> {
     typedef __m128 reg_type;
     static const int stride = 4;
+    inline static reg_type setp (const float& s) { return _mm_set1_ps(s); }
+    inline static reg_type loadu (const float* p) { return _mm_loadu_ps(p); }
+    inline static void storeu (float* p, const reg_type& a) { _mm_storeu_ps(p, a); }
     inline static reg_type plus (const reg_type& a, const reg_type& b) {return _mm_add_ps(a, b);}
     inline static reg_type minus (const reg_type& a, const reg_type& b) {return _mm_sub_ps(a, b);}
     inline static reg_type multiplies (const reg_type& a, const reg_type& b) {return _mm_mul_ps(a, b);}
     inline static reg_type divides (const reg_type& a, const reg_type& b) {return _mm_div_ps(a, b);}
+    inline static reg_type sqrt (const reg_type& a) {return _mm_sqrt_ps(a);}
     inline static reg_type conjugate (const reg_type& a) { return a; }
 
 };
@@ -190,10 +200,14 @@ template<> struct VecTraits<float> {
 template<> struct VecTraits<double> {
     typedef __m128d reg_type;
     static const int stride = 2;
+    inline static reg_type setp (const double& s) { return _mm_set1_pd(s); }
+    inline static reg_type loadu (const double* p) { return _mm_loadu_pd(p); }
+    inline static void storeu (double* p, const reg_type& a) { _mm_storeu_pd(p, a); }
     inline static reg_type plus (const reg_type& a, const reg_type& b) {return _mm_add_pd(a, b);}
     inline static reg_type minus (const reg_type& a, const reg_type& b) {return _mm_sub_pd(a, b);}
     inline static reg_type multiplies (const reg_type& a, const reg_type& b) {return _mm_mul_pd(a, b);}
     inline static reg_type divides (const reg_type& a, const reg_type& b) {return _mm_div_pd(a, b);}
+    inline static reg_type sqrt (const reg_type& a) {return _mm_sqrt_pd(a);}
     inline static reg_type conjugate (const reg_type& a) { return a; }
 };
 template<> struct VecTraits<cxfl> {
@@ -250,7 +264,7 @@ template<> struct VecTraits<cxfl> {
 };
 template<> struct VecTraits<cxdb> {
     typedef __m128d reg_type;
-    static const int stride = 2;
+    static const int stride = 1;
     inline static reg_type plus (const reg_type& a, const reg_type& b) {return _mm_add_pd(a, b);}
     inline static reg_type minus (const reg_type& a, const reg_type& b) {return _mm_sub_pd(a, b);}
     inline static reg_type multiplies (reg_type const & a, reg_type const & b) {
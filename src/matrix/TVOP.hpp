@@ -23,197 +23,53 @@
 
 #include "Matrix.hpp"
 #include "Operator.hpp"
+#include "SIMDTraits.hpp"
+#include "ExecutionContext.hpp"
 
-
-template<class T, bool b0, bool b1> struct TV2D {};
-template<class T> struct TV2D<T,1,1> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-
-        size_t M = A.Dim(0), N = A.Dim(1);
-        Matrix<T> res (M, N, 2);
-                for (size_t n = 0; n < N; ++n)
-            for (size_t m = 0; m < M-1; ++m)
-                res(m,n,0) = A(m+1,n) - A(m,n);
-                for (size_t n = 0; n < N-1; ++n)
-            for (size_t m = 0; m < M; ++m)
-                res(m,n,1) = A(m,n+1) - A(m,n);
-                return res;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        size_t M = A.Dim(0), N = A.Dim(1);
-        Matrix<T> res = Matrix<T>(M,N);
-        for (size_t m = 0; m < M; ++m)
-            for (size_t n = 1; n < N-1; ++n)
-                res (n,m) = A(n-1,m,0) - A(n,m,0);
-        for (size_t m = 1; m < M-1; ++m)
-            for (size_t n = 0; n < N; ++n)
-                res (n,m) += A(n,m-1,1) - A(n,m,1);
-        return res;
-    }
-};
-
-template<class T, bool b0, bool b1, bool b2> struct TV3D {};
-template<class T> struct TV3D<T,1,1,1> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-        size_t M = A.Dim(0), N = A.Dim(1), L = A.Dim(2);
-        Matrix<T> res = Matrix<T>(M, N, L, 3);
-        for (size_t l = 0; l < L; ++l)
-            for (size_t n = 0; n < N; ++n)
-                for (size_t m = 0; m < M-1; ++m)
-                    res(m,n,l,0) = A(m+1,n,l) - A(m,n,l);
-        for (size_t l = 0; l < L; ++l)
-            for (size_t n = 0; n < N-1; ++n)
-                for (size_t m = 0; m < M; ++m)
-                    res(m,n,l,1) = A(m,n+1,l) - A(m,n,l);
-        for (size_t l = 0; l < L-1; ++l)
-            for (size_t n = 0; n < N; ++n)
-                for (size_t m = 0; m < M; ++m)
-                    res(m,n,l,1) = A(m,n,l+1) - A(m,n,l);
-        return res;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        size_t M = A.Dim(0), N = A.Dim(1), L = A.Dim(2);
-        Matrix<T> res = Matrix<T>(M,N,L);
-        for (size_t l = 0; l < L; ++l)
-            for (size_t m = 0; m < M; ++m)
-                for (size_t n = 1; n < N-1; ++n)
-                    res (n,m,l) = A(n-1,m,l,0) - A(n,m,l,0);
-        for (size_t l = 0; l < L; ++l)
-            for (size_t m = 1; m < M-1; ++m)
-                for (size_t n = 0; n < N; ++n)
-                    res (n,m,l) += A(n,m-1,l,1) - A(n,m,l,1);
-        for (size_t l = 1; l < L-1; ++l)
-            for (size_t m = 0; m < M; ++m)
-                for (size_t n = 0; n < N; ++n)
-                    res (n,m,l) += A(n,m,l-1,2) - A(n,m,l,2);
-        return res;
-    }
-};
-
-template<class T> struct TV3D<T,0,0,1> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        Matrix<T> ret (dims);
-        size_t stride = dims[0]*dims[1];
-        for (size_t i = 0; i < dims[2]-1; i++)
-            std::transform(A.Begin()+(i+1)*stride, A.Begin()+(i+2)*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        return ret;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        size_t stride = dims[0]*dims[1];
-        Matrix<T> ret (dims);
-        for (size_t i = 1; i < dims[2]-1; i++)
-            std::transform(A.Begin()+(i-1)*stride, A.Begin()+i*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        for (size_t i = 0; i < stride; ++i)
-            ret[i] = -A[i];
-        std::copy_n(A.Begin()+(dims[2]-2)*stride, stride, ret.Begin()+(dims[2]-1)*stride);
-        return ret;
-    }
-};
-
-
-template<class T, bool b0, bool b1, bool b2, bool b3> struct TV4D {};
-template<class T> struct TV4D<T,0,0,0,1> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        Matrix<T> ret (dims);
-        size_t stride = dims[0]*dims[1]*dims[2];
-        for (size_t i = 0; i < dims[3]-1; i++)
-            std::transform(A.Begin()+(i+1)*stride, A.Begin()+(i+2)*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        return ret;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        size_t stride = dims[0]*dims[1]*dims[2];
-        Matrix<T> ret (dims);
-        for (size_t i = 1; i < dims[3]-1; i++)
-            std::transform(A.Begin()+(i-1)*stride, A.Begin()+i*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        for (size_t i = 0; i < stride; ++i)
-            ret[i] = -A[i];
-        std::copy_n(A.Begin()+(dims[3]-2)*stride, stride, ret.Begin()+(dims[3]-1)*stride);
-        return ret;
-    }
-};
-
-
-template<class T, bool b0, bool b1, bool b2, bool b3, bool b4> struct TV5D {};
-template<class T> struct TV5D<T,0,0,0,1,0> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        Matrix<T> ret (dims);
-        size_t stride = dims[0]*dims[1]*dims[2];
-        for (size_t j = 0; j < dims[4]; ++j)
-            for (size_t i = 0; i < dims[3]-1; ++i)
-                std::transform(A.Begin()+(j*dims[3]+i+1)*stride, A.Begin()+(j*dims[3]+i+2)*stride,
-                               A.Begin()+(j*dims[3]+i  )*stride, ret.Begin()+(j*dims[3]+i)*stride,
-                               std::minus<T>());
-        return ret;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        Matrix<T> ret (dims);
-        size_t stride = dims[0]*dims[1]*dims[2];
-        for (size_t j = 0; j < dims[4]; ++j) {
-            size_t offset = j*dims[3];
-            for (size_t i = 1; i < dims[3]-1; ++i)
-                std::transform(A.Begin()+(offset+i-1)*stride, A.Begin()+(offset+i)*stride,
-                               A.Begin()+(offset+i)*stride, ret.Begin()+(offset+i)*stride,
-                               std::minus<T>());
-        }
-        for (size_t j = 0; j < dims[4]; ++j) {
-            size_t offset = j*dims[3];
-            std::copy_n(A.Begin()+(offset+dims[3]-2)*stride, stride, ret.Begin()+(offset+dims[3]-1)*stride);
-            for (size_t i = 0; i < stride; ++i)
-                ret[offset*stride+i] = -A[offset*stride+i];
-        }
-        return ret;
-    }
-};
-template<class T> struct TV5D<T,0,0,0,0,1> {
-    Matrix<T> inline static fwd (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        Matrix<T> ret (dims);
-        size_t stride = dims[0]*dims[1]*dims[2]*dims[3];
-        for (size_t i = 0; i < dims[4]-1; i++)
-            std::transform(A.Begin()+(i+1)*stride, A.Begin()+(i+2)*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        return ret;
-    }
-    Matrix<T> inline static adj (const Matrix<T>& A) {
-        Vector<size_t> dims = size(A);
-        size_t stride = dims[0]*dims[1]*dims[2]*dims[3];
-        Matrix<T> ret (dims);
-        for (size_t i = 1; i < dims[4]-1; i++)
-            std::transform(A.Begin()+(i-1)*stride, A.Begin()+i*stride, A.Begin()+i*stride,
-                           ret.Begin()+i*stride, std::minus<T>());
-        for (size_t i = 0; i < stride; ++i)
-            ret[i] = -A[i];
-        std::copy_n(A.Begin()+(dims[4]-2)*stride, stride, ret.Begin()+(dims[4]-1)*stride);
-        return ret;
-    }
-};
+#include <cmath>
 
 enum TVOP_EXCEPTION {UNDEFINED_TV_OPERATOR};
 
 /**
- * @brief 2D Finite difference operator
+ * @brief Finite difference operator over any subset of dimensions<br/>
+ *        Forward differences (zero at the upper boundary) of K dimensions are
+ *        stacked along a trailing dimension (K > 1) or keep the shape of the
+ *        input (K == 1). All kernels run in one OpenMP parallel pass over the
+ *        lines of dimension 0, all components of a line at once, with packed
+ *        arithmetic along the line. Norm and Gradient fuse the differences
+ *        with the smoothed L_p norm and its derivative used by the CS
+ *        operators, so that no gradient images are materialised.
  */
 template <class T>
 class TVOP : public Operator<T> {
-	
+
+    typedef typename TypeTraits<T>::RT RT;
+    typedef typename VecTraits<RT>::reg_type reg_type;
+
+    /**
+     * @brief Differentiated dimensions of an image
+     */
+    struct Geometry {
+        Vector<size_t> dims;    /**< @brief Image dimensions */
+        Vector<size_t> tv;      /**< @brief Differentiated dimensions */
+        Vector<size_t> stride;  /**< @brief Strides of differentiated dimensions */
+        size_t         size;    /**< @brief Image size */
+    };
 
 public:
 
 	/**
-	 * @brief Default constructor
+	 * @brief Default constructor: all dimensions
 	 */
 	TVOP()  NOEXCEPT {};
-    TVOP (const Vector<size_t>& dims) : _dims(dims) {}
+
+	/**
+	 * @brief Construct with mask of differentiated dimensions
+	 */
+    TVOP (const Vector<size_t>& dims) : _dims(dims.size()) {
+        for (size_t i = 0; i < dims.size(); ++i)
+            _dims[i] = (unsigned short)dims[i];
+    }
     TVOP (const unsigned short dim0, const unsigned short dim1,
           const unsigned short dim2, const unsigned short dim3, const unsigned short dim4) {
         _dims.resize(5);
@@ -232,65 +88,257 @@ public:
 
 
 	/**
-	 * @brief    2D Forward transform
+	 * @brief    Forward transform
 	 *
-	 * @param  m To transform
-	 * @return   Transform
+	 * @param  A Image
+	 * @return   Forward differences
 	 */
-    
-    
     inline Matrix<T> Trafo (const Matrix<T>& A) const {
 
-        Matrix<T> ret;
-
-        if      (ndims(A)==2 && (_dims.size()==0 || (_dims[0] == 1 && _dims[1] == 1)))
-            ret = TV2D<T,1,1>::fwd(A);
-        else if (ndims(A)==3 && (_dims.size()==0 || (_dims[0] == 1 && _dims[1] == 1 && _dims[2] == 1))) 
-            ret = TV3D<T,1,1,1>::fwd(A);
-        else if (ndims(A)==3 && (_dims[0] == 0 && _dims[1] == 0 && _dims[2] == 1))
-            ret = TV3D<T,0,0,1>::fwd(A);
-        else if (ndims(A)==4 && (_dims.size()==4 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 1))
-        	ret = TV4D<T,0,0,0,1>::fwd(A);
-        else if (ndims(A)==5 && (_dims.size()==5 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 1 && _dims[4] == 0))
-            ret = TV5D<T,0,0,0,1,0>::fwd(A);
-        else if (ndims(A)==5 && (_dims.size()==5 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 0 && _dims[4] == 1))
-            ret = TV5D<T,0,0,0,0,1>::fwd(A);
-        else
-            throw UNDEFINED_TV_OPERATOR;
-        
-        return ret;
-        
-	}	
-	
+        Geometry g = Image (A.Dim(), false);
+        const size_t K = g.tv.size(), n0 = g.dims[0], nl = g.size/n0;
+        Vector<size_t> odims = g.dims;
+        if (K > 1)
+            odims.push_back(K);
+        Matrix<T> res (odims);
+
+        const T* a = A.Ptr();
+        T* r = res.Ptr();
+
+#pragma omp parallel for schedule (static) num_threads (Team(g.size))
+        for (long l = 0; l < (long)nl; ++l) {
+            const size_t b = l*n0;
+            for (size_t k = 0; k < K; ++k) {
+                T* o = r + k*g.size + b;
+                const size_t d = g.tv[k], s = g.stride[k];
+                if (d == 0) {
+                    if (n0 > 1)
+                        Diff (a+b+1, a+b, o, n0-1);
+                    o[n0-1] = T(0);
+                } else if ((b/s)%g.dims[d] < g.dims[d]-1) {
+                    Diff (a+b+s, a+b, o, n0);
+                } else {
+                    std::fill_n (o, n0, T(0));
+                }
+            }
+        }
+
+        return res;
+
+	}
+
+
 	/**
-	 * @brief    Backward transform
+	 * @brief    Adjoint transform
 	 *
-	 * @param  m To transform
-	 * @return   Transform
+	 * @param  A Forward differences
+	 * @return   Image
 	 */
 	inline Matrix<T> Adjoint (const Matrix<T>& A) const {
 
-        Matrix<T> ret;
-
-        if      (ndims(A)==3 && (_dims.size()==0 || (_dims[0] == 1 && _dims[1] == 1)))
-            ret = TV2D<T,1,1>::adj(A);
-		else if (ndims(A)==4 && (_dims.size()==0 || (_dims[0] == 1 && _dims[1] == 1 && _dims[2] == 1)))
-            ret = TV3D<T,1,1,1>::adj(A);
-		else if (ndims(A)==3 && (_dims[0] == 0 && _dims[1] == 0 && _dims[2] == 1))
-            ret = TV3D<T,0,0,1>::adj(A);
-        else if (ndims(A)==4 && (_dims.size()==4 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 1))
-        	ret = TV4D<T,0,0,0,1>::adj(A);
-		else if (ndims(A)==5 && (_dims.size()==5 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 1 && _dims[4] == 0))
-            ret = TV5D<T,0,0,0,1,0>::adj(A);
-        else if (ndims(A)==5 && (_dims.size()==5 && _dims[0] == 0 && _dims[1] == 0 && _dims[2] == 0 && _dims[3] == 0 && _dims[4] == 1))
-            ret = TV5D<T,0,0,0,0,1>::adj(A);
-        else
-            throw UNDEFINED_TV_OPERATOR;
-		
-		return ret;
-		
+        Geometry g = Image (A.Dim(), true);
+        const size_t K = g.tv.size(), n0 = g.dims[0], nl = g.size/n0;
+        Matrix<T> res (g.dims);
+
+        const T* a = A.Ptr();
+        T* r = res.Ptr();
+
+#pragma omp parallel for schedule (static) num_threads (Team(g.size))
+        for (long l = 0; l < (long)nl; ++l) {
+            const size_t b = l*n0;
+            T* o = r + b;
+            for (size_t k = 0; k < K; ++k) {
+                const T* y = a + k*g.size + b;
+                const size_t d = g.tv[k], s = g.stride[k];
+                if (d == 0) {
+                    if (n0 < 2)
+                        continue;
+                    if (n0 > 2)
+                        Acc (y, y+1, o+1, n0-2);
+                    o[0]    -= y[0];
+                    o[n0-1] += y[n0-2];
+                } else {
+                    const size_t i = (b/s)%g.dims[d];
+                    if (i > 0 && i < g.dims[d]-1)
+                        Acc (y-s, y, o, n0);
+                    else if (i > 0)
+                        Acc (y-s, (const T*)0, o, n0);
+                    else if (i < g.dims[d]-1)
+                        Acc ((const T*)0, y, o, n0);
+                }
+            }
+        }
+
+		return res;
+
 	}
-	
+
+
+	/**
+	 * @brief    Smoothed L_p norm of the differences of x + t dx in one pass,
+	 *           i.e. sum (|D(x+t dx)|^2 + l1)^(p/2) without forming D(x+t dx).
+	 *           dx is ignored for t <= 0.
+	 *
+	 * @param  x   Image
+	 * @param  dx  Search direction
+	 * @param  t   Step
+	 * @param  l1  Smoothing
+	 * @param  p   Norm
+	 * @return     Norm
+	 */
+    inline RT Norm (const Matrix<T>& x, const Matrix<T>& dx, const RT& t,
+                    const RT& l1, const RT& p) const {
+        return Norm (x, dx, Vector<RT>(1,t), l1, p)[0];
+    }
+
+
+	/**
+	 * @brief    Smoothed L_p norm of the differences of x + t_i dx for all
+	 *           step sizes t_i in one pass over x and dx
+	 *
+	 * @param  x   Image
+	 * @param  dx  Search direction
+	 * @param  t   Steps
+	 * @param  l1  Smoothing
+	 * @param  p   Norm
+	 * @return     Norms
+	 */
+    inline Vector<RT> Norm (const Matrix<T>& x, const Matrix<T>& dx, const Vector<RT>& t,
+                            const RT& l1, const RT& p) const {
+
+        Geometry g = Image (x.Dim(), false);
+        const size_t K = g.tv.size(), n0 = g.dims[0], nl = g.size/n0, nt = t.size();
+        Vector<RT> ts (nt), sum (nt, (RT)0.);
+        bool step = false;
+        for (size_t i = 0; i < nt; ++i) {
+            ts[i] = (t[i] > 0.) ? t[i] : (RT)0.;
+            step = step || (t[i] > 0.);
+        }
+        const T* a = x.Ptr();
+        const T* da = step ? dx.Ptr() : a;
+        size_t nb = 0;      // boundary entries
+
+#pragma omp parallel num_threads (Team(g.size))
+        {
+            Vector<RT> acc (nt, (RT)0.);
+            Vector<T> u (n0), v (n0);
+            Vector<RT> q (n0);
+            size_t nbl = 0;
+#pragma omp for schedule (static)
+            for (long l = 0; l < (long)nl; ++l) {
+                const size_t b = l*n0;
+                for (size_t k = 0; k < K; ++k) {
+                    const size_t d = g.tv[k], s = (d == 0) ? 1 : g.stride[k];
+                    size_t n = n0;
+                    if (d == 0) {
+                        n = n0-1;
+                        nbl += 1;
+                    } else if ((b/s)%g.dims[d] == g.dims[d]-1) {
+                        nbl += n0;
+                        continue;
+                    }
+                    Diff (a+b+s, a+b, &u[0], n);
+                    if (step)
+                        Diff (da+b+s, da+b, &v[0], n);
+                    for (size_t i = 0; i < nt; ++i) {
+                        if (step)
+                            for (size_t j = 0; j < n; ++j)
+                                q[j] = std::norm(u[j] + ts[i]*v[j]) + l1;
+                        else
+                            for (size_t j = 0; j < n; ++j)
+                                q[j] = std::norm(u[j]) + l1;
+                        acc[i] += Sum (&q[0], n, p);
+                    }
+                }
+            }
+#pragma omp critical
+            {
+                for (size_t i = 0; i < nt; ++i)
+                    sum[i] += acc[i];
+                nb += nbl;
+            }
+        }
+
+        for (size_t i = 0; i < nt; ++i)
+            sum[i] += (RT)nb * Pow (l1, p);
+        return sum;
+
+    }
+
+
+	/**
+	 * @brief    Derivative of the smoothed L_p norm, i.e.
+	 *           D^T [p Dx (|Dx|^2 + l1)^(p/2-1)] without forming Dx.
+	 *           Per differentiated dimension, threads walk chains of lines
+	 *           along it, so that every difference's weight is evaluated once
+	 *           into a line buffer and subtracted from its own and added to
+	 *           the next line. Differences, accumulation and the weights of
+	 *           p = 1 use packed arithmetic.
+	 *
+	 * @param  x   Image
+	 * @param  l1  Smoothing
+	 * @param  p   Norm
+	 * @return     Gradient
+	 */
+    inline Matrix<T> Gradient (const Matrix<T>& x, const RT& l1, const RT& p) const {
+
+        Geometry g = Image (x.Dim(), false);
+        const size_t K = g.tv.size(), n0 = g.dims[0], nl = g.size/n0;
+        Matrix<T> res (x.Dim());
+        const T* a = x.Ptr();
+        T* r = res.Ptr();
+
+#pragma omp parallel num_threads (Team(g.size))
+        {
+            Vector<T> w (n0);
+            Vector<RT> q (n0);
+            for (size_t k = 0; k < K; ++k) {
+                const size_t d = g.tv[k], s = g.stride[k];
+                if (d == 0) {
+                    if (n0 < 2)
+                        continue;
+#pragma omp for schedule (static)
+                    for (long l = 0; l < (long)nl; ++l) {
+                        const size_t b = l*n0;
+                        Weights (a+b+1, a+b, &w[0], &q[0], n0-1, l1, p);
+                        Acc ((const T*)0, &w[0], r+b, n0-1);
+                        Acc (&w[0], (const T*)0, r+b+1, n0-1);
+                    }
+                } else {
+                    // chains of lines along d: ls lines apart, nd long
+                    const size_t nd = g.dims[d], ls = s/n0, nc = nl/nd;
+#pragma omp for schedule (static)
+                    for (long c = 0; c < (long)nc; ++c) {
+                        const size_t b0 = ((c/ls)*nd*ls + c%ls)*n0;
+                        for (size_t i = 0; i < nd; ++i) {
+                            const size_t b = b0 + i*s;
+                            if (i > 0)
+                                Acc (&w[0], (const T*)0, r+b, n0);
+                            if (i < nd-1) {
+                                Weights (a+b+s, a+b, &w[0], &q[0], n0, l1, p);
+                                Acc ((const T*)0, &w[0], r+b, n0);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return res;
+
+    }
+
+
+	/**
+	 * @brief    # of differentiated dimensions (0: all)
+	 */
+    inline size_t Components () const {
+        size_t K = 0;
+        for (size_t i = 0; i < _dims.size(); ++i)
+            if (_dims[i])
+                ++K;
+        return K;
+    }
 
 
 	/**
@@ -325,6 +373,168 @@ public:
 	}
 
 private:
+
+	/**
+	 * @brief    Image geometry from image (adjoint: differences) dimensions
+	 */
+    inline Geometry Image (const Vector<size_t>& dims, const bool& adjoint) const {
+
+        Geometry g;
+        size_t nd = 1;
+        for (size_t i = 1; i < dims.size(); ++i)
+            if (dims[i] > 1)
+                nd = i+1;
+
+        size_t K = 0;
+        if (_dims.size() == 0) {
+            K = adjoint ? nd-1 : nd;
+        } else {
+            for (size_t i = 0; i < _dims.size(); ++i)
+                if (_dims[i])
+                    ++K;
+        }
+        if (adjoint && K > 1) {
+            if (nd < 2 || dims[nd-1] != K)
+                throw UNDEFINED_TV_OPERATOR;
+            --nd;
+        }
+        if (K == 0)
+            throw UNDEFINED_TV_OPERATOR;
+
+        g.dims.resize((K == 1) ? dims.size() : nd);
+        std::copy (dims.begin(), dims.begin() + g.dims.size(), g.dims.begin());
+        g.size = 1;
+        for (size_t i = 0; i < g.dims.size(); ++i)
+            g.size *= g.dims[i];
+
+        size_t s = 1;
+        for (size_t i = 0; i < g.dims.size(); ++i) {
+            if ((_dims.size() == 0) ? (i < nd) : (i < _dims.size() && _dims[i])) {
+                g.tv.push_back(i);
+                g.stride.push_back(s);
+            }
+            s *= g.dims[i];
+        }
+        if (g.tv.size() != K)
+            throw UNDEFINED_TV_OPERATOR;
+
+        return g;
+
+    }
+
+
+	/**
+	 * @brief    Team size for image of n elements
+	 */
+    inline static int Team (const size_t& n) {
+        return (n >= EXPR_PARALLEL_THRESHOLD) ? ExecutionContext::Instance().Threads() : 1;
+    }
+
+
+	/**
+	 * @brief    o = a - b over n elements
+	 */
+    inline static void Diff (const T* a, const T* b, T* o, const size_t& n) {
+        const size_t m = n*sizeof(T)/sizeof(RT), stride = VecTraits<RT>::stride;
+        const RT *ra = (const RT*)a, *rb = (const RT*)b;
+        RT* ro = (RT*)o;
+        size_t i = 0;
+        for (; i + stride <= m; i += stride)
+            VecTraits<RT>::storeu (ro+i, VecTraits<RT>::minus (
+                VecTraits<RT>::loadu(ra+i), VecTraits<RT>::loadu(rb+i)));
+        for (; i < m; ++i)
+            ro[i] = ra[i] - rb[i];
+    }
+
+
+	/**
+	 * @brief    o += a - b over n elements. Null a or b count as zero.
+	 */
+    inline static void Acc (const T* a, const T* b, T* o, const size_t& n) {
+        const size_t m = n*sizeof(T)/sizeof(RT), stride = VecTraits<RT>::stride;
+        const RT *ra = (const RT*)a, *rb = (const RT*)b;
+        RT* ro = (RT*)o;
+        size_t i = 0;
+        if (a && b) {
+            for (; i + stride <= m; i += stride)
+                VecTraits<RT>::storeu (ro+i, VecTraits<RT>::plus (VecTraits<RT>::loadu(ro+i),
+                    VecTraits<RT>::minus (VecTraits<RT>::loadu(ra+i), VecTraits<RT>::loadu(rb+i))));
+            for (; i < m; ++i)
+                ro[i] += ra[i] - rb[i];
+        } else if (a) {
+            for (; i + stride <= m; i += stride)
+                VecTraits<RT>::storeu (ro+i, VecTraits<RT>::plus (VecTraits<RT>::loadu(ro+i),
+                    VecTraits<RT>::loadu(ra+i)));
+            for (; i < m; ++i)
+                ro[i] += ra[i];
+        } else {
+            for (; i + stride <= m; i += stride)
+                VecTraits<RT>::storeu (ro+i, VecTraits<RT>::minus (VecTraits<RT>::loadu(ro+i),
+                    VecTraits<RT>::loadu(rb+i)));
+            for (; i < m; ++i)
+                ro[i] -= rb[i];
+        }
+    }
+
+
+	/**
+	 * @brief    q^(p/2)
+	 */
+    inline static RT Pow (const RT& q, const RT& p) {
+        return (p == 1.) ? std::sqrt(q) : (p == 2.) ? q : std::pow(q, (RT).5*p);
+    }
+
+
+	/**
+	 * @brief    sum q^(p/2) over n elements. The TV case p = 1 is packed.
+	 */
+    inline static RT Sum (const RT* q, const size_t& n, const RT& p) {
+        RT s = (RT)0.;
+        size_t j = 0;
+        if (p == 1.) {
+            const size_t stride = VecTraits<RT>::stride;
+            reg_type acc = VecTraits<RT>::setp ((RT)0.);
+            for (; j + stride <= n; j += stride)
+                acc = VecTraits<RT>::plus (acc, VecTraits<RT>::sqrt (VecTraits<RT>::loadu(q+j)));
+            RT b[VecTraits<RT>::stride];
+            VecTraits<RT>::storeu (b, acc);
+            for (size_t i = 0; i < stride; ++i)
+                s += b[i];
+        }
+        for (; j < n; ++j)
+            s += Pow (q[j], p);
+        return s;
+    }
+
+
+	/**
+	 * @brief    w = p v (|v|^2 + l1)^(p/2-1) with v = a - b over n elements.
+	 *           q is scratch of n reals. The TV case p = 1 is packed.
+	 */
+    inline static void Weights (const T* a, const T* b, T* w, RT* q, const size_t& n,
+                                const RT& l1, const RT& p) {
+        Diff (a, b, w, n);
+        for (size_t j = 0; j < n; ++j)
+            q[j] = std::norm(w[j]) + l1;
+        if (p == 1.) {
+            const size_t stride = VecTraits<RT>::stride;
+            const reg_type one = VecTraits<RT>::setp ((RT)1.);
+            size_t j = 0;
+            for (; j + stride <= n; j += stride)
+                VecTraits<RT>::storeu (q+j, VecTraits<RT>::divides (one,
+                    VecTraits<RT>::sqrt (VecTraits<RT>::loadu(q+j))));
+            for (; j < n; ++j)
+                q[j] = (RT)1./std::sqrt(q[j]);
+        } else if (p == 2.) {
+            std::fill_n (q, n, (RT)2.);
+        } else {
+            for (size_t j = 0; j < n; ++j)
+                q[j] = p*std::pow(q[j], (RT).5*p-(RT)1.);
+        }
+        for (size_t j = 0; j < n; ++j)
+            w[j] *= q[j];
+    }
+
     Vector<unsigned short> _dims;
 
 };
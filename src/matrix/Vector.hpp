@@ -273,6 +273,7 @@ public:
 
 
 	inline void clear() NOEXCEPT {_data.clear();}
+	inline void shrink_to_fit() NOEXCEPT {_data.shrink_to_fit();}
 
 	inline bool empty() const NOEXCEPT {return _data.empty();}
 	inline bool operator== (const Vector<T>& other) const NOEXCEPT {return _data == other._data;}
@@ -4,6 +4,8 @@
 #include <type_traits>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cstddef>
 
 #include "Range.hpp"
 
@@ -46,16 +48,83 @@ private:
 	Vector<size_t> _dim;
 };
 
+#ifndef VIEW_PARALLEL_THRESHOLD
+#  define VIEW_PARALLEL_THRESHOLD 65536
+#endif
+
+namespace codeare {
+namespace view {
+
+    /**
+     * @brief Element-wise kernels used for view traversal: a (op)= b
+     */
+	struct assign {
+		template<class A, class B> inline void operator() (A& a, const B& b) const { a = b; }
+	};
+	struct plus {
+		template<class A, class B> inline void operator() (A& a, const B& b) const { a += b; }
+	};
+	struct minus {
+		template<class A, class B> inline void operator() (A& a, const B& b) const { a -= b; }
+	};
+	struct multiplies {
+		template<class A, class B> inline void operator() (A& a, const B& b) const { a *= b; }
+	};
+	struct divides {
+		template<class A, class B> inline void operator() (A& a, const B& b) const { a /= b; }
+	};
+
+    /**
+     * @brief Contiguous line: a[i] (op)= b[i]
+     */
+	template<class A, class B, class Op> inline static void
+	line (A* a, const B* b, const size_t& n, const Op& op) {
+		for (size_t i = 0; i < n; ++i)
+			op(a[i], b[i]);
+	}
+	template<class A> inline static void
+	line (A* a, const A* b, const size_t& n, const assign&) {
+		std::copy (b, b+n, a);
+	}
+
+    /**
+     * @brief Strided line, stride 0 means irregular, i.e. offsets from table
+     */
+	template<class A, class B, class Op> inline static void
+	line (A* a, const ptrdiff_t& as, const ptrdiff_t* at,
+		  const B* b, const ptrdiff_t& bs, const ptrdiff_t* bt, const size_t& n, const Op& op) {
+		if (as == 1 && bs == 1)
+			line (a, b, n, op);
+		else if (as && bs)
+			for (size_t i = 0; i < n; ++i)
+				op(a[i*as], b[i*bs]);
+		else
+			for (size_t i = 0; i < n; ++i)
+				op(a[as ? i*as : at[i]], b[bs ? i*bs : bt[i]]);
+	}
+
+}}
+
+/**
+ * @brief   Strided view on a matrix
+ *
+ *          A view is described by a pointer to its first element and per
+ *          non-singleton dimension an extent and a stride (in elements).
+ *          Dimensions selected with irregular index lists carry an offset
+ *          table instead of a stride. Leading dimensions, which are
+ *          contiguous in memory, are folded into a single line, such that
+ *          e.g. m(CR(),CR(),CR(k)) is traversed with one memcpy.
+ */
 template<class T, bool is_const = true> class View : public MatrixType<T> {
 public:
     
     typedef typename std::conditional<is_const, const Matrix<T>, Matrix<T> >::type MatrixTypeType;
     typedef typename std::conditional<is_const, const T, T>::type Type;
     
-    inline View () : _matrix(0) {}
+    inline View () : _matrix(0), _ptr(0), _size(0), _run(0), _nrun(0), _lstr(1) {}
 
     inline View (MatrixTypeType* matrix, Vector<Range<is_const> >& range) :
-        _matrix(matrix), _range(range) {
+        _matrix(matrix), _range(range), _ptr(0), _size(1), _run(1), _nrun(0), _lstr(1) {
         assert (_range.size());
         if (_range.size() == 1) {
         	if (!_range[0].IsSingleton()) {
@@ -72,74 +141,47 @@ public:
 				}
 			}
         }
-        if (_range.size() == 1)
-            for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                _pointers.push_back(matrix->Ptr()+_range[0][n0]);
-        else if (_range.size() == 2)
-            for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                    _pointers.push_back(&((*_matrix)(_range[0][n0],_range[1][n1])));
-        else if (_range.size() == 3)
-            for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                    for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                        _pointers.push_back(&((*_matrix)(_range[0][n0],_range[1][n1],_range[2][n2])));
-        else if (_range.size() == 4)
-            for (size_t n3 = 0; n3 < _range[3].Size(); ++n3)
-                for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                    for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                        for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                            _pointers.push_back(&((*_matrix)
-                                                  (_range[0][n0],_range[1][n1],
-                                                   _range[2][n2],_range[3][n3])));
-        else if (_range.size() == 5)
-            for (size_t n4 = 0; n4 < _range[4].Size(); ++n4)
-                for (size_t n3 = 0; n3 < _range[3].Size(); ++n3)
-                    for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                        for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                            for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                                _pointers.push_back(&((*_matrix)
-                                                      (_range[0][n0],_range[1][n1],
-                                                       _range[2][n2],_range[3][n3],
-                                                       _range[4][n4])));
-        else if (_range.size() == 6)
-            for (size_t n5 = 0; n5 < _range[5].Size(); ++n5)
-                for (size_t n4 = 0; n4 < _range[4].Size(); ++n4)
-                    for (size_t n3 = 0; n3 < _range[3].Size(); ++n3)
-                        for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                            for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                                for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                                    _pointers.push_back(&((*_matrix)
-                                                          (_range[0][n0],_range[1][n1],
-                                                           _range[2][n2],_range[3][n3],
-                                                           _range[4][n4],_range[5][n5])));
-        else if (_range.size() == 7)
-            for (size_t n6 = 0; n6 < _range[6].Size(); ++n6)
-                for (size_t n5 = 0; n5 < _range[5].Size(); ++n5)
-                    for (size_t n4 = 0; n4 < _range[4].Size(); ++n4)
-                        for (size_t n3 = 0; n3 < _range[3].Size(); ++n3)
-                            for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                                for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                                    for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                                        _pointers.push_back(&((*_matrix)
-                                                              (_range[0][n0],_range[1][n1],
-                                                               _range[2][n2],_range[3][n3],
-                                                               _range[4][n4],_range[5][n5],
-                                                               _range[6][n6])));
-        else if (_range.size() == 8)
-            for (size_t n7 = 0; n7 < _range[7].Size(); ++n7)
-                for (size_t n6 = 0; n6 < _range[6].Size(); ++n6)
-                    for (size_t n5 = 0; n5 < _range[5].Size(); ++n5)
-                        for (size_t n4 = 0; n4 < _range[4].Size(); ++n4)
-                            for (size_t n3 = 0; n3 < _range[3].Size(); ++n3)
-                                for (size_t n2 = 0; n2 < _range[2].Size(); ++n2)
-                                    for (size_t n1 = 0; n1 < _range[1].Size(); ++n1)
-                                        for (size_t n0 = 0; n0 < _range[0].Size(); ++n0)
-                                            _pointers.push_back(&((*_matrix)
-                                                                  (_range[0][n0],_range[1][n1],
-                                                                   _range[2][n2],_range[3][n3],
-                                                                   _range[4][n4],_range[5][n5],
-                                                                   _range[6][n6],_range[7][n7])));
+
+        // Offset of first element, extents and strides / offset tables
+        ptrdiff_t offset = 0, last = 0, dsz = 1;
+        for (size_t i = 0; i < _range.size(); ++i) {
+            const Range<is_const>& r = _range[i];
+            const size_t n = r.Size();
+            offset += r[0]*dsz;
+            last   += r[0]*dsz;
+            if (n > 1) {
+                ptrdiff_t stride = (ptrdiff_t)r[1]-(ptrdiff_t)r[0];
+                for (size_t j = 2; j < n && stride; ++j)
+                    if ((ptrdiff_t)r[j]-(ptrdiff_t)r[j-1] != stride)
+                        stride = 0;
+                Vector<ptrdiff_t> table;
+                if (!stride) {
+                    table.resize(n);
+                    for (size_t j = 0; j < n; ++j)
+                        table[j] = ((ptrdiff_t)r[j]-(ptrdiff_t)r[0])*dsz;
+                }
+                for (size_t j = 0; j < n; ++j)
+                    last = std::max(last, offset + ((ptrdiff_t)r[j]-(ptrdiff_t)r[0])*dsz);
+                _ext.push_back(n);
+                _str.push_back(stride*dsz);
+                _off.push_back(table);
+                _size *= n;
+            }
+            if (_range.size() > 1)
+                dsz *= _matrix->Dim(i);
+        }
+        assert (last < (ptrdiff_t)_matrix->Size());
+        _ptr = _matrix->Ptr() + offset;
+
+        // Fold contiguous leading dimensions into one line
+        if (!_ext.empty()) {
+            _nrun = 1;
+            _run  = _ext[0];
+            _lstr = _str[0];
+            if (_lstr == 1)
+                while (_nrun < _ext.size() && _str[_nrun] == (ptrdiff_t)_run)
+                    _run *= _ext[_nrun++];
+        }
         
         for (auto it = _range.begin(); it != _range.end();) {
             _dim.push_back(it->Size());
@@ -153,122 +195,290 @@ public:
     
     operator Matrix<T>() const {
         Matrix<T> res (_dim);
-        for (size_t i = 0; i < Size(); ++i)
-            res[i] = *(_pointers[i]);
-            return res;
+        Pull (res.Ptr(), codeare::view::assign());
+        return res;
     }
     
     template<class S> inline View& operator= (const Matrix<S>& M) {
         assert (Size() == M.Size());
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) = M[i];
+        if (Aliases(&M)) {
+            const Matrix<S> tmp = M;
+            Push (tmp.Ptr(), codeare::view::assign());
+        } else
+            Push (M.Ptr(), codeare::view::assign());
         return *this;
     }
         
     inline virtual const T& operator[] (const size_t& pos) const {
         assert(pos < Size());
-        return *(_pointers[pos]);
+        return *Elem(pos);
     }
 
     template<class S> inline Matrix<T> operator* (const MatrixType<S>& d) const {
-        assert (Size() == d.Size());
-        Matrix<T> M(_dim);
-        for (size_t i = 0; i < Size(); ++i)
-            M[i] = *(_pointers[i])*d[i];
-        return M;
+        return Binary (d, codeare::view::multiplies());
     }
-    template<class S> inline MatrixType<T>& operator*= (const MatrixType<S>& d)  {
-        assert (Size() == d.Size());
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) *= d[i];
-        return *this;
+    template<class S> inline View& operator*= (const MatrixType<S>& d)  {
+        return Update (d, codeare::view::multiplies());
     }
     
-    inline virtual Matrix<T> operator/ (const MatrixTypeType& d) const {
-        Matrix<T> M(_dim);
-        for (size_t i = 0; i < Size(); ++i)
-            M[i] = *(_pointers[i])/d[i];
-        return M;
+    template<class S> inline Matrix<T> operator/ (const MatrixType<S>& d) const {
+        return Binary (d, codeare::view::divides());
     }
     inline virtual Matrix<T> operator/ (const T& t) const {
-        Matrix<T> M(_dim);
+        Matrix<T> res = *this;
         for (size_t i = 0; i < Size(); ++i)
-            M[i] = *(_pointers[i])/t;
-        return M;
+            res[i] /= t;
+        return res;
     }
-    template<class S> inline MatrixType<T>& operator/= (const MatrixType<S>& d)  {
-        assert (Size() == d.Size());
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) /= d[i];
-        return *this;
+    template<class S> inline View& operator/= (const MatrixType<S>& d)  {
+        return Update (d, codeare::view::divides());
     }
-    inline MatrixType<T>& operator/= (const T& t)  {
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) /= t;
-        return *this;
+    inline View& operator/= (const T& t)  {
+        return Update (t, codeare::view::divides());
     }
     
-    inline virtual Matrix<T> operator+ (const MatrixTypeType& d) const {
-        Matrix<T> M(_dim);
-        for (size_t i = 0; i < Size(); ++i)
-            M[i] = *(_pointers[i])+d[i];
-        return M;
+    template<class S> inline Matrix<T> operator+ (const MatrixType<S>& d) const {
+        return Binary (d, codeare::view::plus());
     }
-    template<class S> inline MatrixType<T>& operator+= (const MatrixType<S>& d)  {
-        assert (Size() == d.Size());
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) += d[i];
-        return *this;
+    template<class S> inline View& operator+= (const MatrixType<S>& d)  {
+        return Update (d, codeare::view::plus());
     }
 
-    inline virtual Matrix<T> operator- (const MatrixTypeType& d) const {
-        Matrix<T> M(_dim);
-        for (size_t i = 0; i < Size(); ++i)
-            M[i] = *(_pointers[i])-d[i];
-        return M;
+    template<class S> inline Matrix<T> operator- (const MatrixType<S>& d) const {
+        return Binary (d, codeare::view::minus());
     }
-    template<class S> inline MatrixType<T>& operator-= (const MatrixType<S>& d)  {
-        assert (Size() == d.Size());
-        for (size_t i = 0; i < Size(); ++i)
-            *(_pointers[i]) -= d[i];
-        return *this;
+    template<class S> inline View& operator-= (const MatrixType<S>& d)  {
+        return Update (d, codeare::view::minus());
     }
 
-    virtual ~View () { _matrix = 0; }
+    virtual ~View () { _matrix = 0; _ptr = 0; }
     
-    inline View& operator= (const View<T,true>& v) {
-        Matrix<T>& lhs = *_matrix;
-        const Matrix<T>& rhs = *(v._matrix);
-        assert (_nsdims.size() == v._nsdims.size());
-        for (size_t i = 0; i < _nsdims.size(); ++i) {
-        	if (_range[i].Size()!=v._range[i].Size())
-        		std::cout << _range[i].Size() << " != " << v._range[i].Size() << std::endl;
-            assert(_range[i].Size()==v._range[i].Size());
-        }
-        for (size_t i = 0; i < _pointers.size(); ++i)
-            *_pointers[i] = *(v._pointers)[i];
-        return *this;
+    inline View& operator= (const View& v) {
+        return Update (v, codeare::view::assign());
+    }
+    template<class S, bool c> inline View& operator= (const View<S,c>& v) {
+        return Update (v, codeare::view::assign());
     }
     inline View& operator= (const Type& t) {
-        assert (_matrix);
-        for (size_t i = 0; i < _pointers.size(); ++i)
-            *_pointers[i] = t;
-        return *this;
+        return Update (t, codeare::view::assign());
     }
     
-    inline Range<is_const>& Rng() { return _range; }
-    inline virtual size_t Size() const {return _pointers.size();}
+    inline virtual size_t Size() const {return _size;}
     inline virtual size_t Dim (const size_t& i) const { assert (i<_dim.size()); return _dim[i];}
     inline virtual const Vector<size_t>& Dim() const { return _dim; }
     virtual size_t NDim() const  { return _dim.size(); }
+
+    /**
+     * @brief   Is the view's data contiguous in memory
+     */
+    inline bool IsContiguous () const { return _run == _size && _lstr == 1; }
+
+    /**
+     * @brief   Does this view refer to the data of a given matrix
+     */
+    inline bool Aliases (const void* m) const { return (const void*)_matrix == m; }
+
+    /**
+     * @brief   Traverse view in column major order: op (buf[i], view[i])
+     *          e.g. gather into buffer with codeare::view::assign
+     *
+     * @param   buf  Contiguous buffer of Size() elements
+     * @param   op   Element kernel
+     */
+    template<class S, class Op> inline void Pull (S* buf, const Op& op) const {
+        const long nl = (long)(_size/_run);
+        const ptrdiff_t* lt = LineTable();
+#pragma omp parallel for schedule (static) if (_size >= VIEW_PARALLEL_THRESHOLD && nl > 1)
+        for (long l = 0; l < nl; ++l)
+            codeare::view::line (buf + l*_run, 1, (const ptrdiff_t*)0,
+                                 (const Type*)_ptr + LineOffset(l,_nrun), _lstr, lt, _run, op);
+    }
+
+    /**
+     * @brief   Traverse view in column major order: op (view[i], buf[i])
+     *          e.g. scatter from buffer with codeare::view::assign
+     *
+     * @param   buf  Contiguous buffer of Size() elements
+     * @param   op   Element kernel
+     */
+    template<class S, class Op> inline void Push (const S* buf, const Op& op) {
+        const long nl = (long)(_size/_run);
+        const ptrdiff_t* lt = LineTable();
+#pragma omp parallel for schedule (static) if (_size >= VIEW_PARALLEL_THRESHOLD && nl > 1)
+        for (long l = 0; l < nl; ++l)
+            codeare::view::line (_ptr + LineOffset(l,_nrun), _lstr, lt, buf + l*_run,
+                                 1, (const ptrdiff_t*)0, _run, op);
+    }
+
+    /**
+     * @brief   Traverse two views of identical shape: op (this[i], v[i])
+     *
+     * @param   v    Right hand side view
+     * @param   op   Element kernel
+     */
+    template<class S, bool c, class Op> inline void Zip (const View<S,c>& v, const Op& op) {
+        assert (_ext == v._ext);
+        size_t nrun = 0, run = 1;
+        ptrdiff_t as = 1, bs = 1;
+        const ptrdiff_t *at = 0, *bt = 0;
+        if (!_ext.empty()) {
+            if (_lstr == 1 && v._lstr == 1) {
+                nrun = std::min(_nrun, v._nrun);
+                for (size_t d = 0; d < nrun; ++d)
+                    run *= _ext[d];
+            } else {
+                nrun = 1;
+                run  = _ext[0];
+                as   = _str[0];
+                bs   = v._str[0];
+                at   = LineTable();
+                bt   = v.LineTable();
+            }
+        }
+        const long nl = (long)(_size/run);
+#pragma omp parallel for schedule (static) if (_size >= VIEW_PARALLEL_THRESHOLD && nl > 1)
+        for (long l = 0; l < nl; ++l)
+            codeare::view::line (_ptr + LineOffset(l,nrun), as, at,
+                                 (const S*)v._ptr + v.LineOffset(l,nrun), bs, bt, run, op);
+    }
+
+    /**
+     * @brief   View with dimension dim of Dim() cyclically shifted by k,
+     *          i.e. element j along dim maps to element (j+k)%n.
+     *
+     * @param   dim  Dimension (as in Dim())
+     * @param   k    Shift
+     * @return       Shifted view
+     */
+    inline View Rotated (const size_t& dim, const size_t& k) const {
+        View ret = *this;
+        size_t d = std::find(_nsdims.begin(), _nsdims.end(), dim) - _nsdims.begin();
+        if (d >= _ext.size() || !(k % _ext[d]))
+            return ret;
+        const size_t n = _ext[d];
+        Vector<ptrdiff_t> table (n);
+        for (size_t j = 0; j < n; ++j)
+            table[j] = Offset (d, (j+k)%n);
+        ret._off[d] = table;
+        ret._str[d] = 0;
+        ret.Fold();
+        return ret;
+    }
     
     MatrixTypeType* _matrix;
     Vector<Range<is_const> > _range;
-    Vector<Type*> _pointers;
     Vector<size_t> _nsdims;
     Vector<size_t> _dim;
     
 private:
+
+    template<class S, bool c> friend class View;
+
+    inline void Fold () {
+        _nrun = 1; _run = _ext[0]; _lstr = _str[0];
+        if (_lstr == 1)
+            while (_nrun < _ext.size() && _str[_nrun] == (ptrdiff_t)_run)
+                _run *= _ext[_nrun++];
+    }
+
+    inline ptrdiff_t Offset (const size_t& d, const size_t& i) const {
+        return _str[d] ? (ptrdiff_t)i*_str[d] : _off[d][i];
+    }
+
+    inline ptrdiff_t LineOffset (size_t l, const size_t& d0) const {
+        ptrdiff_t o = 0;
+        for (size_t d = d0; d < _ext.size(); ++d) {
+            o += Offset (d, l % _ext[d]);
+            l /= _ext[d];
+        }
+        return o;
+    }
+
+    inline const ptrdiff_t* LineTable () const {
+        return (_ext.empty() || _str[0]) ? 0 : _off[0].ptr();
+    }
+
+    inline Type* Elem (size_t pos) const {
+        if (_nrun == _ext.size() && _lstr)
+            return _ptr + (ptrdiff_t)pos*_lstr;
+        ptrdiff_t o = 0;
+        for (size_t d = 0; d < _ext.size(); ++d) {
+            o += Offset (d, pos % _ext[d]);
+            pos /= _ext[d];
+        }
+        return _ptr + o;
+    }
+
+    template<class S, class Op> inline Matrix<T> Binary (const MatrixType<S>& d, const Op& op) const {
+        assert (Size() == d.Size());
+        Matrix<T> res = *this;
+        if (const Matrix<S>* M = dynamic_cast<const Matrix<S>*>(&d))
+            codeare::view::line (res.Ptr(), M->Ptr(), Size(), op);
+        else if (const View<S,true>* v = dynamic_cast<const View<S,true>*>(&d))
+            v->Pull (res.Ptr(), op);
+        else if (const View<S,false>* v = dynamic_cast<const View<S,false>*>(&d))
+            v->Pull (res.Ptr(), op);
+        else
+            for (size_t i = 0; i < Size(); ++i)
+                op(res[i], d[i]);
+        return res;
+    }
+
+    template<class S, class Op> inline View& Update (const MatrixType<S>& d, const Op& op) {
+        if (const Matrix<S>* M = dynamic_cast<const Matrix<S>*>(&d))
+            return Update (*M, op);
+        else if (const View<S,true>* v = dynamic_cast<const View<S,true>*>(&d))
+            return Update (*v, op);
+        else if (const View<S,false>* v = dynamic_cast<const View<S,false>*>(&d))
+            return Update (*v, op);
+        Matrix<S> tmp (d.Dim());
+        for (size_t i = 0; i < tmp.Size(); ++i)
+            tmp[i] = d[i];
+        return Update (tmp, op);
+    }
+
+    template<class S, class Op> inline View& Update (const Matrix<S>& M, const Op& op) {
+        assert (Size() == M.Size());
+        if (Aliases(&M)) {
+            const Matrix<S> tmp = M;
+            Push (tmp.Ptr(), op);
+        } else
+            Push (M.Ptr(), op);
+        return *this;
+    }
+
+    template<class S, bool c, class Op> inline View& Update (const View<S,c>& v, const Op& op) {
+        assert (Size() == v.Size());
+        if (_ext != v._ext || (const void*)_matrix == (const void*)v._matrix) {
+            const Matrix<S> tmp = v; // overlap or reshape: evaluate rhs first
+            Push (tmp.Ptr(), op);
+        } else
+            Zip (v, op);
+        return *this;
+    }
+
+    template<class Op> inline View& Update (const T& t, const Op& op) {
+        assert (_matrix);
+        const long nl = (long)(_size/_run);
+        const ptrdiff_t* lt = LineTable();
+#pragma omp parallel for schedule (static) if (_size >= VIEW_PARALLEL_THRESHOLD && nl > 1)
+        for (long l = 0; l < nl; ++l) {
+            Type* p = _ptr + LineOffset(l,_nrun);
+            for (size_t i = 0; i < _run; ++i)
+                op(p[_lstr ? (ptrdiff_t)i*_lstr : lt[i]], t);
+        }
+        return *this;
+    }
+
+    Type* _ptr;                     /// First element
+    Vector<size_t> _ext;            /// Extents of non-singleton dimensions
+    Vector<ptrdiff_t> _str;         /// Strides (0: irregular, see _off)
+    Vector<Vector<ptrdiff_t> > _off;/// Offset tables of irregular dimensions
+    size_t _size;                   /// Number of elements
+    size_t _run;                    /// Elements per line
+    size_t _nrun;                   /// Dimensions folded into a line
+    ptrdiff_t _lstr;                /// Line stride (0: irregular)
+
     friend std::ostream& operator<< (std::ostream &os, const View& r) {
         os << "(";
         for (size_t i = 0; i < r._range.size(); ++i) {
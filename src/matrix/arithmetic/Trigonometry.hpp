@@ -15,6 +15,34 @@ namespace codeare {
     namespace matrix {
         namespace arithmetic {
 
+            /**
+             * @brief       Single precision sine and cosine (Cephes minimax
+             *              polynomials, ~1e-7 absolute on |x| < 8192)<br/>
+             *              Branch free to vectorise inside SIMD loops.
+             *
+             * @param  x    Angle
+             * @param  s    sin(x)
+             * @param  c    cos(x)
+             */
+            inline static void
+            fast_sincos (const float& x, float& s, float& c) {
+                const float ax = std::abs(x);
+                int         j  = (int) (ax * 1.27323954473516f); // 4/pi
+                j = (j + 1) & ~1;
+                const float y  = (float) j;
+                const float z  = ((ax - y * 0.78515625f) - y * 2.4187564849853515625e-4f)
+                    - y * 3.77489497744594108e-8f;
+                const float zz = z * z;
+                const float ps = ((-1.9515295891e-4f * zz + 8.3321608736e-3f) * zz
+                                  - 1.6666654611e-1f) * zz * z + z;
+                const float pc = ((2.443315711809948e-5f * zz - 1.388731625493765e-3f) * zz
+                                  + 4.166664568298827e-2f) * zz * zz - .5f * zz + 1.f;
+                const float sv = (j & 2) ? pc : ps;
+                const float cv = (j & 2) ? ps : pc;
+                s = ((j & 4) ? -sv : sv) * ((x < 0.f) ? -1.f : 1.f);
+                c = ((j + 2) & 4) ? -cv : cv;
+            }
+
             template<class T> inline static Matrix<T>
             sin (const Matrix<T>& m) {
                 Matrix<T> ret (m.Dim(), m.Res());
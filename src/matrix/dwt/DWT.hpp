@@ -29,9 +29,14 @@
 /**
  * @brief OMP related makros
  */
-# define NUM_THREADS_DWT 8
+# define NUM_THREADS_DWT 0 // 0: execution context budget
 # define OMP_SCHEDULE guided
 
+/**
+ * @brief Lines transformed at once along strided dimensions
+ */
+# define DWT_PANEL 32
+
 /**
  * @brief Default wavelet parameters
  */
@@ -59,6 +64,21 @@ enum wlfamily {
 # include "Matrix.hpp"
 # include "Wavelet.hpp"
 # include "Operator.hpp"
+# include "ExecutionContext.hpp"
+
+
+/**
+ * @brief No contraction of multiply and add to FMA in the kernels, so that
+ *        vectorised and line by line transforms agree to the last bit with
+ *        any -march flags.
+ */
+# if defined (__clang__)
+#  pragma float_control (push)
+#  pragma clang fp contract (off)
+# elif defined (__GNUC__)
+#  pragma GCC push_options
+#  pragma GCC optimize ("fp-contract=off")
+# endif
 
 
 /**
@@ -105,11 +125,12 @@ class DWT : public Operator<T> {
               _fl (wl_mem),
               _modd (_fl/2),
               _meven ((_fl+1)/2),
-              _num_threads (num_threads),
+              _num_threads (num_threads > 0 ? num_threads : ExecutionContext::Instance().Threads()),
               _temp (Vector <T> (_num_threads * std::max (6 * _sl3, std::max (6 * _sl2, 5 * sl1)))),
               dpwt (_dim == 2 ? & DWT <T> :: dpwt2 : & DWT <T> :: dpwt3),
               idpwt (_dim == 2 ? & DWT <T> :: idpwt2 : & DWT <T> :: idpwt3) {
             setupWlFilters <T> (wl_fam, wl_mem, _lpf_d, _lpf_r, _hpf_d, _hpf_r);
+            Vectorise (true);
         }
 
 
@@ -140,11 +161,12 @@ class DWT : public Operator<T> {
           _fl (wl_mem),
           _modd (_fl/2),
           _meven ((_fl+1)/2),
-          _num_threads (num_threads),
+          _num_threads (num_threads > 0 ? num_threads : ExecutionContext::Instance().Threads()),
           _temp (Vector <T> (_num_threads * std::max (6 * _sl3, std::max (6 * _sl2, 5 * sl1)))),
           dpwt (_dim == 2 ? & DWT <T> :: dpwt2 : & DWT <T> :: dpwt3),
           idpwt (_dim == 2 ? & DWT <T> :: idpwt2 : & DWT <T> :: idpwt3) {
             setupWlFilters <T> (wl_fam, wl_mem, _lpf_d, _lpf_r, _hpf_d, _hpf_r);
+            Vectorise (true);
         }
 
 
@@ -175,20 +197,29 @@ class DWT : public Operator<T> {
           _fl (wl_mem),
           _modd (_fl/2),
           _meven ((_fl+1)/2),
-          _num_threads (num_threads),
+          _num_threads (num_threads > 0 ? num_threads : ExecutionContext::Instance().Threads()),
           _temp (Vector <T> (_num_threads * std::max (6 * _sl3, std::max (6 * _sl2, 5 * sl1)))),
           dpwt (_dim == 2 ? & DWT <T> :: dpwt2 : & DWT <T> :: dpwt3),
           idpwt (_dim == 2 ? & DWT <T> :: idpwt2 : & DWT <T> :: idpwt3) {
             setupWlFilters <T> (wl_fam, wl_mem, _lpf_d, _lpf_r, _hpf_d, _hpf_r);
+            Vectorise (true);
         }
 
 
         virtual
-        ~DWT () NOEXCEPT { }
+        ~DWT () NOEXCEPT {
+            for (size_t i = 0; i < _frames.size(); ++i)
+                delete _frames[i];
+        }
 
 
         /**
-         * @brief    Forward transform (no constructor calls)
+         * @brief    Forward transform (no constructor calls)<br/>
+         *           Higher dimensions (frames, gates, ...) are batched. Every
+         *           thread transforms whole images / volumes through all
+         *           levels as long as there is one for each thread. The
+         *           vectorised transform shares the lines of the remaining
+         *           frames among threads in one parallel region.
          *
          * @param  m    Signal to decompose
          * @param  res  Resulting DWT
@@ -201,8 +232,11 @@ class DWT : public Operator<T> {
                     && (_dim == 2 || m.Dim (2) == _sl3)
                     && m.Dim () == res.Dim ());
 
-            /* function pointer */
-            (this ->* dpwt) (m, res);
+            const size_t nv = m.Size() / ((size_t)_ld12 * _sl3);
+            if (nv == 1 || (_vectorised && (_num_threads == 1 || nv < (size_t)_num_threads)))
+                (this ->* dpwt) (m, res);
+            else
+                Batch (m, res, false);
 
         }
 
@@ -221,8 +255,11 @@ class DWT : public Operator<T> {
                     && (_dim == 2 || m.Dim (2) == _sl3)
                     && m.Dim () == res.Dim ());
 
-            /* function pointer */
-            (this ->* idpwt) (m, res);
+            const size_t nv = m.Size() / ((size_t)_ld12 * _sl3);
+            if (nv == 1 || (_vectorised && (_num_threads == 1 || nv < (size_t)_num_threads)))
+                (this ->* idpwt) (m, res);
+            else
+                Batch (m, res, true);
 
         }
 
@@ -270,9 +307,49 @@ class DWT : public Operator<T> {
         inline virtual std::ostream& Print (std::ostream& os) const {
             Operator<T>::Print(os);
             os << "    dims(" << _sl1 << "," << _sl2 << "," << _sl3 << ")" <<
-                " WL(" << _wl_fam << "," << _fl << ") threads(" << _num_threads << ")";
+                " WL(" << _wl_fam << "," << _fl << ") threads(" << _num_threads << ")" <<
+                " vectorised(" << _vectorised << ")";
             return os;
         }
+
+
+        /**
+         * @brief    Transform many lines at once along second and third
+         *           dimension with packed arithmetic instead of gathering
+         *           every line. Results are bit-identical to the line by
+         *           line transform. Available for Haar and Daubechies filters
+         *           which do not wrap more than once around the coarsest
+         *           scale.
+         *
+         * @param  v Use vectorised transform if available
+         */
+        inline void
+        Vectorise    (const bool v) NOEXCEPT {
+
+            _vectorised = v && ((_wl_fam == WL_HAAR && _fl == 2) ||
+                                (_wl_fam == WL_DAUBECHIES && (_fl == 4 || _fl == 8))) &&
+                (1 << (_min_level + 1)) >= _fl;
+
+            if (_vectorised) {
+                _panel_size = DWT_PANEL * std::max (_sl2, _sl3);
+                _panel.resize (_num_threads * _panel_size);
+                dpwt  = (_dim == 2) ? & DWT <T> :: dpwt2v  : & DWT <T> :: dpwt3v;
+                idpwt = (_dim == 2) ? & DWT <T> :: idpwt2v : & DWT <T> :: idpwt3v;
+            } else {
+                dpwt  = (_dim == 2) ? & DWT <T> :: dpwt2  : & DWT <T> :: dpwt3;
+                idpwt = (_dim == 2) ? & DWT <T> :: idpwt2 : & DWT <T> :: idpwt3;
+            }
+
+        }
+
+
+        /**
+         * @brief    Vectorised transform in use
+         */
+        inline bool
+        Vectorised   () const NOEXCEPT {
+            return _vectorised;
+        }
     
 
     private:
@@ -317,6 +394,14 @@ class DWT : public Operator<T> {
         // temporary memory used in transform algorithms
         Vector<T> _temp;
 
+        // per thread panels of vectorised transforms
+        Vector<T> _panel;
+        size_t _panel_size;
+        bool _vectorised;
+
+        // single threaded transforms of whole frames per thread (batches)
+        std::vector<DWT <T> *> _frames;
+
         // used transform functions
         void (DWT <T> :: * dpwt) (const Matrix <T> &, Matrix <T> &);
         void (DWT <T> :: * idpwt) (const Matrix <T> &, Matrix <T> &);
@@ -335,6 +420,60 @@ class DWT : public Operator<T> {
          */
 
 
+        /**
+         * @brief           Transform of batches. Complete rounds of one frame
+         *                  per thread are transformed by the threads' own single
+         *                  threaded transforms, so that a frame stays in the
+         *                  thread's cache through all levels. The remaining
+         *                  frames are transformed with all threads, at once if
+         *                  vectorised or else one after the other.
+         *
+         * @param  m        Input
+         * @param  res      Output
+         * @param  adjoint  Adjoint transform
+         */
+        inline void
+        Batch               (const Matrix <T> & m, Matrix <T> & res, const bool adjoint) NOEXCEPT {
+
+            const size_t vol = (size_t)_ld12 * _sl3;
+            const int nv = m.Size() / vol, nb = nv - nv % _num_threads;
+            void (DWT <T> :: * f) (const Matrix <T> &, Matrix <T> &) = adjoint ? idpwt : dpwt;
+
+            if (nb > 0 && _num_threads > 1) {
+
+                if (_frames.empty())
+                    for (int t = 0; t < _num_threads; ++t)
+                        _frames.push_back (new DWT <T> (_sl1, _sl2, _sl3, _wl_fam, _fl, _min_level, 1));
+                for (size_t t = 0; t < _frames.size(); ++t)
+                    if (_frames[t]->Vectorised() != _vectorised)
+                        _frames[t]->Vectorise (_vectorised);
+
+# pragma omp parallel default (shared) num_threads (_num_threads)
+                {
+                    DWT <T> & w = * _frames [omp_get_thread_num ()];
+                    Matrix <T> in (_sl1, _sl2, _sl3), out (_sl1, _sl2, _sl3);
+
+# pragma omp for schedule (static)
+                    for (int i = 0; i < nb; ++i) {
+                        std::copy (m.Begin() + i * vol, m.Begin() + (i+1) * vol, in.Begin());
+                        (w .* f) (in, out);
+                        std::copy (out.Begin(), out.End(), res.Begin() + i * vol);
+                    }
+                }
+
+            }
+
+            const int first = (_num_threads > 1) ? nb : 0, nr = (_vectorised) ? nv - first : 1;
+            Matrix <T> in (_sl1, _sl2, _sl3, nr), out (_sl1, _sl2, _sl3, nr);
+            for (int i = first; i < nv; i += nr) {
+                std::copy (m.Begin() + i * vol, m.Begin() + (i+nr) * vol, in.Begin());
+                (this ->* f) (in, out);
+                std::copy (out.Begin(), out.End(), res.Begin() + i * vol);
+            }
+
+        }
+
+
         /**
          * @brief           Calculate start level for decomposition.
          *                  (Depends on minimum of side lengths.)
@@ -1176,7 +1315,429 @@ class DWT : public Operator<T> {
 
         }
 
+
+        /**
+         * @brief       Perform forward DWT (periodic boundaries) on 2D data.
+         *              Vectorised along second dimension. All images of
+         *              the matrix (sl1 x sl2 x ...) are transformed at once.
+         *
+         * @param  sig  Signal to be transformed.
+         * @param  res  Decomposed signal.
+         */
+        inline void
+        dpwt2v      (const Matrix <T> & sig, Matrix <T> & res) NOEXCEPT {
+
+            // assign signal to result matrix
+            res = sig;
+
+            // # of images / volumes
+            const int nv = res.Size() / (_ld12 * _sl3);
+
+# pragma omp parallel default (shared), num_threads (_num_threads)
+            {
+
+                int sl1 = _sl1,
+                    sl2 = _sl2;
+                const int t_num = omp_get_thread_num ();
+                T * tmp, * panel = & _panel [t_num * _panel_size];
+
+                // loop over levels of DWT
+                for (int j = (_max_level-1); j >= _min_level; --j) {
+
+                    tmp = & _temp [sl1 * t_num];
+
+#pragma omp for
+                    // loop over lines along first dimension ('columns') of all images
+                    for (int c = 0; c < nv * sl2; c++)
+                        downline (& res [(size_t)(c / sl2) * _ld12 + (c % sl2) * _sl1], sl1, tmp);
+
+                    const int np = (sl1 + DWT_PANEL - 1) / DWT_PANEL;
+
+#pragma omp for
+                    // loop over panels of lines along second dimension ('rows') of all images
+                    for (int c = 0; c < nv * np; c++) {
+                        const int p = c % np;
+                        downpanel (& res [(size_t)(c / np) * _ld12 + p * DWT_PANEL], sl2, _sl1,
+                                   std::min (DWT_PANEL, sl1 - p * DWT_PANEL), panel);
+                    }
+
+                    // reduce dimensions for next level
+                    sl1 /= 2;
+                    sl2 /= 2;
+
+                } // loop over levels of DWT
+
+            } // omp parallel
+
+        }
+
+
+        /**
+         * @brief       Perform forward DWT (periodic boundaries) on 3D data.
+         *              Vectorised along second and third dimension. All
+         *              volumes of the matrix (sl1 x sl2 x sl3 x ...) are
+         *              transformed at once.
+         *
+         * @param  sig  Signal to be transformed.
+         * @param  res  Decomposed signal.
+         */
+        inline void
+        dpwt3v      (const Matrix <T> & sig, Matrix <T> & res) NOEXCEPT {
+
+            // assign signal to result matrix
+            res = sig;
+
+            // # of images / volumes
+            const int nv = res.Size() / (_ld12 * _sl3);
+            const size_t vol = (size_t)_ld12 * _sl3;
+
+# pragma omp parallel default (shared), num_threads (_num_threads)
+            {
+
+                int sl1 = _sl1,
+                    sl2 = _sl2,
+                    sl3 = _sl3;
+                const int t_num = omp_get_thread_num ();
+                T * tmp, * panel = & _panel [t_num * _panel_size];
+
+                // loop over levels of DWT
+                for (int j = (_max_level-1); j >= _min_level; --j) {
+
+                    tmp = & _temp [sl1 * t_num];
+
+# pragma omp for
+                    // loop over lines along first dimension ('columns') of all volumes
+                    for (int c = 0; c < nv * sl3 * sl2; c++)
+                        downline (& res [(size_t)(c / (sl2 * sl3)) * vol + ((c / sl2) % sl3) * _ld12
+                                         + (c % sl2) * _sl1], sl1, tmp);
+
+                    const int np = (sl1 + DWT_PANEL - 1) / DWT_PANEL;
+
+# pragma omp for
+                    // loop over panels of lines along second dimension ('rows') per slice
+                    for (int c = 0; c < nv * sl3 * np; c++) {
+                        const int p = c % np, s = c / np;
+                        downpanel (& res [(size_t)(s / sl3) * vol + (s % sl3) * _ld12 + p * DWT_PANEL],
+                                   sl2, _sl1, std::min (DWT_PANEL, sl1 - p * DWT_PANEL), panel);
+                    }
+
+# pragma omp for
+                    // loop over panels of lines along third dimension ('third') per row
+                    for (int c = 0; c < nv * sl2 * np; c++) {
+                        const int p = c % np, r = c / np;
+                        downpanel (& res [(size_t)(r / sl2) * vol + (r % sl2) * _sl1 + p * DWT_PANEL],
+                                   sl3, _ld12, std::min (DWT_PANEL, sl1 - p * DWT_PANEL), panel);
+                    }
+
+                    // reduce dimensions for next level
+                    sl1 /= 2;
+                    sl2 /= 2;
+                    sl3 /= 2;
+
+                } // loop over levels of DWT
+
+            } // omp parallel
+
+        }
+
+
+        /**
+         * @brief       Perform inverse DWT (periodic boundaries) on 2D data.
+         *              Vectorised along second dimension. All images of
+         *              the matrix (sl1 x sl2 x ...) are transformed at once.
+         *
+         * @param  wc   Wavelet presentation of 2D data.
+         * @param  img  Reconstructed signal.
+         */
+        inline void
+        idpwt2v     (const Matrix <T> & wc, Matrix <T> & img) NOEXCEPT {
+
+            // assign dwt to result image
+            img = wc;
+
+            // # of images / volumes
+            const int nv = img.Size() / (_ld12 * _sl3);
+
+# pragma omp parallel default (shared) num_threads (_num_threads)
+            {
+
+                int sl1 = _sl1_scale,
+                    sl2 = _sl2_scale;
+                const int t_num = omp_get_thread_num ();
+                T * tmp, * panel = & _panel [t_num * _panel_size];
+
+                // loop over levels of backwards DWT
+                for (int j = _min_level; j < _max_level; j++) {
+
+                    const int np = (2 * sl1 + DWT_PANEL - 1) / DWT_PANEL;
+
+# pragma omp for
+                    // loop over panels of lines along second dimension ('rows') of all images
+                    for (int c = 0; c < nv * np; c++) {
+                        const int p = c % np;
+                        uppanel (& img [(size_t)(c / np) * _ld12 + p * DWT_PANEL], sl2, _sl1,
+                                 std::min (DWT_PANEL, 2 * sl1 - p * DWT_PANEL), panel);
+                    }
+
+                    tmp = & _temp [5 * sl1 * t_num];
+
+# pragma omp for
+                    // loop  over lines along first dimension ('columns') of all images
+                    for (int c = 0; c < nv * 2 * sl2; c++)
+                        upline (& img [(size_t)(c / (2 * sl2)) * _ld12 + (c % (2 * sl2)) * _sl1],
+                                sl1, tmp);
+
+                    // update current row / column size
+                    sl2 *= 2;
+                    sl1 *= 2;
+
+                } // loop over levels of backwards DWT
+
+            } // omp parallel
+
+        }
+
+
+        /**
+         * @brief       Perform inverse DWT (periodic boundaries) on 3D data.
+         *              Vectorised along second and third dimension. All
+         *              volumes of the matrix (sl1 x sl2 x sl3 x ...) are
+         *              transformed at once.
+         *
+         * @param  wc   Wavelet presentation of 3D data.
+         * @param  img  Reconstructed signal.
+         */
+        inline void
+        idpwt3v     (const Matrix <T> & wc, Matrix <T> & img) NOEXCEPT {
+
+            // assign dwt to result image
+            img = wc;
+
+            // # of images / volumes
+            const int nv = img.Size() / (_ld12 * _sl3);
+            const size_t vol = (size_t)_ld12 * _sl3;
+
+# pragma omp parallel default (shared) num_threads (_num_threads)
+            {
+
+                int sl1 = _sl1_scale,
+                    sl2 = _sl2_scale,
+                    sl3 = _sl3_scale;
+                const int t_num = omp_get_thread_num ();
+                T * tmp, * panel = & _panel [t_num * _panel_size];
+
+                // loop over levels of backwards DWT
+                for (int j = _min_level; j < _max_level; j++) {
+
+                    const int np = (2 * sl1 + DWT_PANEL - 1) / DWT_PANEL;
+
+# pragma omp for
+                    // loop over panels of lines along third dimension ('third') per row
+                    for (int c = 0; c < nv * 2 * sl2 * np; c++) {
+                        const int p = c % np, r = c / np;
+                        uppanel (& img [(size_t)(r / (2 * sl2)) * vol + (r % (2 * sl2)) * _sl1 + p * DWT_PANEL],
+                                 sl3, _ld12, std::min (DWT_PANEL, 2 * sl1 - p * DWT_PANEL), panel);
+                    }
+
+# pragma omp for
+                    // loop over panels of lines along second dimension ('rows') per slice
+                    for (int c = 0; c < nv * 2 * sl3 * np; c++) {
+                        const int p = c % np, s = c / np;
+                        uppanel (& img [(size_t)(s / (2 * sl3)) * vol + (s % (2 * sl3)) * _ld12 + p * DWT_PANEL],
+                                 sl2, _sl1, std::min (DWT_PANEL, 2 * sl1 - p * DWT_PANEL), panel);
+                    }
+
+                    tmp = & _temp [5 * sl1 * t_num];
+
+# pragma omp for
+                    // loop  over lines along first dimension ('columns') of all volumes
+                    for (int c = 0; c < nv * 2 * sl3 * 2 * sl2; c++)
+                        upline (& img [(size_t)(c / (4 * sl2 * sl3)) * vol + ((c / (2 * sl2)) % (2 * sl3)) * _ld12
+                                       + (c % (2 * sl2)) * _sl1], sl1, tmp);
+
+                    // update current row / column size
+                    sl2 *= 2;
+                    sl1 *= 2;
+                    sl3 *= 2;
+
+                } // loop over levels of backwards DWT
+
+            } // omp parallel
+
+        }
+
+
+        /**
+         * @brief       One level forward transform of a contiguous line in place.
+         *
+         * @param  line Line.
+         * @param  n    Side length of current level.
+         * @param  tmp  Temporary memory (n).
+         */
+        inline void
+        downline    (T * const line, const int n, T * const tmp) NOEXCEPT {
+            copydouble (line, tmp, n);
+            downlo (tmp, n, line);
+            downhi (tmp, n, line + n / 2);
+        }
+
+
+        /**
+         * @brief       One level inverse transform of a contiguous line in place.
+         *
+         * @param  line Line (n lowpass followed by n highpass coefficients).
+         * @param  n    # of lowpass coefficients.
+         * @param  tmp  Temporary memory (5n).
+         */
+        inline void
+        upline      (T * const line, const int n, T * const tmp) NOEXCEPT {
+            uplo (line, n, tmp + n);
+            uphi (line + n, n, tmp + 3 * n);
+            adddouble (tmp + n, tmp + 3 * n, 2 * n, line);
+        }
+
+
+        /**
+         * @brief       One level forward transform of w adjacent lines along a
+         *              strided dimension in place. Rows are copied to the panel
+         *              contiguously and each output row is filtered at once.
+         *
+         * @param  sig   First element of first line.
+         * @param  n     Side length of current level.
+         * @param  ld    Distance of successive line elements.
+         * @param  w     # of lines (<= DWT_PANEL).
+         * @param  panel Temporary memory (n * w).
+         */
+        inline void
+        downpanel   (T * const sig, const int n, const size_t ld, const int w,
+                     T * const panel) const NOEXCEPT {
+
+            const size_t m = w * sizeof(T) / sizeof(RT);
+            const RT * rows [8];
+            const RT * t = (const RT *) panel;
+
+            for (int k = 0; k < n; k++)
+                copydouble (sig + k * ld, panel + k * w, w);
+
+            for (int i = 0; i < n / 2; i++) {
+                for (int h = 0; h < _fl; h++)
+                    rows [h] = t + ((2 * i + h) % n) * m;
+                fir (rows, _lpf_d, _fl, (RT *) (sig + i * ld), m);
+                for (int h = 0; h < _fl; h++)
+                    rows [h] = t + ((2 * i + 1 - h + n) % n) * m;
+                fir (rows, _hpf_d, _fl, (RT *) (sig + (n / 2 + i) * ld), m);
+            }
+
+        }
+
+
+        /**
+         * @brief       One level inverse transform of w adjacent lines along a
+         *              strided dimension in place.
+         *
+         * @param  sig   First element of first line.
+         * @param  n     # of lowpass coefficients (2n rows are reconstructed).
+         * @param  ld    Distance of successive line elements.
+         * @param  w     # of lines (<= DWT_PANEL).
+         * @param  panel Temporary memory (2n * w).
+         */
+        inline void
+        uppanel     (T * const sig, const int n, const size_t ld, const int w,
+                     T * const panel) const NOEXCEPT {
+
+            const size_t m = w * sizeof(T) / sizeof(RT);
+            const RT * lo [4], * hi [4];
+            const RT * t = (const RT *) panel;
+
+            for (int k = 0; k < 2 * n; k++)
+                copydouble (sig + k * ld, panel + k * w, w);
+
+            for (int i = 0; i < n; i++) {
+                for (int h = 0; h < _modd; h++) {
+                    lo [h] = t + ((i - h + n) % n) * m;
+                    hi [h] = t + (n + (i + h) % n) * m;
+                }
+                fir2 (lo, _lpf_r,     hi, _hpf_r + 1, _modd, (RT *) (sig + 2 * i * ld), m);
+                fir2 (lo, _lpf_r + 1, hi, _hpf_r,     _modd, (RT *) (sig + (2 * i + 1) * ld), m);
+            }
+
+        }
+
+
+        /**
+         * @brief       out = sum_h f[h] rows[h] over m reals.
+         *              Same order of operations as the scalar convolutions.
+         */
+        inline static void
+        fir         (const RT * const * rows, const RT * const f, const int nf,
+                     RT * const out, const size_t m) NOEXCEPT {
+
+            typedef typename VecTraits<RT>::reg_type reg_type;
+            const size_t stride = VecTraits<RT>::stride;
+            size_t x = 0;
+
+            for (; x + stride <= m; x += stride) {
+                reg_type s = VecTraits<RT>::setp (0.);
+                for (int h = 0; h < nf; h++)
+                    s = VecTraits<RT>::plus (s, VecTraits<RT>::multiplies (
+                        VecTraits<RT>::setp (f [h]), VecTraits<RT>::loadu (rows [h] + x)));
+                VecTraits<RT>::storeu (out + x, s);
+            }
+
+            for (; x < m; x++) {
+                RT s = 0.;
+                for (int h = 0; h < nf; h++)
+                    s += f [h] * rows [h] [x];
+                out [x] = s;
+            }
+
+        }
+
+
+        /**
+         * @brief       out = sum_h fa[2h] a[h] + sum_h fb[2h] b[h] over m reals,
+         *              i.e. lowpass plus highpass reconstruction with polyphase
+         *              components of the reconstruction filters.
+         */
+        inline static void
+        fir2        (const RT * const * a, const RT * const fa,
+                     const RT * const * b, const RT * const fb, const int nf,
+                     RT * const out, const size_t m) NOEXCEPT {
+
+            typedef typename VecTraits<RT>::reg_type reg_type;
+            const size_t stride = VecTraits<RT>::stride;
+            size_t x = 0;
+
+            for (; x + stride <= m; x += stride) {
+                reg_type sa = VecTraits<RT>::setp (0.), sb = sa;
+                for (int h = 0; h < nf; h++) {
+                    sa = VecTraits<RT>::plus (sa, VecTraits<RT>::multiplies (
+                        VecTraits<RT>::setp (fa [2 * h]), VecTraits<RT>::loadu (a [h] + x)));
+                    sb = VecTraits<RT>::plus (sb, VecTraits<RT>::multiplies (
+                        VecTraits<RT>::setp (fb [2 * h]), VecTraits<RT>::loadu (b [h] + x)));
+                }
+                VecTraits<RT>::storeu (out + x, VecTraits<RT>::plus (sa, sb));
+            }
+
+            for (; x < m; x++) {
+                RT sa = 0., sb = 0.;
+                for (int h = 0; h < nf; h++) {
+                    sa += fa [2 * h] * a [h] [x];
+                    sb += fb [2 * h] * b [h] [x];
+                }
+                out [x] = sa + sb;
+            }
+
+        }
+
 };
 
 
+# if defined (__clang__)
+#  pragma float_control (pop)
+# elif defined (__GNUC__)
+#  pragma GCC pop_options
+# endif
+
+
 # endif // __DWT_HPP__
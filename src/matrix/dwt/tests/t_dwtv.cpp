@@ -0,0 +1,108 @@
+#include "Matrix.hpp"
+#include "Creators.hpp"
+#include "DWT.hpp"
+#include "OMP.hpp"
+
+template<class T> inline static double maxdiff (const Matrix<T>& a, const Matrix<T>& b) {
+    double d = 0.;
+    for (size_t i = 0; i < a.Size(); ++i)
+        d = std::max (d, (double)std::abs(a[i]-b[i]));
+    return d;
+}
+
+/**
+ * @brief Vectorised against line by line transform, forward and adjoint.
+ *        Both must agree to the last bit.
+ */
+template<class T> inline static int check (const Vector<size_t>& n, wlfamily fam, int mem,
+                                           int scale, size_t reps) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    const size_t sl3 = (n.size() > 2) ? n[2] : 1;
+    Matrix<T> x = randn<T>(n), a, b, c, d;
+    DWT<T> vw (n[0], n[1], sl3, fam, mem, scale), sw (n[0], n[1], sl3, fam, mem, scale);
+    sw.Vectorise (false);
+    if (!vw.Vectorised())
+        return 1;
+
+    a = vw * x; c = vw ->* a;
+    b = sw * x; d = sw ->* b;
+    RT tol = 1.e-3 * std::sqrt ((double)x.Size());
+    int ret = (maxdiff (a, b) == 0. && maxdiff (c, d) == 0. && maxdiff (c, x) < tol) ? 0 : 1;
+
+    double t0 = omp_get_wtime();
+    for (size_t i = 0; i < reps; ++i) {
+        sw.Trafo (x, b); sw.Adjoint (b, d);
+    }
+    double ts = omp_get_wtime() - t0;
+    t0 = omp_get_wtime();
+    for (size_t i = 0; i < reps; ++i) {
+        vw.Trafo (x, a); vw.Adjoint (a, c);
+    }
+    double tv = omp_get_wtime() - t0;
+
+    printf ("  %s %s WL(%d,%d): %s dpwt %.4fs vectorised %.4fs speedup %.2f\n",
+            TypeTraits<T>::Name().c_str(), (sl3 > 1) ? "3D" : "2D", fam, mem, ret ? "FAILED" : "OK",
+            ts/reps, tv/reps, ts/tv);
+    return ret;
+
+}
+
+/**
+ * @brief Batched transform of frames against frame by frame transforms
+ */
+template<class T> inline static int batch (const Vector<size_t>& n, const size_t& dims, bool vec,
+                                           size_t reps) {
+
+    const size_t sl3 = (dims > 2) ? n[2] : 1;
+    size_t vol = n[0]*n[1]*sl3, nv = 1;
+    for (size_t i = dims; i < n.size(); ++i)
+        nv *= n[i];
+    Matrix<T> x = randn<T>(n), a, b = x, c, d = x, f (n[0], n[1], sl3), g;
+    DWT<T> dwt (n[0], n[1], sl3, WL_DAUBECHIES, 4, 3);
+    dwt.Vectorise (vec);
+
+    a = dwt * x; c = dwt ->* a;
+    double t0 = omp_get_wtime();
+    for (size_t i = 0; i < reps; ++i) {
+        dwt.Trafo (x, a); dwt.Adjoint (a, c);
+    }
+    double tb = omp_get_wtime() - t0;
+
+    t0 = omp_get_wtime();
+    for (size_t r = 0; r < reps; ++r)
+        for (size_t i = 0; i < nv; ++i) {
+            std::copy (x.Begin() + i*vol, x.Begin() + (i+1)*vol, f.Begin());
+            g = dwt * f;
+            std::copy (g.Begin(), g.End(), b.Begin() + i*vol);
+            g = dwt ->* g;
+            std::copy (g.Begin(), g.End(), d.Begin() + i*vol);
+        }
+    double tf = omp_get_wtime() - t0;
+
+    int ret = (maxdiff (a, b) == 0. && maxdiff (c, d) == 0.) ? 0 : 1;
+    printf ("  %s %zuD x %zu %s: %s frame by frame %.4fs batched %.4fs speedup %.2f\n",
+            TypeTraits<T>::Name().c_str(), dims, nv, vec ? "vectorised" : "dpwt", ret ? "FAILED" : "OK",
+            tf/reps, tb/reps, tf/tb);
+    return ret;
+
+}
+
+int main (int args, char** argv) {
+    int ret = 0;
+    Vector<size_t> n2 (2, 128), n3 (3, 32);
+    int fams[] = {WL_HAAR, WL_DAUBECHIES, WL_DAUBECHIES}, mems[] = {2, 4, 8};
+    for (size_t i = 0; i < 3; ++i) {
+        ret += check<float>(n2, (wlfamily)fams[i], mems[i], 4, 5);
+        ret += check<cxfl> (n2, (wlfamily)fams[i], mems[i], 4, 5);
+        ret += check<cxdb> (n2, (wlfamily)fams[i], mems[i], 3, 5);
+        ret += check<cxfl> (n3, (wlfamily)fams[i], mems[i], 3, 2);
+        ret += check<double>(n3, (wlfamily)fams[i], mems[i], 3, 2);
+    }
+    Vector<size_t> n4 (4, 64), n5 (5, 16);
+    n4[2] = 8; n4[3] = 3; n5[3] = 4; n5[4] = 2;
+    ret += batch<cxfl> (n4, 2, true, 2) + batch<cxfl> (n4, 2, false, 2);
+    ret += batch<cxfl> (n5, 3, true, 2) + batch<cxfl> (n5, 3, false, 2);
+    return ret;
+}
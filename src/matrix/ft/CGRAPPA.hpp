@@ -111,15 +111,10 @@ public:
 
 
 // Parallelisation
-        if (p.exists("nthreads")) {
-            m_nthreads = unsigned_cast(p["nthreads"]);
-            omp_set_num_threads(m_nthreads);
-        } else {
-#pragma omp parallel default (shared)
-            {
-                m_nthreads = omp_get_num_threads();
-            }
-        }
+        if (p.exists("nthreads"))
+            m_nthreads = ExecutionContext::Instance().Workers(unsigned_cast(p["nthreads"]));
+        else
+            m_nthreads = ExecutionContext::Instance().Threads();
         std::cout << "  # threads: " << m_nthreads << std::endl;
 
         CalcCalibMatrix();
@@ -140,7 +135,7 @@ virtual
     Adjoint (const Matrix<T>& kspace) const NOEXCEPT {
 
         Matrix<T> res = kspace;
-#pragma omp parallel for default (shared)
+#pragma omp parallel for default (shared) num_threads (m_nthreads)
         for (int coil = 0; coil < (int)m_nc; ++coil)
             Slice(res, coil, ARC(kspace,coil));
         return res;
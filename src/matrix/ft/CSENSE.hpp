@@ -117,9 +117,7 @@ public:
 				dims[2]*af[2] : 1, (compgfm) ? 2 : 1);
 		Matrix<T> tmp = m;
 
-		omp_set_num_threads(nthreads);
-
-#pragma omp parallel
+#pragma omp parallel num_threads (nthreads)
 		{
 			
 			int tid = omp_get_thread_num ();
@@ -268,11 +266,10 @@ private:
 		if (params.exists("nthreads"))
 			nthreads = params.Get<unsigned short>("nthreads");
 
-		if (nthreads == 1)
-#pragma omp parallel default (shared)
-			{
-				nthreads = omp_get_num_threads ();
-			}
+		if (nthreads <= 1)
+			nthreads = ExecutionContext::Instance().Threads();
+		else
+			nthreads = ExecutionContext::Instance().Workers(nthreads);
 
 		printf ("  allocating %d " JL_SIZE_T_SPECIFIER "-dim ffts ... ", nthreads, ndim);
 		fflush (stdout);
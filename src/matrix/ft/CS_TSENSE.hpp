@@ -27,6 +27,8 @@
 #include "NLCG.hpp"
 #include "LBFGS.hpp"
 #include "SplitBregman.hpp"
+#include "ADMM.hpp"
+#include "FISTA.hpp"
 #include "TVOP.hpp"
 
 #include "Workspace.hpp"
@@ -36,7 +38,7 @@
 
 enum CS_EXCEPTION {UNDEFINED_FT_OPERATOR, UNDEFINED_OPTIMISATION_ALGORITHM};
 
-const char* nlopt_names[] = {"NLCG", "L-BFGS", "Split Bregman"};
+const char* nlopt_names[] = {"NLCG", "L-BFGS", "Split Bregman", "ADMM", "FISTA"};
 
     using namespace codeare::optimisation;
 
@@ -117,6 +119,12 @@ public:
         case 2: // Split-Bregman
             nlopt = (NonLinear<T>*) new SplitBregman<T> (p);
             break;
+        case 3: // ADMM
+            nlopt = (NonLinear<T>*) new ADMM<T> (p);
+            break;
+        case 4: // FISTA
+            nlopt = (NonLinear<T>*) new FISTA<T> (p);
+            break;
         default:
             printf ("**ERROR - CS_TSENSE: Invalid or unspecified optimisation algorithm\n");
             throw UNDEFINED_OPTIMISATION_ALGORITHM;
@@ -222,26 +230,51 @@ public:
     virtual FT<T>* getFT () {
         return ft;
     }
+
+    virtual NonLinear<T>* getNLOpt () {
+        return nlopt;
+    }
+
+
+    /**
+     * @brief Splitting for proximal solvers: E = F, L1 terms: TV
+     */
+    inline virtual Matrix<T> NormalData (const Matrix<T>& x) const {
+        return *ft ->* (*ft * x);
+    }
+
+    inline virtual Matrix<T> AdjointData () const {
+        return *ft ->* data;
+    }
+
+    inline virtual size_t Terms () const {
+        return (_tvw[0] ? 1 : 0) + (_tvw[1] ? 1 : 0);
+    }
+
+    inline virtual RT TermWeight (const size_t& i) const {
+        return _tvw[Term(i)];
+    }
+
+    inline virtual RT TermNorm (const size_t& i) const {
+        size_t k = Term(i);
+        return 4. * (tvt[k]->Components() ? tvt[k]->Components() : _dim);
+    }
+
+    inline virtual Matrix<T> Sparse (const size_t& i, const Matrix<T>& x) const {
+        return tvt[Term(i)]->Trafo (x);
+    }
+
+    inline virtual Matrix<T> SparseAdjoint (const size_t& i, const Matrix<T>& y) const {
+        return tvt[Term(i)]->Adjoint (y);
+    }
     
     inline virtual RT obj (const Matrix<T>& x, const Matrix<T>& dx, const RT& t, RT& rmse) const {
         RT obj = Obj (x,dx,t), objtv1 = 0, objtv2 = 0;
         rmse = sqrt(obj/_ndnz);
-#pragma omp parallel num_threads(2)
-        {
-            size_t tn = omp_get_thread_num();
-            switch (tn)
-        	{
-        	case 0:
-        		if (_tvw[tn])
-        			objtv1 = TV (x,dx,t,tn);
-        		break;
-        	case 1:
-        		if (_tvw[tn])
-        			objtv2 = TV (x,dx,t,tn);
-        		break;
-        	default: break;
-        	}
-        }
+        if (_tvw[0])
+            objtv1 = TV (x,dx,t,0);
+        if (_tvw[1])
+            objtv2 = TV (x,dx,t,1);
         return obj + objtv1 + objtv2;
     }
     
@@ -257,6 +290,13 @@ public:
     }
 
 private:
+
+    /**
+     * @brief TV of L1 term i
+     */
+    inline size_t Term (const size_t& i) const {
+        return (i == 0 && _tvw[0]) ? 0 : 1;
+    }
     
     inline RT Obj (const Matrix<T>& x, const Matrix<T>& dx, const RT& t) const {
         Matrix<T> w = *ft * (x + t*dx) - data; 
@@ -264,12 +304,7 @@ private:
     }
     
     inline RT TV  (const Matrix<T>& x, const Matrix<T>& dx, const RT& t, size_t i) const {
-        RT o = 0.;
-        Matrix<T> w = *tvt[i] * (x + t*dx);
-        w = (w*conj(w)+_l1)^.5;
-        for (size_t i = 0; i < w.Size(); i++)
-            o += real(w[i]);
-        return _tvw[i] * o;
+        return _tvw[i] * tvt[i]->Norm (x, dx, t, _l1, 1.);
     }
     
     /**
@@ -288,8 +323,7 @@ private:
      * @param  cgp Parameters
      */
     inline Matrix<T> dTV (const Matrix<T>& x, const size_t& i) const {
-        Matrix<T> w = *tvt[i] * x;
-        return _tvw[i] * (*tvt[i]) ->* (w * ((w*conj(w)+_l1)^(-.5)));
+        return _tvw[i] * tvt[i]->Gradient (x, _l1, 1.);
     }
     
 
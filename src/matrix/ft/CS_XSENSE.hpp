@@ -29,6 +29,8 @@
 #include "NLCG.hpp"
 #include "LBFGS.hpp"
 #include "SplitBregman.hpp"
+#include "ADMM.hpp"
+#include "FISTA.hpp"
 #include "DWT.hpp"
 #include "TVOP.hpp"
 
@@ -39,7 +41,7 @@
 
 enum CS_EXCEPTION {UNDEFINED_FT_OPERATOR, UNDEFINED_OPTIMISATION_ALGORITHM};
 
-const char* nlopt_names[] = {"NLCG", "L-BFGS", "Split Bregman"};
+const char* nlopt_names[] = {"NLCG", "L-BFGS", "Split Bregman", "ADMM", "FISTA"};
 
     using namespace codeare::optimisation;
 
@@ -125,6 +127,12 @@ public:
         case 2: // Split-Bregman
             nlopt = (NonLinear<T>*) new SplitBregman<T> (p);
             break;
+        case 3: // ADMM
+            nlopt = (NonLinear<T>*) new ADMM<T> (p);
+            break;
+        case 4: // FISTA
+            nlopt = (NonLinear<T>*) new FISTA<T> (p);
+            break;
         default:
             printf ("**ERROR - CS_XSENSE: Invalid or unspecified optimisation algorithm\n");
             throw UNDEFINED_OPTIMISATION_ALGORITHM;
@@ -139,7 +147,8 @@ public:
             _wf = -1;
 
         if (_wf>-1)
-            dwt = new DWT<T> (_image_size[0], (wlfamily)_wf, _wm);
+            dwt = new DWT<T> (_image_size[0], (_dim > 1) ? _image_size[1] : _image_size[0],
+                              (wlfamily)_wf, _wm);
 
         tvt.push_back(new TVOP<T>(_tvv[0]));
         tvt.push_back(new TVOP<T>(_tvv[1]));
@@ -196,28 +205,34 @@ public:
     
 
     inline virtual RT obj (const Matrix<T>& x, const Matrix<T>& dx, const RT& t, RT& rmse) const {
-        RT obj = Obj (t), objtv1 = 0, objtv2 = 0, objxfm = 0;
-        rmse = sqrt(obj/_ndnz);
-#pragma omp parallel num_threads(3)
-        {
-        switch (omp_get_thread_num())
-        	{
-        	case 0:
-        		if (_tvw[0])
-        			objtv1 = TV (t,0);
-        		break;
-        	case 1:
-        		if (_tvw[1])
-        			objtv2 = TV (t,1);
-        		break;
-            case 2:
-                if (_xfmw)
-                    objxfm = XFM (x, dx, t);
-                break;
-        	default: break;
-        	}
+        Vector<RT> r;
+        RT f = obj (x, dx, Vector<RT>(1,t), r)[0];
+        rmse = r[0];
+        return f;
+    }
+
+    /**
+     * @brief Objective at all step sizes t_i in one pass over the cached
+     *        projections F w(x), F w(dx) and the sparse/TV images
+     */
+    inline virtual Vector<RT> obj (const Matrix<T>& x, const Matrix<T>& dx, const Vector<RT>& t,
+                                   Vector<RT>& rmse) const {
+        Vector<RT> f = Obj (t), g;
+        rmse.resize(t.size());
+        for (size_t i = 0; i < t.size(); ++i)
+            rmse[i] = sqrt(f[i]/_ndnz);
+        for (size_t k = 0; k < 2; ++k)
+            if (_tvw[k]) {
+                g = TV (t,k);
+                for (size_t i = 0; i < t.size(); ++i)
+                    f[i] += g[i];
+            }
+        if (_xfmw) {
+            g = XFM (x, dx, t);
+            for (size_t i = 0; i < t.size(); ++i)
+                f[i] += g[i];
         }
-        return obj + objtv1 + objtv2 + objxfm;
+        return f;
     }
     
 
@@ -237,24 +252,6 @@ public:
         wdx =  (dwt) ? *dwt->*dx : dx;
         ffdbx = *ft * wx;
         ffdbg = *ft * wdx;
-        if (_tvw[0]) {
-            if (ttdbx.size() == 0) {
-                ttdbx.push_back(*tvt[0] * wx);
-                ttdbg.push_back(*tvt[0] * wdx);
-            } else {
-                ttdbx[0] = *tvt[0] * wx;
-                ttdbg[0] = *tvt[0] * wdx;
-            }
-        } 
-        if (_tvw[1]) {
-            if (ttdbx.size() == 1) {
-                ttdbx.push_back(*tvt[1] * wx);
-                ttdbg.push_back(*tvt[1] * wdx);
-            } else {
-                ttdbx[1] = *tvt[1] * wx;
-                ttdbg[1] = *tvt[1] * wdx;
-            }
-        } 
     }
 
 	virtual std::ostream& Print (std::ostream& os) const {
@@ -331,43 +328,129 @@ public:
     virtual FT<T>* getFT () {
         return ft;
     }
+
+    virtual NonLinear<T>* getNLOpt () {
+        return nlopt;
+    }
+
+
+    /**
+     * @brief Splitting for proximal solvers: E = F W^H, L1 terms: sparse
+     *        transform (identity on x) and TV of W^H x
+     */
+    inline virtual Matrix<T> NormalData (const Matrix<T>& x) const {
+        if (dwt)
+            return *dwt * (*ft ->* (*ft * (*dwt ->* x)));
+        else
+            return *ft ->* (*ft * x);
+    }
+
+    inline virtual Matrix<T> AdjointData () const {
+        return (dwt) ? *dwt * (*ft ->* data) : *ft ->* data;
+    }
+
+    inline virtual size_t Terms () const {
+        return (_xfmw ? 1 : 0) + (_tvw[0] ? 1 : 0) + (_tvw[1] ? 1 : 0);
+    }
+
+    inline virtual RT TermWeight (const size_t& i) const {
+        int k = Term(i);
+        return (k < 0) ? _xfmw : _tvw[k];
+    }
+
+    inline virtual RT TermNorm (const size_t& i) const {
+        int k = Term(i);
+        return (k < 0) ? 1. : 4. * (tvt[k]->Components() ? tvt[k]->Components() : _dim);
+    }
+
+    inline virtual Matrix<T> Sparse (const size_t& i, const Matrix<T>& x) const {
+        int k = Term(i);
+        if (k < 0)
+            return x;
+        return tvt[k]->Trafo ((dwt) ? *dwt ->* x : x);
+    }
+
+    inline virtual Matrix<T> SparseAdjoint (const size_t& i, const Matrix<T>& y) const {
+        int k = Term(i);
+        if (k < 0)
+            return y;
+        Matrix<T> g = tvt[k]->Adjoint (y);
+        return (dwt) ? *dwt * g : g;
+    }
     
 private:
+
+    /**
+     * @brief L1 term i: -1 sparse transform, 0/1 TV
+     */
+    inline int Term (const size_t& i) const {
+        int n = (int)i;
+        if (_xfmw && n-- == 0)
+            return -1;
+        if (_tvw[0] && n-- == 0)
+            return 0;
+        return 1;
+    }
     
-    inline RT Obj (const RT& t) const {
-        Matrix<T> om = ffdbx;
-        if (t > 0.0)
-            om += t * ffdbg;
-        om -= data;
-        return real(om.dotc(om));
+    /**
+     * @brief Data consistency ||F w(x + t dx) - b||^2 for all t in one pass.
+     *        Exactly quadratic in t: |a|^2 + 2t Re<a,c> + t^2 |c|^2,
+     *        a = F w(x) - b, c = F w(dx).
+     */
+    inline Vector<RT> Obj (const Vector<RT>& t) const {
+        const T *a = ffdbx.Ptr(), *c = ffdbg.Ptr(), *b = data.Ptr();
+        const long n = (long)data.Size();
+        RT aa = 0., ac = 0., cc = 0.;
+#pragma omp parallel for schedule (static) reduction (+:aa,ac,cc)
+        for (long i = 0; i < n; ++i) {
+            const T r = a[i] - b[i];
+            aa += std::norm(r);
+            ac += std::real(std::conj(r)*c[i]);
+            cc += std::norm(c[i]);
+        }
+        Vector<RT> f (t.size());
+        for (size_t i = 0; i < t.size(); ++i)
+            f[i] = (t[i] > 0.) ? aa + 2.*t[i]*ac + t[i]*t[i]*cc : aa;
+        return f;
     }
     
-    inline RT TV (const RT& t, size_t i) const {
-        RT o = 0.0;
-        Matrix<T> om = ttdbx[i];
-        if (t > 0.0)
-            om += t * ttdbg[i];
-        om *= conj(om);
-        om += _l1;
-        om ^= 0.5*_pnorm;
-#pragma omp parallel for default(shared) schedule(static,16) reduction(+:o)
-        for (size_t i = 0; i < om.Size(); i++)
-            o = o + real(om[i]);
-        return _tvw[i] * o;
+    /**
+     * @brief Smoothed TV norm of w(x+t dx) for all t in one fused pass
+     */
+    inline Vector<RT> TV (const Vector<RT>& t, size_t i) const {
+        Vector<RT> f = tvt[i]->Norm (wx, wdx, t, _l1, _pnorm);
+        for (size_t j = 0; j < f.size(); ++j)
+            f[j] *= _tvw[i];
+        return f;
     }
     
-    inline RT XFM (const Matrix<T>& x, const Matrix<T>& g, const RT& t) const {
-        RT o = 0.;
-        Matrix<T> om = x;
-        if (t > 0.0)
-            om += t * g;
-        om *= conj(om);
-        om += _l1;
-        om ^= 0.5*_pnorm;
-#pragma omp parallel for default(shared) schedule(static,16) reduction(+:o)
-        for (size_t i = 0; i < om.Size(); i++)
-            o = o + real(om[i]);
-        return _xfmw * o;
+    /**
+     * @brief Smoothed L_p norm of x + t dx for all t in one pass
+     */
+    inline Vector<RT> XFM (const Matrix<T>& x, const Matrix<T>& g, const Vector<RT>& t) const {
+        const size_t nt = t.size();
+        const long n = (long)x.Size();
+        const T *a = x.Ptr(), *d = (g.Size() == x.Size()) ? g.Ptr() : a;
+        const RT hp = 0.5*_pnorm;
+        Vector<RT> ts (nt), o (nt, (RT)0.);
+        for (size_t i = 0; i < nt; ++i)
+            ts[i] = (t[i] > 0. && d != a) ? t[i] : (RT)0.;
+#pragma omp parallel
+        {
+            Vector<RT> acc (nt, (RT)0.);
+#pragma omp for schedule (static)
+            for (long j = 0; j < n; ++j)
+                for (size_t i = 0; i < nt; ++i) {
+                    const RT q = std::norm(a[j] + ts[i]*d[j]) + _l1;
+                    acc[i] += (_pnorm == 1.) ? sqrt(q) : pow(q, hp);
+                }
+#pragma omp critical
+            for (size_t i = 0; i < nt; ++i)
+                o[i] += acc[i];
+        }
+        for (size_t i = 0; i < nt; ++i)
+            o[i] *= _xfmw;
+        return o;
     }
     
     
@@ -402,14 +485,9 @@ private:
      * @param  cgp Parameters
      */
     inline Matrix<T> dTV (const Matrix<T>& x, const size_t& i) const {
-        Matrix<T> dx, g;
-        dx = *tvt[i] * wx;
-        g  = dx * conj(dx);
-        g += _l1;
-        g ^= 0.5*_pnorm-1.0;
-        g *= dx;
-        g *= _pnorm;
-        g  = (dwt) ? *dwt * (*(tvt[i])->*g) : *(tvt[i])->*g;
+        Matrix<T> g = tvt[i]->Gradient (wx, _l1, _pnorm);
+        if (dwt)
+            g = *dwt * g;
         return (_tvw[i] * g);
     }
     
@@ -426,7 +504,6 @@ private:
     mutable RT _ndnz;
     int _verbose, _ft_type, _csiter, _wf, _wm, _nlopt_type, _dim;
     Matrix<T> ffdbx, ffdbg, wx, wdx;
-    Vector<Matrix<T> > ttdbx, ttdbg;
     mutable Matrix<T> data;
 
     
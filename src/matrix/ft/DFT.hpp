@@ -25,49 +25,31 @@
 #include "Algos.hpp"
 #include "FT.hpp"
 #include "FFTWTraits.hpp"
+#include "FFTN.hpp"
 
 #include <iterator>
 #include "Access.hpp"
 
-template<class T> inline static Matrix<T> fftshift (const Matrix<T>& in, const size_t& dim,
-		bool fwd) NOEXCEPT {
-
+/**
+ * @brief         (Inverse) FFT shift along dimension dim in place
+ *
+ * @param  m      Matrix
+ * @param  dim    Dimension
+ * @param  fwd    fftshift (true) or ifftshift (false)
+ */
+template<class T> inline static void fftshift_inplace (Matrix<T>& m, const size_t& dim,
+		bool fwd = true) NOEXCEPT {
 	typedef typename TypeTraits<T>::RT RT;
-	size_t howmany;
-	Matrix<T> ret, tmp;
-	Vector<size_t> order;
-	size_t cent, ndims, n;
-
-	if (dim > 0) {
-		Vector<size_t> in_dims = size(in);
-		ndims = numel(in_dims);
-		assert(ndims>=dim);
-		for (size_t i = 0; i < ndims; ++i)
-			order.push_back(i);
-		order.erase(order.begin()+dim);
-		order.insert(order.begin(), dim);
-		ret = permute (in, order);
-		in_dims.erase(in_dims.begin()+dim);
-	} else {
-		ret = in;
-	}
-
-	howmany = numel(in)/size(in,0);
-	n = size(ret,0);
-	cent = (fwd) ? round((RT)n/2) : floor((RT)n/2);
-	for (auto i = ret.Begin(); i < ret.End(); i += size(ret,0))
-		std::rotate(i, i+cent, i+n);
-
-	if (dim > 0) {
-		for (size_t i = 0; i < ndims; ++i)
-			order[i] = i;
-		order.erase(order.begin());
-		order.insert(order.begin()+dim, 0);
-		return permute (ret, order);
-	} else {
-		return ret;
-	}
+	assert (dim < ndims(m));
+	const size_t n = size(m,dim), cent = (fwd) ? round((RT)n/2) : floor((RT)n/2);
+	codeare::matrix::rotate (m.Ptr(), size(m), dim, cent % n);
+}
 
+template<class T> inline static Matrix<T> fftshift (const Matrix<T>& in, const size_t& dim,
+		bool fwd) NOEXCEPT {
+	Matrix<T> ret = in;
+	fftshift_inplace (ret, dim, fwd);
+	return ret;
 }
 
 template<class T> inline static Matrix<T>
@@ -78,82 +60,81 @@ template<class T> inline static Matrix<T>
 ifftshift (const Matrix<T>& in, const size_t& dim = 0) NOEXCEPT {
 	return fftshift(in, dim, false);
 }
+template<class T> inline static Matrix<T> fftshift (const View<T,true>& in, const size_t& dim,
+		bool fwd) NOEXCEPT {
+	typedef typename TypeTraits<T>::RT RT;
+	size_t n = in.Dim(dim), cent = (fwd) ? round((RT)n/2) : floor((RT)n/2);
+	Matrix<T> ret (in.Dim());
+	in.Rotated(dim, cent).Pull(ret.Ptr(), codeare::view::assign());
+	return ret;
+}
 template<class T> inline static Matrix<T>
 fftshift (const View<T,true>& in, const size_t& dim = 0) NOEXCEPT {
-	Matrix<T> inn = in;
-	return fftshift(inn, dim, true);
+	return fftshift(in, dim, true);
 }
 template<class T> inline static Matrix<T>
 ifftshift (const View<T,true>& in, const size_t& dim = 0) NOEXCEPT {
-	Matrix<T> inn = in;
-	return fftshift(inn, dim, false);
+	return fftshift(in, dim, false);
 }
 
 
+/**
+ * @brief         Centred (shift) FFT along dimension dim (strided, in place on copy)
+ *
+ * @param  in     Data
+ * @param  dim    Dimension
+ * @param  shift  ifftshift before and fftshift after transform
+ * @param  fwd    Forward (true) or backward (false)
+ * @return        Transform
+ */
 template<class T> inline static Matrix<T> fft (const Matrix<T>& in, size_t dim, bool shift, bool fwd) NOEXCEPT {
 
 	typedef typename TypeTraits<T>::RT RT;
-	Matrix<T> ret, tmp;
-	Vector<size_t> order;
-	size_t ndims;
-
-	if (dim > 0) {
-		Vector<size_t> in_dims = size(in);
-		size_t cent = floor((float)in_dims[dim]/2);
-		ndims = numel(in_dims);
-		assert(ndims>=dim);
-
-		for (size_t i = 0; i < ndims; ++i)
-			order.push_back(i);
-		order.erase(order.begin()+dim);
-		order.insert(order.begin(), dim);
-		ret = permute (in, order);
-		in_dims.erase(in_dims.begin()+dim);
-	} else {
-		ret = in;
-	}
+	assert (dim < ndims(in));
 
-	int n = static_cast<int>(size(ret,0));
-	int n2 = floor((RT)n/2);
-	int howmany = numel(ret)/n;
-
-	if (shift)
-		for (auto os = ret.Begin(); os < ret.End(); os += n)
-			std::rotate(os, os+n2, os+n);
-
-	// 1d-fft
-	typedef typename FTTraits<T>::Plan FTPlan;
-	typedef typename FTTraits<T>::T FTType;
-    FTPlan cp = FTTraits<T>::DFTPlanMany (1, &n, howmany,
-          (FTType*)ret.Ptr(), (FTType*)ret.Ptr(), (fwd) ? FFTW_FORWARD : FFTW_BACKWARD);
-    FTTraits<T>::Execute(cp);
-    FTTraits<T>::Destroy(cp);
-    ret /= n;
-    
-    n2 = round((RT)n/2);
-    if (shift)
-    	for (auto os = ret.Begin(); os < ret.End(); os += n)
-    		std::rotate(os, os+n2, os+n);
-
-	if (dim > 0) {
-		for (size_t i = 0; i < ndims; ++i)
-			order[i] = i;
-		order.erase(order.begin());
-		order.insert(order.begin()+dim, 0);
-		if (fwd)
-			return permute (ret, order)*sqrt((RT)numel(in));
-		else
-			return permute (ret, order);
-	} else {
-		if (fwd)
-			return ret*sqrt((RT)numel(in));
-		else
-			return ret;
-	}
+	Matrix<T> ret = in;
+	const RT n = (RT) size(ret,dim);
+	codeare::matrix::fftn (ret.Ptr(), size(ret), Vector<size_t>(1,dim), shift, fwd,
+		(fwd) ? (RT)(sqrt((RT)numel(in)) / n) : (RT)(1. / n));
 
+	return ret;
 
 }
 
+/**
+ * @brief         Unitary centred FFT along a set of dimensions
+ *
+ * @param  in     Data
+ * @param  axes   Dimensions
+ * @param  shift  ifftshift before and fftshift after transform
+ * @return        Transform
+ */
+template<class T> inline static Matrix<T>
+fftn (const Matrix<T>& in, const Vector<size_t>& axes, bool shift = true) NOEXCEPT {
+	typedef typename TypeTraits<T>::RT RT;
+	Matrix<T> ret = in;
+	size_t n = 1;
+	for (size_t i = 0; i < axes.size(); ++i)
+		n *= size(ret,axes[i]);
+	codeare::matrix::fftn (ret.Ptr(), size(ret), axes, shift, true, (RT)(1. / sqrt((double)n)));
+	return ret;
+}
+/**
+ * @brief         Unitary centred inverse FFT along a set of dimensions
+ *
+ * @see           fftn
+ */
+template<class T> inline static Matrix<T>
+ifftn (const Matrix<T>& in, const Vector<size_t>& axes, bool shift = true) NOEXCEPT {
+	typedef typename TypeTraits<T>::RT RT;
+	Matrix<T> ret = in;
+	size_t n = 1;
+	for (size_t i = 0; i < axes.size(); ++i)
+		n *= size(ret,axes[i]);
+	codeare::matrix::fftn (ret.Ptr(), size(ret), axes, shift, false, (RT)(1. / sqrt((double)n)));
+	return ret;
+}
+
 template<class T> inline static Matrix<typename TypeTraits<T>::CT>
 fft (const Matrix<T>& in, size_t dim = 0, bool shift = true) NOEXCEPT {
 	typedef typename TypeTraits<T>::CT CT;
@@ -168,16 +149,14 @@ template<class T> inline static Matrix<typename TypeTraits<T>::CT>
 fft (const View<T,true>& in, size_t dim = 0, bool shift = true) NOEXCEPT {
 	typedef typename TypeTraits<T>::CT CT;
 	Matrix<CT> inn(size(in));
-	for (size_t i =0; i < numel(inn); ++ i)
-		inn[i] = in[i];
+	in.Pull(inn.Ptr(), codeare::view::assign());
 	return fft(inn, dim, shift, true);
 }
 template<class T> inline static Matrix<typename TypeTraits<T>::CT>
 ifft (const View<T,true>& in, size_t dim = 0, bool shift = true) NOEXCEPT {
 	typedef typename TypeTraits<T>::CT CT;
 	Matrix<CT> inn(size(in));
-	for (size_t i =0; i < numel(inn); ++ i)
-		inn[i] = in[i];
+	in.Pull(inn.Ptr(), codeare::view::assign());
 	return fft(inn, dim, shift, false);
 }
 
@@ -240,7 +219,8 @@ hannwindow (const Matrix<size_t>& size, const T& t) NOEXCEPT {
 
 
 /**
- * @brief Matrix templated 1-3D Discrete Cartesian Fourier transform
+ * @brief Matrix templated N-D Discrete Cartesian Fourier transform<br/>
+ *        Centred, strided in place transforms (see FFTN.hpp)
  */
 template <class T=std::complex<float> >
 class DFT : public FT<T> {
@@ -297,7 +277,7 @@ public:
 	}
 
 	DFT        (const Params& p) NOEXCEPT :
-		FT<T>::FT(p), m_cs(0), m_N(0), m_in(0), m_have_pc(false), m_zpad(false),
+		FT<T>::FT(p), m_N(0), m_have_pc(false), m_zpad(false),
 		m_initialised(false), m_have_mask(false), m_threads(1) {
 
 		size_t rank;
@@ -365,7 +345,6 @@ public:
 
 
 		m_N = ft.m_N;
-		m_cs = ft.m_cs;
 
 		m_sn = ft.m_sn;
         m_threads = ft.m_threads;
@@ -374,7 +353,6 @@ public:
 		m_have_pc=ft.m_have_pc;
 		m_zpad=ft.m_zpad;
 
-		m_in=ft.m_in;
 		d=ft.d;
 		c=ft.c;
 
@@ -441,7 +419,7 @@ public:
 
 
     DFT () NOEXCEPT :
-    	m_cs(0), m_N(0), m_in(0), m_have_pc(false), m_zpad(false),
+    	m_N(0), m_have_pc(false), m_zpad(false),
     	m_initialised(false), m_have_mask(false), m_threads(8){}
     
 	/**
@@ -450,9 +428,7 @@ public:
 	virtual 
 	~DFT        () NOEXCEPT {
 
-		FTTraits<T>::Destroy (m_fwplan);
-		FTTraits<T>::Destroy (m_bwplan);
-		//FTTraits<T>::CleanUp();
+		// Plans are owned by FTPlanCache
 		
 	}
 	
@@ -466,22 +442,21 @@ public:
 	inline virtual Matrix<T>
 	Trafo       (const Matrix<T>& m) const NOEXCEPT {
 		
-		Matrix<T> res = ishift((m_have_pc) ? m * m_pc : m);
-
-		FTTraits<T>::Execute (m_fwplan, (FTT*)&res[0], (FTT*)&res[0]);
+		Matrix<T> res = (m_have_pc) ? m * m_pc : m;
 
-		res = shift(res);
+		codeare::matrix::fftn (res.Ptr(), m_dims, m_axes, true, true, (RT)1 / m_sn, m_threads);
 
 		if (m_have_mask)
 			res *= m_mask;
 		
-		return res / m_sn;
+		return res;
 		
 	}
 	
 	
 	/**
-	 * @brief    Backward transform
+	 * @brief    Backward transform, the adjoint of Trafo: centred like the
+	 *           forward transform (ifftshift before, fftshift after)
 	 *
 	 * @param  m To transform
 	 * @return   Transform
@@ -493,14 +468,12 @@ public:
         if (m_have_mask)
             res *= m_mask;
 
-		FTTraits<T>::Execute (m_bwplan, (FTT*)&res[0], (FTT*)&res[0]);
-
-		res = shift(res);
+		codeare::matrix::fftn (res.Ptr(), m_dims, m_axes, true, false, (RT)1 / m_sn, m_threads);
 
 		if (m_have_pc)
 			res *= m_cpc;
 		
-		return res / m_sn;
+		return res;
 			
 	}
 	
@@ -546,112 +519,23 @@ public:
 
 private:
 
-	inline Matrix<T>
-	shift (const Matrix<T>& m, const bool& fw = true) const NOEXCEPT {
-		switch (ndims(m)) {
-		case  2: return shift2 (m, fw); 
-		case  3: return shift3 (m, fw);
-		default: return shift2 (m, fw);
-		}
-	}
-
-
-	inline Matrix<T>
-	shift3 (const Matrix<T>& m, const bool& fw = true) const NOEXCEPT {
-
-		Matrix<T> res (size(m));
-
-		size_t xi,yi,zi,xs,ys,zs;
-		
-		for (zi = 0; zi < d[2]; zi++) {
-			zs = (zi + c[2]) % d[2];
-			for (yi = 0; yi < d[1]; yi++) {
-				ys = (yi + c[1]) % d[1];
-				for (xi = 0; xi < d[0]; xi++) {
-					xs = (xi + c[0]) % d[0];
-					if (fw)
-						res(xs,ys,zs) = m(xi,yi,zi);
-					else
-						res(xi,yi,zi) = m(xs,ys,zs);
-				}
-			}
-		}
-
-		return res;
-
-	}
-
-	inline Matrix<T>
-	shift2 (const Matrix<T>& m, const bool& fw = true) const NOEXCEPT {
-
-		Matrix<T> res (size(m));
-		size_t xi,yi,xs,ys;
-		
-		for (yi = 0; yi < d[1]; yi++) {
-			ys = (yi + c[1]) % d[1];
-			for (xi = 0; xi < d[0]; xi++) {
-				xs = (xi + c[0]) % d[0];
-				if (fw)
-					res(xs,ys) = m(xi,yi);
-				else
-					res(xi,yi) = m(xs,ys);
-			}
-		}
-
-		return res;
-
-	}
-
-	inline Matrix<T>
-	shift1 (const Matrix<T>& m, const bool& fw = true) const NOEXCEPT {
-
-		Matrix<T> res (size(m));
-		size_t xi,xs;
-
-		for (xi = 0; xi < d[0]; xi++) {
-			xs = (xi + c[0]) % d[0];
-			if (fw)
-				res(xs) = m(xi);
-			else
-				res(xi) = m(xs);
-		}
-
-
-		return res;
-
-	}
-
-
-	inline Matrix<T>
-	ishift(const Matrix<T>& m) const NOEXCEPT {
-
-		switch (ndims(m)) {
-		case  2: return shift2 (m, false); 
-		case  3: return shift3 (m, false);
-		default: return shift2 (m, false);
-		}
-
-	}
-
-
 	/**
-	 * @brief       Allocate RAM and plans
+	 * @brief       Transform geometry (plans come from FTPlanCache on first use)
 	 *
 	 * @param  rank FT rank
-	 * @param  n    Side lengths
+	 * @param  n    Side lengths (row-major)
 	 */
 	inline void
 	Allocate (const int rank, const int* n) NOEXCEPT {
 		
-		m_in     = Vector<T> (m_N);
-
-		m_fwplan = FTTraits<T>::DFTPlan (rank, n, (FTT*)&m_in[0], (FTT*)&m_in[0],
-                FFTW_FORWARD,  FFTW_ESTIMATE | FFTW_DESTROY_INPUT, m_threads);
-		m_bwplan = FTTraits<T>::DFTPlan (rank, n, (FTT*)&m_in[0], (FTT*)&m_in[0],
-                FFTW_BACKWARD, FFTW_ESTIMATE | FFTW_DESTROY_INPUT, m_threads);
+		m_dims.resize (rank);
+		m_axes.resize (rank);
+		for (int i = 0; i < rank; ++i) {
+			m_dims[i] = n[rank-1-i];
+			m_axes[i] = i;
+		}
 
-		m_cs     = m_N * sizeof(FTT);
-		m_sn     = sqrt ((T)m_N);
+		m_sn     = sqrt ((RT)m_N);
 
 	}
 
@@ -663,15 +547,13 @@ private:
 	Matrix<T> m_pc;           /**< @brief Phase correction (applied after inverse and before forward trafos) (double precision)*/
 	Matrix<T> m_cpc;          /**< @brief Phase correction (applied after inverse and before forward trafos) (double precision)*/
 	
-	Plan       m_fwplan;       /**< @brief Forward plan (double precision)*/
-	Plan       m_bwplan;       /**< @brief Backward plan (double precision)*/
+	Vector<size_t> m_dims;     /**< @brief FT side lengths */
+	Vector<size_t> m_axes;     /**< @brief FT dimensions (all of m_dims) */
 
-	size_t     m_cs;
 	size_t     m_N;            /**< @brief # Nodes */
 
-	T          m_sn;
+	RT         m_sn;           /**< @brief Normalisation sqrt(m_N) */
 
-	Vector<T> m_in;           /**< @brief Aligned fftw input*/
 	bool       m_have_mask;    /**< @brief Apply mask?*/
 	bool       m_have_pc;      /**< @brief Apply phase correction?*/
 	bool       m_zpad;         /**< @brief Zero padding? (!!!NOT OPERATIONAL YET!!!)*/
@@ -682,8 +564,6 @@ private:
 
     int m_threads;
 
-	//FTT*      m_in;           /**< @brief Aligned fftw input*/
-
 	
 };
 
@@ -0,0 +1,163 @@
+/*
+ * FFTN.hpp
+ *
+ *  Strided in-place N-dimensional FFT along arbitrary axes
+ */
+
+#ifndef __FFTN_HPP__
+#define __FFTN_HPP__
+
+#include "Matrix.hpp"
+#include "OMP.hpp"
+#include "FFTWTraits.hpp"
+
+#include <cmath>
+
+/**
+ * Any subset of axes is transformed in place by one FFTW guru plan: the
+ * selected axes become FT dimensions, all other non-singleton axes loop
+ * dimensions, with their natural (column-major) strides. No permutation is
+ * needed to bring an axis to the front. Sizes and strides use FFTW's 64-bit
+ * guru interface, so arrays beyond 2^31 elements are addressed correctly.
+ *
+ * Centred transforms (ifftshift before, fftshift after) are folded into
+ * phase ramps. With y(j) = x(j+a) and Z(k) = Y(k+b), a = floor(n/2),
+ * b = ceil(n/2) and w = exp(s 2 pi i/n):
+ *
+ *   Z(k) = w^(-a(k+b)) sum_m [x(m) w^(mb)] w^(mk)
+ *
+ * i.e. one modulation before and one after the transform, which the
+ * scaling rides along with.
+ */
+namespace codeare {
+namespace matrix {
+
+	/**
+	 * @brief   w^q for w = exp(s 2 pi i/n), exact at quarter turns
+	 */
+	template<class T> inline static T
+	unit_root (const size_t& q, const size_t& n, const int& s) {
+		typedef typename TypeTraits<T>::RT RT;
+		const size_t r = q % n;
+		if ((4 * r) % n == 0)
+			switch ((4 * r) / n) {
+			case 0: return T ( 1, 0);
+			case 1: return T ( 0, s);
+			case 2: return T (-1, 0);
+			case 3: return T ( 0,-s);
+			}
+		return std::polar ((RT)1, (RT)(s * 2. * M_PI * (double)r / (double)n));
+	}
+
+
+	/**
+	 * @brief   x(i_0,...) *= scale * prod_d tabs[d](i_d) (empty tabs[d] = 1)
+	 */
+	template<class T> inline static void
+	modulate (T* x, const Vector<size_t>& dims, const Vector<Vector<T> >& tabs,
+	          const typename TypeTraits<T>::RT& scale) {
+
+		const size_t nd = dims.size(), n0 = dims[0];
+		size_t n = 1;
+		for (size_t d = 0; d < nd; ++d)
+			n *= dims[d];
+		const long nr = (long) (n / n0);
+		const T* t0 = tabs[0].empty() ? 0 : tabs[0].ptr();
+
+#pragma omp parallel for schedule (static) if (n >= EXPR_PARALLEL_THRESHOLD)
+		for (long r = 0; r < nr; ++r) {
+			T f = T(scale);
+			size_t q = r;
+			for (size_t d = 1; d < nd; ++d) {
+				if (!tabs[d].empty())
+					f *= tabs[d][q % dims[d]];
+				q /= dims[d];
+			}
+			T* row = x + r * n0;
+			if (t0)
+				for (size_t i = 0; i < n0; ++i)
+					row[i] *= f * t0[i];
+			else if (f != T(1))
+				for (size_t i = 0; i < n0; ++i)
+					row[i] *= f;
+		}
+
+	}
+
+
+	/**
+	 * @brief   In place N-D FFT along selected axes
+	 *
+	 * @param   x       Data (column-major)
+	 * @param   dims    Dimensions
+	 * @param   axes    Axes to transform
+	 * @param   shift   Centred transform (ifftshift before, fftshift after)
+	 * @param   fwd     Forward (true) or backward (false)
+	 * @param   scale   Scaling of result (default 1, i.e. unnormalised)
+	 * @param   threads # of fftw threads (default 0 = budget)
+	 */
+	template<class T> inline static void
+	fftn (T* x, const Vector<size_t>& dims, const Vector<size_t>& axes, const bool& shift,
+	      const bool& fwd, const typename TypeTraits<T>::RT& scale = 1, const int& threads = 0) {
+
+		typedef FTTraits<T>                FT;
+		typedef typename FT::IODim         IODim;
+		typedef typename FT::T             FTT;
+
+		const size_t nd = dims.size();
+		const int    s  = fwd ? FFTW_FORWARD : FFTW_BACKWARD;
+
+		std::vector<bool> ft (nd, false);
+		for (size_t i = 0; i < axes.size(); ++i) {
+			assert (axes[i] < nd);
+			ft[axes[i]] = true;
+		}
+
+		// FT and loop dimensions, outermost first
+		std::vector<IODim> fd, ld;
+		size_t st = 1;
+		for (size_t d = 0; d < nd; ++d)
+			st *= dims[d];
+		for (size_t d = nd; d-- > 0; ) {
+			st /= dims[d];
+			if (dims[d] == 1)
+				continue;
+			IODim io;
+			io.n = (ptrdiff_t) dims[d]; io.is = (ptrdiff_t) st; io.os = (ptrdiff_t) st;
+			(ft[d] ? fd : ld).push_back (io);
+		}
+
+		if (fd.empty()) { // Nothing to transform
+			if (scale != 1)
+				modulate (x, dims, Vector<Vector<T> >(nd), scale);
+			return;
+		}
+
+		Vector<Vector<T> > pre (nd), post (nd);
+		if (shift)
+			for (size_t d = 0; d < nd; ++d)
+				if (ft[d] && dims[d] > 1) {
+					const size_t n = dims[d], a = n / 2, b = n - a;
+					pre[d].resize (n);
+					post[d].resize (n);
+					for (size_t m = 0; m < n; ++m) {
+						pre [d][m] = unit_root<T> (m * b, n, s);
+						post[d][m] = unit_root<T> (n - (a * ((m + b) % n)) % n, n, s);
+					}
+				}
+
+		if (shift)
+			modulate (x, dims, pre, 1);
+
+		typename FT::Plan p = FTPlanCache<T>::Instance().Get ((int)fd.size(), &fd[0],
+			(int)ld.size(), ld.empty() ? 0 : &ld[0], s, (FTT*)x, (FTT*)x, threads);
+		FT::Execute (p, (FTT*)x, (FTT*)x);
+
+		if (shift || scale != 1)
+			modulate (x, dims, post, scale);
+
+	}
+
+}}
+
+#endif // __FFTN_HPP__
@@ -24,9 +24,25 @@
 //#include "Workspace.hpp"
 #include "Params.hpp"
 #include "OMP.hpp"
+#include "ExecutionContext.hpp"
 
 #include <fftw3.h>
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef HAVE_CXX11_MUTEX
+#  include <mutex>
+typedef std::mutex                    ft_mutex;
+typedef std::lock_guard<std::mutex>   ft_lock;
+#else
+#  include <boost/thread/mutex.hpp>
+typedef boost::mutex                  ft_mutex;
+typedef boost::mutex::scoped_lock     ft_lock;
+#endif
+
 static Params p;
 
 template <class T>
@@ -40,28 +56,27 @@ struct FTTraits<std::complex<float> > {
 	
 	typedef fftwf_plan    Plan; /**< @brief fftw plan (float precision) */
 	typedef fftwf_complex T;    /**< @brief fftw complex data type (float precision) */
+	typedef fftwf_iodim64 IODim; /**< @brief fftw 64-bit guru dimension (float precision) */
 	typedef float         RT;
 	
 
 	/**
-	 * @brief         Initialise FFTWF threads (Should only be done once)
+	 * @brief         Initialise FFTWF threads once and set # of threads of
+	 *                subsequent plans. Capped by the execution context's budget.
 	 *
+	 * @param  nt     # of threads (default 0 = budget)
 	 * @return        Success
 	 */
 	static inline bool InitThreads (int nt = 0) {
-		if (p.exists("FFTWThreads"))
-			return true;
-        if (nt==0) {
-#pragma omp parallel
-            {
-                nt = omp_get_num_threads();
-            }
-        } 
+		const int budget = ExecutionContext::Instance().Threads();
+		nt = (nt <= 0) ? budget : std::min (nt, budget);
 #ifdef _OPENMP
-		if (fftwf_init_threads()) {
-			fftwf_plan_with_nthreads (nt);
-			p["FFTWThreads"] = nt;
+		if (!p.exists("FFTWFThreads")) {
+			if (!fftwf_init_threads())
+				return true;
+			p["FFTWFThreads"] = nt;
 		}
+		fftwf_plan_with_nthreads (nt);
 #endif
 		return true;
 	}
@@ -76,7 +91,7 @@ struct FTTraits<std::complex<float> > {
 	 * @param  out    Output memory
 	 * @param  sign   FT direction
 	 * @param  flags  FFTW flags
-     * @prama  threads #of fftw threads. (default 0 = #cpus.)
+     * @prama  threads #of fftw threads. (default 0 = budget)
 	 *
 	 * @return        Plan
 	 */
@@ -95,6 +110,96 @@ struct FTTraits<std::complex<float> > {
 	}
 
 
+	/**
+	 * @brief         Plan many interleaved transforms. Element i of transform j
+	 *                resides at i*stride + j*dist (e.g. stride = howmany, dist = 1
+	 *                for transforms innermost).
+	 *
+	 * @param  rank   FT dimesionality
+	 * @param  n      Size lengths of individual dimensions (row-major)
+	 * @param  howmany Number of transforms
+	 * @param  in     Input memory
+	 * @param  out    Output memory
+	 * @param  stride Stride between elements of one transform
+	 * @param  dist   Distance between transforms
+	 * @param  dir    FT direction
+     * @prama  threads #of fftw threads. (default 0 = budget)
+	 *
+	 * @return        Plan
+	 */
+	static inline Plan DFTPlanMany (int rank, const int* n, int howmany,
+			T* in, T* out, int stride, int dist, int dir, int threads = 0) {
+		InitThreads(threads);
+		return fftwf_plan_many_dft (rank, n, howmany, in, NULL, stride, dist, out,
+				NULL, stride, dist, dir, FFTW_ESTIMATE);
+	}
+
+
+	/**
+	 * @brief         Plan many interleaved transforms with planner flags
+	 *
+	 * @see           DFTPlanMany
+	 * @param  flags  FFTW planner flags
+	 */
+	static inline Plan DFTPlanMany (int rank, const int* n, int howmany,
+			T* in, T* out, int stride, int dist, int dir, unsigned flags, int threads) {
+		InitThreads(threads);
+		return fftwf_plan_many_dft (rank, n, howmany, in, NULL, stride, dist, out,
+				NULL, stride, dist, dir, flags);
+	}
+
+
+	/**
+	 * @brief         Plan transforms of arbitrary strides (FFTW 64-bit guru interface)
+	 *
+	 * @param  rank   FT dimensionality
+	 * @param  dims   Side lengths and input/output strides of FT dimensions
+	 * @param  hrank  # of loop dimensions
+	 * @param  hdims  Side lengths and input/output strides of loop dimensions
+	 * @param  in     Input memory
+	 * @param  out    Output memory
+	 * @param  dir    FT direction
+	 * @param  flags  FFTW planner flags
+	 * @param  threads # of fftw threads
+	 * @return        Plan
+	 */
+	static inline Plan DFTPlanGuru (int rank, const IODim* dims, int hrank, const IODim* hdims,
+			T* in, T* out, int dir, unsigned flags, int threads) {
+		InitThreads(threads);
+		return fftwf_plan_guru64_dft (rank, dims, hrank, hdims, in, out, dir, flags);
+	}
+
+
+	/**
+	 * @brief         SIMD alignment of memory relative to fftw_malloc
+	 */
+	static inline int Alignment (const T* p) {
+		return fftwf_alignment_of ((float*) p);
+	}
+
+
+	/**
+	 * @brief         Import accumulated wisdom
+	 *
+	 * @param  fname  File name
+	 * @return        Success
+	 */
+	static inline bool ImportWisdom (const char* fname) {
+		return fftwf_import_wisdom_from_filename (fname) != 0;
+	}
+
+
+	/**
+	 * @brief         Export accumulated wisdom
+	 *
+	 * @param  fname  File name
+	 * @return        Success
+	 */
+	static inline bool ExportWisdom (const char* fname) {
+		return fftwf_export_wisdom_to_filename (fname) != 0;
+	}
+
+
 	/**
 	 * @brief        Inlined memory allocation for performance
 	 *
@@ -166,27 +271,26 @@ struct FTTraits<std::complex<double> > {
 	
 	typedef fftw_plan    Plan;  /**< @brief fftw plan (double precision) */
 	typedef fftw_complex T;  /**< @brief fftw complex data type (double precision) */
+	typedef fftw_iodim64 IODim; /**< @brief fftw 64-bit guru dimension (double precision) */
 	typedef double       RT;
 
 	/**
-	 * @brief         Initialise FFTWF threads (Should only be done once)
+	 * @brief         Initialise FFTW threads once and set # of threads of
+	 *                subsequent plans. Capped by the execution context's budget.
 	 *
+	 * @param  nt     # of threads (default 0 = budget)
 	 * @return        Success
 	 */
 	static inline bool InitThreads (int nt = 0) {
-		if (p.exists("FFTWThreads"))
-			return true;
-        if (nt==0) {
-#pragma omp parallel
-            {
-                nt = omp_get_num_threads();
-            }
-        } 
+		const int budget = ExecutionContext::Instance().Threads();
+		nt = (nt <= 0) ? budget : std::min (nt, budget);
 #ifdef _OPENMP
-		if (fftw_init_threads()) {
-			fftw_plan_with_nthreads (nt);
+		if (!p.exists("FFTWThreads")) {
+			if (!fftw_init_threads())
+				return true;
 			p["FFTWThreads"] = nt;
 		}
+		fftw_plan_with_nthreads (nt);
 #endif
 		return true;
 	}
@@ -201,7 +305,7 @@ struct FTTraits<std::complex<double> > {
 	 * @param  out    Output memory
 	 * @param  sign   FT direction
 	 * @param  flags  FFTW flags
-     * @prama  threads #of fftw threads. (default 0 = #cpus.)
+     * @prama  threads #of fftw threads. (default 0 = budget)
 	 *
 	 * @return        Plan
 	 */
@@ -220,6 +324,96 @@ struct FTTraits<std::complex<double> > {
 	}
 
 
+	/**
+	 * @brief         Plan many interleaved transforms. Element i of transform j
+	 *                resides at i*stride + j*dist (e.g. stride = howmany, dist = 1
+	 *                for transforms innermost).
+	 *
+	 * @param  rank   FT dimesionality
+	 * @param  n      Size lengths of individual dimensions (row-major)
+	 * @param  howmany Number of transforms
+	 * @param  in     Input memory
+	 * @param  out    Output memory
+	 * @param  stride Stride between elements of one transform
+	 * @param  dist   Distance between transforms
+	 * @param  dir    FT direction
+     * @prama  threads #of fftw threads. (default 0 = budget)
+	 *
+	 * @return        Plan
+	 */
+	static inline Plan DFTPlanMany (int rank, const int* n, int howmany,
+			T* in, T* out, int stride, int dist, int dir, int threads = 0) {
+		InitThreads(threads);
+		return fftw_plan_many_dft (rank, n, howmany, in, NULL, stride, dist, out,
+				NULL, stride, dist, dir, FFTW_ESTIMATE);
+	}
+
+
+	/**
+	 * @brief         Plan many interleaved transforms with planner flags
+	 *
+	 * @see           DFTPlanMany
+	 * @param  flags  FFTW planner flags
+	 */
+	static inline Plan DFTPlanMany (int rank, const int* n, int howmany,
+			T* in, T* out, int stride, int dist, int dir, unsigned flags, int threads) {
+		InitThreads(threads);
+		return fftw_plan_many_dft (rank, n, howmany, in, NULL, stride, dist, out,
+				NULL, stride, dist, dir, flags);
+	}
+
+
+	/**
+	 * @brief         Plan transforms of arbitrary strides (FFTW 64-bit guru interface)
+	 *
+	 * @param  rank   FT dimensionality
+	 * @param  dims   Side lengths and input/output strides of FT dimensions
+	 * @param  hrank  # of loop dimensions
+	 * @param  hdims  Side lengths and input/output strides of loop dimensions
+	 * @param  in     Input memory
+	 * @param  out    Output memory
+	 * @param  dir    FT direction
+	 * @param  flags  FFTW planner flags
+	 * @param  threads # of fftw threads
+	 * @return        Plan
+	 */
+	static inline Plan DFTPlanGuru (int rank, const IODim* dims, int hrank, const IODim* hdims,
+			T* in, T* out, int dir, unsigned flags, int threads) {
+		InitThreads(threads);
+		return fftw_plan_guru64_dft (rank, dims, hrank, hdims, in, out, dir, flags);
+	}
+
+
+	/**
+	 * @brief         SIMD alignment of memory relative to fftw_malloc
+	 */
+	static inline int Alignment (const T* p) {
+		return fftw_alignment_of ((double*) p);
+	}
+
+
+	/**
+	 * @brief         Import accumulated wisdom
+	 *
+	 * @param  fname  File name
+	 * @return        Success
+	 */
+	static inline bool ImportWisdom (const char* fname) {
+		return fftw_import_wisdom_from_filename (fname) != 0;
+	}
+
+
+	/**
+	 * @brief         Export accumulated wisdom
+	 *
+	 * @param  fname  File name
+	 * @return        Success
+	 */
+	static inline bool ExportWisdom (const char* fname) {
+		return fftw_export_wisdom_to_filename (fname) != 0;
+	}
+
+
 	/**
 	 * @brief        Inlined memory allocation for performance
 	 *
@@ -282,4 +476,266 @@ struct FTTraits<std::complex<double> > {
 
 };
 
+
+/**
+ * @brief Process wide cache of FFTW plans. Singleton per precision.<br/>
+ *        Plans are keyed by rank, sizes, howmany, strides, direction,
+ *        placement, alignment, threads and planner rigour. They are made
+ *        once on scratch memory with the configured rigour and executed on the
+ *        caller's arrays through the new-array interface, which is thread
+ *        safe. Planning and wisdom I/O are serialised, FFTW's planner is not.
+ *        Cached plans are owned by the cache and must not be destroyed.
+ */
+template<class S>
+class FTPlanCache {
+
+public:
+
+	typedef FTTraits<S>          FT;
+	typedef typename FT::Plan    Plan;
+	typedef typename FT::T       T;
+	typedef typename FT::IODim   IODim;
+	typedef std::vector<ptrdiff_t> Key; /**< @brief Plan geometry, 64-bit for guru strides */
+
+
+	/**
+	 * @brief        Get reference to cache instance
+	 */
+	static FTPlanCache& Instance () {
+		static FTPlanCache c;
+		return c;
+	}
+
+
+	/**
+	 * @brief        Plan of many transforms (element i of transform j at i*stride + j*dist)
+	 *
+	 * @param  rank  FT dimensionality
+	 * @param  n     Side lengths (row-major)
+	 * @param  howmany # of transforms
+	 * @param  stride  Stride between elements of one transform
+	 * @param  dist  Distance between transforms
+	 * @param  dir   FT direction
+	 * @param  in    Input memory (alignment and placement)
+	 * @param  out   Output memory (alignment and placement)
+	 * @param  threads # of fftw threads (default 0 = budget)
+	 * @return       Plan
+	 */
+	inline Plan Get (int rank, const int* n, int howmany, int stride, int dist, int dir,
+			const T* in, const T* out, int threads = 0) {
+
+		const int budget = ExecutionContext::Instance().Threads();
+		threads = (threads <= 0) ? budget : std::min (threads, budget);
+
+		ft_lock lock (m_lock);
+
+		Key key (n, n + rank);
+		const ptrdiff_t k[] = {rank, howmany, stride, dist, dir, (in == out),
+		                       FT::Alignment(in), FT::Alignment(out), threads, m_flags};
+		key.insert (key.end(), k, k + sizeof(k)/sizeof(ptrdiff_t));
+
+		typename std::map<Key,Plan>::const_iterator it = m_plans.find (key);
+		if (it != m_plans.end())
+			return it->second;
+
+		// Scratch of same extent and alignment, planning may overwrite it
+		size_t nt = 1;
+		for (int i = 0; i < rank; ++i)
+			nt *= n[i];
+		const size_t ext = (nt - 1) * stride + (howmany - 1) * (size_t) dist + 1 + 64 / sizeof(T);
+		T* bi = FT::Malloc (ext);
+		T* bo = (in == out) ? bi : FT::Malloc (ext);
+		memset ((void*) bi, 0, ext * sizeof(T));
+		memset ((void*) bo, 0, ext * sizeof(T));
+		T* si = (T*) ((char*) bi + FT::Alignment(in));
+		T* so = (T*) ((char*) bo + FT::Alignment(out));
+
+		Plan p = FT::DFTPlanMany (rank, n, howmany, si, so, stride, dist, dir, m_flags, threads);
+
+		FT::Free (bi);
+		if (bo != bi)
+			FT::Free (bo);
+
+		m_plans[key] = p;
+		return p;
+
+	}
+
+
+	/**
+	 * @brief        Plan of contiguous transforms, one after the other
+	 */
+	inline Plan Get (int rank, const int* n, int howmany, int dir, const T* in, const T* out,
+			int threads = 0) {
+		int nt = 1;
+		for (int i = 0; i < rank; ++i)
+			nt *= n[i];
+		return Get (rank, n, howmany, 1, nt, dir, in, out, threads);
+	}
+
+
+	/**
+	 * @brief        Plan of arbitrarily strided transforms (FFTW guru interface)
+	 *
+	 * @param  rank  FT dimensionality
+	 * @param  dims  Side lengths and strides of FT dimensions
+	 * @param  hrank # of loop dimensions
+	 * @param  hdims Side lengths and strides of loop dimensions
+	 * @param  dir   FT direction
+	 * @param  in    Input memory (alignment and placement)
+	 * @param  out   Output memory (alignment and placement)
+	 * @param  threads # of fftw threads (default 0 = budget)
+	 * @return       Plan
+	 */
+	inline Plan Get (int rank, const IODim* dims, int hrank, const IODim* hdims, int dir,
+			const T* in, const T* out, int threads = 0) {
+
+		const int budget = ExecutionContext::Instance().Threads();
+		threads = (threads <= 0) ? budget : std::min (threads, budget);
+
+		ft_lock lock (m_lock);
+
+		// Leading -1 separates guru keys from those of Get above
+		Key key (1, -1);
+		size_t ei = 1, eo = 1;
+		for (int i = 0; i < rank + hrank; ++i) {
+			const IODim& d = (i < rank) ? dims[i] : hdims[i-rank];
+			key.push_back (d.n); key.push_back (d.is); key.push_back (d.os);
+			ei += (size_t)(d.n - 1) * d.is;
+			eo += (size_t)(d.n - 1) * d.os;
+		}
+		const ptrdiff_t k[] = {rank, hrank, dir, (in == out),
+		                       FT::Alignment(in), FT::Alignment(out), threads, m_flags};
+		key.insert (key.end(), k, k + sizeof(k)/sizeof(ptrdiff_t));
+
+		typename std::map<Key,Plan>::const_iterator it = m_plans.find (key);
+		if (it != m_plans.end())
+			return it->second;
+
+		const size_t ext = std::max (ei, eo) + 64 / sizeof(T);
+		T* bi = FT::Malloc (ext);
+		T* bo = (in == out) ? bi : FT::Malloc (ext);
+		memset ((void*) bi, 0, ext * sizeof(T));
+		memset ((void*) bo, 0, ext * sizeof(T));
+		T* si = (T*) ((char*) bi + FT::Alignment(in));
+		T* so = (T*) ((char*) bo + FT::Alignment(out));
+
+		Plan p = FT::DFTPlanGuru (rank, dims, hrank, hdims, si, so, dir, m_flags, threads);
+
+		FT::Free (bi);
+		if (bo != bi)
+			FT::Free (bo);
+
+		m_plans[key] = p;
+		return p;
+
+	}
+
+
+	/**
+	 * @brief        Planner rigour of subsequent plans
+	 *
+	 * @param  level "estimate", "measure", "patient" or "exhaustive"
+	 */
+	inline void Planner (const std::string& level) {
+		ft_lock lock (m_lock);
+		m_flags = (level == "measure")    ? FFTW_MEASURE :
+		          (level == "patient")    ? FFTW_PATIENT :
+		          (level == "exhaustive") ? FFTW_EXHAUSTIVE : FFTW_ESTIMATE;
+	}
+
+
+	/**
+	 * @brief        Import wisdom
+	 */
+	inline bool Import (const std::string& fname) {
+		ft_lock lock (m_lock);
+		return FT::ImportWisdom (fname.c_str());
+	}
+
+
+	/**
+	 * @brief        Export wisdom
+	 */
+	inline bool Export (const std::string& fname) {
+		ft_lock lock (m_lock);
+		return FT::ExportWisdom (fname.c_str());
+	}
+
+
+	/**
+	 * @brief        # of cached plans
+	 */
+	inline size_t Size () {
+		ft_lock lock (m_lock);
+		return m_plans.size();
+	}
+
+
+	/**
+	 * @brief        Destroy all plans
+	 */
+	inline void Clear () {
+		ft_lock lock (m_lock);
+		for (typename std::map<Key,Plan>::iterator it = m_plans.begin();
+		     it != m_plans.end(); ++it)
+			FT::Destroy (it->second);
+		m_plans.clear();
+	}
+
+
+private:
+
+	FTPlanCache () : m_flags (FFTW_ESTIMATE) {}
+	~FTPlanCache () { Clear(); }
+	FTPlanCache (const FTPlanCache&);
+	FTPlanCache& operator= (const FTPlanCache&);
+
+
+	std::map<Key,Plan>              m_plans;   /**< @brief Plans by key */
+	unsigned                        m_flags;   /**< @brief Planner rigour */
+	ft_mutex                        m_lock;
+
+};
+
+
+/**
+ * @brief         Import wisdom of both precisions (fname, fname + "f")
+ *
+ * @param  fname  Wisdom file of double precision
+ * @return        Success
+ */
+inline static bool
+ImportWisdom (const std::string& fname) {
+	bool d = FTPlanCache<std::complex<double> >::Instance().Import (fname);
+	bool f = FTPlanCache<std::complex<float>  >::Instance().Import (fname + "f");
+	return d && f;
+}
+
+
+/**
+ * @brief         Export wisdom of both precisions (fname, fname + "f")
+ *
+ * @param  fname  Wisdom file of double precision
+ * @return        Success
+ */
+inline static bool
+ExportWisdom (const std::string& fname) {
+	bool d = FTPlanCache<std::complex<double> >::Instance().Export (fname);
+	bool f = FTPlanCache<std::complex<float>  >::Instance().Export (fname + "f");
+	return d && f;
+}
+
+
+/**
+ * @brief         Planner rigour of both precisions
+ *
+ * @param  level  "estimate", "measure", "patient" or "exhaustive"
+ */
+inline static void
+PlannerRigour (const std::string& level) {
+	FTPlanCache<std::complex<double> >::Instance().Planner (level);
+	FTPlanCache<std::complex<float>  >::Instance().Planner (level);
+}
+
 #endif
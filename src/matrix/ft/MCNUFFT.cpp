@@ -0,0 +1,4 @@
+#include "MCNUFFT.hpp"
+
+template class MCNUFFT<std::complex<float> >;
+template class MCNUFFT<std::complex<double> >;
@@ -0,0 +1,491 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __MCNUFFT_HPP__
+#define __MCNUFFT_HPP__
+
+#include "FT.hpp"
+#include "FFTWTraits.hpp"
+#include "Algos.hpp"
+#include "Creators.hpp"
+#include "OMP.hpp"
+
+#include <thread>
+
+/**
+ * @brief Multi-coil (batched) non-equidistant Fourier transform<br/>
+ *        Kaiser-Bessel gridding on an oversampled grid which stores all coils of
+ *        a grid point contiguously. Every sample evaluates its interpolation
+ *        kernel once and applies it to all coils in a vectorisable inner loop.
+ *        Up to 3 dimensions.<br/>
+ *        Trafo:   coil images (imsz..., nc) -> k-space (nk, nc)<br/>
+ *        Adjoint: k-space (nk, nc) -> coil images (imsz..., nc), weighted with
+ *        k-space weights if assigned (density compensated gridding).
+ */
+template <class T>
+class MCNUFFT : public FT<T> {
+
+	typedef typename TypeTraits<T>::RT RT;
+	typedef typename FTTraits<T>::Plan Plan;
+	typedef typename FTTraits<T>::T    FTType;
+
+public:
+
+    /**
+     * @brief         Default constructor
+     */
+    MCNUFFT () NOEXCEPT : m_initialised (false), m_have_kspace (false),
+        m_have_weights (false), m_rank (0), m_nk (0), m_m (1), m_W (4),
+        m_alpha (2.), m_beta (0.), m_Nt (0), m_nt (0), m_fwd (0), m_bwd (0),
+        m_plan_nc (0), m_np (ExecutionContext::Instance().Threads()) {}
+
+    /**
+     * @brief         Construct with parameters
+     *
+     * @param  p      Parameters: imsz (image size), nk (# of k-space samples),
+     *                m (kernel half width, default 1), alpha (oversampling,
+     *                default 2), threads
+     */
+    MCNUFFT (const Params& p) NOEXCEPT : m_initialised (false), m_have_kspace (false),
+        m_have_weights (false), m_fwd (0), m_bwd (0), m_plan_nc (0) {
+
+        if (p.exists("nk")) {// Number of kspace samples
+            try {
+                m_nk = unsigned_cast(p["nk"]);
+            } catch (const boost::bad_any_cast& e) {
+                printf ("**ERROR - MCNUFFT: Numer of ksppace samples need to be "
+                		"specified\n%s\n", e.what());
+                assert(false);
+            }
+        } else {
+            printf ("**ERROR - MCNUFFT: Numer of ksppace samples need to be specified\n");
+            assert(false);
+        }
+
+        if (p.exists("imsz")) {// Image domain size
+            try {
+                m_N = boost::any_cast<Vector<size_t> >(p["imsz"]);
+            } catch (const boost::bad_any_cast& e) {
+                printf ("**ERROR - MCNUFFT: Image domain dimensions need to be "
+                		"specified\n%s\n", e.what());
+                assert(false);
+            }
+        } else {
+            printf ("**ERROR - MCNUFFT: Image domain dimensions need to be specified\n");
+            assert(false);
+        }
+
+        m_m     = p.exists("m") ? unsigned_cast (p["m"]) : 1;
+        m_alpha = p.exists("alpha") ? fp_cast (p["alpha"]) : 2.;
+        m_np    = try_to_fetch<int> (p, "threads", ExecutionContext::Instance().Threads());
+
+        Init();
+
+    }
+
+    /**
+     * @brief         Copy constructor
+     */
+    MCNUFFT (const MCNUFFT<T>& ft) NOEXCEPT : m_fwd (0), m_bwd (0), m_plan_nc (0) {
+        *this = ft;
+    }
+
+    /**
+     * @brief         Clean up and destruct
+     */
+    virtual ~MCNUFFT () NOEXCEPT {
+        DestroyPlans();
+    }
+
+    /**
+     * @brief         Assignment (FFTW plans are made on first use)
+     */
+    inline MCNUFFT<T>& operator= (const MCNUFFT<T>& ft) NOEXCEPT {
+        if (this == &ft)
+            return *this;
+        DestroyPlans();
+        m_initialised  = ft.m_initialised;
+        m_have_kspace  = ft.m_have_kspace;
+        m_have_weights = ft.m_have_weights;
+        m_rank         = ft.m_rank;
+        m_nk           = ft.m_nk;
+        m_m            = ft.m_m;
+        m_W            = ft.m_W;
+        m_alpha        = ft.m_alpha;
+        m_beta         = ft.m_beta;
+        m_N            = ft.m_N;
+        m_n            = ft.m_n;
+        m_Nt           = ft.m_Nt;
+        m_nt           = ft.m_nt;
+        m_apod         = ft.m_apod;
+        m_psi          = ft.m_psi;
+        m_idx          = ft.m_idx;
+        m_w            = ft.m_w;
+        m_blocks       = ft.m_blocks;
+        m_np           = ft.m_np;
+        return *this;
+    }
+
+    /**
+     * @brief         Assign k-space trajectory and precompute kernel weights
+     *
+     * @param  k      Trajectory (rank x nk) in [-.5,.5)
+     */
+    inline virtual void KSpace (const Matrix<RT>& k) {
+
+        assert (k.Size() == m_rank*m_nk);
+
+        m_psi.resize (m_nk*m_rank*m_W);
+        m_idx.resize (m_nk*m_rank);
+
+#pragma omp parallel for schedule (static)
+        for (int j = 0; j < (int)m_nk; ++j)
+            for (size_t d = 0; d < m_rank; ++d) {
+                RT u = k[j*m_rank+d] * m_n[d];
+                int l0 = (int)std::floor(u) - (int)m_m;
+                RT* psi = &m_psi[(j*m_rank+d)*m_W];
+                for (size_t t = 0; t < m_W; ++t)
+                    psi[t] = Kernel (u - (RT)(l0 + (int)t));
+                m_idx[j*m_rank+d] = ((l0 % (int)m_n[d]) + (int)m_n[d]) % (int)m_n[d];
+            }
+
+        // Samples grouped by slabs of the slowest grid dimension. Slabs of equal
+        // parity are at least one kernel width apart and are gridded concurrently.
+        size_t nl = m_n[m_rank-1], nb = nl / m_W;
+        if (nb % 2)
+            --nb;
+        if (nb < 2)
+            nb = 1;
+        m_blocks.clear();
+        m_blocks.resize (nb);
+        for (size_t j = 0; j < m_nk; ++j)
+            m_blocks[std::min ((size_t)m_idx[j*m_rank+m_rank-1] / m_W, nb-1)].push_back(j);
+
+        m_have_kspace = true;
+
+    }
+
+    /**
+     * @brief         Assign k-space weights (density compensation)
+     *
+     * @param  w      Weights (nk)
+     */
+    inline virtual void Weights (const Matrix<RT>& w) {
+        assert (w.Size() == m_nk);
+        m_w.resize (m_nk);
+        std::copy (w.Begin(), w.End(), m_w.begin());
+        m_have_weights = true;
+    }
+
+    /**
+     * @brief         Forward transform
+     *
+     * @param  m      Coil images (imsz..., nc)
+     * @return        K-space (nk, nc)
+     */
+    inline virtual Matrix<T> Trafo (const MatrixType<T>& m) const NOEXCEPT {
+
+        size_t nc = numel(m) / m_Nt;
+        assert (nc * m_Nt == numel(m));
+        Plans (nc);
+
+        // Deapodise and zero-pad into coil-innermost grid
+        std::fill (m_grid.begin(), m_grid.end(), T(0.));
+        size_t N1 = (m_rank > 1) ? m_N[1] : 1, N2 = (m_rank > 2) ? m_N[2] : 1;
+        size_t n0 = m_n[0], n1 = (m_rank > 1) ? m_n[1] : 1;
+#pragma omp parallel for schedule (static)
+        for (int z = 0; z < (int)N2; ++z)
+            for (size_t y = 0; y < N1; ++y) {
+                size_t gz = (m_rank > 2) ? Wrap (z, 2) : 0, gy = (m_rank > 1) ? Wrap (y, 1) : 0;
+                RT ayz = ((m_rank > 2) ? m_apod[2][z] : (RT)1.) * ((m_rank > 1) ? m_apod[1][y] : (RT)1.);
+                for (size_t x = 0; x < m_N[0]; ++x) {
+                    size_t i = x + m_N[0]*(y + N1*z);
+                    T* g = &m_grid[((gz*n1 + gy)*n0 + Wrap (x, 0))*nc];
+                    RT a = ayz * m_apod[0][x];
+                    for (size_t c = 0; c < nc; ++c)
+                        g[c] = m[c*m_Nt+i] * a;
+                }
+            }
+
+        FTTraits<T>::Execute (m_fwd);
+
+        // Degrid: one kernel evaluation per sample for all coils
+        Matrix<T> out (m_nk, nc);
+        size_t Wy = (m_rank > 1) ? m_W : 1, Wz = (m_rank > 2) ? m_W : 1;
+        const RT one = 1.;
+#pragma omp parallel default (shared)
+        {
+            Vector<T> acc (nc);
+#pragma omp for schedule (static)
+            for (int j = 0; j < (int)m_nk; ++j) {
+                std::fill (acc.begin(), acc.end(), T(0.));
+                const int*  idx = &m_idx[j*m_rank];
+                const RT*   px  = &m_psi[j*m_rank*m_W];
+                const RT*   py  = (m_rank > 1) ? px + m_W   : &one;
+                const RT*   pz  = (m_rank > 2) ? px + 2*m_W : &one;
+                for (size_t tz = 0; tz < Wz; ++tz) {
+                    size_t iz = (m_rank > 2) ? (idx[2] + tz) % m_n[2] : 0;
+                    for (size_t ty = 0; ty < Wy; ++ty) {
+                        size_t iy = (m_rank > 1) ? (idx[1] + ty) % n1 : 0;
+                        RT wyz = pz[tz] * py[ty];
+                        for (size_t tx = 0; tx < m_W; ++tx) {
+                            size_t ix = (idx[0] + tx) % n0;
+                            Axpy (wyz * px[tx], &m_grid[((iz*n1 + iy)*n0 + ix)*nc],
+                                  acc.ptr(), nc);
+                        }
+                    }
+                }
+                for (size_t c = 0; c < nc; ++c)
+                    out[c*m_nk+j] = acc[c];
+            }
+        }
+
+        return out;
+
+    }
+
+    /**
+     * @brief         Adjoint transform
+     *
+     * @param  m      K-space (nk, nc)
+     * @return        Coil images (imsz..., nc)
+     */
+    inline virtual Matrix<T> Adjoint (const MatrixType<T>& m) const NOEXCEPT {
+
+        size_t nc = numel(m) / m_nk;
+        assert (nc * m_nk == numel(m));
+        Plans (nc);
+
+        // Grid: slabs of equal parity concurrently, all coils per kernel weight
+        std::fill (m_grid.begin(), m_grid.end(), T(0.));
+        size_t n0 = m_n[0], n1 = (m_rank > 1) ? m_n[1] : 1;
+        size_t Wy = (m_rank > 1) ? m_W : 1, Wz = (m_rank > 2) ? m_W : 1;
+        const RT one = 1.;
+        for (size_t parity = 0; parity < 2; ++parity) {
+#pragma omp parallel default (shared)
+            {
+                Vector<T> val (nc);
+#pragma omp for schedule (dynamic)
+                for (int b = parity; b < (int)m_blocks.size(); b += 2)
+                    for (size_t s = 0; s < m_blocks[b].size(); ++s) {
+                        size_t j = m_blocks[b][s];
+                        RT wj = m_have_weights ? m_w[j] : (RT)1.;
+                        for (size_t c = 0; c < nc; ++c)
+                            val[c] = m[c*m_nk+j] * wj;
+                        const int*  idx = &m_idx[j*m_rank];
+                        const RT*   px  = &m_psi[j*m_rank*m_W];
+                        const RT*   py  = (m_rank > 1) ? px + m_W   : &one;
+                        const RT*   pz  = (m_rank > 2) ? px + 2*m_W : &one;
+                        for (size_t tz = 0; tz < Wz; ++tz) {
+                            size_t iz = (m_rank > 2) ? (idx[2] + tz) % m_n[2] : 0;
+                            for (size_t ty = 0; ty < Wy; ++ty) {
+                                size_t iy = (m_rank > 1) ? (idx[1] + ty) % n1 : 0;
+                                RT wyz = pz[tz] * py[ty];
+                                for (size_t tx = 0; tx < m_W; ++tx) {
+                                    size_t ix = (idx[0] + tx) % n0;
+                                    Axpy (wyz * px[tx], val.ptr(),
+                                          &m_grid[((iz*n1 + iy)*n0 + ix)*nc], nc);
+                                }
+                            }
+                        }
+                    }
+            }
+            if (m_blocks.size() == 1)
+                break;
+        }
+
+        FTTraits<T>::Execute (m_bwd);
+
+        // Crop and deapodise
+        Vector<size_t> dims = m_N;
+        if (nc > 1)
+            dims.push_back(nc);
+        Matrix<T> out (dims);
+        size_t N1 = (m_rank > 1) ? m_N[1] : 1, N2 = (m_rank > 2) ? m_N[2] : 1;
+#pragma omp parallel for schedule (static)
+        for (int z = 0; z < (int)N2; ++z)
+            for (size_t y = 0; y < N1; ++y) {
+                size_t gz = (m_rank > 2) ? Wrap (z, 2) : 0, gy = (m_rank > 1) ? Wrap (y, 1) : 0;
+                RT ayz = ((m_rank > 2) ? m_apod[2][z] : (RT)1.) * ((m_rank > 1) ? m_apod[1][y] : (RT)1.);
+                for (size_t x = 0; x < m_N[0]; ++x) {
+                    size_t i = x + m_N[0]*(y + N1*z);
+                    const T* g = &m_grid[((gz*n1 + gy)*n0 + Wrap (x, 0))*nc];
+                    RT a = ayz * m_apod[0][x];
+                    for (size_t c = 0; c < nc; ++c)
+                        out[c*m_Nt+i] = g[c] * a;
+                }
+            }
+
+        return out;
+
+    }
+
+    inline size_t Rank () const NOEXCEPT { return m_rank; }
+    inline size_t KSpaceSize () const NOEXCEPT { return m_nk; }
+    inline RT Alpha () const NOEXCEPT { return m_alpha; }
+
+    virtual std::ostream& Print (std::ostream& os) const {
+		Operator<T>::Print(os);
+    	os << "    image size: rank(" << m_rank << ") side(" << m_N[0] << ") nodes("
+           << m_nk << ")" << std::endl;
+    	os << "    gridding: kaiser-bessel width(" << m_W << ") beta(" << m_beta
+           << ") alpha(" << m_alpha << ") grid(" << m_n[0] << ")" << std::endl;
+    	os << "    have_kspace(" << m_have_kspace << ") have_weights(" <<
+            m_have_weights << ") slabs(" << m_blocks.size() << ")" << std::endl;
+    	os << "    ft-threads(" << m_np << ")";
+    	return os;
+    }
+
+private:
+
+    /**
+     * @brief         Oversampled grid, kernel shape and deapodisation
+     */
+    inline void Init () {
+
+        m_rank = m_N.size();
+        assert (m_rank > 0 && m_rank < 4);
+        m_W    = 2*m_m + 2;
+        m_n    = m_N;
+        m_Nt   = prod(m_N);
+        m_nt   = 1;
+        for (size_t d = 0; d < m_rank; ++d) {
+            m_n[d] = std::max (m_N[d], 2 * (size_t)std::ceil(.5 * m_alpha * m_N[d]));
+            m_nt  *= m_n[d];
+        }
+
+        // Beatty et al. IEEE TMI 2005
+        RT s = m_alpha, b = (m_W/s)*(m_W/s)*(s-.5)*(s-.5) - .8;
+        m_beta = PI * std::sqrt (std::max (b, (RT).1));
+
+        m_apod.resize (m_rank);
+        for (size_t d = 0; d < m_rank; ++d) {
+            m_apod[d].resize (m_N[d]);
+            for (size_t i = 0; i < m_N[d]; ++i) {
+                RT xi = ((RT)i - (RT)(m_N[d]/2)) / m_n[d];
+                RT v  = m_beta*m_beta - (PI*m_W*xi)*(PI*m_W*xi), ft;
+                if (v > 0.)
+                    ft = std::sinh (std::sqrt(v)) / std::sqrt(v);
+                else if (v < 0.)
+                    ft = std::sin (std::sqrt(-v)) / std::sqrt(-v);
+                else
+                    ft = 1.;
+                m_apod[d][i] = 1. / (m_W * ft);
+            }
+        }
+
+        m_initialised = true;
+
+    }
+
+    /**
+     * @brief         Kaiser-Bessel kernel I0(beta sqrt(1-(2u/W)^2))
+     */
+    inline RT Kernel (RT u) const {
+        RT r = 2.*u/m_W;
+        r = 1. - r*r;
+        return (r < 0.) ? 0. : BesselI0 (m_beta*std::sqrt(r));
+    }
+
+    /**
+     * @brief         Modified Bessel function of first kind, order 0 (power series)
+     */
+    inline static RT BesselI0 (RT x) {
+        double s = 1., t = 1., q = .25*x*x;
+        for (size_t k = 1; k < 64 && t > 1.e-12*s; ++k) {
+            t *= q / (double)(k*k);
+            s += t;
+        }
+        return (RT)s;
+    }
+
+    /**
+     * @brief         Grid position of image index (image centre at grid origin)
+     */
+    inline size_t Wrap (size_t i, size_t d) const {
+        int x = (int)i - (int)(m_N[d]/2);
+        return (x < 0) ? x + m_n[d] : x;
+    }
+
+    /**
+     * @brief         y += a * x over nc complex values (vectorisable real loop)
+     */
+    inline static void Axpy (RT a, const T* x, T* y, size_t nc) {
+        const RT* xr = (const RT*) x;
+        RT* yr = (RT*) y;
+        for (size_t c = 0; c < 2*nc; ++c)
+            yr[c] += a * xr[c];
+    }
+
+    /**
+     * @brief         (Re-)allocate grid and FFTW plans for nc coils
+     */
+    inline void Plans (size_t nc) const {
+        if (nc == m_plan_nc)
+            return;
+        DestroyPlans();
+        m_grid.resize (m_nt*nc);
+        int n[3];
+        for (size_t d = 0; d < m_rank; ++d)
+            n[d] = m_n[m_rank-1-d]; // FFTW is row-major
+        m_fwd = FTTraits<T>::DFTPlanMany (m_rank, n, nc, (FTType*)m_grid.ptr(),
+            (FTType*)m_grid.ptr(), nc, 1, FFTW_FORWARD, m_np);
+        m_bwd = FTTraits<T>::DFTPlanMany (m_rank, n, nc, (FTType*)m_grid.ptr(),
+            (FTType*)m_grid.ptr(), nc, 1, FFTW_BACKWARD, m_np);
+        m_plan_nc = nc;
+    }
+
+    inline void DestroyPlans () const {
+        if (m_plan_nc) {
+            FTTraits<T>::Destroy (m_fwd);
+            FTTraits<T>::Destroy (m_bwd);
+        }
+        m_plan_nc = 0;
+    }
+
+    bool           m_initialised;  /**< @brief Grid and kernel set up */
+    bool           m_have_kspace, m_have_weights;
+
+    size_t         m_rank;         /**< @brief Dimensionality (1..3) */
+    size_t         m_nk;           /**< @brief # of k-space samples */
+    size_t         m_m;            /**< @brief Kernel half width */
+    size_t         m_W;            /**< @brief Kernel support (2m+2 grid points) */
+    RT             m_alpha;        /**< @brief Oversampling */
+    RT             m_beta;         /**< @brief Kaiser-Bessel shape */
+
+    Vector<size_t> m_N;            /**< @brief Image side lengths */
+    Vector<size_t> m_n;            /**< @brief Oversampled grid side lengths */
+    size_t         m_Nt, m_nt;     /**< @brief Image and grid sizes */
+
+    Vector<Vector<RT> > m_apod;    /**< @brief Deapodisation per dimension */
+    Vector<RT>     m_psi;          /**< @brief Kernel weights (W x rank x nk) */
+    Vector<int>    m_idx;          /**< @brief First grid index (rank x nk) */
+    Vector<RT>     m_w;            /**< @brief K-space weights */
+    Vector<Vector<size_t> > m_blocks; /**< @brief Samples by grid slab */
+
+    mutable Vector<T> m_grid;      /**< @brief Oversampled grid (nc x n) */
+    mutable Plan   m_fwd, m_bwd;   /**< @brief FFTW plans on m_grid */
+    mutable size_t m_plan_nc;      /**< @brief # coils m_grid and plans are made for */
+
+    int            m_np;           /**< @brief # of FFTW threads */
+
+};
+
+#endif
@@ -22,6 +22,8 @@
 #define __NCSENSE_HPP__
 
 #include "NFFT.hpp"
+#include "MCNUFFT.hpp"
+#include "Toeplitz.hpp"
 #include "CX.hpp"
 #include "mri/MRI.hpp"
 #include "Lapack.hpp"
@@ -38,7 +40,14 @@
 
 /**
  * @brief Non-Cartesian SENSE<br/>
- *        According Pruessmann et al. (2001). MRM, 46(4), 638-51.
+ *        According Pruessmann et al. (2001). MRM, 46(4), 638-51.<br/>
+ *        Parameter "batched" replaces the per-channel NFFT pool with one multi-coil
+ *        gridding operator (MCNUFFT) per volume.<br/>
+ *        Parameter "toeplitz" applies the normal operator in CG through a
+ *        precomputed point spread function on a 2x oversampled Cartesian grid.
+ *        It implies "batched", whose adjoint E^H W is the right-hand side the
+ *        point spread function is consistent with.<br/>
+ *        Parameter "warm_start" starts CG from the previous solution.
  *
  */
 
@@ -58,7 +67,8 @@ public:
 	 * @brief         Default constructor
 	 */
 	NCSENSE() NOEXCEPT : m_initialised (false), m_cgiter(30), m_cgeps (1.0e-6), m_lambda (1.0e-6),
-        m_verbose (false), m_np(0), m_3rd_dim_cart(false), m_nmany(1), m_dim4(1), m_dim5(1) {}
+        m_verbose (false), m_np(0), m_3rd_dim_cart(false), m_nmany(1), m_dim4(1), m_dim5(1),
+        m_batched(false), m_toeplitz(false) {}
     
     
 	/**
@@ -68,7 +78,8 @@ public:
 	 */
 	NCSENSE        (const Params& params) NOEXCEPT
               : FT<T>::FT(params), m_cgiter(0), m_initialised(false), m_cgeps(1.0e-6),
-                m_lambda(1.0e-6), m_verbose (false), m_np(0), m_3rd_dim_cart(false), m_nmany(1), m_dim4(1), m_dim5(1)  {
+                m_lambda(1.0e-6), m_verbose (false), m_np(0), m_3rd_dim_cart(false), m_nmany(1), m_dim4(1), m_dim5(1),
+                m_batched(false), m_toeplitz(false) {
 
 		size_t cart_dim = 1;
 
@@ -87,6 +98,8 @@ public:
 			}
 		}
 		ft_params["3rd_dim_cart"] = m_3rd_dim_cart;
+		ft_params["double_precision"] = (params.exists("double_precision")) ?
+				params.Get<bool>("double_precision") : false;
 
 		Workspace& ws = Workspace::Instance();
 		Matrix<RT> b0;
@@ -128,14 +141,14 @@ public:
         } catch (const PARAMETER_MAP_EXCEPTION&) {
         } catch (const boost::bad_any_cast&) {}
 
+        m_np = ExecutionContext::Instance().Threads(); // Chain budget caps "threads"
         try {
-            m_np  = params.Get<int>("threads");
+            int np = params.Get<int>("threads");
+            if (np > 0)
+                m_np = std::min (np, m_np);
         } catch (const PARAMETER_MAP_EXCEPTION&) {
-        } catch (const boost::bad_any_cast&) {
-            m_np  = std::thread::hardware_concurrency();
-        }
+        } catch (const boost::bad_any_cast&) {}
 
-        omp_set_num_threads(m_np);
         ft_params["threads"] = m_np;
 
         try {
@@ -157,16 +170,48 @@ public:
         
 		ft_params["imsz"] = ms;
 
-        if (m_nmany > 1) {
+        if (params.exists("batched")) {
+            try {
+                m_batched = params.Get<bool>("batched");
+            } catch (const boost::bad_any_cast&) {
+                printf ("  WARNING - NCSENSE: Could not interpret input for batched NuFFT.\n");
+            }
+        }
+        if (m_batched && m_3rd_dim_cart) {
+            printf ("  WARNING - NCSENSE: Batched NuFFT does not support Cartesian 3rd "
+                    "dimension. Falling back to NFFT.\n");
+            m_batched = false;
+        }
+
+        if (params.exists("toeplitz")) {
+            try {
+                m_toeplitz = params.Get<bool>("toeplitz");
+            } catch (const boost::bad_any_cast&) {
+                printf ("  WARNING - NCSENSE: Could not interpret input for Toeplitz normal operator.\n");
+            }
+        }
+        if (m_toeplitz && m_3rd_dim_cart) {
+            printf ("  WARNING - NCSENSE: Toeplitz normal operator does not support Cartesian 3rd "
+                    "dimension. Falling back to NuFFT.\n");
+            m_toeplitz = false;
+        }
+        if (m_toeplitz && !m_batched) { // RHS must be the weighted gridding adjoint E^H W
+            printf ("  WARNING - NCSENSE: Toeplitz normal operator requires batched NuFFT. "
+                    "Enabling batched.\n");
+            m_batched = true;
+        }
+
+        if (m_batched) { // One multi-coil operator per volume
+            for (size_t i = 0; i < m_nmany; ++i)
+                m_bfts.push_back(MCNUFFT<T>(ft_params));
+        } else if (m_nmany > 1) { // Own trajectory per volume
             for (size_t i = 0; i < m_nmany; ++i)
                 m_fts.push_back(NFFT<T>(ft_params));
-        } else{
-            for (size_t i = 0; i < m_nx[1]; ++i)
-                m_fts.push_back(NFFT<T>(ft_params));
+        } else { // Channels share one geometry, only transform buffers per thread
+            NFFT<T> ft (ft_params);
+            m_fts.resize (ExecutionContext::Instance().Workers(m_nx[1]), ft);
         }
 
-        omp_set_num_threads(m_fts.size());
-        
 		m_ic     = IntensityMap (m_sm);
 		m_initialised = true;
 
@@ -180,6 +225,13 @@ public:
 		m_bwd_out = Matrix<T> (tmp);               // size of sensitivity maps
 		
 		m_cgls = codeare::optimisation::CGLS<T>(m_cgiter, m_cgeps, m_lambda, m_verbose);
+        if (params.exists("warm_start")) {
+            try {
+                m_cgls.WarmStart (params.Get<bool>("warm_start"));
+            } catch (const boost::bad_any_cast&) {
+                printf ("  WARNING - NCSENSE: Could not interpret input for CG warm start.\n");
+            }
+        }
 
 	}
 
@@ -203,36 +255,13 @@ public:
 	 */
 	void KSpace (const Matrix<RT>& k) {
 		m_k = k;
-        if (size(k,1) == KSpaceSize() && m_nmany == 1) {
-#pragma omp parallel num_threads (m_fts.size())
-            {
-                m_fts[omp_get_thread_num()].KSpace(k);
-            }
-        } else if (size(m_k,2) == m_nmany) {
-#pragma omp parallel num_threads (m_fts.size())
-        	{
-        		size_t i = omp_get_thread_num();
-				if (ndims(k)==3)
-					m_fts[i].KSpace(k(CR(),CR(),CR(i)));
-				else if (ndims(k) == 4)
-					m_fts[i].KSpace(k(CR(),CR(),CR(),CR(i)));
-				else
-					throw NCSENSE_KSPACE_DIMENSIONS;
-        	}
-		} else if (size(m_k,2)*size(m_k,3) == m_nmany) {
-#pragma omp parallel num_threads (m_fts.size())
-            {
-                size_t i = omp_get_thread_num(), l=i%size(m_k,2), n = i/size(m_k,2);
-                if (ndims(k)==4)
-                    m_fts[i].KSpace(k(CR(),CR(),CR(l),CR(n)));
-                else if (ndims(k) == 5)
-                    m_fts[i].KSpace(k(CR(),CR(),CR(),CR(l),CR(n)));
-                else 
-                    throw NCSENSE_KSPACE_DIMENSIONS;
-            }
-        } else {
-            throw NCSENSE_KSPACE_DIMENSIONS;
-        }
+        if (m_batched)
+            KSpace (m_bfts, k);
+        else
+            KSpace (m_fts, k);
+        m_toep.clear();
+        if (m_toeplitz && m_w.Size() > 1)
+            PSF();
     }
 	
     
@@ -243,33 +272,45 @@ public:
 	 */
 	void Weights (const Matrix<RT>& w) NOEXCEPT {
 		m_w = w;
-        for (size_t i = 0; i < m_fts.size(); ++i)
-            m_fts[i].Weights(w);
+        if (m_batched)
+            for (size_t i = 0; i < m_bfts.size(); ++i)
+                m_bfts[i].Weights(w);
+        else if (m_nmany == 1)
+            m_fts[0].Weights(w); // shared geometry
+        else
+            for (size_t i = 0; i < m_fts.size(); ++i)
+                m_fts[i].Weights(w);
+        m_toep.clear();
+        if (m_toeplitz && m_k.Size() > 1)
+            PSF();
 	}
     
     
 	virtual Matrix<T> operator/ (const MatrixType<T>& m) const NOEXCEPT {
         Matrix<T> ret;
 
+        if (m_batched)
+            return BatchedAdjoint (m);
+
         if (m_nmany > 1) {
         	if (ndims(m) == 3) {
-#pragma omp parallel for
-                for (int k = 0; k < m_nmany; ++k) {
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+                for (int k = 0; k < (int)m_nmany; ++k) {
 					for (int j = 0; j < m_nx[1]; ++j)
 						m_bwd_out (R(),R(),R(j),R(k)) = m_fts[k] ->* m(CR(),CR(j),CR(k));
-					m_bwd_out(R(),R(),R(),R(k)) *= m_csm;
+					codeare::expr::Evaluate (m_bwd_out.Ptr() + k*m_csm.Size(), lazy(m_csm),
+					                         codeare::multiplies<T>());
                 }
 				ret = squeeze(sum(m_bwd_out,2));
-#pragma omp parallel num_threads (m_nmany)
-				{
-					size_t k = omp_get_thread_num();
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+				for (int k = 0; k < (int)m_nmany; ++k) {
 					ret(R(),R(),R(k)) *= m_ic;
 				}
 
         	} else if (ndims(m) == 4) {
-#pragma omp parallel num_threads (m_nmany)
-				{
-					size_t k = omp_get_thread_num(), l = k%m_dim4, n = k/m_dim4;
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+				for (int k = 0; k < (int)m_nmany; ++k) {
+					size_t l = k%m_dim4, n = k/m_dim4;
 					for (int j = 0; j < m_nx[1]; ++j)
 						if (m_nx[0] == 2)
 							m_bwd_out (R(),R(),    R(j),R(l),R(n)) =
@@ -277,29 +318,49 @@ public:
 						else
 							m_bwd_out (R(),R(),R(),R(j),R(l),R(n)) =
 								m_fts[k] ->* m(CR(),CR(),CR(j),CR(l),CR(n));
-					m_bwd_out(R(),R(),R(),R(),R(l),R(n)) *= m_csm;
+					codeare::expr::Evaluate (m_bwd_out.Ptr() + k*m_csm.Size(), lazy(m_csm),
+					                         codeare::multiplies<T>());
 				}
 				ret = squeeze(sum(m_bwd_out,3));
-#pragma omp parallel num_threads (m_nmany)
-				{
-					size_t k = omp_get_thread_num(), l = k%m_dim4, n = k/m_dim4;
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+				for (int k = 0; k < (int)m_nmany; ++k) {
+					size_t l = k%m_dim4, n = k/m_dim4;
 					ret(R(),R(),R(),R(l),R(n)) *= m_ic;
 				}
 			}
 		} else {
-#pragma omp parallel num_threads (m_nx[1])
-            {
-                size_t k = omp_get_thread_num();
+#pragma omp parallel for num_threads (Team())
+            for (int k = 0; k < (int)m_nx[1]; ++k) {
+                const NFFT<T>& ft = m_fts[omp_get_thread_num()];
                 if (m_nx[0] == 2)
-                    m_bwd_out (R(),R(),    R(k)) = m_fts[k] ->* m(CR(),     CR(k));
+                    m_bwd_out (R(),R(),    R(k)) = ft ->* m(CR(),     CR(k));
                 else
-                    m_bwd_out (R(),R(),R(),R(k)) = m_fts[k] ->* m(CR(),CR(),CR(k));
+                    m_bwd_out (R(),R(),R(),R(k)) = ft ->* m(CR(),CR(),CR(k));
             }
-            ret = squeeze(sum(m_bwd_out*m_csm,size(m_sm).size()-1)) * m_ic;
+            ret = Combine (m_bwd_out);
         }
 	    return ret;
 	}
     
+
+	/**
+	 * @brief    Normal operator as used by CG. With "toeplitz" two FFTs per
+	 *           coil on the 2x grid, otherwise adjoint of forward transform.
+	 *
+	 * @param  m Image(s)
+	 * @return   Image(s)
+	 */
+	virtual Matrix<T> Normal (const MatrixType<T>& m) const NOEXCEPT {
+        if (!m_toeplitz)
+            return Operator<T>::Normal (m);
+        if (m_toep.empty())
+            PSF();
+        Matrix<T> ret (m.Dim());
+        for (size_t v = 0; v < m_toep.size(); ++v)
+            m_toep[v].Normal (m, v*m_nx[3], m_sm, m_csm, m_ic, ret);
+        return ret;
+	}
+    
     
 	/**
   	 * @brief    Forward transform
@@ -308,19 +369,20 @@ public:
 	 * @return   Transform
 	 */
 	virtual Matrix<T> Trafo (const MatrixType<T>& m) const NOEXCEPT {
+        if (m_batched)
+            return BatchedTrafo (m);
         if (m_nmany > 1) {
         	if (ndims(m) == 3) {
-#pragma omp parallel num_threads (m_nmany)
-				{
-					size_t k = omp_get_thread_num();
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+				for (int k = 0; k < (int)m_nmany; ++k) {
 					for (int j = 0; j < m_nx[1]; ++j)
 						m_fwd_out(R(),    R(j),R(k)) =
 							m_fts[k] * (m_sm(CR(),CR(),CR(j))*m(CR(),CR(),CR(k)));
 				}
 			} else if (ndims(m) == 4) {
-#pragma omp parallel num_threads (m_nmany)
-				{
-					size_t k = omp_get_thread_num(), l = k%m_dim4, n = k/m_dim4;
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(m_nmany))
+				for (int k = 0; k < (int)m_nmany; ++k) {
+					size_t l = k%m_dim4, n = k/m_dim4;
 					if (m_nx[0] == 2)
 						for (int j = 0; j < m_nx[1]; ++j)
 							m_fwd_out(R(),    R(j),R(l),R(n)) =
@@ -332,16 +394,16 @@ public:
 				}
         	}
         } else {
-#pragma omp parallel num_threads (m_fts.size())
-            {
-                size_t j = omp_get_thread_num();
+#pragma omp parallel for num_threads (Team())
+            for (int j = 0; j < (int)m_nx[1]; ++j) {
+                const NFFT<T>& ft = m_fts[omp_get_thread_num()];
                 if (m_3rd_dim_cart)
-                    m_fwd_out(R(),R(),R(),R(j)) = m_fts[j] * (m_sm(CR(),CR(),CR(),CR(j))*m);
+                    m_fwd_out(R(),R(),R(),R(j)) = ft * (m_sm(CR(),CR(),CR(),CR(j))*m);
                 else
                     if (m_nx[0] == 2)
-                        m_fwd_out(R(),     R(j)) = m_fts[j] * (m_sm(CR(),CR(),     CR(j))*m);
+                        m_fwd_out(R(),     R(j)) = ft * (m_sm(CR(),CR(),     CR(j))*m);
                     else
-                        m_fwd_out(R(),R(), R(j)) = m_fts[j] * (m_sm(CR(),CR(),     CR(j))*m);
+                        m_fwd_out(R(),R(), R(j)) = ft * (m_sm(CR(),CR(),     CR(j))*m);
             }
         }
 	    return squeeze(m_fwd_out);
@@ -379,10 +441,12 @@ public:
 	 * @param  data  measurement
 	 */
 	virtual void EstimateSensitivities (const MatrixType<T>& data, size_t nk) const {
+		if (m_batched)
+			return;
 		Matrix<T> out (size(m_sm));
-#pragma omp parallel for
+#pragma omp parallel for num_threads (Team())
 		for (int i = 0; i < m_nx[1]; ++i)
-			m_fts[omp_get_thread_num()].NFFTPlan().M_total = nk;
+			m_fts[omp_get_thread_num()].KSpaceSize(nk);
 	}
     
 
@@ -410,7 +474,14 @@ public:
 		// TODO: Not functional yet
 		if (m_sm.Size() == 1)
 			EstimateSensitivities(m, m_nx[2]);
-        return m_cgls.Solve(*this, m);
+        Matrix<T> ret = m_cgls.Solve(*this, m);
+        if (m_verbose) {
+            const Vector<RT>& res = m_cgls.Residuals();
+            const Vector<double>& t = m_cgls.Timings();
+            for (size_t i = 0; i < res.size(); ++i)
+                printf ("    %03zu %.7f %.4fs\n", i, res[i], (i < t.size()) ? t[i] : 0.);
+        }
+        return ret;
 	}
 	
 	
@@ -438,22 +509,171 @@ public:
 	virtual std::ostream& Print (std::ostream& os) const {
 		Operator<T>::Print(os);
 		os << "    NCCG: eps("<< m_cgeps << ") iter(" << m_cgiter << ") lambda(" << m_lambda << ")" << std::endl;
-		os << "    threads(" << m_np << ") channels(" << m_nx[1] << ") nmany(" << m_nmany << ")" << std::endl;
-		os << m_fts[0];
+		os << "    threads(" << m_np << ") channels(" << m_nx[1] << ") nmany(" << m_nmany << ")"
+           << " toeplitz(" << m_toeplitz << ")" << std::endl;
+		if (m_batched)
+			os << m_bfts[0];
+		else
+			os << m_fts[0];
 		return os;
 	}
 
     virtual FT<T>* getFT () {
-        return (FT<T>*) &m_fts[0];
+        return m_batched ? (FT<T>*) &m_bfts[0] : (FT<T>*) &m_fts[0];
+    }
+
+    /**
+     * @brief    CG solver with telemetry of last solve
+     */
+    inline const codeare::optimisation::CGLS<T>& CG () const {
+        return m_cgls;
     }
 
     inline size_t KSpaceSize () const {
-        return m_fts[0].KSpaceSize();
+        return m_batched ? m_bfts[0].KSpaceSize() : m_fts[0].KSpaceSize();
     }
 	
 private:
 
+	/**
+	 * @brief      Assign k-space trajectory to per-volume operators
+	 *
+	 * @param  fts Operators
+	 * @param  k   K-space trajectory
+	 */
+	template <class F> void KSpace (Vector<F>& fts, const Matrix<RT>& k) {
+        if (size(k,1) == KSpaceSize() && m_nmany == 1) {
+            fts[0].KSpace(k); // shared geometry
+        } else if (size(m_k,2) == m_nmany) {
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(fts.size()))
+        	for (int i = 0; i < (int)fts.size(); ++i) {
+				if (ndims(k)==3)
+					fts[i].KSpace(k(CR(),CR(),CR(i)));
+				else if (ndims(k) == 4)
+					fts[i].KSpace(k(CR(),CR(),CR(),CR(i)));
+				else
+					throw NCSENSE_KSPACE_DIMENSIONS;
+        	}
+		} else if (size(m_k,2)*size(m_k,3) == m_nmany) {
+#pragma omp parallel for num_threads (ExecutionContext::Instance().Workers(fts.size()))
+            for (int i = 0; i < (int)fts.size(); ++i) {
+                size_t l=i%size(m_k,2), n = i/size(m_k,2);
+                if (ndims(k)==4)
+                    fts[i].KSpace(k(CR(),CR(),CR(l),CR(n)));
+                else if (ndims(k) == 5)
+                    fts[i].KSpace(k(CR(),CR(),CR(),CR(l),CR(n)));
+                else 
+                    throw NCSENSE_KSPACE_DIMENSIONS;
+            }
+        } else {
+            throw NCSENSE_KSPACE_DIMENSIONS;
+        }
+    }
+
+	/**
+	 * @brief    Coil combination sum_c in_c conj(s_c) weighted by the intensity
+	 *           map, fused per channel without a full size product
+	 *
+	 * @param  in  Channel images (size of sensitivity maps)
+	 * @return     Image
+	 */
+	inline Matrix<T> Combine (const Matrix<T>& in) const {
+		Vector<size_t> dims = size(m_sm);
+		const size_t nc = dims.back();
+		dims.pop_back();
+		const size_t n = m_sm.Size() / nc;
+		Matrix<T> ret (dims);
+		for (size_t c = 0; c < nc; ++c)
+			codeare::expr::Evaluate (ret.Ptr(), lazy(in, c*n, dims) * lazy(m_csm, c*n, dims),
+			                         codeare::plus<T>());
+		ret = squeeze(ret);
+		ret *= m_ic; // real weights, in place
+		return ret;
+	}
+
+	/**
+	 * @brief    Threads over channels, at most one per transform in the pool
+	 */
+	inline int Team () const {
+		return std::min (ExecutionContext::Instance().Workers(m_nx[1]), (int)m_fts.size());
+	}
+
+	/**
+	 * @brief    Point spread functions of all volumes for the Toeplitz normal operator
+	 */
+	inline void PSF () const {
+		size_t rank = m_nx[0], nk = m_nx[2];
+		assert (m_k.Size() == rank*nk*m_nmany);
+		m_toep.resize (m_nmany);
+		for (size_t v = 0; v < m_nmany; ++v) {
+			Matrix<RT> kv (rank, nk), wv;
+			std::copy (m_k.Begin() + v*rank*nk, m_k.Begin() + (v+1)*rank*nk, kv.Begin());
+			if (m_w.Size() == nk*m_nmany) {
+				wv = Matrix<RT> (nk, 1);
+				std::copy (m_w.Begin() + v*nk, m_w.Begin() + (v+1)*nk, wv.Begin());
+			} else {
+				wv = m_w;
+			}
+			m_toep[v].Kernel (ft_params, kv, wv);
+		}
+	}
+
+	/**
+	 * @brief    Forward transform of all channels per volume in one gridding pass
+	 *
+	 * @param  m Image(s)
+	 * @return   K-space (nodes x channels x volumes)
+	 */
+	inline Matrix<T> BatchedTrafo (const MatrixType<T>& m) const {
+		size_t nc = m_nx[1], nk = m_nx[2], nr = m_nx[3];
+		Matrix<T> ci (size(m_sm));
+		for (size_t v = 0; v < m_nmany; ++v) {
+#pragma omp parallel for schedule (static) num_threads (ExecutionContext::Instance().Threads())
+			for (int c = 0; c < (int)nc; ++c)
+				for (size_t i = 0; i < nr; ++i)
+					ci[c*nr+i] = m_sm[c*nr+i] * m[v*nr+i];
+			Matrix<T> f = m_bfts[v] * ci;
+			std::copy (f.Begin(), f.End(), m_fwd_out.Begin() + v*nk*nc);
+		}
+		return squeeze(m_fwd_out);
+	}
+
+	/**
+	 * @brief    Adjoint transform of all channels per volume in one gridding pass
+	 *
+	 * @param  m K-space (nodes x channels x volumes)
+	 * @return   Coil combined, intensity corrected image(s)
+	 */
+	inline Matrix<T> BatchedAdjoint (const MatrixType<T>& m) const {
+		size_t nc = m_nx[1], nk = m_nx[2], nr = m_nx[3];
+		Vector<size_t> dims = size(m_sm);
+		dims.pop_back();
+		if (m_nmany > 1) {
+			dims.push_back(m_dim4);
+			if (m_dim5 > 1)
+				dims.push_back(m_dim5);
+		}
+		Matrix<T> ret (dims), y (nk, nc);
+		for (size_t v = 0; v < m_nmany; ++v) {
+			for (size_t i = 0; i < nk*nc; ++i)
+				y[i] = m[v*nk*nc+i];
+			Matrix<T> ci = m_bfts[v] ->* y;
+#pragma omp parallel for schedule (static) num_threads (ExecutionContext::Instance().Threads())
+			for (int i = 0; i < (int)nr; ++i) {
+				T s = T(0.);
+				for (size_t c = 0; c < nc; ++c)
+					s += m_csm[c*nr+i] * ci[c*nr+i];
+				ret[v*nr+i] = s * m_ic[i];
+			}
+		}
+		return squeeze(ret);
+	}
+
 	mutable Vector<NFFT<T> > m_fts; /**< Non-Cartesian FT operators (Multi-Core?) */
+	Vector<MCNUFFT<T> > m_bfts;     /**< Batched multi-coil operators (one per volume) */
+	bool       m_batched;     /**< Use batched multi-coil NuFFT */
+	mutable Vector<Toeplitz<T> > m_toep; /**< Normal operator kernels (one per volume) */
+	bool       m_toeplitz;    /**< Toeplitz normal operator in CG */
 	bool       m_initialised; /**< All initialised? */
     bool       m_verbose;	  /**< Verbose binary output (keep all intermediate steps) */
     bool       m_3rd_dim_cart; /**< 3rd FT dimension is Cartesian (stack of ...) */
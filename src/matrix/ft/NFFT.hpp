@@ -22,6 +22,7 @@
 
 #include "NFFTTraits.hpp"
 #include "FFTWTraits.hpp"
+#include "FFTN.hpp"
 #include "Algos.hpp"
 #include "Access.hpp"
 #include "FT.hpp"
@@ -29,25 +30,72 @@
 #include "Creators.hpp"
 
 #include <thread>
+#include <boost/shared_ptr.hpp>
+
+/**
+ * @brief Read-only NFFT 3 geometry: nodes, window tables, phi_hut, weights and damping.<br/>
+ *        Computed once and shared by all workspaces transforming on the same trajectory.
+ */
+template <class NT>
+struct NFFTGeometry {
+
+    typedef typename NFFTTraits<NT>::RT RT;
+
+    NFFTGeometry (const Vector<size_t>& N, size_t M, const Vector<size_t>& n, size_t m) NOEXCEPT :
+        w (M), w_hat (prod(N)) {
+        NFFTTraits<NT>::InitGeometry (N, M, n, m, plan);
+    }
+
+    ~NFFTGeometry () NOEXCEPT {
+        NFFTTraits<NT>::Finalize (plan);
+    }
+
+    typename NFFTTraits<NT>::Plan plan;  /**< @brief Nodes, psi and phi_hut */
+    Vector<RT> w;                        /**< @brief k-space weights */
+    Vector<RT> w_hat;                    /**< @brief Damping factors */
+
+private:
+
+    NFFTGeometry (const NFFTGeometry&);
+    NFFTGeometry& operator= (const NFFTGeometry&);
+
+};
+
+
+/**
+ * @brief NFFT 3 plans of one precision (forward, off-resonance and solver).<br/>
+ *        Without off-resonance, plan and solver only own transform buffers and
+ *        work on the shared geometry.
+ */
+template <class NT>
+struct NFFTPlans {
+    typename NFFTTraits<NT>::Plan   plan;    /**< @brief nfft  plan */
+    typename NFFTTraits<NT>::B0Plan b0_plan; /**< @brief nfft  plan with off-resonance */
+    typename NFFTTraits<NT>::Solver solver;  /**< @brief infft plan */
+    boost::shared_ptr<NFFTGeometry<NT> > geometry; /**< @brief Shared geometry */
+};
+
 
 /**
  * @brief Matrix templated ND non-equidistand Fourier transform with NFFT 3 (TU Chemnitz)<br/>
+ *        Single precision data is transformed with nfftf plans when NFFT 3 was built
+ *        for single precision (HAVE_NFFT3F). Parameter "double_precision" forces
+ *        double precision plans.<br/>
+ *        Copies share the read-only geometry (trajectory, window tables, weights)
+ *        and only allocate their own transform buffers. KSpace and Weights on any
+ *        copy therefore apply to all of them.
  */
 template <class T>
 class NFFT : public FT<T> {
 
-#ifdef HAVE_NFFT3F_UNUSED
+#ifdef HAVE_NFFT3F
     typedef T NFFTType;
-    typedef typename TypeTraits<T>::RT NFFTRType;
 #else
     typedef std::complex<double> NFFTType;
-    typedef double NFFTRType;
 #endif
+    typedef std::complex<double> NFFTDType;
 	typedef typename TypeTraits<T>::RT RT;
     typedef typename NFFTTraits<NFFTType>::Plan   Plan;
-    typedef typename NFFTTraits<NFFTType>::B0Plan B0Plan;
-    typedef typename NFFTTraits<NFFTType>::Solver Solver;
-    typedef typename FTTraits<T>::Plan CartPlan;
 
 public:
 
@@ -57,8 +105,8 @@ public:
     NFFT() NOEXCEPT :  m_initialised (false), m_have_pc (false), m_imgsz (0),
         m_M (0), m_maxit (0), m_rank (0), m_m(0), m_have_b0(false),
         m_3rd_dim_cart(false),m_ncart(1), m_alpha(1.), m_have_weights(false),
-		m_have_kspace(false), m_np(std::thread::hardware_concurrency()),
-        m_per_slice_kspace(false) {};
+		m_have_kspace(false), m_np(ExecutionContext::Instance().Threads()),
+        m_per_slice_kspace(false), m_double(false) {};
 
     /**
      * @brief        Construct with parameter set
@@ -66,8 +114,8 @@ public:
     inline NFFT (const Params& p) NOEXCEPT : m_have_b0(false), m_3rd_dim_cart(false),
         m_t (Matrix<RT>()), m_b0 (Matrix<RT>()), m_maxit(3), m_m(1), m_alpha(1.),
 		m_epsilon(7.e-4f), m_sigma(1.0), m_ncart(1),  m_have_weights(false),
-        m_have_kspace(false), m_np(std::thread::hardware_concurrency()),
-        m_per_slice_kspace(false) {
+        m_have_kspace(false), m_np(ExecutionContext::Instance().Threads()),
+        m_per_slice_kspace(false), m_double(false) {
 
         if (p.exists("nk")) {// Number of kspace samples
             try {
@@ -83,6 +131,7 @@ public:
         }
 
         m_3rd_dim_cart = try_to_fetch (p, "3rd_dim_cart", false);
+        m_double       = try_to_fetch (p, "double_precision", false);
 
         if (p.exists("imsz")) {// Image domain size
             try {
@@ -163,18 +212,13 @@ public:
 
             m_w = std::max(std::abs(m_min_b0),std::abs(m_max_b0))/(.5-((RT) m_m)/m_N[2]);
             m_ts =  (m_min_t+m_max_t)/2.;
-            RT t    = ((m_max_t-m_min_t)/2.)/(.5-((RT) (m_m))/m_N[2]);
-
-        	NFFTTraits<NFFTType>::Init (m_N, m_M, m_n, m_m, m_sigma,
-        			m_b0_plan, m_solver);
 
-            for (size_t j = 0; j < m_N[0]*m_N[1]; ++j)
-                m_b0_plan.w[j] = m_b0[j] / m_w;
-
-
-        } else {
-        	NFFTTraits<NFFTType>::Init (m_N, m_M, m_n, m_m, m_plan, m_solver);
         }
+
+        if (m_double)
+            PlanInit (m_dplans);
+        else
+            PlanInit (m_plans);
         
         if (p.exists("pc")) {
             try {
@@ -193,7 +237,7 @@ public:
     /**
      * @brief Copy conctructor
      */
-    NFFT (const NFFT<T>& ft) NOEXCEPT {
+    NFFT (const NFFT<T>& ft) NOEXCEPT : m_initialised (false) {
         *this = ft;
     }
 
@@ -203,11 +247,10 @@ public:
      */ 
     virtual ~NFFT () NOEXCEPT {
         if (m_initialised) {
-        	if (m_have_b0) {
-        		NFFTTraits<NFFTType>::Finalize (m_b0_plan, m_solver);
-        	} else {
-        		NFFTTraits<NFFTType>::Finalize (m_plan, m_solver);
-        	}
+            if (m_double)
+                PlanFinalize (m_dplans);
+            else
+                PlanFinalize (m_plans);
         }
     }
     
@@ -216,6 +259,14 @@ public:
      * @brief     Assignement
      */
     inline NFFT<T>& operator= (const NFFT<T>& ft) NOEXCEPT {
+        if (this == &ft)
+            return *this;
+        if (m_initialised) {
+            if (m_double)
+                PlanFinalize (m_dplans);
+            else
+                PlanFinalize (m_plans);
+        }
         m_initialised = ft.m_initialised;
         m_have_pc     = ft.m_have_pc;
         m_rank        = ft.m_rank;
@@ -237,16 +288,23 @@ public:
         m_max_t       = ft.m_max_t;
         m_min_b0      = ft.m_min_b0;
         m_max_b0      = ft.m_max_b0;
+        m_w           = ft.m_w;
+        m_ts          = ft.m_ts;
         m_sigma       = ft.m_sigma;
         m_alpha       = ft.m_alpha;
         m_3rd_dim_cart = ft.m_3rd_dim_cart;
         m_ncart       = ft.m_ncart;
         m_np          = ft.m_np;
         m_per_slice_kspace = ft.m_per_slice_kspace;
-        if (m_have_b0)
-        	NFFTTraits<NFFTType>::Init (m_N, m_M, m_n, m_m, m_sigma, m_b0_plan, m_solver);
+        m_double      = ft.m_double;
+        m_plans.geometry  = ft.m_plans.geometry;
+        m_dplans.geometry = ft.m_dplans.geometry;
+        if (!m_initialised)
+            return *this;
+        if (m_double)
+            PlanInit (m_dplans);
         else
-        	NFFTTraits<NFFTType>::Init (m_N, m_M, m_n, m_m,          m_plan,    m_solver);
+            PlanInit (m_plans);
         return *this;
     }
     
@@ -256,19 +314,10 @@ public:
      * @param  k   Kspace trajectory
      */
     inline virtual void KSpace (const Matrix<RT>& k) {
-        m_k = k;
-        if (m_have_b0) { // +1D for omega
-            for (size_t j = 0; j < (size_t)m_b0_plan.M_total; ++j) {
-				m_b0_plan.plan.x[3*j+0] = k[2*j+0];
-				m_b0_plan.plan.x[3*j+1] = k[2*j+1];
-                m_b0_plan.plan.x[3*j+2] = (m_t[j]-m_ts)*m_w/m_N.back();
-            }
-        } else {
-            if (k.Size() == m_plan.M_total*m_rank)
-                std::copy (k.Begin(), k.End(), m_plan.x);
-            else if (k.Size() == m_plan.M_total*m_rank*m_ncart)
-                m_per_slice_kspace = true;
-        }
+        if (m_double)
+            PlanKSpace (m_dplans, k);
+        else
+            PlanKSpace (m_plans, k);
         m_have_kspace = true;
     }
     
@@ -279,19 +328,10 @@ public:
      * @param  w   Weights
      */
     inline virtual void Weights (const Matrix<RT>& w) NOEXCEPT {
-        m_kw = w;
-    	if (m_have_b0)
-    		assert (w.Size() == m_b0_plan.M_total);
-    	else
-    		assert (w.Size() == m_plan.M_total);
-        std::copy (w.Begin(), w.End(), m_solver.w);
-        if (m_have_b0) {
-            NFFTTraits<NFFTType>::Weights (m_b0_plan.plan, m_solver, m_rank);
-            NFFTTraits<NFFTType>::Psi (m_b0_plan.plan);
-        } else {
-        	NFFTTraits<NFFTType>::Weights (m_plan, m_solver, m_rank);
-        	NFFTTraits<NFFTType>::Psi (m_plan);
-        }
+        if (m_double)
+            PlanWeights (m_dplans, w);
+        else
+            PlanWeights (m_plans, w);
         m_have_weights = true;
     }
     
@@ -304,166 +344,230 @@ public:
      */
     inline virtual Matrix<T>
     Trafo       (const MatrixType<T>& m) const NOEXCEPT {
+        return m_double ? PlanTrafo (m_dplans, m) : PlanTrafo (m_plans, m);
+    }
+    
+    
+    /**
+     * @brief    Backward transform
+     *
+     * @param  m To transform
+     * @return   Transform
+     */
+	virtual Matrix<T> Adjoint (const MatrixType<T>& m) const {
+        return m_double ? PlanAdjoint (m_dplans, m) : PlanAdjoint (m_plans, m);
+    }
 
-		NFFTRType* tmpd;
-		RT* tmpt;
-        Matrix<T> out (m_M, ((m_3rd_dim_cart && m_ncart > 1) ? m_ncart : 1));
-
-/*        if (m_3rd_dim_cart && m_ncart > 1) { // Cartesian FT 3rd dim
-        	int n = static_cast<int>(m_ncart);
-        	tmpm = permute (tmpm, 2, 0, 1);
-        	size_t cent = std::ceil(.5*m_ncart);
-        	Matrix<T> tmp;
-        	for (size_t i = 0; i < m_imgsz/2; ++i) { // fftshift colums
-				tmp = Column (tmpm,i);
-				std::rotate(tmp.Begin(), tmp.Begin()+cent, tmp.End());
-				Column (tmpm, i, tmp);
-        	}
-        	CartPlan cp = FTTraits<T>::DFTPlanMany (1, &n, m_imgsz/2,
-        			(FTType*)tmpm.Ptr(), (FTType*)tmpm.Ptr(), FFTW_FORWARD);
-        	FTTraits<T>::Execute(cp);
-        	FTTraits<T>::Destroy(cp);
-        	for (size_t i = 0; i < m_imgsz/2; ++i) { // fftshift colums
-				tmp = Column (tmpm,i);
-				std::rotate(tmp.Begin(), tmp.Begin()+cent, tmp.End());
-				Column (tmpm, i, tmp);
-        	}
-        	tmpm = permute (tmpm, 1, 2, 0)/sqrt((RT)m_ncart);
-            }*/
-
-        size_t tmp = numel(m)/m_ncart;
-        for (size_t i = 0; i < m_ncart; ++i) {
+    
+    Plan& NFFTPlan() {return m_plans.plan;}
+    const Plan& NFFTPlan() const {return m_plans.plan;}
+
+
+    inline size_t Rank() const NOEXCEPT { return m_rank; }
+    
+    inline size_t ImageSize () const {return m_N[0];}
+    inline size_t KSpaceSize () const {
+        return (size_t) (m_double ? m_dplans.plan.M_total : m_plans.plan.M_total);
+    }
+
+    /**
+     * @brief     Restrict number of k-space nodes used by subsequent transforms
+     *
+     * @param  nk Number of nodes
+     */
+    inline void KSpaceSize (size_t nk) {
+        if (m_double)
+            m_dplans.plan.M_total = nk;
+        else
+            m_plans.plan.M_total = nk;
+    }
+    inline size_t Maxit () const {return m_maxit;}
+    inline RT Alpha() const {return m_alpha;}
+    inline RT Sigma() const {return m_sigma;}
+    inline RT Epsilon() const {return m_epsilon;}
+    inline bool DoublePrecision () const {
+        return m_double || sizeof(typename TypeTraits<NFFTType>::RT) == sizeof(double);
+    }
+
+    virtual std::ostream& Print (std::ostream& os) const {
+		Operator<T>::Print(os);
+    	os << "    image size: rank(" << Rank() << ") side(" <<
+            ImageSize() << ") nodes(" << KSpaceSize() << ")" << std::endl;
+    	os << "    nfft: maxit(" << Maxit() << ") eps(" << Epsilon() <<	") alpha("
+           << Alpha() << ") m("<< m_m <<") sigma(" << Sigma() << ") precision("
+           << (DoublePrecision() ? "double" : "single") << ")" << std::endl;
+    	os << "    have_kspace(" << m_have_kspace << ") have_weights(" <<
+            m_have_weights << ") have_b0(" << m_have_b0 << ")" << std::endl;
+    	os << "    ft-threads(" << m_np << ")";
+    	if (m_3rd_dim_cart)
+    		os << " 3rd dimension (" << m_ncart << ") is Cartesian.";
+    	return os;
+    }
 
-			tmpd = (NFFTRType*) m_plan.f_hat;
-            size_t os = i*tmp;
-                
-            for (size_t j = 0; j < tmp; ++j) {
+private:
 
-                T val = (!m_have_b0) ? m[j+os] : m[j+os] *
-                    std::polar<RT>((RT)1., (RT)(2. * PI * m_ts * m_b0[j] * m_w));
-                tmpd[2*j+0] = real(m[j+os]);
-                tmpd[2*j+1] = imag(m[j+os]);
+    /**
+     * @brief     Initialise plans
+     */
+    template <class NT> inline void PlanInit (NFFTPlans<NT>& p) NOEXCEPT {
+        if (m_have_b0) {
+            NFFTTraits<NT>::Init (m_N, m_M, m_n, m_m, m_sigma, p.b0_plan, p.solver);
+            for (size_t j = 0; j < m_N[0]*m_N[1]; ++j)
+                p.b0_plan.w[j] = m_b0[j] / m_w;
+        } else {
+            if (!p.geometry)
+                p.geometry.reset (new NFFTGeometry<NT> (m_N, m_M, m_n, m_m));
+            NFFTTraits<NT>::Init (p.geometry->plan, p.geometry->w.ptr(),
+                p.geometry->w_hat.ptr(), p.plan, p.solver);
+        }
+    }
+
+    /**
+     * @brief     Finalise plans
+     */
+    template <class NT> inline void PlanFinalize (NFFTPlans<NT>& p) NOEXCEPT {
+        if (m_have_b0)
+            NFFTTraits<NT>::Finalize (p.b0_plan, p.solver);
+        else
+            NFFTTraits<NT>::Detach (p.plan, p.solver);
+    }
+
+    /**
+     * @brief     Copy k-space trajectory to plan nodes
+     */
+    template <class NT> inline void PlanKSpace (NFFTPlans<NT>& p, const Matrix<RT>& k) {
+        if (m_have_b0) { // +1D for omega
+            for (size_t j = 0; j < (size_t)p.b0_plan.M_total; ++j) {
+				p.b0_plan.plan.x[3*j+0] = k[2*j+0];
+				p.b0_plan.plan.x[3*j+1] = k[2*j+1];
+                p.b0_plan.plan.x[3*j+2] = (m_t[j]-m_ts)*m_w/m_N.back();
             }
+        } else {
+            if (k.Size() == p.geometry->plan.M_total*m_rank)
+                std::copy (k.Begin(), k.End(), p.geometry->plan.x);
+            else if (k.Size() == p.geometry->plan.M_total*m_rank*m_ncart)
+                m_per_slice_kspace = true;
+        }
+    }
+
+    /**
+     * @brief     Copy weights to solver and precompute damping and psi
+     */
+    template <class NT> inline void PlanWeights (NFFTPlans<NT>& p, const Matrix<RT>& w) NOEXCEPT {
+    	if (m_have_b0)
+    		assert (w.Size() == p.b0_plan.M_total);
+    	else
+    		assert (w.Size() == p.geometry->plan.M_total);
+        std::copy (w.Begin(), w.End(), p.solver.w);
+        if (m_have_b0) {
+            NFFTTraits<NT>::Weights (p.b0_plan.plan, p.solver, m_rank);
+            NFFTTraits<NT>::Psi (p.b0_plan.plan);
+        } else {
+        	NFFTTraits<NT>::Weights (p.geometry->plan, p.solver, m_rank);
+        	NFFTTraits<NT>::Psi (p.geometry->plan);
+        }
+    }
+
+    /**
+     * @brief     Forward transform with plans of precision NT
+     */
+    template <class NT> inline Matrix<T>
+    PlanTrafo (const NFFTPlans<NT>& p, const MatrixType<T>& m) const NOEXCEPT {
+
+        const bool cart = m_3rd_dim_cart && m_ncart > 1;
+        Matrix<T> out (m_M, (cart ? m_ncart : 1));
+        NT* f_hat = (NT*) (m_have_b0 ? p.b0_plan.f_hat : p.plan.f_hat);
+        const NT* f = (const NT*) (m_have_b0 ? p.b0_plan.f : p.plan.f);
+        size_t n = numel(m)/m_ncart;
+
+        Matrix<T> kz;
+        if (cart) { // Cartesian FT 3rd dim
+            kz = Matrix<T> (n, m_ncart);
+            for (size_t j = 0; j < kz.Size(); ++j)
+                kz[j] = m[j];
+            codeare::matrix::fftn (kz.Ptr(), size(kz), Vector<size_t>(1,1), true, true,
+                (RT)(1. / sqrt((double)m_ncart)));
+        }
+        const MatrixType<T>& in = cart ? (const MatrixType<T>&) kz : m;
+
+        for (size_t i = 0; i < m_ncart; ++i) {
+
+            size_t os = i*n;
+            if (m_have_b0)
+                for (size_t j = 0; j < n; ++j)
+                    f_hat[j] = NT(in[j+os] * std::polar<RT>((RT)1.,
+                        (RT)(2. * PI * m_ts * m_b0[j] * m_w)));
+            else
+                for (size_t j = 0; j < n; ++j)
+                    f_hat[j] = NT(in[j+os]);
 
 			if (m_have_b0)
-				NFFTTraits<NFFTType>::Trafo (m_b0_plan);
+				NFFTTraits<NT>::Trafo (p.b0_plan);
 			else
-				NFFTTraits<NFFTType>::Trafo (m_plan);
+				NFFTTraits<NT>::Trafo (p.plan);
 
-			tmpd = (NFFTRType*) m_plan.f;
-			tmpt = (RT*) (out.Ptr() + i*m_M);
-			std::copy (tmpd, tmpd+2*m_M, tmpt);
+            T* o = out.Ptr() + i*m_M;
+            for (size_t j = 0; j < m_M; ++j)
+                o[j] = T(f[j]);
 
         }
 
         return squeeze(out);
-        
+
     }
-    
-    
+
     /**
-     * @brief    Backward transform
-     *
-     * @param  m To transform
-     * @return   Transform
+     * @brief     Backward transform with plans of precision NT
      */
-	virtual Matrix<T> Adjoint (const MatrixType<T>& m) const {
+    template <class NT> inline Matrix<T>
+    PlanAdjoint (const NFFTPlans<NT>& p, const MatrixType<T>& m) const {
 
         Vector<size_t> N = m_N;
-        NFFTRType* tmpd;
-        RT* tmpt;
-        
+        size_t n = m_imgsz/2;
+
         if (m_have_b0)
             N.pop_back();
         if (m_3rd_dim_cart && m_ncart > 1) // Cartesian FT 3rd dim
         	N.push_back(m_ncart);
 
         Matrix<T> out (N);
+        NT* y = (NT*) p.solver.y;
+        const NT* f_hat = (const NT*) p.solver.f_hat_iter;
+
         for (size_t i = 0; i < m_ncart; ++i) {
-            
-			tmpd = (NFFTRType*) m_solver.y;
-            
+
             size_t os = i*m_M;
-            for (size_t j = 0; j < m_M; ++j) {
-                tmpd[2*j+0] = real(m[os+j]);
-                tmpd[2*j+1] = imag(m[os+j]);
-            }
-            
+            for (size_t j = 0; j < m_M; ++j)
+                y[j] = NT(m[os+j]);
+
 			if (m_have_b0)
-				NFFTTraits<NFFTType>::ITrafo
-                    ((B0Plan&) m_b0_plan, (Solver&) m_solver, m_maxit, m_epsilon);
+				NFFTTraits<NT>::ITrafo ((typename NFFTTraits<NT>::B0Plan&) p.b0_plan,
+                    (typename NFFTTraits<NT>::Solver&) p.solver, m_maxit, m_epsilon);
 			else
-				NFFTTraits<NFFTType>::ITrafo
-                    ((Plan&)    m_plan,   (Solver&) m_solver, m_maxit, m_epsilon);
-            
-			tmpd = (NFFTRType*) m_solver.f_hat_iter;
-			tmpt = (RT*) out.Ptr() + i*m_imgsz;
+				NFFTTraits<NT>::ITrafo ((typename NFFTTraits<NT>::Plan&) p.plan,
+                    (typename NFFTTraits<NT>::Solver&) p.solver, m_maxit, m_epsilon);
 
-            std::copy (tmpd, tmpd+m_imgsz, tmpt);
+            T* o = out.Ptr() + i*n;
+            for (size_t j = 0; j < n; ++j)
+                o[j] = T(f_hat[j]);
 
 			//TODO: b0 not 2D+1D+1D
 			if (m_have_b0)
-				for (size_t j = 0; j < out.Size(); ++j)
-					out[j + i*m_imgsz / 2] *= std::polar<RT>((RT)1.,
-							(RT)(-2. * PI * m_ts * m_b0[j] * m_w));
+				for (size_t j = 0; j < n; ++j)
+					o[j] *= std::polar<RT>((RT)1., (RT)(-2. * PI * m_ts * m_b0[j] * m_w));
 
         }
 
-/*        if (m_3rd_dim_cart && m_ncart > 1) { // Cartesian FT 3rd dim
-        	int n = static_cast<int>(m_ncart);
-        	out = permute (out, 2, 0, 1);
-        	size_t cent = std::ceil(.5*m_ncart);
-        	Matrix<T> tmp;
-        	for (size_t i = 0; i < m_imgsz/2; ++i) { // fftshift colums
-				tmp = Column (out,i);
-				std::rotate(tmp.Begin(), tmp.Begin()+cent, tmp.End());
-				Column (out, i, tmp);
-        	}
-        	CartPlan cp = FTTraits<T>::DFTPlanMany (1, &n, m_imgsz/2,
-        			(FTType*)out.Ptr(),	(FTType*)out.Ptr(), FFTW_BACKWARD);
-        	FTTraits<T>::Execute(cp);
-        	FTTraits<T>::Destroy(cp);
-        	for (size_t i = 0; i < m_imgsz/2; ++i) { // fftshift colums
-				tmp = Column (out,i);
-				std::rotate(tmp.Begin(), tmp.Begin()+cent, tmp.End());
-				Column (out, i, tmp);
-        	}
-        	out = permute (out, 1, 2, 0)/sqrt((RT)m_ncart);
-            }*/
+        if (m_3rd_dim_cart && m_ncart > 1) { // Cartesian FT 3rd dim
+            Vector<size_t> dims (2, n);
+            dims[1] = m_ncart;
+            codeare::matrix::fftn (out.Ptr(), dims, Vector<size_t>(1,1), true, false,
+                (RT)(1. / sqrt((double)m_ncart)));
+        }
 
         return out;
-        
-    }
-
-    
-    Plan& NFFTPlan() {return m_plan;}
-    const Plan& NFFTPlan() const {return m_plan;}
 
-
-    inline size_t Rank() const NOEXCEPT { return m_rank; }
-    
-    inline size_t ImageSize () const {return (size_t)m_plan.N[0];}
-    inline size_t KSpaceSize () const {return (size_t)m_plan.M_total;}
-    inline size_t Maxit () const {return m_maxit;}
-    inline RT Alpha() const {return m_alpha;}
-    inline RT Sigma() const {return m_sigma;}
-    inline RT Epsilon() const {return m_epsilon;}
-
-    virtual std::ostream& Print (std::ostream& os) const {
-		Operator<T>::Print(os);
-    	os << "    image size: rank(" << Rank() << ") side(" <<
-            ImageSize() << ") nodes(" << KSpaceSize() << ")" << std::endl;
-    	os << "    nfft: maxit(" << Maxit() << ") eps(" << Epsilon() <<	") alpha("
-           << Alpha() << ") m("<< m_m <<") sigma(" << Sigma() << ")" << std::endl;
-    	os << "    have_kspace(" << m_have_kspace << ") have_weights(" <<
-            m_have_weights << ") have_b0(" << m_have_b0 << ")" << std::endl;
-    	os << "    ft-threads(" << m_np << ")";
-    	if (m_3rd_dim_cart)
-    		os << " 3rd dimension (" << m_ncart << ") is Cartesian.";
-    	return os;
     }
-
-private:
     
     bool       m_initialised;   /**< @brief Memory allocated / Plans, well, planned! :)*/
     bool       m_have_pc, m_have_b0;
@@ -480,7 +584,6 @@ private:
 
     Vector<size_t> m_N;      /**< @brief Image matrix side length (incl. k_{\\omega})*/
     Vector<size_t> m_n;      /**< @brief Oversampling */
-    Vector<RT> m_k, m_kw;
 
     size_t     m_M;             /**< @brief Number of k-space knots */
     size_t     m_maxit;         /**< @brief Number of Recon iterations (NFFT 3) */
@@ -488,12 +591,11 @@ private:
     RT         m_alpha, m_sigma;
     size_t     m_imgsz;
     
-    Plan       m_plan;         /**< nfft  plan */
-    B0Plan     m_b0_plan;
-    Solver     m_solver;         /**< infft plan */
-    CartPlan   m_cart_plan;
+    NFFTPlans<NFFTType>  m_plans;  /**< @brief Plans in native precision */
+    NFFTPlans<NFFTDType> m_dplans; /**< @brief Plans in double precision (double_precision) */
     
     bool       m_3rd_dim_cart, m_have_weights, m_have_kspace, m_per_slice_kspace;
+    bool       m_double;        /**< @brief Use double precision plans */
 
     size_t     m_m, m_ncart;
 
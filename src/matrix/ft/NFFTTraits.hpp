@@ -75,6 +75,69 @@ template <> struct NFFTTraits<std::complex<double> > {
 
     }
 
+    /**
+     * @brief            Initialise geometry plan (nodes, window and phi_hut tables)
+     *                   shared by workspace plans. No transform buffers are allocated.
+     *
+     * @param  N         Actual dimensions
+     * @param  M         Number of k-space samples
+     * @param  n         Oversampled N
+     * @param  m         Spatial cutoff
+     * @param  plan      Geometry plan
+     *
+     * @return success
+     */
+    inline static int InitGeometry (const Vector<int>& N, size_t M, const Vector<int>& n,
+    		int m, Plan& plan) NOEXCEPT {
+
+        Vector<int> _N(N), _n(n);
+        int _d (N.size()), _M(M), _m(m);
+        unsigned nfft_flags = NFFT_OMP_BLOCKWISE_ADJOINT | PRE_PHI_HUT | PRE_PSI | MALLOC_X;
+
+        nfft_init_guru (&plan, _d, _N.ptr(), _M, _n.ptr(), _m, nfft_flags,
+                FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+
+        return 0;
+
+    }
+
+    /**
+     * @brief            Initialise workspace plan and solver on shared geometry
+     *
+     * @param  geometry  Geometry plan
+     * @param  w         Shared k-space weights (M)
+     * @param  w_hat     Shared damping factors (N_total)
+     * @param  plan      Forward FT plan (transform buffers only)
+     * @param  solver    Inverse FT plan
+     *
+     * @return success
+     */
+    inline static int Init (const Plan& geometry, RT* w, RT* w_hat, Plan& plan,
+            Solver& solver) NOEXCEPT {
+
+        fftw_init_threads();
+
+        unsigned fftw_flags  = FFTW_ESTIMATE | FFTW_DESTROY_INPUT;
+        unsigned nfft_flags  = MALLOC_F_HAT | MALLOC_F | FFTW_INIT | FFT_OUT_OF_PLACE;
+
+        nfft_init_guru (&plan, geometry.d, geometry.N, geometry.M_total, geometry.n,
+                geometry.m, nfft_flags, fftw_flags);
+        plan.x         = geometry.x;
+        plan.psi       = geometry.psi;
+        plan.c_phi_inv = geometry.c_phi_inv;
+        plan.index_x   = geometry.index_x;
+        plan.flags    |= geometry.flags & (PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES |
+                NFFT_OMP_BLOCKWISE_ADJOINT);
+
+        solver_init_advanced_complex (&solver, (nfft_mv_plan_complex*) &plan, CGNR);
+        solver.w       = w;
+        solver.w_hat   = w_hat;
+        solver.flags  |= PRECOMPUTE_DAMP | PRECOMPUTE_WEIGHT;
+
+        return 0;
+
+    }
+
     /**
      * @brief            Initialise plan
      *
@@ -302,9 +365,36 @@ template <> struct NFFTTraits<std::complex<double> > {
         return 0;
     }
 
+
+    /**
+     * @brief            Finalise geometry plan
+     *
+     * @param  plan        Geometry plan
+     * @return           Success
+     */
+    inline static int Finalize (Plan& plan) NOEXCEPT {
+        nfft_finalize(&plan);
+        return 0;
+    }
+
+    /**
+     * @brief            Finalise workspace plans without releasing shared geometry
+     *
+     * @param  plan        Workspace plan
+     * @param  solver       Solver plan
+     * @return           Success
+     */
+    inline static int Detach (Plan& plan, Solver& solver) NOEXCEPT {
+        plan.flags   &= ~(PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT);
+        plan.x = 0; plan.psi = 0; plan.c_phi_inv = 0; plan.index_x = 0;
+        solver.flags &= ~(PRECOMPUTE_DAMP | PRECOMPUTE_WEIGHT);
+        solver.w = 0; solver.w_hat = 0;
+        return Finalize (plan, solver);
+    }
+
 };
 
-#ifdef HAVE_NFFT3F_UNUSED
+#ifdef HAVE_NFFT3F
 
 template <> struct NFFTTraits<std::complex<float> > {
 
@@ -329,6 +419,8 @@ template <> struct NFFTTraits<std::complex<float> > {
     inline static int Init (const Vector<int>& N, size_t M, const Vector<int>& n,
     		int m, Plan& plan, Solver& solver) NOEXCEPT {
 
+        fftwf_init_threads();
+
         Vector<int> _N(N), _n(n);
         int _d (N.size()), _M(M), _m(m);
         unsigned nfft_flags, fftw_flags, solver_flags;
@@ -345,6 +437,69 @@ template <> struct NFFTTraits<std::complex<float> > {
 
     }
 
+    /**
+     * @brief            Initialise geometry plan (nodes, window and phi_hut tables)
+     *                   shared by workspace plans. No transform buffers are allocated.
+     *
+     * @param  N         Actual dimensions
+     * @param  M         Number of k-space samples
+     * @param  n         Oversampled N
+     * @param  m         Spatial cutoff
+     * @param  plan      Geometry plan
+     *
+     * @return success
+     */
+    inline static int InitGeometry (const Vector<int>& N, size_t M, const Vector<int>& n,
+    		int m, Plan& plan) NOEXCEPT {
+
+        Vector<int> _N(N), _n(n);
+        int _d (N.size()), _M(M), _m(m);
+        unsigned nfft_flags = NFFT_OMP_BLOCKWISE_ADJOINT | PRE_PHI_HUT | PRE_PSI | MALLOC_X;
+
+        nfftf_init_guru (&plan, _d, _N.ptr(), _M, _n.ptr(), _m, nfft_flags,
+                FFTW_ESTIMATE | FFTW_DESTROY_INPUT);
+
+        return 0;
+
+    }
+
+    /**
+     * @brief            Initialise workspace plan and solver on shared geometry
+     *
+     * @param  geometry  Geometry plan
+     * @param  w         Shared k-space weights (M)
+     * @param  w_hat     Shared damping factors (N_total)
+     * @param  plan      Forward FT plan (transform buffers only)
+     * @param  solver    Inverse FT plan
+     *
+     * @return success
+     */
+    inline static int Init (const Plan& geometry, RT* w, RT* w_hat, Plan& plan,
+            Solver& solver) NOEXCEPT {
+
+        fftwf_init_threads();
+
+        unsigned fftw_flags  = FFTW_ESTIMATE | FFTW_DESTROY_INPUT;
+        unsigned nfft_flags  = MALLOC_F_HAT | MALLOC_F | FFTW_INIT | FFT_OUT_OF_PLACE;
+
+        nfftf_init_guru (&plan, geometry.d, geometry.N, geometry.M_total, geometry.n,
+                geometry.m, nfft_flags, fftw_flags);
+        plan.x         = geometry.x;
+        plan.psi       = geometry.psi;
+        plan.c_phi_inv = geometry.c_phi_inv;
+        plan.index_x   = geometry.index_x;
+        plan.flags    |= geometry.flags & (PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES |
+                NFFT_OMP_BLOCKWISE_ADJOINT);
+
+        solverf_init_advanced_complex (&solver, (nfftf_mv_plan_complex*) &plan, CGNR);
+        solver.w       = w;
+        solver.w_hat   = w_hat;
+        solver.flags  |= PRECOMPUTE_DAMP | PRECOMPUTE_WEIGHT;
+
+        return 0;
+
+    }
+
     /**
      * @brief            Initialise plan
      *
@@ -370,6 +525,7 @@ template <> struct NFFTTraits<std::complex<float> > {
         nfft_flags   = NFFT_OMP_BLOCKWISE_ADJOINT | PRE_PHI_HUT |
                 PRE_PSI | MALLOC_X | MALLOC_F_HAT| MALLOC_F | FFTW_INIT | FFT_OUT_OF_PLACE;
 
+        mrif_inh_3d_init_guru (&plan, _N.ptr(), _M, _n.ptr(), _m, sigma, nfft_flags, fftw_flags);
         solverf_init_advanced_complex (&solver, (nfftf_mv_plan_complex*) &plan, solver_flags);
 
         return 0;
@@ -392,7 +548,7 @@ template <> struct NFFTTraits<std::complex<float> > {
     		RT epsilon = 3.e-7) NOEXCEPT {
 
     	/* Initial guess */
-    	std::fill_n ((RT*)solver.f_hat_iter, 2*plan.N_total, 0.);
+    	std::fill_n ((RT*)solver.f_hat_iter, 2*plan.N_total, 0.f);
 
         solverf_before_loop_complex(&solver);
 
@@ -420,7 +576,7 @@ template <> struct NFFTTraits<std::complex<float> > {
     		RT epsilon = 3.e-7) NOEXCEPT {
 
     	/* Initial guess */
-    	std::fill_n ((RT*)solver.f_hat_iter, 2*plan.N_total, 0.);
+    	std::fill_n ((RT*)solver.f_hat_iter, 2*plan.N_total, 0.f);
 
         solverf_before_loop_complex(&solver);
 
@@ -455,7 +611,7 @@ template <> struct NFFTTraits<std::complex<float> > {
      * @return           Success
      */
     inline static int Trafo (const B0Plan& plan) NOEXCEPT {
-    	//mrif_inh_3d_trafo ((B0Plan*) &plan);
+    	mrif_inh_3d_trafo ((B0Plan*) &plan);
         return 0;
     }
 
@@ -480,7 +636,7 @@ template <> struct NFFTTraits<std::complex<float> > {
      * @return           Success
      */
     inline static int Adjoint  (const B0Plan& plan) NOEXCEPT {
-    	//mrif_inh_3d_adjoint ((B0Plan*) &plan);
+    	mrif_inh_3d_adjoint ((B0Plan*) &plan);
         return 0;
     }
 
@@ -570,6 +726,33 @@ template <> struct NFFTTraits<std::complex<float> > {
         return 0;
     }
 
+
+    /**
+     * @brief            Finalise geometry plan
+     *
+     * @param  plan        Geometry plan
+     * @return           Success
+     */
+    inline static int Finalize (Plan& plan) NOEXCEPT {
+        nfftf_finalize(&plan);
+        return 0;
+    }
+
+    /**
+     * @brief            Finalise workspace plans without releasing shared geometry
+     *
+     * @param  plan        Workspace plan
+     * @param  solver       Solver plan
+     * @return           Success
+     */
+    inline static int Detach (Plan& plan, Solver& solver) NOEXCEPT {
+        plan.flags   &= ~(PRE_PHI_HUT | PRE_PSI | NFFT_SORT_NODES | NFFT_OMP_BLOCKWISE_ADJOINT);
+        plan.x = 0; plan.psi = 0; plan.c_phi_inv = 0; plan.index_x = 0;
+        solver.flags &= ~(PRECOMPUTE_DAMP | PRECOMPUTE_WEIGHT);
+        solver.w = 0; solver.w_hat = 0;
+        return Finalize (plan, solver);
+    }
+
 };
 
 #endif
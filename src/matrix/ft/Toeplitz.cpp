@@ -0,0 +1,4 @@
+#include "Toeplitz.hpp"
+
+template class Toeplitz<std::complex<float> >;
+template class Toeplitz<std::complex<double> >;
@@ -0,0 +1,239 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __TOEPLITZ_HPP__
+#define __TOEPLITZ_HPP__
+
+#include "MCNUFFT.hpp"
+
+/**
+ * @brief Toeplitz embedding of the non-Cartesian normal operator E^H W E<br/>
+ *        For a fixed trajectory and weights E^H W E is a convolution with the
+ *        weighted point spread function. Its circulant embedding on a 2x grid is
+ *        applied with one forward and one backward FFT per coil.<br/>
+ *        Fessler et al. IEEE Trans Signal Process 2005, 53(9):3393-3402.
+ */
+template <class T>
+class Toeplitz {
+
+	typedef typename TypeTraits<T>::RT RT;
+	typedef typename FTTraits<T>::Plan Plan;
+	typedef typename FTTraits<T>::T    FTType;
+
+public:
+
+    /**
+     * @brief         Default constructor
+     */
+    Toeplitz () NOEXCEPT : m_rank (0), m_Nt (0), m_nt (0), m_fwd (0), m_bwd (0),
+        m_plan_nc (0), m_np (ExecutionContext::Instance().Threads()) {}
+
+    /**
+     * @brief         Copy constructor
+     */
+    Toeplitz (const Toeplitz<T>& tp) NOEXCEPT : m_fwd (0), m_bwd (0), m_plan_nc (0) {
+        *this = tp;
+    }
+
+    /**
+     * @brief         Clean up and destruct
+     */
+    virtual ~Toeplitz () NOEXCEPT {
+        DestroyPlans();
+    }
+
+    /**
+     * @brief         Assignment (FFTW plans are made on first use)
+     */
+    inline Toeplitz<T>& operator= (const Toeplitz<T>& tp) NOEXCEPT {
+        if (this == &tp)
+            return *this;
+        DestroyPlans();
+        m_rank = tp.m_rank;
+        m_N    = tp.m_N;
+        m_n    = tp.m_n;
+        m_Nt   = tp.m_Nt;
+        m_nt   = tp.m_nt;
+        m_kern = tp.m_kern;
+        m_np   = tp.m_np;
+        return *this;
+    }
+
+    /**
+     * @brief         Compute transfer function of E^H W E
+     *
+     * @param  p      Parameters as for MCNUFFT (imsz, nk, m, alpha, threads)
+     * @param  k      Trajectory (rank x nk) in [-.5,.5)
+     * @param  w      K-space weights (nk), unity if empty
+     */
+    inline void Kernel (const Params& p, const Matrix<RT>& k, const Matrix<RT>& w) {
+
+        DestroyPlans();
+        m_N    = boost::any_cast<Vector<size_t> >(p["imsz"]);
+        m_rank = m_N.size();
+        m_np   = try_to_fetch<int> (p, "threads", ExecutionContext::Instance().Threads());
+        m_n    = m_N;
+        m_Nt   = prod (m_N);
+        m_nt   = 1;
+        for (size_t d = 0; d < m_rank; ++d) {
+            m_n[d] = 2*m_N[d];
+            m_nt  *= m_n[d];
+        }
+
+        // PSF on [-N,N)^d from weighted gridding of unit data. Kernel uses the
+        // reconstruction's gridding parameters (m, alpha), i.e. the same
+        // approximation of E^H W as the adjoint giving CG's right-hand side.
+        Params pp = p;
+        pp["imsz"]  = m_n;
+        MCNUFFT<T> ft (pp);
+        ft.KSpace (k);
+        if (w.Size() > 1)
+            ft.Weights (w);
+        Matrix<T> psf = ft ->* ones<T> (ft.KSpaceSize(), 1);
+
+        // Circulant embedding: element d of the PSF at grid position d mod 2N
+        m_kern.resize (m_nt);
+        size_t n1 = (m_rank > 1) ? m_n[1] : 1, n2 = (m_rank > 2) ? m_n[2] : 1;
+#pragma omp parallel for schedule (static)
+        for (int z = 0; z < (int)n2; ++z)
+            for (size_t y = 0; y < n1; ++y)
+                for (size_t x = 0; x < m_n[0]; ++x) {
+                    size_t sz = (m_rank > 2) ? (z + m_N[2]) % m_n[2] : 0;
+                    size_t sy = (m_rank > 1) ? (y + m_N[1]) % m_n[1] : 0;
+                    size_t sx = (x + m_N[0]) % m_n[0];
+                    m_kern[(z*n1 + y)*m_n[0] + x] = psf[(sz*n1 + sy)*m_n[0] + sx];
+                }
+
+        int n[3];
+        for (size_t d = 0; d < m_rank; ++d)
+            n[d] = m_n[m_rank-1-d]; // FFTW is row-major
+        Plan plan = FTTraits<T>::DFTPlanMany (m_rank, n, 1, (FTType*)m_kern.ptr(),
+            (FTType*)m_kern.ptr(), 1, 1, FFTW_FORWARD, m_np);
+        FTTraits<T>::Execute (plan);
+        FTTraits<T>::Destroy (plan);
+
+        RT scale = 1. / m_nt; // Unnormalised FFTW round trip
+        for (size_t i = 0; i < m_nt; ++i)
+            m_kern[i] *= scale;
+
+    }
+
+    /**
+     * @brief         Sensitivity encoded normal operator
+     *                out = ic * sum_c conj(s_c) E^H W E (s_c x)
+     *
+     * @param  x      Image(s)
+     * @param  off    Offset of volume in x and out
+     * @param  sm     Sensitivities (imsz..., nc)
+     * @param  csm    Conjugate sensitivities
+     * @param  ic     Intensity correction
+     * @param  out    Output image(s)
+     */
+    inline void Normal (const MatrixType<T>& x, size_t off, const Matrix<T>& sm,
+                        const Matrix<T>& csm, const Matrix<RT>& ic, Matrix<T>& out) const {
+
+        size_t nc = sm.Size() / m_Nt;
+        Plans (nc);
+
+        size_t N1 = (m_rank > 1) ? m_N[1] : 1, N2 = (m_rank > 2) ? m_N[2] : 1;
+        size_t n0 = m_n[0], n1 = (m_rank > 1) ? m_n[1] : 1;
+
+        // Coil images zero-padded into coil-innermost grid
+        std::fill (m_grid.begin(), m_grid.end(), T(0.));
+#pragma omp parallel for schedule (static)
+        for (int z = 0; z < (int)N2; ++z)
+            for (size_t y = 0; y < N1; ++y)
+                for (size_t x0 = 0; x0 < m_N[0]; ++x0) {
+                    size_t i = x0 + m_N[0]*(y + N1*z);
+                    T* g = &m_grid[((z*n1 + y)*n0 + x0)*nc];
+                    T v = x[off+i];
+                    for (size_t c = 0; c < nc; ++c)
+                        g[c] = sm[c*m_Nt+i] * v;
+                }
+
+        FTTraits<T>::Execute (m_fwd);
+#pragma omp parallel for schedule (static)
+        for (int i = 0; i < (int)m_nt; ++i) {
+            T* g = &m_grid[i*nc];
+            for (size_t c = 0; c < nc; ++c)
+                g[c] *= m_kern[i];
+        }
+        FTTraits<T>::Execute (m_bwd);
+
+        // Crop and coil combine
+#pragma omp parallel for schedule (static)
+        for (int z = 0; z < (int)N2; ++z)
+            for (size_t y = 0; y < N1; ++y)
+                for (size_t x0 = 0; x0 < m_N[0]; ++x0) {
+                    size_t i = x0 + m_N[0]*(y + N1*z);
+                    const T* g = &m_grid[((z*n1 + y)*n0 + x0)*nc];
+                    T s = T(0.);
+                    for (size_t c = 0; c < nc; ++c)
+                        s += csm[c*m_Nt+i] * g[c];
+                    out[off+i] = s * ic[i];
+                }
+
+    }
+
+    inline bool Empty () const NOEXCEPT { return m_kern.empty(); }
+
+private:
+
+    /**
+     * @brief         (Re-)allocate grid and FFTW plans for nc coils
+     */
+    inline void Plans (size_t nc) const {
+        if (nc == m_plan_nc)
+            return;
+        DestroyPlans();
+        m_grid.resize (m_nt*nc);
+        int n[3];
+        for (size_t d = 0; d < m_rank; ++d)
+            n[d] = m_n[m_rank-1-d];
+        m_fwd = FTTraits<T>::DFTPlanMany (m_rank, n, nc, (FTType*)m_grid.ptr(),
+            (FTType*)m_grid.ptr(), nc, 1, FFTW_FORWARD, m_np);
+        m_bwd = FTTraits<T>::DFTPlanMany (m_rank, n, nc, (FTType*)m_grid.ptr(),
+            (FTType*)m_grid.ptr(), nc, 1, FFTW_BACKWARD, m_np);
+        m_plan_nc = nc;
+    }
+
+    inline void DestroyPlans () const {
+        if (m_plan_nc) {
+            FTTraits<T>::Destroy (m_fwd);
+            FTTraits<T>::Destroy (m_bwd);
+        }
+        m_plan_nc = 0;
+    }
+
+    size_t         m_rank;         /**< @brief Dimensionality (1..3) */
+    Vector<size_t> m_N;            /**< @brief Image side lengths */
+    Vector<size_t> m_n;            /**< @brief Embedding side lengths (2N) */
+    size_t         m_Nt, m_nt;     /**< @brief Image and embedding sizes */
+    Vector<T>      m_kern;         /**< @brief Transfer function (scaled) */
+
+    mutable Vector<T> m_grid;      /**< @brief Embedding grid (nc x 2N) */
+    mutable Plan   m_fwd, m_bwd;   /**< @brief FFTW plans on m_grid */
+    mutable size_t m_plan_nc;      /**< @brief # coils m_grid and plans are made for */
+
+    int            m_np;           /**< @brief # of FFTW threads */
+
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "Matrix.hpp"
+#include "Creators.hpp"
+#include "Workspace.hpp"
+#include "CS_XSENSE.hpp"
+
+#include <cstdlib>
+
+/**
+ * @brief Wall time to reach a given NRMSE of a TV regularised Cartesian CS
+ *        reconstruction of the Shepp-Logan phantom for NLCG (backtracking,
+ *        batched and interpolating line search) and the proximal solvers
+ *        (Split Bregman, ADMM, FISTA)
+ *
+ * Usage: t_csbench [n] [nrmse] [iterations]
+ */
+int main (int narg, char** argv) {
+
+    const size_t n     = (narg > 1) ? atoi(argv[1]) : 64;
+    const float  nrmse = (narg > 2) ? atof(argv[2]) : .1;
+    const int    iter  = (narg > 3) ? atoi(argv[3]) : 40;
+
+    Vector<size_t> dims (2, n);
+    Matrix<cxfl> x = phantom<cxfl>(n);
+
+    // Variable density random mask, fully sampled centre
+    Matrix<float> mask (n,n);
+    Matrix<float>& pdf = wspace.AddMatrix<float>("pdf");
+    pdf = Matrix<float>(n,n);
+    srand (42);
+    for (size_t j = 0; j < n; ++j)
+        for (size_t i = 0; i < n; ++i) {
+            float kx = (float)i-n/2, ky = (float)j-n/2;
+            float r = sqrt(kx*kx+ky*ky)/(n/2);
+            pdf(i,j) = (r < .1) ? 1. : std::min (1., .3/r);
+            mask(i,j) = ((float)rand()/RAND_MAX < pdf(i,j)) ? 1. : 0.;
+        }
+
+    // NLCG with backtracking, batched and interpolating line search, proximal solvers
+    const int solvers[] = {0, 0, 0, 2, 3, 4}, linesearch[] = {0, 1, 2, 0, 0, 0};
+    const char* ls_names[] = {"", " batch", " interp"};
+    int ret = 0;
+
+    for (size_t s = 0; s < 6; ++s) {
+
+        Params p;
+        p["ft"]          = 0;
+        p["dims"]        = dims;
+        p["imsz"]        = dims;
+        p["threads"]     = 1;
+        p["nlopt"]       = solvers[s];
+        p["csiter"]      = 1;
+        p["nliter"]      = iter;
+        p["wl_family"]   = -1;
+        p["tvw1"]        = .01f;
+        p["l1"]          = 1.e-6f;
+        p["pnorm"]       = 1.f;
+        p["lsiter"]      = 8;
+        p["lsa"]         = .01f;
+        p["lsb"]         = .6f;
+        p["linesearch"]  = linesearch[s];
+        p["cgconv"]      = 0.f;
+        p["mu"]          = .05f;
+        p["xiter"]       = 4;
+        p["proxiter"]    = 5;
+
+        CS_XSENSE<cxfl> cs (p);
+        cs.Mask (mask);
+        Matrix<cxfl> data = cs * x;
+
+        NonLinear<cxfl>* nlopt = cs.getNLOpt();
+        nlopt->Reference (x);
+        cs ->* data;
+
+        const Vector<float>& err = nlopt->Errors();
+        const Vector<double>& t = nlopt->Timings();
+        size_t i = 0;
+        while (i < err.size() && err[i] > nrmse)
+            ++i;
+        std::string name = std::string(nlopt_names[solvers[s]]) + ls_names[linesearch[s]];
+        if (i < err.size())
+            printf ("  %-14s nrmse(%.3f) after %3zu iterations in %.3fs (final %.4f)\n",
+                    name.c_str(), nrmse, i+1, t[i], err.back());
+        else
+            printf ("  %-14s nrmse(%.3f) not reached in %zu iterations, %.3fs (final %.4f)\n",
+                    name.c_str(), nrmse, err.size(), t.size() ? t.back() : 0.,
+                    err.size() ? err.back() : 1.);
+        ret += (err.size() && boost::math::isnan(err.back())) ? 1 : 0;
+
+    }
+
+    return ret;
+
+}
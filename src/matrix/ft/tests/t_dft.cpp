@@ -5,13 +5,81 @@
 #include "DFT.hpp"
 
 
+/**
+ * @brief <Fx,y> = <x,F^H y> with and without mask, F^H F = I without mask
+ */
+template<class T> inline static int adjoint (const Vector<size_t>& n) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    Matrix<T> x = randn<T>(n), y = randn<T>(n);
+    Matrix<RT> mask = rand<RT>(n);
+    for (size_t i = 0; i < mask.Size(); ++i)
+        mask[i] = (mask[i] > .5) ? 1. : 0.;
+
+    int ret = 0;
+    for (size_t k = 0; k < 2; ++k) {
+        DFT<T> ft (n);
+        if (k)
+            ft.Mask (mask);
+        Matrix<T> Fx = ft * x, Fhy = ft ->* y;
+        T lhs = 0., rhs = 0.;
+        for (size_t i = 0; i < x.Size(); ++i) {
+            lhs += std::conj(Fx[i]) * y[i];
+            rhs += std::conj(x[i]) * Fhy[i];
+        }
+        ret += (std::abs(lhs-rhs) < 1.e-4*std::abs(lhs)) ? 0 : 1;
+        if (!k) {
+            Matrix<T> z = ft ->* Fx;
+            RT d = 0.;
+            for (size_t i = 0; i < x.Size(); ++i)
+                d = std::max (d, (RT)std::abs(z[i]-x[i]));
+            ret += (d < 1.e-4) ? 0 : 1;
+        }
+    }
+
+    printf ("  %s %zu x %zu x %zu: %s\n", TypeTraits<T>::Name().c_str(), n[0], n[1],
+            (n.size() > 2) ? n[2] : 1, ret ? "FAILED" : "OK");
+    return ret;
+
+}
+
+
+/**
+ * @brief Cached plans are shared per geometry and planner rigour
+ */
+inline static int cache () {
+
+    typedef FTPlanCache<cxfl> PC;
+    PC& pc = PC::Instance();
+    Matrix<cxfl> a (12,10);
+    int n[2] = {10, 12};
+    size_t s = pc.Size();
+
+    PC::Plan p = pc.Get (2, n, 1, FFTW_FORWARD, (PC::T*)a.Ptr(), (PC::T*)a.Ptr());
+    PC::Plan q = pc.Get (2, n, 1, FFTW_FORWARD, (PC::T*)a.Ptr(), (PC::T*)a.Ptr());
+    pc.Planner ("measure");
+    PC::Plan r = pc.Get (2, n, 1, FFTW_FORWARD, (PC::T*)a.Ptr(), (PC::T*)a.Ptr());
+    pc.Planner ("estimate");
+
+    int ret = (p == q && p != r && pc.Size() == s + 2) ? 0 : 1;
+    printf ("  plan cache: %s\n", ret ? "FAILED" : "OK");
+    return ret;
+
+}
+
+
 int main (int args, char** argv) {
 
     Matrix<cxfl> A = rand<cxfl> (8,8), B;
 
     DFT<cxfl> ft (size(A));
     B = ft * A;
-    
-    return 0;
-    
+
+    Vector<size_t> n (2, 8), m (2), l (3);
+    m[0] = 7; m[1] = 9;
+    l[0] = 6; l[1] = 5; l[2] = 4;
+
+    return adjoint<cxfl> (n) + adjoint<cxfl> (m) + adjoint<cxdb> (l) + cache ();
+
 }
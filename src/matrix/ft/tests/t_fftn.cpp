@@ -0,0 +1,32 @@
+#include "DFT.hpp"
+
+template<class T> inline int check () {
+
+    typedef typename TypeTraits<T>::RT RT;
+    const RT eps = (sizeof(RT) == 4) ? 1.e-4 : 1.e-10;
+
+    Matrix<T> A (5,6,3,4,2);
+    for (size_t i = 0; i < A.Size(); ++i)
+        A[i] = T(std::sin(.3*i), std::cos(.11*i));
+
+    // Non-leading axes, odd and even
+    Vector<size_t> axes;
+    axes.push_back(1); axes.push_back(3);
+    Matrix<T> K = fftn (A, axes);
+    Matrix<T> R = ifftn (K, axes);
+    Matrix<T> C = fft (fft (A, 1), 3) * (RT)(24. / A.Size() / sqrt(24.));
+
+    RT er = 0, ec = 0;
+    for (size_t i = 0; i < A.Size(); ++i) {
+        er = std::max (er, std::abs (R[i] - A[i]));
+        ec = std::max (ec, std::abs (K[i] - C[i]));
+    }
+    std::cout << "ifftn(fftn(A)) - A: " << er << ", fftn(A) - fft(fft(A,1),3): " << ec << std::endl;
+
+    return (er < eps && ec < eps) ? 0 : 1;
+
+}
+
+int main (int narg, char** argv) {
+    return check<cxfl>() + check<cxdb>();
+}
@@ -0,0 +1,164 @@
+#include "MCNUFFT.hpp"
+#include "Toeplitz.hpp"
+
+#include <cmath>
+
+/**
+ * @brief Direct non-equidistant DFT (image index centred at N/2)
+ */
+template<class T> inline Matrix<T>
+ndft (const Matrix<T>& img, const Matrix<typename TypeTraits<T>::RT>& k, size_t N, bool fwd) {
+    typedef typename TypeTraits<T>::RT RT;
+    size_t nk = size(k,1);
+    Matrix<T> out = fwd ? Matrix<T>(nk,1) : Matrix<T>(N,N);
+    for (size_t j = 0; j < nk; ++j)
+        for (size_t y = 0; y < N; ++y)
+            for (size_t x = 0; x < N; ++x) {
+                double ph = -2. * PI * (((double)x-N/2)*k(0,j) + ((double)y-N/2)*k(1,j));
+                if (fwd)
+                    out[j] += img(x,y) * std::polar<RT> (1., ph);
+                else
+                    out(x,y) += img[j] * std::polar<RT> (1., -ph);
+            }
+    return out;
+}
+
+template<class T> inline double relerr (const Matrix<T>& a, const Matrix<T>& b) {
+    double num = 0., den = 0.;
+    for (size_t i = 0; i < a.Size(); ++i) {
+        num += std::norm (std::complex<double>(a[i]) - std::complex<double>(b[i]));
+        den += std::norm (std::complex<double>(b[i]));
+    }
+    return sqrt(num/den);
+}
+
+template<class T> inline int check () {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    size_t N = 16, nk = 300, nc = 3;
+    Matrix<RT> k (2, nk);
+    for (size_t j = 0; j < nk; ++j) { // quasi-random nodes in [-.5,.5)
+        k(0,j) = std::fmod (.6180339887 * (j+1), 1.) - .5;
+        k(1,j) = std::fmod (.7548776662 * (j+1), 1.) - .5;
+    }
+    Matrix<T> img (N, N, nc), dat (nk, nc);
+    for (size_t i = 0; i < img.Size(); ++i)
+        img[i] = T (sin(.37*i), cos(.11*i*i));
+    for (size_t i = 0; i < dat.Size(); ++i)
+        dat[i] = T (cos(.23*i), sin(.05*i*i));
+
+    Params p;
+    p["imsz"]  = Vector<size_t> (2, N);
+    p["nk"]    = nk;
+    p["m"]     = (size_t) 3;
+    p["alpha"] = 2.f;
+    MCNUFFT<T> ft (p);
+    ft.KSpace (k);
+
+    Matrix<T> fwd = ft * img, bwd = ft ->* dat;
+    int ret = 0;
+
+    for (size_t c = 0; c < nc; ++c) {
+        Matrix<T> ic = img(CR(),CR(),CR(c)), dc = dat(CR(),CR(c));
+        double ef = relerr (Matrix<T>(fwd(CR(),CR(c))), ndft (ic, k, N, true));
+        double eb = relerr (Matrix<T>(bwd(CR(),CR(),CR(c))), ndft (dc, k, N, false));
+        printf ("  coil %zu: forward rel. error %.2e, adjoint rel. error %.2e\n", c, ef, eb);
+        ret += (ef < 1.e-3 && eb < 1.e-3) ? 0 : 1;
+    }
+
+    // <A x, y> == <x, A^H y>
+    std::complex<double> l = 0., r = 0.;
+    for (size_t i = 0; i < fwd.Size(); ++i)
+        l += std::complex<double>(fwd[i]) * std::conj(std::complex<double>(dat[i]));
+    for (size_t i = 0; i < img.Size(); ++i)
+        r += std::complex<double>(img[i]) * std::conj(std::complex<double>(bwd[i]));
+    double ea = std::abs(l-r)/std::abs(l);
+    printf ("  adjointness: %.2e\n", ea);
+    ret += (ea < 1.e-4) ? 0 : 1;
+
+    // Copies transform identically
+    MCNUFFT<T> cp (ft);
+    ret += (relerr (Matrix<T>(cp * img), fwd) == 0.) ? 0 : 1;
+
+    return ret;
+
+}
+
+/**
+ * @brief Toeplitz embedded normal operator against direct sum_c conj(s_c) E^H W E s_c x
+ */
+template<class T> inline int toeplitz () {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    size_t N = 16, nk = 300, nc = 3;
+    Matrix<RT> k (2, nk), w (nk, 1), ic (N, N);
+    for (size_t j = 0; j < nk; ++j) {
+        k(0,j) = std::fmod (.6180339887 * (j+1), 1.) - .5;
+        k(1,j) = std::fmod (.7548776662 * (j+1), 1.) - .5;
+        w[j]   = .5 + std::fmod (.3819660113 * j, 1.);
+    }
+    Matrix<T> img (N, N), sm (N, N, nc), ref (N, N);
+    for (size_t i = 0; i < img.Size(); ++i) {
+        img[i] = T (sin(.37*i), cos(.11*i*i));
+        ic[i]  = 1. + .5*cos(.07*i);
+    }
+    for (size_t i = 0; i < sm.Size(); ++i)
+        sm[i] = T (cos(.03*i), sin(.02*i));
+    Matrix<T> csm = conj(sm);
+
+    for (size_t c = 0; c < nc; ++c) {
+        Matrix<T> si (N, N);
+        for (size_t i = 0; i < si.Size(); ++i)
+            si[i] = sm[c*N*N+i] * img[i];
+        Matrix<T> f = ndft (si, k, N, true);
+        for (size_t j = 0; j < nk; ++j)
+            f[j] *= w[j];
+        Matrix<T> b = ndft (f, k, N, false);
+        for (size_t i = 0; i < ref.Size(); ++i)
+            ref[i] += csm[c*N*N+i] * b[i] * ic[i];
+    }
+
+    Params p;
+    p["imsz"]  = Vector<size_t> (2, N);
+    p["nk"]    = nk;
+    p["m"]     = (size_t) 3;
+    p["alpha"] = 2.f;
+    Toeplitz<T> tp;
+    tp.Kernel (p, k, w);
+    Matrix<T> out (N, N);
+    tp.Normal (img, 0, sm, csm, ic, out);
+
+    double e = relerr (out, ref);
+    printf ("  toeplitz normal operator: rel. error %.2e\n", e);
+    int ret = (e < 1.e-3) ? 0 : 1;
+
+    // Kernel at the reconstruction's default gridding (m = 1) against the
+    // batched operator E^H W E which provides CG's right-hand side
+    p["m"] = (size_t) 1;
+    tp.Kernel (p, k, w);
+    tp.Normal (img, 0, sm, csm, ic, out);
+    MCNUFFT<T> ft (p);
+    ft.KSpace (k);
+    ft.Weights (w);
+    Matrix<T> si (N, N, nc);
+    for (size_t i = 0; i < si.Size(); ++i)
+        si[i] = sm[i] * img[i % (N*N)];
+    Matrix<T> ci = ft ->* (ft * si);
+    ref = Matrix<T> (N, N);
+    for (size_t c = 0; c < nc; ++c)
+        for (size_t i = 0; i < ref.Size(); ++i)
+            ref[i] += csm[c*N*N+i] * ci[c*N*N+i] * ic[i];
+
+    e = relerr (out, ref);
+    printf ("  toeplitz vs. gridding normal operator (m = 1): rel. error %.2e\n", e);
+    ret += (e < 5.e-3) ? 0 : 1;
+
+    return ret;
+
+}
+
+int main (int narg, char** argv) {
+    return check<cxfl>() + check<cxdb>() + toeplitz<cxfl>() + toeplitz<cxdb>();
+}
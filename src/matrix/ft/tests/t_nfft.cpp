@@ -0,0 +1,140 @@
+#include "NCSENSE.hpp"
+#include "Creators.hpp"
+#include "OMP.hpp"
+
+#include <cmath>
+
+/**
+ * @brief Radial 2D trajectory with ramp density compensation
+ */
+template<class RT> inline void radial (size_t nr, size_t ns, Matrix<RT>& k, Matrix<RT>& w) {
+    k = Matrix<RT> (2, nr*ns);
+    w = Matrix<RT> (nr*ns, 1);
+    for (size_t s = 0; s < ns; ++s) {
+        RT phi = PI * s / ns;
+        for (size_t r = 0; r < nr; ++r) {
+            RT rho = ((RT)r - .5*nr) / nr;
+            k[2*(s*nr+r)+0] = rho * cos(phi);
+            k[2*(s*nr+r)+1] = rho * sin(phi);
+            w[s*nr+r] = std::max(std::abs(rho), (RT).5/nr);
+        }
+    }
+}
+
+/**
+ * @brief Smooth synthetic coil sensitivities on a ring of coils
+ */
+template<class T> inline Matrix<T> coils (size_t n, size_t nc) {
+    typedef typename TypeTraits<T>::RT RT;
+    Matrix<T> sm (n, n, nc);
+    for (size_t c = 0; c < nc; ++c) {
+        RT cx = .5*n*(1. + .7*cos(2.*PI*c/nc)), cy = .5*n*(1. + .7*sin(2.*PI*c/nc));
+        for (size_t j = 0; j < n; ++j)
+            for (size_t i = 0; i < n; ++i) {
+                RT d2 = ((i-cx)*(i-cx) + (j-cy)*(j-cy)) / (RT)(n*n);
+                sm(i,j,c) = std::polar<RT> (exp(-2.*d2), 2.*PI*c/nc);
+            }
+    }
+    return sm;
+}
+
+template<class T> inline double relerr (const Matrix<T>& a, const Matrix<T>& b) {
+    double num = 0., den = 0.;
+    for (size_t i = 0; i < a.Size(); ++i) {
+        num += std::norm(std::complex<double>(a[i]) - std::complex<double>(b[i]));
+        den += std::norm(std::complex<double>(b[i]));
+    }
+    return sqrt(num/den);
+}
+
+/**
+ * @brief Compare single and double precision NFFT plans on an NCSENSE workload
+ */
+template<class T> inline int check (size_t n, size_t nc, size_t reps) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    size_t nr = 2*n, ns = n;
+    Matrix<RT> k, w;
+    radial (nr, ns, k, w);
+    Matrix<T> img = phantom<T>(n);
+
+    Params p;
+    p["sensitivities"] = coils<T>(n, nc);
+    p["nk"]            = (size_t) (nr*ns);
+    p["ftiter"]        = (size_t) 3;
+    p["cgiter"]        = (size_t) 10;
+    p["cgeps"]         = (RT) 1.e-6;
+    p["lambda"]        = (RT) 1.e-6;
+    p["threads"]       = (int) nc;
+    p["m"]             = (size_t) 1;
+    p["alpha"]         = (RT) 2.;
+
+    Matrix<T> data[2], recon[2];
+    double tfwd[2], tbwd[2];
+
+    for (size_t d = 0; d < 2; ++d) {
+
+        p["double_precision"] = (d == 1);
+        NCSENSE<T> ncs (p);
+        ncs.KSpace (k);
+        ncs.Weights (w);
+
+        double t = omp_get_wtime();
+        for (size_t r = 0; r < reps; ++r)
+            data[d] = ncs * img;
+        tfwd[d] = (omp_get_wtime() - t) / reps;
+
+        t = omp_get_wtime();
+        for (size_t r = 0; r < reps; ++r)
+            recon[d] = ncs ->* data[d];
+        tbwd[d] = (omp_get_wtime() - t) / reps;
+
+    }
+
+    double efwd = relerr (data[0], data[1]), ebwd = relerr (recon[0], recon[1]);
+
+    printf ("  n(%zu) coils(%zu) nodes(%zu)\n", n, nc, nr*ns);
+    printf ("    forward: single %.4fs double %.4fs speedup %.2f rel. error %.2e\n",
+            tfwd[0], tfwd[1], tfwd[1]/tfwd[0], efwd);
+    printf ("    cg-sense: single %.4fs double %.4fs speedup %.2f rel. error %.2e\n",
+            tbwd[0], tbwd[1], tbwd[1]/tbwd[0], ebwd);
+
+    return (efwd < 1.e-4 && ebwd < 1.e-3) ? 0 : 1;
+
+}
+
+/**
+ * @brief Copies share geometry with the original and must transform identically
+ */
+template<class T> inline int shared (size_t n) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    Matrix<RT> k, w;
+    radial (2*n, n, k, w);
+    Matrix<T> img = phantom<T>(n);
+
+    Params p;
+    p["nk"]   = (size_t) (2*n*n);
+    p["imsz"] = size(img);
+    p["m"]    = (size_t) 1;
+
+    NFFT<T> a (p);
+    a.KSpace (k);
+    a.Weights (w);
+    NFFT<T> b (a);
+
+    Matrix<T> fa = a * img, fb = b * img;
+    Matrix<T> ia = a ->* fa, ib = b ->* fb;
+    int ret = (relerr (fa, fb) == 0. && relerr (ia, ib) == 0.) ? 0 : 1;
+    printf ("  shared geometry: %s\n", ret ? "FAILED" : "OK");
+
+    return ret;
+
+}
+
+int main (int narg, char** argv) {
+    size_t n = (narg > 1) ? atoi(argv[1]) : 64;
+    return shared<cxfl>(n) + check<cxfl>(n, 8, 3);
+}
@@ -11,9 +11,11 @@
 
 #include "Matrix.hpp"
 #include "IOFile.hpp"
+#include "MappedFile.hpp"
 
 #include <fstream>
 #include <iostream>
+#include <stdint.h>
 
 
 namespace codeare {
@@ -45,6 +47,214 @@ namespace io{
 	static const std::string delim = "543f562189f1e82beb9c177f89f67822";
 
 
+	/**
+	 * @brief    Alignment of version 2 payloads (bytes)
+	 */
+	static const size_t COD_ALIGN = 64;
+
+	/**
+	 * @brief    Version 2 magic. Never a valid version 1 data type.
+	 */
+	static const char cod_magic[8] = {'C','O','D','E','A','R','E','2'};
+
+
+	/**
+	 * @brief    Version 2 .cod header<br/>
+	 *           Followed by ndim dimensions (uint64), ndim resolutions (float),
+	 *           the name and zero padding up to the payload at offset, which is
+	 *           a multiple of COD_ALIGN. The payload may thus be mapped and used
+	 *           in place.
+	 */
+	struct CODHeader {
+		char     magic[8];  /**< cod_magic */
+		uint32_t version;   /**< 2 */
+		int32_t  dt;        /**< Data type */
+		uint64_t ndim;      /**< # of dimensions */
+		uint64_t nlen;      /**< Name length */
+		uint64_t offset;    /**< Payload offset */
+		uint64_t bytes;     /**< Payload size */
+		char     pad[16];
+	};
+
+
+	/**
+	 * @brief    Memory map of a version 2 .cod file<br/>
+	 *           The payload is accessed in place, either read-only or
+	 *           copy-on-write. Pages are only read on first touch, i.e.
+	 *           extracting a slab (one coil, one slice ...) costs the slab only.
+	 */
+	class CODMap {
+
+	public:
+
+		enum map_mode {READ_ONLY, COPY_ON_WRITE};
+
+		/**
+		 * @brief  Map file and validate header
+		 *
+		 * @param  fname   File name
+		 * @param  mode    READ_ONLY (default) / COPY_ON_WRITE
+		 */
+		explicit CODMap (const std::string& fname, const map_mode mode = READ_ONLY) :
+			m_payload (0) {
+
+			if (!m_file.Open (fname, mode == COPY_ON_WRITE)) {
+				printf ("Cannot map %s.\n", fname.c_str());
+				return;
+			}
+
+			if (!m_file.Copy (&m_header, 0, sizeof(CODHeader)) ||
+				memcmp (m_header.magic, cod_magic, sizeof(cod_magic)) || m_header.version != 2) {
+				printf ("%s is not a version 2 .cod file.\n", fname.c_str());
+				return;
+			}
+
+			const size_t nd = m_header.ndim, nl = m_header.nlen, off = m_header.offset;
+			const size_t meta = sizeof(CODHeader) + nd * (sizeof(uint64_t) + sizeof(float)) + nl;
+			if (off % COD_ALIGN || meta > off || !m_file.Within (off, m_header.bytes)) {
+				printf ("%s: corrupt header.\n", fname.c_str());
+				return;
+			}
+
+			const char* p = m_file.Data() + sizeof(CODHeader);
+			m_dim = Vector<size_t>(nd);
+			m_res = Vector<float>(nd);
+			for (size_t i = 0; i < nd; ++i, p += sizeof(uint64_t)) {
+				uint64_t d;
+				memcpy (&d, p, sizeof(uint64_t));
+				m_dim[i] = (size_t) d;
+			}
+			memcpy (m_res.ptr(), p, nd * sizeof(float));
+			p += nd * sizeof(float);
+			m_name = std::string (p, nl);
+
+			m_payload = (mode == COPY_ON_WRITE) ? m_file.MutableData() + off :
+				const_cast<char*>(m_file.Data()) + off;
+
+		}
+
+
+		/**
+		 * @brief  Mapped successfully
+		 */
+		inline bool IsOpen () const { return m_payload != 0; }
+
+
+		/**
+		 * @brief  Data type
+		 */
+		inline dtype DType () const { return (dtype) m_header.dt; }
+
+
+		/**
+		 * @brief  Dimensions
+		 */
+		inline const Vector<size_t>& Dim () const { return m_dim; }
+
+
+		/**
+		 * @brief  Resolutions
+		 */
+		inline const Vector<float>& Res () const { return m_res; }
+
+
+		/**
+		 * @brief  Name
+		 */
+		inline const std::string& Name () const { return m_name; }
+
+
+		/**
+		 * @brief  Mapped payload, COD_ALIGN aligned
+		 */
+		template <class T> inline const T*
+		Ptr () const {
+			assert (IsOpen() && CODTraits<T>::dt == DType());
+			return (const T*) m_payload;
+		}
+
+
+		/**
+		 * @brief  Mapped payload, writable if mapped copy-on-write<br/>
+		 *         Changes are private to this map and never reach the file.
+		 */
+		template <class T> inline T*
+		MutablePtr () {
+			assert (IsOpen() && CODTraits<T>::dt == DType() && m_file.CopyOnWrite());
+			return (T*) m_payload;
+		}
+
+
+		/**
+		 * @brief  Copy of the whole payload
+		 */
+		template <class T> Matrix<T>
+		Read () const {
+			if (!IsOpen() || CODTraits<T>::dt != DType())
+				return Matrix<T>();
+			m_file.Advise (MappedFile::SEQUENTIAL, m_header.offset, m_header.bytes);
+			Matrix<T> M (m_dim, m_res);
+			std::copy (Ptr<T>(), Ptr<T>() + numel(M), M.Ptr());
+			M.SetClassName (m_name.c_str());
+			return M;
+		}
+
+
+		/**
+		 * @brief  Copy of slab i along dimension d (e.g. one coil or slice)<br/>
+		 *         Only pages of the slab are read from disk.
+		 *
+		 * @param  i       Index along d
+		 * @param  d       Dimension (default: last)
+		 * @return         Slab, dimension d being 1
+		 */
+		template <class T> Matrix<T>
+		Slab (const size_t& i, size_t d = ~size_t(0)) const {
+
+			if (!IsOpen() || CODTraits<T>::dt != DType() || m_dim.empty())
+				return Matrix<T>();
+			if (d >= m_dim.size())
+				d = m_dim.size() - 1;
+			assert (i < m_dim[d]);
+
+			size_t inner = 1, outer = 1;
+			for (size_t j = 0; j < d; ++j)
+				inner *= m_dim[j];
+			for (size_t j = d+1; j < m_dim.size(); ++j)
+				outer *= m_dim[j];
+			const size_t stride = inner * m_dim[d];
+
+			if (outer == 1) // Contiguous: prefetch
+				m_file.Advise (MappedFile::WILLNEED, m_header.offset + i * inner * sizeof(T),
+							   inner * sizeof(T));
+
+			Vector<size_t> dim = m_dim;
+			dim[d] = 1;
+			Matrix<T> S (dim, m_res);
+			const T* src = Ptr<T>() + i * inner;
+			for (size_t o = 0; o < outer; ++o)
+				std::copy (src + o * stride, src + o * stride + inner, S.Ptr() + o * inner);
+			S.SetClassName (m_name.c_str());
+
+			return S;
+
+		}
+
+	private:
+
+		CODMap (const CODMap&);
+		CODMap& operator= (const CODMap&);
+
+		MappedFile     m_file;
+		CODHeader      m_header;
+		Vector<size_t> m_dim;
+		Vector<float>  m_res;
+		std::string    m_name;
+		char*          m_payload;
+
+	};
+
+
 	/**
 	 * @brief    codeare .cod file io class
 	 *
@@ -59,13 +269,16 @@ namespace io{
 		 *
 		 * @param  fname   File name
 		 * @param  mode    READ(default)/WRITE
-		 * @param  params  Optional parameter set (not used yet)
+		 * @param  params  Optional parameter set ("version": 1 (default) or 2 for
+		 *                 aligned, mappable output, see CODMap)
 		 * @param  verbose Verbose output true/false
 		 */
 		CODFile (const std::string& fname, const IOMode mode = READ,
 				const Params& params = Params(), const bool verbose = false) :
 					IOFile (fname, mode, params, verbose) {
 
+			m_version = params.exists ("version") ? params.Get<int> ("version") : 1;
+
 			const char* R = "rb";
 			const char* W = "wb";
 
@@ -89,6 +302,12 @@ namespace io{
 		};
 
 
+		/**
+		 * @brief  Read matrix, either format version
+		 *
+		 * @param  uri     Not used
+		 * @return         Matrix
+		 */
 		template <class T> Matrix<T>
 		Read (const std::string& uri = "") const {
 
@@ -98,6 +317,13 @@ namespace io{
 			Vector<float>  res;
 			char* name;
 			Matrix<T> M;
+			char magic[sizeof(cod_magic)];
+
+			// Version 2 is read through its map
+			if (fread (magic, 1, sizeof(magic), m_file) == sizeof(magic) &&
+				!memcmp (magic, cod_magic, sizeof(magic)))
+				return CODMap (this->m_fname).Read<T>();
+			rewind (m_file);
 
 			// Read type
 			if (!mread (&dt, 1, m_file, "data type"))
@@ -146,11 +372,55 @@ namespace io{
 		}
 
 
+		/**
+		 * @brief  Read matrix as configured in XML<br/>
+		 *         With attribute slab (and optionally dim, default last) a
+		 *         version 2 file yields only that slab through CODMap, i.e.
+		 *         only the slab's pages are read from disk.
+		 *
+		 * @param  txe     Data element (attributes: slab, dim)
+		 * @return         Matrix
+		 */
+		template <class T> Matrix<T>
+		Read (const TiXmlElement* txe) const {
+
+			int slab, dim;
+			if (txe->QueryIntAttribute ("slab", &slab) == TIXML_SUCCESS) {
+				CODMap map (this->m_fname);
+				if (map.IsOpen()) {
+					const Vector<size_t>& dims = map.Dim();
+					size_t d = dims.size() - 1;
+					if (txe->QueryIntAttribute ("dim", &dim) == TIXML_SUCCESS)
+						d = (size_t) dim;
+					if (slab < 0 || d >= dims.size() || (size_t)slab >= dims[d]) {
+						printf ("%s: no slab %d along dimension %zu.\n", this->m_fname.c_str(),
+								slab, d);
+						return Matrix<T>();
+					}
+					return map.Slab<T> ((size_t)slab, d);
+				}
+			}
+
+			return Read<T> ();
+
+		}
+
+
+		/**
+		 * @brief  Write matrix in format version chosen on construction
+		 *
+		 * @param  M       Matrix
+		 * @param  uri     Name
+		 * @return         Success
+		 */
 		template <class T> bool
 		Write (const Matrix<T>& M, const std::string& uri = "") {
 
 			assert (m_file != NULL);
 
+			if (m_version == 2)
+				return WriteAligned (M, uri);
+
 			dtype dt = CODTraits<T>::dt;
 			size_t n = M.NDim();
 
@@ -189,13 +459,68 @@ namespace io{
 
 		}
 
+
+		/**
+		 * @brief  Write matrix as configured in XML
+		 *
+		 * @param  M       Matrix
+		 * @param  txe     Data element (attribute: uri)
+		 * @return         Success
+		 */
+		template <class T> bool
+		Write (const Matrix<T>& M, const TiXmlElement* txe) {
+			const char* uri = txe->Attribute("uri");
+			return Write (M, std::string (uri ? uri : ""));
+		}
+
 	private:
 
 
-		CODFile () : m_file (0) {};
-		CODFile (const CODFile&) : m_file(0) {};
+		/**
+		 * @brief  Write version 2: header, meta data, padding, aligned payload
+		 */
+		template <class T> bool
+		WriteAligned (const Matrix<T>& M, const std::string& uri) {
+
+			const size_t nd = M.NDim();
+			CODHeader h;
+			memset (&h, 0, sizeof(CODHeader));
+			memcpy (h.magic, cod_magic, sizeof(cod_magic));
+			h.version = 2;
+			h.dt      = CODTraits<T>::dt;
+			h.ndim    = nd;
+			h.nlen    = uri.size();
+			h.offset  = sizeof(CODHeader) + nd * (sizeof(uint64_t) + sizeof(float)) + uri.size();
+			h.offset  = (h.offset + COD_ALIGN - 1) / COD_ALIGN * COD_ALIGN;
+			h.bytes   = numel(M) * sizeof(T);
+
+			std::vector<char> meta (h.offset, 0);
+			char* p = &meta[0];
+			memcpy (p, &h, sizeof(CODHeader));
+			p += sizeof(CODHeader);
+			for (size_t i = 0; i < nd; ++i, p += sizeof(uint64_t)) {
+				const uint64_t d = M.Dim(i);
+				memcpy (p, &d, sizeof(uint64_t));
+			}
+			for (size_t i = 0; i < nd; ++i, p += sizeof(float)) {
+				const float r = M.Res(i);
+				memcpy (p, &r, sizeof(float));
+			}
+			memcpy (p, uri.c_str(), uri.size());
+
+			if (!mwrite(&meta[0], meta.size(), m_file, "header"))
+				return false;
+
+			return mwrite(M.Ptr(), numel(M), m_file, "data");
+
+		}
+
+
+		CODFile () : m_file (0), m_version (1) {};
+		CODFile (const CODFile&) : m_file(0), m_version (1) {};
 
 		FILE* m_file;
+		int   m_version; /**< Format version written */
 
 	};
 
@@ -18,6 +18,13 @@
 #include <H5Cpp.h>
 using namespace H5;
 
+/**
+ * @brief Registered id of the LZ4 filter plugin
+ */
+#ifndef H5Z_FILTER_LZ4
+#  define H5Z_FILTER_LZ4 32004
+#endif
+
 namespace codeare {
 namespace matrix {
 namespace io {
@@ -50,6 +57,20 @@ namespace io {
         }
     };
 
+
+    /**
+     * @brief  Catalog entry of a dataset
+     */
+    struct HDF5Entry {
+        std::string    path;    /**< Full path */
+        Vector<size_t> dims;    /**< Matrix dimensions */
+        Vector<size_t> chunk;   /**< Chunk shape (empty if contiguous) */
+        H5T_class_t    cls;     /**< Type class */
+        size_t         size;    /**< Element size (bytes, per real component) */
+        bool           complex; /**< Complex data */
+    };
+
+
     class HDF5File : public IOFile {
 
     public:
@@ -59,12 +80,30 @@ namespace io {
          *
          * @param  fname   File name
          * @param  mode    IO mode (R/RW)
-         * @param  params  Optional params
+         * @param  params  Optional params<br/>
+         *                 "chunk"   Vector<size_t> chunk shape in matrix order,
+         *                           0 for full extent (default with filters:
+         *                           one slab of the last dimension)<br/>
+         *                 "shuffle" Byte shuffle filter (bool)<br/>
+         *                 "deflate" Deflate level 1-9 (int)<br/>
+         *                 "lz4"     LZ4 filter, if plugin available (bool)<br/>
+         *                 "lazy"    Read() lists datasets without loading (bool)
          * @param  verbose Verbosity
          */
         HDF5File  (const std::string& fname, const IOMode mode = READ,
                 Params params = Params(), const bool verbose = false) :
-                    IOFile(fname, mode, params, verbose), _depth(0) {
+                    IOFile(fname, mode, params, verbose), _depth(0), m_deflate(0),
+                    m_shuffle(false), m_lz4(false), m_lazy(false) {
+            if (params.exists("chunk"))
+                m_chunk   = params.Get<Vector<size_t> >("chunk");
+            if (params.exists("deflate"))
+                m_deflate = params.Get<int>("deflate");
+            if (params.exists("shuffle"))
+                m_shuffle = params.Get<bool>("shuffle");
+            if (params.exists("lz4"))
+                m_lz4     = params.Get<bool>("lz4");
+            if (params.exists("lazy"))
+                m_lazy    = params.Get<bool>("lazy");
             Exception::dontPrint();
             try {
                 m_file = H5File (fname, (mode == READ) ? H5F_ACC_RDONLY :H5F_ACC_TRUNC);
@@ -146,6 +185,83 @@ namespace io {
         }
 
 
+        /**
+         * @brief   Read hyperslab (sub-block) of a dataset<br/>
+         *          Only chunks intersecting the block are read and decompressed.
+         *
+         * @param   uri     Dataset
+         * @param   offset  Offset (matrix order)
+         * @param   count   Extent (matrix order)
+         * @return          Block of size count
+         */
+        template<class T> Matrix<T> Read (const std::string& uri, const Vector<size_t>& offset,
+                                          const Vector<size_t>& count) const {
+
+            T         t       = (T) 0;
+            Matrix<T> M;
+
+            try {
+
+                DataSet   dataset = m_file.openDataSet(uri);
+                DataSpace space   = dataset.getSpace();
+                size_t    ndim    = space.getSimpleExtentNdims();
+
+                if (is_complex(t))
+                    --ndim;
+                assert (offset.size() == ndim && count.size() == ndim);
+
+                Vector<hsize_t> hoff (ndim), hcnt (ndim);
+                for (size_t i = 0; i < ndim; ++i) {
+                    hoff[ndim-i-1] = offset[i];
+                    hcnt[ndim-i-1] = count[i];
+                }
+                if (is_complex(t)) {
+                    hoff.push_back(0);
+                    hcnt.push_back(2);
+                }
+
+                if (this->m_verb) {
+                    printf ("Reading block of dataset %s ... ", uri.c_str());
+                    fflush(stdout);
+                }
+
+                space.selectHyperslab (H5S_SELECT_SET, &hcnt[0], &hoff[0]);
+                DataSpace mspace (hcnt.size(), &hcnt[0]);
+                PredType* type = HDF5Traits<T>::PType();
+                M = Matrix<T> (count);
+                dataset.read (&M[0], *type, mspace, space);
+                delete type;
+
+                if (this->m_verb)
+                    printf ("O(%s) done\n", DimsToCString(M));
+
+                mspace.close();
+                space.close();
+                dataset.close();
+
+            } catch (const Exception& e) {
+                printf ("Reading block of %s failed\n%s\n", uri.c_str(), e.getDetailMsg().c_str());
+            }
+
+            return M;
+
+        }
+
+
+        /**
+         * @brief   List all datasets of the file without reading any data
+         *
+         * @return  Catalog
+         */
+        inline std::vector<HDF5Entry> Catalog () const {
+            std::vector<HDF5Entry> cat;
+            H5::Group h5g = m_file.openGroup("/");
+            Catalog (h5g, "", cat);
+            h5g.close();
+            return cat;
+        }
+
+
 
         template<class T> bool Write (const Matrix<T>& M, const std::string& uri) throw () {
 
@@ -203,7 +319,7 @@ namespace io {
             
             DataSpace space (tmpdim, &dims[0]), attr_space(one, &hone);
             PredType*  type = HDF5Traits<T>::PType();
-            DataSet set = group.createDataSet(name, (*type), space);
+            DataSet set = group.createDataSet(name, (*type), space, Layout(M));
             if (is_complex(t))
                 set.createAttribute("complex", H5::PredType::NATIVE_INT, attr_space).write(H5::PredType::NATIVE_INT, &one);
 
@@ -330,6 +446,17 @@ namespace io {
             }
 #endif
             std::cout << std::string(_depth, ' ') << "Dataset: " << name; fflush(stdout);
+            if (m_lazy) {
+                DataSpace space = h5d.getSpace();
+                Vector<hsize_t> dims (space.getSimpleExtentNdims());
+                space.getSimpleExtentDims(&dims[0], NULL);
+                const size_t nd = dims.size() - (is_complex ? 1 : 0);
+                for (size_t i = 0; i < nd; ++i)
+                    std::cout << (i ? "x" : " (") << dims[nd-1-i];
+                std::cout << (is_complex ? " complex)" : ")") << std::endl;
+                space.close();
+                return;
+            }
             std::string wname = name;
             if (wname[0]=='/')
             	wname = wname.substr(1,wname.length());
@@ -361,10 +488,111 @@ namespace io {
 
     private:
 
-        HDF5File (const HDF5File&) : _depth(0) {}
-        HDF5File  () : _depth(0) {}
+        /**
+         * @brief   Creation properties: contiguous unless chunks or filters are requested
+         */
+        template<class T> DSetCreatPropList Layout (const Matrix<T>& M) const {
+
+            DSetCreatPropList plist;
+            const size_t nd = ndims(M);
+
+            if ((m_chunk.empty() && !m_deflate && !m_shuffle && !m_lz4) || numel(M) == 0)
+                return plist;
+
+            // Reverse order, complex components innermost
+            Vector<hsize_t> chunk (nd);
+            for (size_t i = 0; i < nd; ++i) {
+                size_t c = (i < m_chunk.size()) ? m_chunk[i] :
+                    (m_chunk.empty() && nd > 1 && i == nd-1) ? 1 : 0;
+                if (c == 0 || c > M.Dim(i))
+                    c = M.Dim(i);
+                chunk[nd-1-i] = c;
+            }
+            if (is_complex(T()))
+                chunk.push_back(2);
+            plist.setChunk (chunk.size(), &chunk[0]);
+
+            if (m_shuffle)
+                plist.setShuffle();
+            if (m_lz4) {
+                if (H5Zfilter_avail(H5Z_FILTER_LZ4) > 0)
+                    plist.setFilter (H5Z_FILTER_LZ4, H5Z_FLAG_OPTIONAL);
+                else
+                    printf ("LZ4 filter not available, writing %s\n",
+                            m_deflate ? "deflated only" : "uncompressed");
+            }
+            if (m_deflate)
+                plist.setDeflate (m_deflate);
+
+            return plist;
+
+        }
+
+
+        /**
+         * @brief   Collect datasets below group recursively
+         */
+        inline void Catalog (const H5::Group& h5g, const std::string& path,
+                             std::vector<HDF5Entry>& cat) const {
+
+            for (hsize_t i = 0; i < h5g.getNumObjs(); ++i) {
+
+                std::string oname = h5g.getObjnameByIdx(i), opath = path + "/" + oname;
+                int otype = h5g.getObjTypeByIdx(i);
+
+                if (otype == H5G_GROUP) {
+                    H5::Group grp = h5g.openGroup(oname);
+                    Catalog (grp, opath, cat);
+                    grp.close();
+                } else if (otype == H5G_DATASET) {
+                    H5::DataSet set = h5g.openDataSet(oname);
+                    DataSpace space = set.getSpace();
+                    DSetCreatPropList plist = set.getCreatePlist();
+                    HDF5Entry e;
+                    e.path    = opath;
+                    e.cls     = set.getTypeClass();
+                    e.size    = set.getDataType().getSize();
+#ifdef HDF5_HAS_LOCATION
+                    e.complex = set.attrExists("complex");
+#else
+                    e.complex = false;
+                    for (int j = 0; j < set.getNumAttrs(); ++j)
+                        if (set.openAttribute(j).getName().compare("complex") == 0)
+                            e.complex = true;
+#endif
+                    const size_t rank = space.getSimpleExtentNdims(), nd = rank - (e.complex ? 1 : 0);
+                    Vector<hsize_t> dims (rank);
+                    space.getSimpleExtentDims(&dims[0], NULL);
+                    e.dims = Vector<size_t>(nd);
+                    for (size_t j = 0; j < nd; ++j)
+                        e.dims[j] = dims[nd-1-j];
+                    if (plist.getLayout() == H5D_CHUNKED) {
+                        plist.getChunk(rank, &dims[0]);
+                        e.chunk = Vector<size_t>(nd);
+                        for (size_t j = 0; j < nd; ++j)
+                            e.chunk[j] = dims[nd-1-j];
+                    }
+                    cat.push_back(e);
+                    plist.close();
+                    space.close();
+                    set.close();
+                }
+
+            }
+
+        }
+
+
+        HDF5File (const HDF5File&) : _depth(0), m_deflate(0), m_shuffle(false), m_lz4(false),
+                                     m_lazy(false) {}
+        HDF5File  () : _depth(0), m_deflate(0), m_shuffle(false), m_lz4(false), m_lazy(false) {}
         H5File m_file; /// @brief My file
         mutable size_t _depth;
+        Vector<size_t> m_chunk;   /**< Chunk shape (matrix order) */
+        int            m_deflate; /**< Deflate level (0: off) */
+        bool           m_shuffle; /**< Shuffle filter */
+        bool           m_lz4;     /**< LZ4 filter */
+        bool           m_lazy;    /**< Read() lists only */
 
     };
 
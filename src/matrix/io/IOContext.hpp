@@ -54,7 +54,7 @@ namespace io{
 	/**
 	 * @brief Supported data formats
 	 */
-	enum IOStrategy {HDF5 = 0, MATLAB, ISMRM, NIFTI, SYNGO, GE, PHILIPS, NO_STRATEGY};
+	enum IOStrategy {HDF5 = 0, MATLAB, ISMRM, NIFTI, SYNGO, GE, PHILIPS, CODEARE, NO_STRATEGY};
 
 	template<IOStrategy T> struct IOTraits;
 	
@@ -223,6 +223,36 @@ namespace io{
 		}
 	};
 
+
+	template<>
+	struct IOTraits<CODEARE> {
+		typedef CODFile IOClass;
+
+		static const std::string Suffix () {
+			return ".cod";
+		}
+		static const std::string CName () {
+			return "codeare";
+		}
+		inline static IOFile* Open (const std::string& fname, const IOMode mode,
+			  const Params& params, const bool verbosity) {
+			return (IOFile*) new IOClass (fname, mode, params, verbosity);
+		}
+		inline static void Read (const IOFile*) {}
+		template <class T> inline static Matrix<T> Read (const IOFile* iof, const std::string& uri) {
+			return ((IOClass*)iof)->Read<T>(uri);
+		}
+		template <class T> inline static Matrix<T> Read (const IOFile* iof, const TiXmlElement* txe) {
+			return ((IOClass*)iof)->Read<T>(txe);
+		}
+		template <class T> inline static bool Write (IOFile* iof, const Matrix<T>& M, const std::string& uri) {
+			return ((IOClass*)iof)->Write(M,uri);
+		}
+		template <class T> inline static bool Write (IOFile* iof, const Matrix<T>& M, const TiXmlElement* txe) {
+			return ((IOClass*)iof)->Write(M,txe);
+		}
+	};
+
 	
 	
 	
@@ -327,6 +357,7 @@ namespace io{
 				case NIFTI:  return IOTraits< NIFTI>::Read<T>(m_iof, uri);
 #endif
 				case SYNGO:  return IOTraits< SYNGO>::Read<T>(m_iof, uri);
+				case CODEARE: return IOTraits<CODEARE>::Read<T>(m_iof, uri);
 				case GE:     break;
 				case PHILIPS: break;
 				default:     break;
@@ -352,6 +383,7 @@ namespace io{
 				case NIFTI:  return IOTraits< NIFTI>::Write<T>(m_iof, M, uri);
 #endif
 				case SYNGO:  return IOTraits< SYNGO>::Write<T>(m_iof, M, uri);
+				case CODEARE: return IOTraits<CODEARE>::Write<T>(m_iof, M, uri);
 				case GE:     break;
 				case PHILIPS: break;
 				default:     break;
@@ -377,6 +409,7 @@ namespace io{
 				case NIFTI:  return IOTraits< NIFTI>::Read<T>(m_iof, txe);
 #endif
 				case SYNGO:  return IOTraits< SYNGO>::Read<T>(m_iof, txe);
+				case CODEARE: return IOTraits<CODEARE>::Read<T>(m_iof, txe);
 				case GE:     break;
 				case PHILIPS: break;
 				default:     break;
@@ -402,6 +435,7 @@ namespace io{
 				case NIFTI:  return IOTraits< NIFTI>::Read(m_iof);
 #endif
 				case SYNGO:  return IOTraits< SYNGO>::Read(m_iof);
+				case CODEARE: return IOTraits<CODEARE>::Read(m_iof);
 				case GE:     break;
 				case PHILIPS: break;
 				default:     break;
@@ -427,6 +461,7 @@ namespace io{
 				case NIFTI:  return IOTraits< NIFTI>::Write<T>(m_iof, M, txe);
 #endif
 				case SYNGO:  return IOTraits< SYNGO>::Write<T>(m_iof, M, txe);
+				case CODEARE: return IOTraits<CODEARE>::Write<T>(m_iof, M, txe);
 				case GE:     break;
 				case PHILIPS: break;
 				default:     break;
@@ -470,6 +505,8 @@ namespace io{
 				return NIFTI;
 			else if (HasSuffix (lfname, IOTraits<SYNGO>::Suffix()))
 				return SYNGO;
+			else if (HasSuffix (lfname, IOTraits<CODEARE>::Suffix()))
+				return CODEARE;
 			else
 				return HDF5;
 		}
@@ -485,6 +522,8 @@ namespace io{
 				return NIFTI;
 			else if (lname.compare(IOTraits<SYNGO>::CName()) == 0)
 				return SYNGO;
+			else if (lname.compare(IOTraits<CODEARE>::CName()) == 0)
+				return CODEARE;
 			else
 				return HDF5;
 		}
@@ -504,6 +543,7 @@ namespace io{
 				case NIFTI:  m_iof = IOTraits< NIFTI>::Open(fname, mode, params, verbosity); break;
 #endif
 				case SYNGO:  m_iof = IOTraits< SYNGO>::Open(fname, mode, params, verbosity); break;
+				case CODEARE: m_iof = IOTraits<CODEARE>::Open(fname, mode, params, verbosity); break;
 				case GE:      break;
 				case PHILIPS: break;
 				default:      printf ("Failed to make IO context concrete!\n ");  break;
@@ -0,0 +1,185 @@
+/*
+ *  codeare Copyright (C) 2007-2015 Kaveh Vahedipour
+ *                                  NYU School of Madicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+#if defined (_MSC_VER)
+#  include <fstream>
+#  include <vector>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace codeare {
+namespace matrix  {
+namespace io      {
+
+/**
+ * @brief Read-only or copy-on-write memory map of a whole file<br/>
+ *        Falls back to reading the file into memory where mmap is unavailable.
+ */
+class MappedFile {
+
+public:
+
+	enum access_hint {SEQUENTIAL, RANDOM, WILLNEED};
+
+	MappedFile () : _data (0), _size (0), _cow (false) {}
+
+	/**
+	 * @brief       Map file
+	 *
+	 * @param fname File name
+	 * @param cow   Copy-on-write: pages may be modified privately (default: false)
+	 */
+	explicit MappedFile (const std::string& fname, const bool cow = false) :
+		_data (0), _size (0), _cow (false) {
+		Open (fname, cow);
+	}
+
+	~MappedFile () { Close(); }
+
+	/**
+	 * @brief       Map file
+	 *
+	 * @param fname File name
+	 * @param cow   Copy-on-write: pages may be modified privately (default: false)
+	 * @return      Success
+	 */
+	inline bool Open (const std::string& fname, const bool cow = false) {
+		Close();
+#if defined (_MSC_VER)
+		std::ifstream f (fname.c_str(), std::ios::in|std::ios::binary);
+		if (!f.is_open())
+			return false;
+		f.seekg (0, f.end);
+		_buf.resize ((size_t)f.tellg());
+		f.seekg (0, f.beg);
+		if (!_buf.empty())
+			f.read (&_buf[0], _buf.size());
+		_size = _buf.size();
+		_data = _size ? &_buf[0] : 0;
+		_cow  = cow;
+		return true;
+#else
+		int fd = open (fname.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		if (fstat (fd, &st) != 0 || st.st_size == 0) {
+			close (fd);
+			return false;
+		}
+		void* p = mmap (0, (size_t)st.st_size, cow ? PROT_READ|PROT_WRITE : PROT_READ,
+		                MAP_PRIVATE, fd, 0);
+		close (fd); // Mapping keeps file referenced
+		if (p == MAP_FAILED)
+			return false;
+		_data = (char*) p;
+		_size = (size_t) st.st_size;
+		_cow  = cow;
+		return true;
+#endif
+	}
+
+	/**
+	 * @brief       Unmap
+	 */
+	inline void Close () {
+#if defined (_MSC_VER)
+		std::vector<char>().swap(_buf);
+#else
+		if (_data)
+			munmap ((void*)_data, _size);
+#endif
+		_data = 0;
+		_size = 0;
+		_cow  = false;
+	}
+
+	/**
+	 * @brief       Advise kernel on upcoming access pattern
+	 */
+	inline void Advise (access_hint hint) const {
+		Advise (hint, 0, _size);
+	}
+
+	/**
+	 * @brief       Advise kernel on upcoming access of n bytes at offset
+	 */
+	inline void Advise (access_hint hint, size_t offset, size_t n) const {
+#if !defined (_MSC_VER)
+		if (!_data || offset >= _size)
+			return;
+		const size_t a = offset - offset % (size_t) sysconf (_SC_PAGESIZE);
+		madvise ((void*)(_data + a), std::min (n + offset - a, _size - a),
+		         (hint == SEQUENTIAL) ? MADV_SEQUENTIAL :
+		         (hint == RANDOM) ? MADV_RANDOM : MADV_WILLNEED);
+#endif
+	}
+
+	/**
+	 * @brief       Copy n bytes at offset into dst
+	 *
+	 * @return      False if out of bounds
+	 */
+	inline bool Copy (void* dst, size_t offset, size_t n) const {
+		if (offset + n > _size)
+			return false;
+		memcpy (dst, _data + offset, n);
+		return true;
+	}
+
+	/**
+	 * @brief       Offset and length are within file
+	 */
+	inline bool Within (size_t offset, size_t n) const { return offset + n <= _size; }
+
+	inline const char* Data () const { return _data; }
+	inline char* MutableData () { return _cow ? _data : 0; }
+	inline size_t Size () const { return _size; }
+	inline bool IsOpen () const { return _data != 0; }
+	inline bool CopyOnWrite () const { return _cow; }
+
+private:
+
+	MappedFile (const MappedFile&);
+	MappedFile& operator= (const MappedFile&);
+
+	char*       _data;       /**< Mapped memory */
+	size_t      _size;       /**< File size */
+	bool        _cow;        /**< Copy-on-write mapping */
+#if defined (_MSC_VER)
+	std::vector<char> _buf;  /**< Fallback buffer */
+#endif
+
+};
+
+}}}
+
+#endif /* __MAPPED_FILE_HPP__ */
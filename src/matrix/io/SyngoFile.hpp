@@ -35,6 +35,7 @@
 #include <algorithm>
 
 #include "SyngoMRProtocol.hpp"
+#include "MappedFile.hpp"
 
 static const float kB = 1.f/1024.f, iMB = 1.f/1.31072f, iGB = 1.f/1.073741824f;
 static uint32_t header_len, data_len;
@@ -80,6 +81,16 @@ namespace codeare {
 namespace matrix  {
 namespace io      {
 
+/**
+ * @brief Compact index entry of one ADC line found while parsing
+ */
+struct ADCLine {
+    uint64_t pos;      /**< Offset of first channel in file */
+    uint16_t ns;       /**< Samples in scan */
+    uint16_t nc;       /**< Channel ID (VB) or # of channels (VD) */
+    uint16_t lc[14];   /**< Loop counters */
+};
+
 /**
  * @brief Base class for Syngo MR file readers
  */
@@ -158,6 +169,7 @@ protected:
     int _status ;          /**< Well being of the reader */
     
     std::ifstream _file;   /**< File */
+    MappedFile _map;       /**< Memory map of file while digesting */
     std::string _fname;    /**< File name */
     
     uint32_t _header_len;  /**< Header length */
@@ -81,93 +81,55 @@ namespace VB {
         }
         
         
+        /**
+         * @brief Digest ingredients. The file is memory mapped, MDHs are
+         *        indexed in one pass and ADC lines are then copied to their
+         *        place in parallel.
+         */
         virtual void Digest () {
 
-            MeasHeader mh;
-            size_t i = 0;
-            char* wbm = const_cast<char*>("reading ...");
             SimpleTimer st;
-            
-            _file.seekg (_header_len);
-            
-            if (!_meas_r)
-                prtmsg ("   Parsing ... \n");
-            else {
-                prtmsg ("   Reading ... \n");
-                //h = waitbar_create (0, wbm) ;
-            }
-            
-            while (true) {
 
-                _file.read ((char*)&mh, MEAS_HEADER_LEN);
-                fflush(stdout);
-
-                if (bit_set(mh.aulEvalInfoMask[0], ACQEND)) {
-                    prtmsg ("     Hit ACQEND\n");
-                    break;
-                } else if (bit_set(mh.aulEvalInfoMask[0], SYNCDATA)) {
-                    size_t tmp1 = _file.tellg(), tmp2;
-                    ParseSync (mh);
-                    tmp2 = _file.tellg();
-                    tmp1 = ((tmp2-tmp1)%32);
-                    if (tmp1)
-                        _file.seekg (tmp2 + 32-tmp1);
-                } else if (bit_set(mh.aulEvalInfoMask[0], NOISEADJSCAN)) {
-                    ParseNoise (mh);
-                } else if (bit_set(mh.aulEvalInfoMask[0], RTFEEDBACK)) {
-                    if (_nrtfb == 0 && !_rtfb_r) {
-                        _rtfbdims[0] = mh.ushSamplesInScan;
-                        _rtfbdims[1] = mh.ushUsedChannels;
-                    }
-                    ParseFeedback (mh);
-                } else if (bit_set(mh.aulEvalInfoMask[1], ONLINE)) {
-                    ParseCTNormalize (mh);
-                } else {
-                    if (_nmeas == 0 && !_meas_r) {
-                        _measdims[0] = mh.ushSamplesInScan;
-                        _measdims[1] = mh.ushUsedChannels;
-                    }
-                    ParseMeas (mh);
-                }
-                if (_meas_r && i%1000==0) {
-                    //waitbar_update ((double)i/(double)_lines, h, wbm);
-                }
-                
-                ++i;
-            }
-            _lines = i;
-            if (_meas_r) {
-                //waitbar_destroy(h);
+            if (!_map.Open (_fname)) {
+                prtwrn ("     Failed to map file.\n");
+                return;
             }
+
+            prtmsg ("   Parsing ... \n");
+            Index ();
             prtmsg ("     done - wtime %s", st.Format().c_str());
-            
-            if (!_meas_r) {
-                _measdims = _raise_one (_measdims);
-                _rtfbdims = _raise_one (_rtfbdims);
-                _syncdims = _raise_one (_syncdims);
-                _measdims[5] = (_measdims[5]-_cent_par)*2;
-                //_ta = 2.5e-3*(_tend-_tstart);
-                _ta = _protocol.Get<long>("XProtocol.ASCCONV.lScanTimeSec");
-                _tr = _protocol.Get<long>("XProtocol.ASCCONV.alTR[0]")/1000;
-                wspace.PSet("TA", _ta);
-                wspace.PSet("TR", _tr);
-                wspace.PSet("Protocol", _protocol.Properties());
-                prtmsg ("     Found %zu lines (data: (Meas: %u, Noise: %u, Sync: %u))\n", i, _nmeas, _nnoise, _syncdims[1]);
-                prtmsg ("     Centres: column: %zu, line: %zu, partition: %zu\n", _cent_col, _cent_lin, _cent_par);
-                prtmsg ("     Measurement TA: %.2fs, TR: %.2fms\n", _ta, _tr);
-                prtmsg ("       Data dims ( ");
-                for (size_t i = 0; i < 15; ++i)
-                    prtmsg ("%d ", _measdims[i]);
-                prtmsg(")\n");
-                prtmsg ("       RTFB dims ( ");
-                for (size_t i = 0; i < 15; ++i)
-                    prtmsg ("%d ", _rtfbdims[i]);
-                prtmsg(")\n");
-                prtmsg ("       Sync dims ( %d %d )\n", _syncdims[0], _syncdims[1] );
-                const char* res = evalstr("drawnow;");
-                this->Allocate();
-                this->Digest();
-            }
+
+            _measdims = _raise_one (_measdims);
+            _rtfbdims = _raise_one (_rtfbdims);
+            _syncdims = _raise_one (_syncdims);
+            _measdims[5] = (_measdims[5]-_cent_par)*2;
+            //_ta = 2.5e-3*(_tend-_tstart);
+            _ta = _protocol.Get<long>("XProtocol.ASCCONV.lScanTimeSec");
+            _tr = _protocol.Get<long>("XProtocol.ASCCONV.alTR[0]")/1000;
+            wspace.PSet("TA", _ta);
+            wspace.PSet("TR", _tr);
+            wspace.PSet("Protocol", _protocol.Properties());
+            prtmsg ("     Found %u lines (data: (Meas: %u, Noise: %u, Sync: %zu))\n", _lines, _nmeas, _nnoise, _sync_index.size());
+            prtmsg ("     Centres: column: %zu, line: %zu, partition: %zu\n", _cent_col, _cent_lin, _cent_par);
+            prtmsg ("     Measurement TA: %.2fs, TR: %.2fms\n", _ta, _tr);
+            prtmsg ("       Data dims ( ");
+            for (size_t i = 0; i < 15; ++i)
+                prtmsg ("%d ", _measdims[i]);
+            prtmsg(")\n");
+            prtmsg ("       RTFB dims ( ");
+            for (size_t i = 0; i < 15; ++i)
+                prtmsg ("%d ", _rtfbdims[i]);
+            prtmsg(")\n");
+            prtmsg ("       Sync dims ( %d %zu )\n", _syncdims[0], _sync_index.size());
+            const char* res = evalstr("drawnow;");
+            this->Allocate();
+
+            SimpleTimer rt;
+            prtmsg ("   Reading ... \n");
+            Scatter ();
+            prtmsg ("     done - wtime %s", rt.Format().c_str());
+
+            _map.Close();
             _digested=true;
             
         }
@@ -197,7 +159,6 @@ namespace VB {
             _lhs[0] = mxCreateNumericArray (16, measdim, mxSINGLE_CLASS, mxCOMPLEX);
             _meas_r = (float*) mxGetData(_lhs[0]);
             _meas_i = (float*) mxGetImagData(_lhs[0]);
-            _nmeas = 0;
             
             // Realtime
             if (_nlhs >= 2) {
@@ -225,87 +186,157 @@ namespace VB {
             	_sync_r = &_sync[0];
             }
 #endif
-            _nmeas = 0;
-            _nrtfb = 0;
-            _syncdims[1]=0;
         }
         
-        inline void ParseSync (const MeasHeader& mh) {
-            size_t start (_file.tellg());
-            if (!_sync_r) {
-                if (_syncdims[0] == 0) {
-                    _file.read((char*)&_syncdims[0], sizeof(uint32_t));
-                    _syncdims[0] /= sizeof(float);
+        /**
+         * @brief Single pass over MDHs. Records counters, dimensions and the
+         *        offsets of ADC, feedback and sync lines.
+         */
+        inline void Index () {
+
+            MeasHeader mh;
+            size_t pos = _header_len;
+            _map.Advise (MappedFile::SEQUENTIAL);
+
+            _lines = 0;
+            _nmeas = 0;
+            _nrtfb = 0;
+            _nnoise = 0;
+            _index.clear();
+            _rtfb_index.clear();
+            _sync_index.clear();
+
+            while (true) {
+
+                if (!_map.Copy (&mh, pos, MEAS_HEADER_LEN)) {
+                    prtwrn ("     Unexpected end of file.\n");
+                    break;
                 }
-                _file.seekg (start + SYNC_HEADER_SIZE - 4 + _syncdims[0]*sizeof(float));
-            } else {
-                _file.seekg (start + SYNC_HEADER_SIZE - 4);
-                _file.read((char*)&_sync_r[_syncdims[0]*_syncdims[1]], _syncdims[0]*sizeof(float));
+                pos += MEAS_HEADER_LEN;
+                const size_t len = mh.ushSamplesInScan*sizeof(std::complex<float>);
+
+                if (bit_set(mh.aulEvalInfoMask[0], ACQEND)) {
+                    prtmsg ("     Hit ACQEND\n");
+                    break;
+                } else if (bit_set(mh.aulEvalInfoMask[0], SYNCDATA)) {
+                    if (_syncdims[0] == 0) {
+                        _map.Copy (&_syncdims[0], pos, sizeof(uint32_t));
+                        _syncdims[0] /= sizeof(float);
+                    }
+                    size_t slen = SYNC_HEADER_SIZE - 4 + _syncdims[0]*sizeof(float);
+                    if (!_map.Within (pos, slen)) {
+                        prtwrn ("     Unexpected end of file.\n");
+                        break;
+                    }
+                    _sync_index.push_back (pos + SYNC_HEADER_SIZE - 4);
+                    _syncdims[1]++;
+                    if (slen%32)
+                        slen += 32 - slen%32;
+                    pos += slen;
+                } else if (!_map.Within (pos, len)) {
+                    prtwrn ("     Unexpected end of file.\n");
+                    break;
+                } else if (bit_set(mh.aulEvalInfoMask[0], NOISEADJSCAN)) {
+                    _nnoise++;
+                    pos += len;
+                } else if (bit_set(mh.aulEvalInfoMask[0], RTFEEDBACK)) {
+                    if (_nrtfb == 0) {
+                        _rtfbdims[0] = mh.ushSamplesInScan;
+                        _rtfbdims[1] = mh.ushUsedChannels;
+                    }
+                    _rtfbdims = _max (_rtfbdims, mh.sLC);
+                    _rtfb_index.push_back (Line (mh, pos));
+                    _nrtfb++;
+                    pos += len;
+                } else if (bit_set(mh.aulEvalInfoMask[1], ONLINE)) { // CT_NORMALIZE
+                    _nctnorm++;
+                    pos += len;
+                } else {
+                    if (_nmeas == 0) {
+                        _measdims[0] = mh.ushSamplesInScan;
+                        _measdims[1] = mh.ushUsedChannels;
+                    }
+                    if (_nmeas == 0 && mh.ushChannelId == 0) {
+                        _tstart   = mh.ulTimeStamp;
+                        _cent_par = mh.ushKSpaceCentrePartitionNo;
+                        _cent_lin = mh.ushKSpaceCentreLineNo;
+                        _cent_col = mh.ushKSpaceCentreColumn;
+                    } else if (bit_set(mh.aulEvalInfoMask[0], LASTSCANINMEAS) && mh.ushChannelId == 0) {
+                        _tend = mh.ulTimeStamp;
+                    }
+                    _measdims = _max (_measdims, mh.sLC);
+                    _index.push_back (Line (mh, pos));
+                    _nmeas++;
+                    pos += len;
+                }
+                
+                ++_lines;
             }
-            _syncdims[1]++;
-        }
-        
-        inline void ParseNoise (const MeasHeader& mh) {
-            std::vector<std::complex<float> > noise (mh.ushSamplesInScan);
-            _file.read((char*)&noise[0], mh.ushSamplesInScan*sizeof(std::complex<float>));
-            if (!_noise_r)
-                _nnoise++;
+
         }
-        
-        inline void ParseCTNormalize (const MeasHeader& mh) {
-            std::vector<std::complex<float> > buf (mh.ushSamplesInScan);
-            _file.read((char*)&buf[0], mh.ushSamplesInScan*sizeof(std::complex<float>));
+
+        /**
+         * @brief Index entry of single channel line with data at pos
+         */
+        inline static ADCLine Line (const MeasHeader& mh, size_t pos) {
+            ADCLine line;
+            line.pos = pos;
+            line.ns  = mh.ushSamplesInScan;
+            line.nc  = mh.ushChannelId;
+            std::copy (mh.sLC, mh.sLC+14, line.lc);
+            return line;
         }
-        
-        inline void ParseMeas (const MeasHeader& mh) {
-            size_t pos (_file.tellg());
-            if (!_meas_r) {
-            	if (_nmeas == 0 && mh.ushChannelId == 0) {
-            		_tstart   = mh.ulTimeStamp;
-            		_cent_par = mh.ushKSpaceCentrePartitionNo;
-            		_cent_lin = mh.ushKSpaceCentreLineNo;
-            		_cent_col = mh.ushKSpaceCentreColumn;
-            	} else if (bit_set(mh.aulEvalInfoMask[0], LASTSCANINMEAS) && mh.ushChannelId == 0) {
-            		_tend = mh.ulTimeStamp;
-            	}
-                _measdims = _max (_measdims, mh.sLC);
-                _file.seekg (pos + _measdims[0]*sizeof(std::complex<float>));
-            } else {
+
+        /**
+         * @brief Copy indexed lines to their place in the measurement, feedback
+         *        and sync repositories. Lines with identical counters are not
+         *        expected and overwrite each other in any order.
+         */
+        inline void Scatter () {
+
+            _map.Advise (MappedFile::WILLNEED);
+            const char* data = _map.Data();
+            const long nl = (long) _index.size(), nf = (long) _rtfb_index.size();
+
+#pragma omp parallel
+            {
+#pragma omp for schedule (dynamic, 256) nowait
+                for (long l = 0; l < nl; ++l) {
+                    const ADCLine& line = _index[l];
+                    const std::complex<float>* src = (const std::complex<float>*) (data + line.pos);
 #ifndef USE_IN_MATLAB
-               	_file.read ((char*)&_meas(0, mh.ushChannelId, mh.sLC[0], mh.sLC[1], mh.sLC[2],
-               			mh.sLC[3], mh.sLC[4], mh.sLC[5], mh.sLC[6], mh.sLC[7], mh.sLC[8], mh.sLC[9],
-						mh.sLC[10], mh.sLC[11], mh.sLC[12], mh.sLC[13]),
-						mh.ushSamplesInScan*sizeof(std::complex<float>));
+                    memcpy (&_meas(0, line.nc, line.lc[0], line.lc[1], line.lc[2], line.lc[3],
+                        line.lc[4], line.lc[5], line.lc[6], line.lc[7], line.lc[8], line.lc[9],
+                        line.lc[10], line.lc[11], line.lc[12], line.lc[13]), src,
+                        line.ns*sizeof(std::complex<float>));
 #else
-                std::vector<std::complex<float> >buf (mh.ushSamplesInScan);
-                _file.read((char*)&buf[0], mh.ushSamplesInScan*sizeof(std::complex<float>));
-                for (size_t i = 0; i < _measdims[0]; ++i) {
-                    _meas_r[i+_nmeas*_measdims[0]] = std::real(buf[i]);
-                    _meas_i[i+_nmeas*_measdims[0]] = std::imag(buf[i]);
-                }
+                    for (size_t i = 0; i < _measdims[0]; ++i) {
+                        _meas_r[i+l*_measdims[0]] = std::real(src[i]);
+                        _meas_i[i+l*_measdims[0]] = std::imag(src[i]);
+                    }
 #endif
-            }
-            _nmeas++;
-        }
-        
-        inline void ParseFeedback (const MeasHeader& mh) {
-            size_t pos (_file.tellg());
-            if (!_rtfb_r) {
-                _rtfbdims = _max (_rtfbdims, mh.sLC);
-                _file.seekg (pos + _rtfbdims[0]*sizeof(std::complex<float>));
-            } else {
+                }
+                if (_rtfb_r) {
+#pragma omp for schedule (static) nowait
+                    for (long l = 0; l < nf; ++l) {
+                        const ADCLine& line = _rtfb_index[l];
+                        const std::complex<float>* src = (const std::complex<float>*) (data + line.pos);
 #ifndef USE_IN_MATLAB
-                _file.read((char*)&_rtfb[_nrtfb*_rtfbdims[0]], mh.ushSamplesInScan*sizeof(std::complex<float>));
+                        memcpy (&_rtfb[l*_rtfbdims[0]], src, line.ns*sizeof(std::complex<float>));
 #else
-                std::vector<std::complex<float> >buf (mh.ushSamplesInScan);
-                _file.read((char*)&buf[0], mh.ushSamplesInScan*sizeof(std::complex<float>));
-                for (size_t i = 0; i < _rtfbdims[0]; ++i) {
-                    _rtfb_r[i+_nrtfb*_rtfbdims[0]] = std::real(buf[i]);
-                    _rtfb_i[i+_nrtfb*_rtfbdims[0]] = std::imag(buf[i]);
-                }
+                        for (size_t i = 0; i < _rtfbdims[0]; ++i) {
+                            _rtfb_r[i+l*_rtfbdims[0]] = std::real(src[i]);
+                            _rtfb_i[i+l*_rtfbdims[0]] = std::imag(src[i]);
+                        }
 #endif
+                    }
+                }
             }
-            _nrtfb++;
+
+            if (_sync_r)
+                for (size_t i = 0; i < _sync_index.size(); ++i)
+                    _map.Copy (&_sync_r[i*_syncdims[0]], _sync_index[i], _syncdims[0]*sizeof(float));
+
         }
 
         bool _digested;
@@ -315,6 +346,8 @@ namespace VB {
         float *_meas_r, *_meas_i, *_rtfb_r, *_rtfb_i, *_noise_r, *_noise_i, *_sync_r, _ta, _tr;
         size_t _tend, _tstart;
         std::vector<uint32_t> _syncdims, _measdims, _rtfbdims, _noisedims;
+        std::vector<ADCLine> _index, _rtfb_index; // Measurement and feedback lines
+        std::vector<size_t> _sync_index;          // Sync data offsets
 #ifndef USE_IN_MATLAB
         Matrix<raw> _meas, _rtfb, _ctnorm;
         Matrix<float> _sync;
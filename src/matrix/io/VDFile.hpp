@@ -81,161 +81,175 @@ public:
 
 
     /**
-     * @brief Digest ingredients
-     *
-     * @param  dry    Dry run
+     * @brief Digest ingredients. The file is memory mapped, MDHs are indexed
+     *        in one pass and ADC lines are then copied to their place in
+     *        parallel.
      */
     virtual void Digest () {
-        
-        uint32_t cur_pos;
-        MeasHeader sh;
+
         SimpleTimer st;
-        
-        if (_meas_r == 0)
-            prtmsg ("   Parsing ... \n");
-        else 
-            prtmsg ("   Reading ... \n");
-        
-        _file.seekg(_veh.back().MeasOffset);                // Go to last measurement
-        _file.read((char*)&cur_pos, sizeof(uint32_t));
-        _file.seekg (_veh.back().MeasOffset + cur_pos);     // Skip protocol
+
+        if (!_map.Open (_fname)) {
+            prtwrn ("     Failed to map file.\n");
+            return;
+        }
+
+        prtmsg ("   Parsing ... \n");
+        Index ();
+        prtmsg ("     done - wtime %s", st.Format().c_str());
+
+        _measdims = _raise_one (_measdims); // Dimensions one higher that highest counter
+        _ta = 2.5e-3*(_tend-_tstart);
+        wspace.PSet("TA", _ta);
+        _tr = _ta/_nmeas;
+        wspace.PSet("TR", _tr);
+        PrintParse();
+        Allocate();
+
+        SimpleTimer rt;
+        prtmsg ("   Reading ... \n");
+        Scatter ();
+        prtmsg ("     done - wtime %s", rt.Format().c_str());
+
+        _map.Close();
+        _digested = true;
+
+    }
+    
+    void Read () {
+        if (!_digested)
+            this->Digest();
+        wspace.Add<cxfl>("meas", _meas);
+        wspace.Add<cxfl>("rtfb", _rtfb);
+        wspace.Add<float>("sync", _sync);
+    }
+
+private:
+
+    /**
+     * @brief Bytes following a measurement header (channel headers and data)
+     */
+    inline static size_t LineLength (const MeasHeader& mh) {
+        return (mh.ushSamplesInScan*sizeof(std::complex<float>) + CHANNEL_HEADER_LEN) *
+            mh.ushUsedChannels;
+    }
+
+    /**
+     * @brief Single pass over MDHs. Records counters, dimensions and the
+     *        offsets of ADC and sync lines.
+     */
+    inline void Index () {
+
+        MeasHeader sh;
+        uint32_t cur_pos = 0;
+        size_t pos = _veh.back().MeasOffset;                // Go to last measurement
+        _map.Advise (MappedFile::SEQUENTIAL);
+        _map.Copy (&cur_pos, pos, sizeof(uint32_t));
+        pos += cur_pos;                                     // Skip protocol
+
         _nmeas = 0;
         _nlines = 0;
-        
+        _index.clear();
+        _sync_index.clear();
+
         while (true) {
-            _file.read((char*)&sh, MEAS_HEADER_LEN);
+            if (!_map.Copy (&sh, pos, MEAS_HEADER_LEN)) {
+                prtwrn ("     Unexpected end of file.\n");
+                break;
+            }
+            pos += MEAS_HEADER_LEN;
             if (bit_set(sh.aulEvalInfoMask[0], ACQEND) || sh.ushSamplesInScan == 0) { // ACQEND
                 break;
             } else if (bit_set (sh.aulEvalInfoMask[0], SYNCDATA)) {
-                size_t tmp1 = _file.tellg(), tmp2;
-                ParseSync (sh);
-                tmp2 = _file.tellg();
-                tmp1 = ((tmp2-tmp1)%32);
-                if (tmp1)
-                    _file.seekg (tmp2 + 32-tmp1);
+                if (_syncdims[0] == 0) {
+                    _map.Copy (&_syncdims[0], pos, sizeof(uint32_t));
+                    _syncdims[0] /= sizeof(float);
+                }
+                size_t len = SYNC_HEADER_SIZE - 4 + _syncdims[0]*sizeof(float);
+                if (!_map.Within (pos, len)) {
+                    prtwrn ("     Unexpected end of file.\n");
+                    break;
+                }
+                _sync_index.push_back (pos + SYNC_HEADER_SIZE - 4);
+                _syncdims[1]++;
+                if (len%32)
+                    len += 32 - len%32;
+                pos += len;
             } else if (bit_set(sh.aulEvalInfoMask[1], ONLINE)) { // CT_NORMALIZE
-                    ParseCTNormalize (sh);
+                pos += LineLength (sh);
             } else if (bit_set (sh.aulEvalInfoMask[0], ONLINE)) { // Actual data
+                if (!_map.Within (pos, LineLength (sh))) {
+                    prtwrn ("     Unexpected end of file.\n");
+                    break;
+                }
                 if (_nmeas == 0) {
                     _measdims[0] = sh.ushSamplesInScan;
                     _measdims[1] = sh.ushUsedChannels;
+                    _tstart   = sh.ulTimeStamp;
+                    _cent_par = sh.ushKSpaceCentrePartitionNo;
+                    _cent_lin = sh.ushKSpaceCentreLineNo;
+                    _cent_col = sh.ushKSpaceCentreColumn;
+                } else if (bit_set(sh.aulEvalInfoMask[0], LASTSCANINMEAS)) {
+                    _tend = sh.ulTimeStamp;
                 }
-                ParseMeas (sh);
+                _measdims = _max (_measdims, sh.sLC);  // Keep track of highest counter
+                ADCLine line;
+                line.pos = pos;
+                line.ns  = sh.ushSamplesInScan;
+                line.nc  = sh.ushUsedChannels;
+                std::copy (sh.sLC, sh.sLC+14, line.lc);
+                _index.push_back (line);
+                pos += LineLength (sh);
+                _nmeas++;
             } else {
-                prtwrn ("Failed to understand data set. Skipping.");
+                prtwrn("Failed to understand data set. Skipping.");
                 _measdims.resize(16,1);
                 break;
             }
             _nlines++;
         }
-        prtmsg ("     done - wtime %s", st.Format().c_str());
 
-        //prtmsg ("     done - wtime (%d ms).\n", 0/*GetTimeMs64()-start*/);
-        
-        if (_meas_r == 0) {
-            _measdims = _raise_one (_measdims); // Dimensions one higher that highest counter
-            _ta = 2.5e-3*(_tend-_tstart);
-            wspace.PSet("TA", _ta);
-            _tr = _ta/_nmeas;                            
-            wspace.PSet("TR", _tr);
-            PrintParse(); 
-            Allocate(); 
-            Digest(); 
-        }
-        _digested = true;
-    }
-    
-    void Read () {
-        if (!_digested)
-            this->Digest();
-        wspace.Add<cxfl>("meas", _meas);
-        wspace.Add<cxfl>("rtfb", _rtfb);
-        wspace.Add<float>("sync", _sync);
     }
 
-private:
-
     /**
-     * @brief Parse one multichannel measurement line
-     *
-     * @param  mh    Measurement header
+     * @brief Copy indexed ADC lines to their place in the measurement and
+     *        sync lines to the sync repository. Lines with identical
+     *        counters are not expected and overwrite each other in any order.
      */
-    inline void ParseMeas (const MeasHeader& mh) {
-        size_t pos (_file.tellg());
-
-        ChannelHeader ch;
-        if (!_meas_r) {
-            _measdims = _max (_measdims, mh.sLC);  // Keep track of highest counter
-            _file.seekg (pos + (mh.ushSamplesInScan*sizeof(std::complex<float>)
-                             + CHANNEL_HEADER_LEN)*mh.ushUsedChannels);
-            if (_nmeas == 0) {
-                _tstart   = mh.ulTimeStamp;
-                _cent_par = mh.ushKSpaceCentrePartitionNo;
-                _cent_lin = mh.ushKSpaceCentreLineNo;
-                _cent_col = mh.ushKSpaceCentreColumn;
-            } else if (bit_set(mh.aulEvalInfoMask[0], LASTSCANINMEAS)) {
-                _tend = mh.ulTimeStamp;
-            }
+    inline void Scatter () {
 
-        } else {
+        _map.Advise (MappedFile::WILLNEED);
+        const char* data = _map.Data();
+        const long nl = (long) _index.size();
+
+#pragma omp parallel for schedule (dynamic, 64)
+        for (long l = 0; l < nl; ++l) {
+            const ADCLine& line = _index[l];
+            const size_t len = line.ns*sizeof(std::complex<float>);
+            const char* src = data + line.pos + CHANNEL_HEADER_LEN;
 #ifndef USE_IN_MATLAB
-            for (size_t i = 0; i < mh.ushUsedChannels; ++i) {
-                _file.read((char*)&ch, CHANNEL_HEADER_LEN);
-                _file.read ((char*)&_meas(0, i, mh.sLC[0], mh.sLC[1], mh.sLC[2],
-                    mh.sLC[3], mh.sLC[4], mh.sLC[5], mh.sLC[6], mh.sLC[7],
-					mh.sLC[8], mh.sLC[9], mh.sLC[10], mh.sLC[11], mh.sLC[12],
-					mh.sLC[13]), mh.ushSamplesInScan*sizeof(std::complex<float>));
-            }
+            for (size_t i = 0; i < line.nc; ++i, src += len + CHANNEL_HEADER_LEN)
+                memcpy (&_meas(0, i, line.lc[0], line.lc[1], line.lc[2], line.lc[3],
+                    line.lc[4], line.lc[5], line.lc[6], line.lc[7], line.lc[8], line.lc[9],
+                    line.lc[10], line.lc[11], line.lc[12], line.lc[13]), src, len);
 #else
-            std::vector<std::complex<float> > buf (mh.ushSamplesInScan*mh.ushUsedChannels);
-            for (size_t i = 0; i < mh.ushUsedChannels; ++i) {
-                _file.read((char*)&ch, CHANNEL_HEADER_LEN);
-                _file.read((char*)&buf[i*mh.ushSamplesInScan],
-                           mh.ushSamplesInScan*sizeof(std::complex<float>));
-            }
             size_t offset = 0;
             for (size_t i = 0; i < 14; ++i)
-                offset += mh.sLC[i]*_measdims_sizes[i];
-            for (size_t j = 0; j < mh.ushUsedChannels; ++j) {
-                for (size_t i = 0; i < mh.ushSamplesInScan; ++i) {
-                    _meas_r[offset + j*mh.ushSamplesInScan + i] =
-                        std::real(buf[j*mh.ushSamplesInScan + i]);
-                    _meas_i[offset + j*mh.ushSamplesInScan + i] =
-                        std::imag(buf[j*mh.ushSamplesInScan + i]);
+                offset += line.lc[i]*_measdims_sizes[i];
+            for (size_t j = 0; j < line.nc; ++j, src += len + CHANNEL_HEADER_LEN) {
+                const std::complex<float>* buf = (const std::complex<float>*) src;
+                for (size_t i = 0; i < line.ns; ++i) {
+                    _meas_r[offset + j*line.ns + i] = std::real(buf[i]);
+                    _meas_i[offset + j*line.ns + i] = std::imag(buf[i]);
                 }
             }
 #endif
         }
-        _nmeas++;
-    }
 
+        if (_sync_r)
+            for (size_t i = 0; i < _sync_index.size(); ++i)
+                _map.Copy (&_sync_r[i*_syncdims[0]], _sync_index[i], _syncdims[0]*sizeof(float));
 
-    inline void ParseCTNormalize (const MeasHeader& mh) {
-        ChannelHeader ch;
-        std::vector<std::complex<float> > buf (mh.ushSamplesInScan*mh.ushUsedChannels);
-        for (size_t i = 0; i < mh.ushUsedChannels; ++i) {
-            _file.read((char*)&ch, CHANNEL_HEADER_LEN);
-            _file.read((char*)&buf[i*mh.ushSamplesInScan],
-                       mh.ushSamplesInScan*sizeof(std::complex<float>));
-        }
-    }
-        
-    /**
-     * @brief Parse SyncData
-     */
-    inline void ParseSync (const MeasHeader& mh) {
-        size_t start (_file.tellg());
-        if (!_sync_r) {
-            if (_syncdims[0] == 0) {
-                _file.read((char*)&_syncdims[0], sizeof(uint32_t));
-                _syncdims[0] /= sizeof(float);
-            }
-            _file.seekg (start + SYNC_HEADER_SIZE - 4 + _syncdims[0]*sizeof(float));
-        } else {
-            _file.seekg (start + SYNC_HEADER_SIZE - 4);
-            _file.read((char*)&_sync_r[_syncdims[0]*_syncdims[1]], _syncdims[0]*sizeof(float));
-        }
-        _syncdims[1]++;
     }
     
     
@@ -258,13 +272,11 @@ private:
             _measdims_sizes[i] = _measdims_sizes[i-1]*_measdims[i+1];
         _meas_r = (float*) mxGetData(_lhs[0]);
         _meas_i = (float*) mxGetImagData(_lhs[0]);
-        _nmeas = 0;
         if (_nlhs > 1) {
             _lhs[1] = mxCreateNumericArray (2, syncdim, mxSINGLE_CLASS, mxREAL);
             _sync_r = (float*) mxGetData(_lhs[1]);
             for (size_t i = 0; i < _syncdims[1]*_syncdims[0]; ++i)
                 _sync_r[i] = 0.;
-            _syncdims[1]=0;
         }
 #else
 
@@ -301,6 +313,8 @@ private:
     std::vector<EntryHeader> _veh; // Entry headers
     std::vector<uint32_t> _measdims, _syncdims;
     std::vector<size_t> _measdims_sizes; 
+    std::vector<ADCLine> _index;      // ADC lines
+    std::vector<size_t> _sync_index;  // Sync data offsets
     size_t _nmeas, _nlines, _nsync, _cent_par, _cent_lin, _cent_col;
     bool _digested;
     size_t _tend, _tstart;
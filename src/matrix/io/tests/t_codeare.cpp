@@ -5,7 +5,7 @@
  *      Author: kvahed
  */
 
-#include "CODFile.hpp"
+#include "IOContext.hpp"
 #include "Algos.hpp"
 #include "Creators.hpp"
 
@@ -15,8 +15,10 @@ std::string mname = "A";
 std::string fname = "test.cod";
 
 template <class T>
-inline static bool write (const Matrix<T> A) {
-	CODFile mfw (fname, WRITE);
+inline static bool write (const Matrix<T> A, const int version = 1) {
+	Params p;
+	p["version"] = version;
+	CODFile mfw (fname, WRITE, p);
 	mfw.Write (A, mname);
     return true;
 }
@@ -47,9 +49,89 @@ inline static bool check () {
 
 }
 
+template <class T>
+inline static bool same (const Matrix<T>& A, const Matrix<T>& B) {
+	return A.Dim() == B.Dim() && std::equal (A.Begin(), A.End(), B.Begin());
+}
+
+template<class T>
+inline static bool check_mapped () {
+
+	Matrix<T> A = rand<T>(5,3,4), B;
+
+	write(A, 2);
+	read(B);
+	if (!same(A,B))
+		return false;
+
+	CODMap map (fname);
+	if (!map.IsOpen() || map.Name() != mname || ((size_t)map.Ptr<T>()) % COD_ALIGN)
+		return false;
+
+	for (size_t k = 0; k < 4; ++k) { // Slices
+		Matrix<T> S = map.Slab<T>(k);
+		for (size_t j = 0; j < 3; ++j)
+			for (size_t i = 0; i < 5; ++i)
+				if (S(i,j) != A(i,j,k))
+					return false;
+	}
+
+	Matrix<T> S = map.Slab<T>(1,1); // Strided
+	for (size_t k = 0; k < 4; ++k)
+		for (size_t i = 0; i < 5; ++i)
+			if (S(i,0,k) != A(i,1,k))
+				return false;
+
+	CODMap cow (fname, CODMap::COPY_ON_WRITE);
+	cow.MutablePtr<T>()[0] = T(0);
+	read(B);
+
+	return same(A,B);
+
+}
+
+/**
+ * @brief Whole matrix and single slabs through the data-in load path
+ */
+template<class T>
+inline static bool check_load () {
+
+	Matrix<T> A = rand<T>(5,3,4);
+	write(A, 2);
+
+	TiXmlElement din ("data-in"), e (mname.c_str());
+	din.SetAttribute ("fname", fname.c_str());
+	e.SetAttribute ("uri", mname.c_str());
+	IOContext ic (&din, ".", READ);
+	if (ic.Strategy() != CODEARE || !same (A, ic.Read<T>(&e)))
+		return false;
+
+	e.SetAttribute ("slab", 2);
+	Matrix<T> S = ic.Read<T>(&e);
+	if (size(S,2) != 1)
+		return false;
+	for (size_t j = 0; j < 3; ++j)
+		for (size_t i = 0; i < 5; ++i)
+			if (S(i,j) != A(i,j,2))
+				return false;
+
+	e.SetAttribute ("dim", 1);
+	S = ic.Read<T>(&e);
+	if (size(S,1) != 1)
+		return false;
+	for (size_t k = 0; k < 4; ++k)
+		for (size_t i = 0; i < 5; ++i)
+			if (S(i,0,k) != A(i,2,k))
+				return false;
+
+	return true;
+
+}
+
 int main (int args, char** argv) {
 
-	if (check<float>() && check<double>() && check<cxfl>() && check<cxdb>())
+	if (check<float>() && check<double>() && check<cxfl>() && check<cxdb>() &&
+		check_mapped<float>() && check_mapped<cxdb>() && check_load<cxfl>())
         return 0;
 
 	return 1;
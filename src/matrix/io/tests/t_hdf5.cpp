@@ -50,10 +50,53 @@ template<class T> inline static bool check () {
 
 }
 
+template<class T> inline static bool check_chunked () {
+
+	Matrix<T> A = rand<T>(6,5,4), B;
+
+	// Chunked per slice, shuffled and deflated
+	{
+		Params p;
+		p["shuffle"] = true;
+		p["deflate"] = 4;
+		Vector<size_t> chunk (3,0);
+		chunk[2] = 1;
+		p["chunk"]   = chunk;
+		HDF5File nf (fname, WRITE, p);
+		nf.Write (A, "/data/" + mname);
+	}
+
+	HDF5File nf (fname, READ);
+
+	// Whole
+	B = nf.Read<T>("/data/" + mname);
+	if (!std::equal (A.Begin(), A.End(), B.Begin()))
+		return false;
+
+	// Sub-block
+	Vector<size_t> off (3), cnt (3);
+	off[0] = 1; off[1] = 2; off[2] = 1;
+	cnt[0] = 4; cnt[1] = 2; cnt[2] = 3;
+	B = nf.Read<T>("/data/" + mname, off, cnt);
+	for (size_t k = 0; k < cnt[2]; ++k)
+		for (size_t j = 0; j < cnt[1]; ++j)
+			for (size_t i = 0; i < cnt[0]; ++i)
+				if (B(i,j,k) != A(off[0]+i,off[1]+j,off[2]+k))
+					return false;
+
+	// Catalog
+	std::vector<HDF5Entry> cat = nf.Catalog();
+	return cat.size() == 1 && cat[0].path == "/data/" + mname && cat[0].dims == A.Dim() &&
+		cat[0].chunk.size() == 3 && cat[0].chunk[2] == 1 && cat[0].chunk[0] == 6 &&
+		cat[0].complex == is_complex(T());
+
+}
+
 int main (int args, char** argv) {
 
     if (args == 1) {
-        if (check<float>() && check<double>() && check<cxfl>() && check<cxdb>())
+        if (check<float>() && check<double>() && check<cxfl>() && check<cxdb>() &&
+            check_chunked<float>() && check_chunked<cxfl>())
             return 0;
     } else {
         HDF5File h5f (argv[1]);
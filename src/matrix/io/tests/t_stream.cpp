@@ -0,0 +1,76 @@
+/*
+ * t_stream.cpp
+ *
+ *  Line by line acquisition into the workspace
+ */
+
+#include "Workspace.hpp"
+
+const size_t ns = 8, nc = 2, nl = 4, npar = 3, chunk = 3;
+
+inline static cxfl sample (size_t i, size_t c, size_t l, size_t par) {
+    return cxfl (i + 10*c, 100*l + par);
+}
+
+/**
+ * @brief Every chunk reports the counters and offsets its lines landed at
+ */
+inline static bool check (bool ring) {
+
+    Vector<size_t> dims (4);
+    dims[0] = ns; dims[1] = nc; dims[2] = nl; dims[3] = ring ? 2 : npar;
+    wspace.OpenStream<cxfl> ("meas", dims, chunk, ring);
+
+    std::vector<cxfl> d (ns*nc);
+    uint16_t lc[2];
+    size_t first, n = 0, chunks = 0;
+    std::vector<AcqLine> lines;
+
+    for (size_t par = 0; par < npar; ++par)
+        for (size_t l = 0; l < nl; ++l) {
+            lc[0] = l; lc[1] = par;
+            for (size_t c = 0; c < nc; ++c)
+                for (size_t i = 0; i < ns; ++i)
+                    d[c*ns+i] = sample (i, c, l, par);
+            if (wspace.AppendLine ("meas", lc, 2, &d[0], ns) != codeare::OK)
+                return false;
+            if (l == nl-1 && par == npar-1)
+                wspace.CloseStream ("meas");
+            while (wspace.NextChunk ("meas", first, lines)) {
+                if (first != n || (lines.size() != chunk && !wspace.Stream("meas")->done))
+                    return false;
+                const Matrix<cxfl>& meas = wspace.Get<cxfl>("meas");
+                for (size_t j = 0; j < lines.size(); ++j) {
+                    const AcqLine& al = lines[j];
+                    if (al.lc.size() != 2 || al.lc[0] != (first+j)%nl || al.lc[1] != (first+j)/nl)
+                        return false;
+                    for (size_t c = 0; c < nc; ++c)
+                        for (size_t i = 0; i < ns; ++i)
+                            if (meas[al.slot + c*ns + i] != sample (i, c, al.lc[0], al.lc[1]))
+                                return false;
+                }
+                n += lines.size();
+                ++chunks;
+            }
+        }
+
+    const AcqStream* as = wspace.Stream ("meas");
+    if (!as || !as->done || as->lines != nl*npar || as->emitted != n || n != nl*npar ||
+        chunks != (nl*npar + chunk - 1)/chunk)
+        return false;
+
+    lc[0] = nl; lc[1] = 0;
+    if ((wspace.AppendLine ("meas", lc, 2, &d[0], ns) == codeare::OK) != ring)
+        return false;
+
+    wspace.EraseStream ("meas");
+    return wspace.Stream ("meas") == 0 &&
+        wspace.AppendLine ("meas", lc, 2, &d[0], ns) == codeare::NO_MATRIX_IN_WORKSPACE_BY_NAME;
+
+}
+
+int main (int args, char** argv) {
+
+    return (check (false) && check (true)) ? 0 : 1;
+
+}
@@ -0,0 +1,110 @@
+/*
+ * t_transfer.cpp
+ *
+ *  Chunked matrix transfer into the workspace with broken connections and resume
+ */
+
+#include "Workspace.hpp"
+#include "ChunkedTransfer.hpp"
+#include "Creators.hpp"
+
+using namespace RRClient;
+
+const size_t chunk = 100;
+
+/**
+ * @brief Loopback channel straight into the workspace. The n-th slab
+ *        (counting from 1) is lost before (request) or after (reply) the
+ *        service saw it. From slab cut on the connection stays down.
+ */
+struct Loopback {
+
+	Loopback () : puts(0), opens(0), request(0), reply(0), cut(0) {}
+
+	long long Open (const std::string& name, const bool& resume) {
+		if (cut && puts >= cut)
+			throw TransferLost();
+		++opens;
+		Vector<size_t> dims (2);
+		dims[0] = 33; dims[1] = 7;
+		return (long long) wspace.OpenTransfer<cxfl> (name, dims, Vector<float>(2,1.), resume);
+	}
+
+	long long Put (const std::string& name, const size_t& off, const char* data, const size_t& len) {
+		++puts;
+		if (puts == request || (cut && puts >= cut))
+			throw TransferLost();
+		long long r = wspace.PutChunk (name, off, data, len);
+		if (puts == reply)
+			throw TransferLost();
+		return r;
+	}
+
+	size_t puts, opens, request, reply, cut;
+
+};
+
+static size_t last = 0;
+static bool   monotonic = true;
+
+inline static void progress (const std::string&, const size_t& done, const size_t& total) {
+	monotonic &= (done >= last && done <= total);
+	last = done;
+}
+
+inline static bool arrived (const Matrix<cxfl>& m) {
+	if (wspace.Exists<cxfl>("meas") != codeare::OK || wspace.Transfer("meas") != 0)
+		return false;
+	const Matrix<cxfl>& r = wspace.Get<cxfl>("meas");
+	if (r.Size() != m.Size())
+		return false;
+	for (size_t i = 0; i < m.Size(); ++i)
+		if (r[i] != m[i])
+			return false;
+	return true;
+}
+
+int main (int args, char** argv) {
+
+	Matrix<cxfl> m = randn<cxfl> (33, 7);
+	const size_t size = m.Size() * sizeof(cxfl), slabs = (size + chunk - 1) / chunk;
+	const char* p = (const char*) m.Ptr();
+
+	// Lost request and lost reply are resumed within one call
+	Loopback a;
+	a.request = 3;
+	a.reply   = 6;
+	if (SendChunks (a, "meas", p, size, false, chunk, 3, progress) != codeare::OK ||
+		!arrived (m) || !monotonic || last != size || a.opens != 3 || a.puts != slabs + 1)
+		return 1;
+
+	// Broken for good after 4 slabs, resumed by a later call
+	Loopback b;
+	b.cut = 5;
+	if (SendChunks (b, "meas", p, size, false, chunk, 2) != codeare::GENERAL_IO_ERROR ||
+		wspace.Received ("meas") != (long long)(4 * chunk))
+		return 1;
+	Loopback c;
+	if (SendChunks (c, "meas", p, size, true, chunk, 0) != codeare::OK ||
+		!arrived (m) || c.puts != slabs - 4)
+		return 1;
+
+	// Reply to the last slab lost: the service forgot the completed transfer, start over
+	Loopback d;
+	d.reply = slabs;
+	if (SendChunks (d, "meas", p, size, false, chunk, 1) != codeare::OK ||
+		!arrived (m) || d.opens != 2 || d.puts != 2 * slabs)
+		return 1;
+
+	// Gaps are refused, unknown and replaced transfers are reported
+	Loopback e;
+	e.Open ("meas", false);
+	if (wspace.PutChunk ("meas", chunk, p, chunk) != 0 || wspace.PutChunk ("none", 0, p, chunk) != -1)
+		return 1;
+	wspace.AddMatrix<cxfl>("meas") = Matrix<cxfl> (3, 3);
+	if (wspace.PutChunk ("meas", 0, p, chunk) != -1 || wspace.Transfer ("meas") != 0)
+		return 1;
+
+	return 0;
+
+}
@@ -0,0 +1,211 @@
+/*
+ * t_vxsynthetic.cpp
+ *
+ *  Memory mapped VB/VD reader on small synthetic raid files
+ */
+
+#include "VXFile.hpp"
+#include "MappedFile.hpp"
+
+#include <fstream>
+
+using namespace codeare::matrix::io;
+
+const size_t ns = 64, nc = 4, nl = 16, npar = 3;
+
+inline static cxfl sample (size_t i, size_t l, size_t c, size_t par) {
+    return cxfl (i + 100*l + 10000*c, par);
+}
+
+inline static std::string protocol () {
+    return std::string ("<XProtocol> { <Name> \"Meas\" }\n### ASCCONV BEGIN ###\n"
+                        "lScanTimeSec = 10\nalTR[0] = 5000\nlTotalScanTimeSec = 10\n"
+                        "### ASCCONV END ###\n");
+}
+
+inline static uint32_t bit (int b) { return 1u << b; }
+
+/**
+ * @brief Sync data: 160 bytes of 40 floats (3)
+ */
+inline static void sync (std::ofstream& f, size_t len) {
+    std::vector<char> s (len, 0);
+    uint32_t n = 160;
+    float v = 3.f;
+    memcpy (&s[0], &n, 4);
+    for (size_t i = 0; i < 40; ++i)
+        memcpy (&s[60+4*i], &v, 4);
+    f.write (&s[0], s.size());
+}
+
+inline static void write_vb (const std::string& fname) {
+
+    std::ofstream f (fname.c_str(), std::ios::binary);
+    std::string p = protocol();
+    uint32_t hl = 4 + p.size();
+    hl += (32 - hl%32) % 32;
+    std::string hdr (hl, ' ');
+    memcpy (&hdr[0], &hl, 4);
+    memcpy (&hdr[4], p.data(), p.size());
+    f.write (hdr.data(), hl);
+
+    VB::MeasHeader mh;
+    memset (&mh, 0, sizeof(mh)); // Noise adjust
+    mh.aulEvalInfoMask[0] |= bit (NOISEADJSCAN);
+    mh.ushSamplesInScan = ns;
+    mh.ushUsedChannels  = nc;
+    std::vector<cxfl> d (ns, cxfl(1.f));
+    for (size_t c = 0; c < nc; ++c) {
+        f.write ((char*)&mh, sizeof(mh));
+        f.write ((char*)&d[0], ns*sizeof(cxfl));
+    }
+
+    memset (&mh, 0, sizeof(mh));
+    mh.aulEvalInfoMask[0] |= bit (SYNCDATA);
+    f.write ((char*)&mh, sizeof(mh));
+    sync (f, 224);
+
+    for (size_t par = 0; par < npar; ++par)
+        for (size_t l = 0; l < nl; ++l)
+            for (size_t c = 0; c < nc; ++c) {
+                memset (&mh, 0, sizeof(mh));
+                mh.ushSamplesInScan = ns;
+                mh.ushUsedChannels  = nc;
+                mh.ushChannelId     = c;
+                mh.sLC[0]           = l;
+                mh.sLC[3]           = par;
+                mh.aulEvalInfoMask[0] |= bit (ONLINE);
+                f.write ((char*)&mh, sizeof(mh));
+                for (size_t i = 0; i < ns; ++i)
+                    d[i] = sample (i, l, c, par);
+                f.write ((char*)&d[0], ns*sizeof(cxfl));
+            }
+
+    memset (&mh, 0, sizeof(mh));
+    mh.aulEvalInfoMask[0] |= bit (ACQEND);
+    f.write ((char*)&mh, sizeof(mh));
+    std::vector<char> pad (1024, 0);
+    f.write (&pad[0], pad.size());
+
+}
+
+inline static void write_vd (const std::string& fname) {
+
+    std::ofstream f (fname.c_str(), std::ios::binary);
+    uint32_t id = 0, nd = 1;
+    f.write ((char*)&id, 4);
+    f.write ((char*)&nd, 4);
+    VD::EntryHeader eh;
+    memset (&eh, 0, sizeof(eh));
+    eh.MeasOffset = 10240;
+    strcpy (eh.ProtocolName, "synthetic");
+    f.write ((char*)&eh, sizeof(eh));
+
+    std::string p = protocol();
+    std::vector<char> pad (10240 - 8 - sizeof(eh), 0);
+    memcpy (&pad[100], p.data(), p.size());
+    f.write (&pad[0], pad.size());
+    uint32_t hl = 4096;
+    std::string hdr (hl, ' ');
+    memcpy (&hdr[0], &hl, 4);
+    memcpy (&hdr[4], p.data(), p.size());
+    f.write (hdr.data(), hl);
+
+    VD::MeasHeader mh;
+    VD::ChannelHeader ch;
+    memset (&ch, 0, sizeof(ch));
+    memset (&mh, 0, sizeof(mh));
+    mh.aulEvalInfoMask[0] |= bit (SYNCDATA);
+    mh.ushSamplesInScan = 1;
+    f.write ((char*)&mh, sizeof(mh));
+    sync (f, 224);
+
+    std::vector<cxfl> d (ns);
+    for (size_t par = 0; par < npar; ++par)
+        for (size_t l = 0; l < nl; ++l) {
+            memset (&mh, 0, sizeof(mh));
+            mh.ushSamplesInScan = ns;
+            mh.ushUsedChannels  = nc;
+            mh.sLC[0]           = l;
+            mh.sLC[3]           = par;
+            mh.aulEvalInfoMask[0] |= bit (ONLINE);
+            f.write ((char*)&mh, sizeof(mh));
+            for (size_t c = 0; c < nc; ++c) {
+                f.write ((char*)&ch, sizeof(ch));
+                for (size_t i = 0; i < ns; ++i)
+                    d[i] = sample (i, l, c, par);
+                f.write ((char*)&d[0], ns*sizeof(cxfl));
+            }
+        }
+
+    memset (&mh, 0, sizeof(mh));
+    mh.aulEvalInfoMask[0] |= bit (ACQEND);
+    f.write ((char*)&mh, sizeof(mh));
+    std::vector<char> pad2 (1024, 0);
+    f.write (&pad2[0], pad2.size());
+
+}
+
+/**
+ * @brief Every ADC line lands at (col, cha, lin, ..., par) and sync is complete
+ */
+inline static bool check (const std::string& fname) {
+
+    {
+        VXFile vxf (fname, READ);
+        vxf.Read();
+    }
+
+    const Matrix<cxfl>&  meas = wspace.Get<cxfl>("meas");
+    const Matrix<float>& sync = wspace.Get<float>("sync");
+
+    if (size(meas,0) != ns || size(meas,1) != nc || size(meas,2) != nl || size(meas,5) < npar)
+        return false;
+
+    const size_t slab = ns*nc*nl*size(meas,3)*size(meas,4);
+    for (size_t par = 0; par < npar; ++par)
+        for (size_t l = 0; l < nl; ++l)
+            for (size_t c = 0; c < nc; ++c)
+                for (size_t i = 0; i < ns; ++i)
+                    if (meas[par*slab + (l*nc + c)*ns + i] != sample (i, l, c, par))
+                        return false;
+
+    float s = 0.f;
+    for (size_t i = 0; i < sync.Size(); ++i)
+        s += sync[i];
+
+    return sync.Size() == 40 && s == 120.f;
+
+}
+
+/**
+ * @brief Bounds, ranged advice and private copy-on-write pages
+ */
+inline static bool check_map (const std::string& fname) {
+
+    MappedFile ro (fname), cow (fname, true);
+    if (!ro.IsOpen() || !cow.IsOpen() || ro.Size() != cow.Size() || ro.MutableData() != 0)
+        return false;
+
+    char c;
+    if (!ro.Copy (&c, ro.Size()-1, 1) || ro.Copy (&c, ro.Size(), 1) || ro.Within (1, ro.Size()))
+        return false;
+    ro.Advise (MappedFile::WILLNEED, ro.Size()/2, 4096);
+
+    cow.MutableData()[0] ^= 0x5a;
+    MappedFile again (fname);
+    return again.Data()[0] == ro.Data()[0] && cow.Data()[0] != ro.Data()[0];
+
+}
+
+int main (int args, char** argv) {
+
+    write_vb ("synthetic_vb.dat");
+    write_vd ("synthetic_vd.dat");
+
+    if (check ("synthetic_vb.dat") && check ("synthetic_vd.dat") && check_map ("synthetic_vb.dat"))
+        return 0;
+
+    return 1;
+
+}
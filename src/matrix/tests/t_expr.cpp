@@ -0,0 +1,100 @@
+#include <Matrix.hpp>
+#include <Creators.hpp>
+#include <OMP.hpp>
+
+template<class T> inline static double maxdiff (const Matrix<T>& a, const Matrix<T>& b) {
+    double d = 0.;
+    for (size_t i = 0; i < a.Size(); ++i)
+        d = std::max (d, (double)std::abs(a[i]-b[i]));
+    return d;
+}
+
+/**
+ * @brief Fused expressions against eager Matrix arithmetic
+ */
+template<class T> inline static int check (size_t n) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    Matrix<T> a = randn<T>(n,3), b = randn<T>(n,3), c = randn<T>(n,3);
+    T s = randn<T>(1,1)[0];
+    RT t = .7;
+    RT tol = 1.e-5;
+    int ret = 0;
+
+    // Construction, scalars, all operators
+    Matrix<T> e = a + s * b - c / (c + (T)2.);
+    Matrix<T> f = lazy(a) + s * lazy(b) - lazy(c) / (lazy(c) + (T)2.);
+    ret += (maxdiff (e, f) < tol) ? 0 : 1;
+
+    // Compound assignment with real scaling
+    e = c; e -= b * t;
+    f = c; f -= t * lazy(b);
+    ret += (maxdiff (e, f) < tol) ? 0 : 1;
+
+    // In place update referring to the lhs
+    e = c + b * t;
+    f = c; f = lazy(c) + lazy(b) * t;
+    ret += (maxdiff (e, f) < tol) ? 0 : 1;
+    f = lazy(f) * lazy(a);
+    e *= a;
+    ret += (maxdiff (e, f) < tol) ? 0 : 1;
+
+    // Assignment with size change
+    Matrix<T> g;
+    g = lazy(a) * lazy(b);
+    ret += (g.Dim() == a.Dim() && maxdiff (g, a*b) < tol) ? 0 : 1;
+
+    // Column slabs, unaligned for odd n: coil combination sum_j a_j b_j
+    Vector<size_t> dn (1, n);
+    Matrix<T> h (n,1), k = sum (a*b, 1);
+    for (size_t j = 0; j < 3; ++j)
+        codeare::expr::Evaluate (h.Ptr(), lazy(a, j*n, dn) * lazy(b, j*n, dn), codeare::plus<T>());
+    ret += (maxdiff (h, k) < tol) ? 0 : 1;
+
+    printf ("  %s n(%zu): %s\n", typeid(T).name(), n, ret ? "FAILED" : "OK");
+    return ret;
+
+}
+
+/**
+ * @brief CG update p = r + beta p; x += ts p; r -= ts q eager and fused
+ */
+template<class T> inline static void bench (size_t n, size_t reps) {
+
+    typedef typename TypeTraits<T>::RT RT;
+
+    Matrix<T> x = zeros<T>(n,1), p = randn<T>(n,1), q = randn<T>(n,1), r = randn<T>(n,1);
+    RT ts = .1, beta = .9;
+
+    double t0 = omp_get_wtime();
+    for (size_t i = 0; i < reps; ++i) {
+        x += ts * p;
+        r -= ts * q;
+        p *= beta;
+        p += r;
+    }
+    double te = omp_get_wtime() - t0;
+
+    t0 = omp_get_wtime();
+    for (size_t i = 0; i < reps; ++i) {
+        x += ts * lazy(p);
+        r -= ts * lazy(q);
+        p  = lazy(r) + beta * lazy(p);
+    }
+    double tf = omp_get_wtime() - t0;
+
+    printf ("  %s n(%zu): eager %.4fs fused %.4fs speedup %.2f\n", typeid(T).name(),
+            n, te/reps, tf/reps, te/tf);
+
+}
+
+int main (int args, char** argv) {
+    int ret = 0;
+    size_t ns[] = {1, 7, 1001, 100003};
+    for (size_t i = 0; i < 4; ++i)
+        ret += check<float>(ns[i]) + check<double>(ns[i]) + check<cxfl>(ns[i]) + check<cxdb>(ns[i]);
+    bench<cxfl> (1<<22, 10);
+    bench<cxdb> (1<<22, 10);
+    return ret;
+}
@@ -0,0 +1,63 @@
+#include <Matrix.hpp>
+#include <Creators.hpp>
+#include <Algos.hpp>
+
+/**
+ * @brief Element-wise reference permutation
+ */
+template<class T> static Matrix<T> reference (const Matrix<T>& M, const Vector<size_t>& perm) {
+    const size_t nd = perm.size();
+    Vector<size_t> so = size(M), sn (nd), st (nd), x (nd);
+    for (size_t d = 0, s = 1; d < nd; s *= so[d++])
+        st[d] = s;
+    for (size_t d = 0; d < nd; ++d)
+        sn[d] = so[perm[d]];
+    Matrix<T> ret (sn);
+    for (size_t i = 0; i < numel(ret); ++i) {
+        size_t q = i, o = 0;
+        for (size_t d = 0; d < nd; ++d) {
+            o += (q % sn[d]) * st[perm[d]];
+            q /= sn[d];
+        }
+        ret[i] = M[o];
+    }
+    return ret;
+}
+
+template<class T> int check () {
+    const size_t dims[][5] = {{67,33,1,5,9}, {130,7,70,2,3}, {1,64,1,129,2}, {9,8,7,6,5}};
+    const size_t perms[][5] = {{1,0,2,3,4}, {3,2,0,4,1}, {4,3,2,1,0}, {0,1,3,2,4}, {2,0,1,4,3}};
+    int ret = 0;
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 5; ++j) {
+            Matrix<T> A (dims[i][0], dims[i][1], dims[i][2], dims[i][3], dims[i][4]);
+            for (size_t k = 0; k < numel(A); ++k)
+                A[k] = T(k);
+            Vector<size_t> perm (5);
+            std::copy (perms[j], perms[j]+5, perm.begin());
+            if (issame (permute (A, perm), reference (A, perm)) != 2) {
+                printf ("  permute mismatch: dims %zu, order %zu\n", i, j);
+                ++ret;
+            }
+        }
+    Matrix<T> B = rand<T>(65,127), C = rand<T>(31,17,19);
+    Vector<size_t> p3 (3);
+    p3[0] = 2; p3[1] = 0; p3[2] = 1;
+    ret += issame (permute (B, 1, 0), transpose (B)) ? 0 : 1;
+    ret += issame (permute (C, 2, 0, 1), reference (C, p3)) ? 0 : 1;
+    // Trailing singletons of the input beyond the permutation and vice versa
+    Matrix<T> D = rand<T>(4,3,1), E = rand<T>(64,64,1), F = rand<T>(5,6);
+    Vector<size_t> p2 (2), p1 (3);
+    p2[0] = 1; p2[1] = 0;
+    p1[0] = 1; p1[1] = 0; p1[2] = 2;
+    ret += issame (permute (D, p2), transpose (D)) ? 0 : 1;
+    ret += issame (permute (D, 1, 0), transpose (D)) ? 0 : 1;
+    ret += issame (permute (E, 1, 0, 2), transpose (E)) ? 0 : 1;
+    ret += issame (permute (E, 2, 1, 0), resize (transpose (E), 1, 64, 64)) ? 0 : 1;
+    ret += issame (permute (F, p1), transpose (F)) ? 0 : 1;
+    return ret;
+}
+
+int main (int args, char** argv) {
+    return check<float>() + check<double>() + check<cxfl>() + check<cxdb>();
+}
@@ -35,10 +35,53 @@ int test_5d5 () {
 	return 0;
 }
 
+/**
+ * @brief <Dx,y> = <x,D^T y> and fused norm / gradient against composed
+ *        operators for a subset of dimensions
+ */
+int check (const TVOP<cxdb>& tv, const Matrix<cxdb>& x) {
+
+    typedef double RT;
+    const RT l1 = 1.e-3, t = .3, p[] = {1., 1.5};
+    int ret = 0;
+
+    Matrix<cxdb> dx = randn<cxdb>(x.Dim()), Dx = tv.Trafo(x), y = randn<cxdb>(Dx.Dim());
+    Matrix<cxdb> Dty = tv.Adjoint(y);
+    cxdb lhs = 0., rhs = 0.;
+    for (size_t i = 0; i < Dx.Size(); ++i)
+        lhs += std::conj(Dx[i])*y[i];
+    for (size_t i = 0; i < x.Size(); ++i)
+        rhs += std::conj(x[i])*Dty[i];
+    ret += (std::abs(lhs-rhs) < 1.e-9*std::abs(lhs)) ? 0 : 1;
+
+    for (size_t k = 0; k < 2; ++k) {
+        Matrix<cxdb> w = tv.Trafo(x + t*dx), v = tv.Trafo(x), u (v.Dim());
+        RT n = 0.;
+        for (size_t i = 0; i < w.Size(); ++i)
+            n += pow (std::norm(w[i]) + l1, .5*p[k]);
+        ret += (std::abs(n - tv.Norm(x, dx, t, l1, p[k])) < 1.e-9*n) ? 0 : 1;
+        for (size_t i = 0; i < v.Size(); ++i)
+            u[i] = p[k] * v[i] * pow (std::norm(v[i]) + l1, .5*p[k]-1.);
+        Matrix<cxdb> g = tv.Adjoint(u), h = tv.Gradient(x, l1, p[k]);
+        for (size_t i = 0; i < g.Size(); ++i)
+            ret += (std::abs(g[i]-h[i]) < 1.e-9*(1.+std::abs(g[i]))) ? 0 : 1;
+    }
+
+    printf ("  n(%zu) K(%zu): %s\n", x.Size(), Dx.Size()/x.Size(), ret ? "FAILED" : "OK");
+    return ret;
+
+}
+
 int main (int narg, char** argv) {
     test_2d();
     test_3d();
     test_5d4();
     test_5d5();
-    return 0;
+    int ret = 0;
+    ret += check (TVOP<cxdb>(), randn<cxdb>(13,9));
+    ret += check (TVOP<cxdb>(), randn<cxdb>(7,6,5));
+    ret += check (TVOP<cxdb>(1,1,0,1,0), randn<cxdb>(5,4,3,6,2));
+    ret += check (TVOP<cxdb>(0,0,0,1,0), randn<cxdb>(4,5,3,4,3));
+    ret += check (TVOP<cxdb>(0,0,0,0,1), randn<cxdb>(4,5,3,4,3));
+    return ret;
 }
@@ -8,7 +8,7 @@ int main (int narg, const char** argv) {
 	typedef Range<false> R;
 	typedef Range<true> CR;
 
-	Matrix<double> M1(10, 1), M2, M3(M1), M4(3, 4), M6(4, 3), M5(3, 4, 2), M7(3, 4, 2), M8, M9, M10, M11;
+	Matrix<double> M1(10, 1), M2, M3(M1), M4(3, 4), M6(4, 3), M5(3, 4, 2), M7(3, 4, 2), M8, M9, M10, M11, M12, M13;
     M1 = 0.0;
     M2 = M1;
 
@@ -28,6 +28,10 @@ int main (int narg, const char** argv) {
     M10 = M6(CR("1:-1:0,1"),CR("1:2"));
     M11 = M6(CR(),CR()) * M6(CR(),CR());
     M11 = M6 * M6(CR(),CR());
+    M12 = M5(CR(0,2,2),CR(),CR(1));
+    M13 = M5;
+    M13(R(),R(1),R()) *= M5(CR(),CR(2),CR());
+    M13(R(1),R(),R(0)) = 0.0;
     std::cout << M3 << std::endl<< std::endl;
     std::cout << M4 << std::endl<< std::endl;
     std::cout << M6 << std::endl<< std::endl;
@@ -37,6 +41,8 @@ int main (int narg, const char** argv) {
     std::cout << M9 << std::endl<< std::endl;
     std::cout << M10 << std::endl<< std::endl;
     std::cout << M11 << std::endl<< std::endl;
+    std::cout << M12 << std::endl<< std::endl;
+    std::cout << M13 << std::endl<< std::endl;
     return 0;
 }
 
@@ -1,8 +1,8 @@
 /*
   3D Unwrapping algorithm
   Rhodri Cusack 2000-2006
-  Algorithm described in 
-  Cusack, R. & Papadakis, N. (2002) 
+  Algorithm described in
+  Cusack, R. & Papadakis, N. (2002)
   "New robust 3-D phase unwrapping algorithms: application to magnetic field mapping and undistorting echoplanar images."
   Neuroimage. 2002 Jul;16(3 Pt 1):754-64.
   Distributed under GNU public license http://www.gnu.org/copyleft/gpl.html
@@ -10,306 +10,362 @@
   Version 3.00 Oct 2006 adapted for matlab
 */
 
+#ifndef __UNWRAP_HPP__
+#define __UNWRAP_HPP__
+
 #include "Matrix.hpp"
 #include "Algos.hpp"
 #include "Creators.hpp"
+#include "OMP.hpp"
 
-#include <stdio.h>
-#include <string.h>
-#include <string>
-#include <iostream>
-#include <math.h>
+#include <deque>
+#include <map>
+#include <cmath>
 
 
-size_t m_bsx,m_bsy,m_bsz;
-container<unsigned short> flag;
+const static size_t NUMQUEUES = 10000;
+const static size_t DEFAULT_NB = NUMQUEUES;
 
-struct FIELD {
-    double d;	/* value of field */
-    size_t p[3];  /* at this offset */
-    int x,y,z;
-};
 
-struct QUEUEENTRY {
-    int x,y,z;
-    size_t p;
-    double v;
-};
+/**
+ * @brief Quality guided 3D phase unwrapping (Cusack & Papadakis 2002)<br/>
+ *        Voxels are grown from a seed through bucketed priority queues
+ *        ordered by magnitude, strong voxels first. Queues and flags are
+ *        owned by the object, one object per thread unwraps concurrently.
+ */
+template<class T>
+class Unwrapper {
 
-struct FIELD_2 {
-    double d;	/*value of field*/
-    size_t p;		/*at this offset*/
-    int x,y,z;
-};
+public:
 
+	/**
+	 * @brief       Construct with # of quality bins
+	 *
+	 * @param  nb   # of bins (minimum 2)
+	 */
+	Unwrapper (const size_t& nb = DEFAULT_NB) : m_nb ((nb < 2) ? 2 : nb) {}
 
 
-const static size_t NUMQUEUES = 10000;
-const static size_t DEFAULT_NB = NUMQUEUES;
-const static size_t DEFAULTBLOCK = 100;
-const static size_t BLOCKINCREMENT = 500;
-
-size_t m_bot[NUMQUEUES], m_top[NUMQUEUES];
-size_t m_size[NUMQUEUES], m_chunk[NUMQUEUES], m_sizeb[NUMQUEUES];
-char *m_q[NUMQUEUES];
-
-inline static void
-InitQueue (const int queuenum, const int chunk) {
-    
-    m_chunk[queuenum] = chunk;
-    m_bot[queuenum]   = 0;
-    m_top[queuenum]   = 0;
-    m_size[queuenum]  = DEFAULTBLOCK;
-    m_sizeb[queuenum] = m_size[queuenum]*m_chunk[queuenum];
-    
-    m_q[queuenum]=0;
+	/**
+	 * @brief       Unwrap phase of a contiguous volume
+	 *
+	 * @param  in   Complex data (nx x ny x nz)
+	 * @param  n    Volume size
+	 * @param  s    Seed
+	 * @param  out  Unwrapped phase
+	 */
+	void Unwrap (const std::complex<T>* in, const size_t* n, const size_t* s, T* out) {
 
-}
+		const size_t nx = n[0], ny = n[1], nz = n[2], sze = nx*ny*nz;
 
-inline static void
-TerminateQueue(const int queuenum) {
-    
-    if (m_q[queuenum])
-    	delete m_q[queuenum];
+		Bins (in, sze);
+		m_flag.resize (sze);
+		std::fill (m_flag.begin(), m_flag.end(), 0);
+		m_q.resize (m_nb);
 
-    m_q[queuenum]=0;
+		Entry qe;
+		qe.x = s[0]; qe.y = s[1]; qe.z = s[2];
+		qe.p = s[0] + nx*(s[1] + ny*s[2]);
+		out[qe.p] = qe.v = std::arg(in[qe.p]);
+		m_flag[qe.p] = 1;
+		m_q[0].push_back (qe);
 
-}
+		const long sx = 1, sy = nx, sz = nx*ny;
 
+		for (size_t i = 0; i < m_nb; ++i) {
 
-inline static int
-Push(const int queuenum, const void *x) {
-    
-    if (!m_q[queuenum])
-    	m_q[queuenum] = new char[m_sizeb[queuenum]];
-
-    if (!m_q[queuenum]) {
-        printf("Out of memory - could not generate new point queue.\n");
-        return(-1);
-    }
-    
-    int stacksize = m_top[queuenum]-m_bot[queuenum];
-    if (stacksize<0)
-    	stacksize+=m_size[queuenum];
-
-    memcpy(m_q[queuenum]+m_top[queuenum]*m_chunk[queuenum],x,m_chunk[queuenum]);
-    m_top[queuenum]++;
-    
-    if (m_top[queuenum]==m_size[queuenum])
-    	m_top[queuenum]=0;
-    
-    if (m_top[queuenum]==m_bot[queuenum]) {
-        
-        char *newq;
-        size_t newsize, newsizeb, abovebot_b;
-
-        newsize=m_size[queuenum]+BLOCKINCREMENT;
-        newsizeb=newsize*m_chunk[queuenum];
-        newq=new char[newsizeb];
-        if (!newq) {
-            printf("Out of memory - point queue full.\n");
-            return(-1);
-        }
-        
-        abovebot_b=(m_size[queuenum]-m_bot[queuenum])*m_chunk[queuenum];
-        if (abovebot_b>0)
-        	memcpy(newq,(char *)m_q[queuenum]+m_bot[queuenum]*m_chunk[queuenum],abovebot_b);
-        // then, do m_top downwards
-        if (m_top[queuenum]!=0)
-        	memcpy((char *) newq+abovebot_b,m_q[queuenum],m_top[queuenum]*m_chunk[queuenum]);
-        m_bot[queuenum] =0;
-        m_top[queuenum] = m_size[queuenum];
-        m_size[queuenum] = newsize;
-        m_sizeb[queuenum] = newsizeb;
-        delete m_q[queuenum]; // recover old memory
-        m_q[queuenum]=newq;
-
-    }
-    
-    return 0;
-    
-}
+			std::deque<Entry>& q = m_q[i];
 
-static inline int
-Pop (const int queuenum, void *x) {
-    
-    if (m_bot[queuenum]==m_top[queuenum])
-    	return(1);
-    
-    memcpy(x,m_q[queuenum]+m_bot[queuenum]*m_chunk[queuenum],m_chunk[queuenum]);
-    m_bot[queuenum]++;
-
-    if (m_bot[queuenum]==m_size[queuenum])
-    	m_bot[queuenum]=0;
-    
-    return 0;
-}
+			while (!q.empty()) {
+
+				qe = q.front();
+				q.pop_front();
+
+				if (m_bin[qe.p] > i) { // too close to a scary pole, defer to relevant stack
+					m_q[m_bin[qe.p]].push_back (qe);
+					continue;
+				}
+
+				if (qe.z+1 < (int)nz) Check (q, qe,  sz,  0,  0,  1, in, out);
+				if (qe.z   > 0)       Check (q, qe, -sz,  0,  0, -1, in, out);
+				if (qe.y+1 < (int)ny) Check (q, qe,  sy,  0,  1,  0, in, out);
+				if (qe.y   > 0)       Check (q, qe, -sy,  0, -1,  0, in, out);
+				if (qe.x+1 < (int)nx) Check (q, qe,  sx,  1,  0,  0, in, out);
+				if (qe.x   > 0)       Check (q, qe, -sx, -1,  0,  0, in, out);
+
+			}
+
+			std::deque<Entry>().swap (q); // done with this queue so free up memory
+
+		}
+
+	}
+
+
+private:
+
+	struct Entry {
+		int x,y,z;
+		size_t p;
+		double v;
+	};
+
+
+	/**
+	 * @brief       Quality bin of all voxels: smallest i with -|in| <= min + diff i/(nb-1)
+	 */
+	inline void Bins (const std::complex<T>* in, const size_t& sze) {
+
+		double minin = 1.e300, maxin = -1.e300;
+		m_bin.resize (sze);
+		for (size_t p = 0; p < sze; ++p) {
+			const double a = -std::abs(in[p]);
+			minin = std::min (minin, a);
+			maxin = std::max (maxin, a);
+		}
+		const double diff = 1.00001 * (maxin - minin), nb1 = m_nb - 1;
+
+		for (size_t p = 0; p < sze; ++p) {
+			const double a = -std::abs(in[p]);
+			size_t i = (diff > 0.) ? (size_t) std::ceil ((a - minin) / diff * nb1) : 0;
+			i = std::min (i, m_nb - 1);
+			while (i > 0 && minin + diff * (i-1) / nb1 >= a)
+				--i;
+			while (i < m_nb - 1 && minin + diff * i / nb1 < a)
+				++i;
+			m_bin[p] = (unsigned) i;
+		}
+
+	}
+
+
+	/**
+	 * @brief       Unwrap neighbour of qe at offset off and push it to q
+	 */
+	inline void Check (std::deque<Entry>& q, const Entry& qe, const long& off, const int& offx,
+	                   const int& offy, const int& offz, const std::complex<T>* in, T* out) {
+
+		Entry nqe;
+		nqe.p = qe.p + off;
 
+		if (m_flag[nqe.p])
+			return; // Already been here
 
-template<class T> static inline void
-Check(int primaryqueuenum, QUEUEENTRY* qe, size_t offp, int offx, int offy, int offz,
-	  const container<size_t>& dim, const Matrix<T>& phase, Matrix<T>& unwrapped) {
+		nqe.x = qe.x + offx;
+		nqe.y = qe.y + offy;
+		nqe.z = qe.z + offz;
 
-    // first check bounds
-    QUEUEENTRY nqe;
+		// Actually do unwrap
+		const double phase = std::arg(in[nqe.p]);
+		const int wholepis = int((phase - qe.v) / PI);
 
-    nqe.x=qe->x+offx;
-    if ((nqe.x<0)||(nqe.x>=dim[0]))
-    	return;
+		if (wholepis >= 1)
+			nqe.v = phase - TWOPI * int((wholepis+1)/2);
+		else if (wholepis <= -1)
+			nqe.v = phase + TWOPI * int((1-wholepis)/2);
+		else
+			nqe.v = phase;
 
-    nqe.y=qe->y+offy;
-    if ((nqe.y<0)||(nqe.y>=dim[1]))
-    	return;
+		out[nqe.p] = nqe.v;
+		m_flag[nqe.p] = 1;
+		q.push_back (nqe);
 
-    nqe.z=qe->z+offz;
-    if ((nqe.z<0)||(nqe.z>=dim[2]))
-    	return;
+	}
 
-    nqe.p=qe->p+offp;
 
-    if (flag[nqe.p])
-    	return; // Already been here
+	size_t                        m_nb;   /**< @brief # of quality bins */
+	Vector<std::deque<Entry> >    m_q;    /**< @brief Queue per bin */
+	Vector<unsigned char>         m_flag; /**< @brief Visited */
+	Vector<unsigned>              m_bin;  /**< @brief Quality bin per voxel */
+
+};
 
-    // Actually do unwrap
-    int wholepis = int((phase[nqe.p]-qe->v)/PI);
-    
-    if (wholepis>=1)
-        nqe.v = (double) phase[nqe.p] - TWOPI * int((wholepis+1)/2);
-    else if (wholepis<=-1)
-        nqe.v = (double) phase[nqe.p] + TWOPI * int((1-wholepis)/2);
-    else
-    	nqe.v = phase[nqe.p];
-    
-    unwrapped[nqe.p] = nqe.v;
-    flag[nqe.p] = true;
-    
-    if (Push(primaryqueuenum,&nqe))
-        std::cerr << "Out of memory!" << std::endl;
 
+/**
+ * @brief       Volume size (nx,ny,nz) and # of volumes of M
+ */
+template<class T> inline static size_t
+volumes (const Matrix<T>& M, size_t* n) {
+	const Vector<size_t>& d = M.Dim();
+	for (size_t i = 0; i < 3; ++i)
+		n[i] = (i < d.size()) ? d[i] : 1;
+	return numel(M) / (n[0]*n[1]*n[2]);
 }
 
-template <class T> void 
+
+/**
+ * @brief       Unwrap phase of in from seed s (single volume)
+ */
+template <class T> void
 unwrap (const Matrix<size_t>& s, const size_t unb,
         const Matrix<std::complex<T> >& in, Matrix<T>& unwrapped) {
-    
-    Matrix<T> inamp = - abs(in);
-    Matrix<T> wrapped = arg(in);
-    unwrapped = Matrix<T> (in.Dims());
-
-    size_t sze = numel(wrapped), i, sp, nb;
-    container<size_t> dim = size(wrapped);
-
-    // Minimum number of unwrapping bins is 2
-    nb = (unb<2) ? 2 : unb;
-    
-    // Find min and max
-    double minin, maxin, diff;
-    minin    = min(inamp);
-    maxin    = max(inamp);
-    diff     = 1.00001 * (maxin - minin);
-    
-    sp = sub2ind(wrapped,s.Container());
-    
-    flag.resize(sze);
-    
-    for (i = 0; i < sze; i++)
-        flag[i] = false;
-    
-    for (i = 0; i < nb; i++)
-        InitQueue (i, sizeof(QUEUEENTRY));
-
-    QUEUEENTRY qe;
-    
-    qe.p  = sp;
-    qe.x  = s[0];
-    qe.y  = s[1];
-    qe.z  = s[2];
-    unwrapped[85]  = wrapped[85];
-    unwrapped[sp]  = qe.v = wrapped[sp];
-    flag[sp] = true;
-    
-    // push s
-    Push(0, &qe);
-    
-    // First, work out pole field threshold that we're going to use
-    container<double> polefieldthresholds (nb);
-    int ind  = 0;
-
-    for (i = 0; i < nb; ++i)
-        polefieldthresholds[ind++] = minin + diff * i / (nb-1);
-    
-    for (i=0; i < nb; i++) {
-
-        while (!Pop(i,&qe)) {
-
-            if (inamp[qe.p] > polefieldthresholds[i]) { // too close to a scary pole, so just defer by pushing to other stack
-                ind = i;
-                while (inamp[qe.p] > polefieldthresholds[++ind]);
-                Push(ind,&qe);  // just defer by pushing to relevant stack
-            } else { 
-                Check (i, &qe,  m_bsz,  0,  0,  1, dim, wrapped, unwrapped);
-                Check (i, &qe, -m_bsz,  0,  0, -1, dim, wrapped, unwrapped);
-                Check (i, &qe,  m_bsy,  0,  1,  0, dim, wrapped, unwrapped);
-                Check (i, &qe, -m_bsy,  0, -1,  0, dim, wrapped, unwrapped);
-                Check (i, &qe,  m_bsx,  1,  0,  0, dim, wrapped, unwrapped);
-                Check (i, &qe, -m_bsx, -1,  0,  0, dim, wrapped, unwrapped);
-            }
-        }
-
-        TerminateQueue(i);	// done with this Queue so free up memory
-        
-    }
-    
+
+	size_t n[3];
+	volumes (in, n);
+	unwrapped = Matrix<T> (size(in));
+	Unwrapper<T> (unb).Unwrap (in.Ptr(), n, s.Ptr(), unwrapped.Ptr());
+
 }
 
 
-template<class T> Matrix<T>
-unwrap3d (const Matrix<T>& M, const Matrix<size_t>& seed, const size_t nub = DEFAULT_NB) {
+/**
+ * @brief       Unwrap all 3D volumes of M (echoes, channels, time points ...)<br/>
+ *              Volumes are unwrapped in parallel, each from the same seed.
+ *
+ * @param  M    Complex data
+ * @param  seed Seed (3)
+ * @param  nub  # of quality bins
+ * @return      Unwrapped phase
+ */
+template <class T> Matrix<T>
+unwrap3d (const Matrix<std::complex<T> >& M, const Matrix<size_t>& seed, const size_t nub = DEFAULT_NB) {
+
+	size_t n[3];
+	const long nv = (long) volumes (M, n), nvox = n[0]*n[1]*n[2];
+	assert (seed[0] < n[0] && seed[1] < n[1] && seed[2] < n[2]);
 
-    assert (is3d(M));
-    assert (seed[0] < size(M,0) && seed[1] < size(M,1) && seed[2] < size(M,2));
+	Matrix<T> ret (size(M));
 
-    Matrix<T> ret (size(M));
-    m_bsx = M.Dszs()[0]; m_bsy = M.Dszs()[1]; m_bsz = M.Dszs()[2];
-    unwrap (seed, nub, complex2(ones<T>(size(M)),M), ret);
+#pragma omp parallel if (nv > 1)
+	{
+		Unwrapper<T> u (nub);
+#pragma omp for schedule (dynamic)
+		for (long v = 0; v < nv; ++v)
+			u.Unwrap (M.Ptr() + v*nvox, n, seed.Ptr(), ret.Ptr() + v*nvox);
+	}
 
-    return ret;
+	return ret;
 
 }
 
 
+/**
+ * @brief       Default seed: centre of volume
+ */
+template <class T> inline static Matrix<size_t>
+centre_seed (const Matrix<T>& M) {
+	size_t n[3];
+	volumes (M, n);
+	Matrix<size_t> seed (3,1);
+	for (size_t i = 0; i < 3; i++)
+		seed[i] = (n[i] > 1) ? n[i]/2 - 1 : 0;
+	return seed;
+}
+
+
 template <class T> Matrix<T>
-unwrap3d (const Matrix<T>& M, const size_t nub = DEFAULT_NB) {
+unwrap3d (const Matrix<std::complex<T> >& M, const size_t nub = DEFAULT_NB) {
+	return unwrap3d (M, centre_seed(M), nub);
+}
 
-    Matrix<size_t> seed (3,1);
-    for (size_t i = 0; i < 3; i++)
-        seed[i] = floor (.5 * (float)size(M,i)) -1;
-    return unwrap3d (complex2(ones<T>(size(M)),M), seed, nub);
 
+template<class T> Matrix<T>
+unwrap3d (const Matrix<T>& M, const Matrix<size_t>& seed, const size_t nub = DEFAULT_NB) {
+	return unwrap3d (complex2(ones<T>(size(M)),M), seed, nub);
 }
 
 
 template <class T> Matrix<T>
-unwrap3d (const Matrix<std::complex<T> >& M, const Matrix<size_t>& seed, const size_t nub = DEFAULT_NB) {
-    
-    assert (is3d(M));
-    assert (seed[0] < size(M,0) && seed[1] < size(M,1) && seed[2] < size(M,2));
-
-    Matrix<T> ret (size(M));
-    m_bsx = M.Dszs()[0]; m_bsy = M.Dszs()[1]; m_bsz = M.Dszs()[2];
-    unwrap (seed, nub, M, ret);
-    
-    return ret;
-    
+unwrap3d (const Matrix<T>& M, const size_t nub = DEFAULT_NB) {
+	return unwrap3d (complex2(ones<T>(size(M)),M), centre_seed(M), nub);
 }
 
 
+/**
+ * @brief       Shift slab [z0,z1) by the magnitude weighted majority 2pi offset
+ *              between its face zb and the neighbouring face zn
+ */
+template <class T> inline static void
+join_slab (const std::complex<T>* in, T* out, const size_t& nxy, const size_t& zb,
+           const size_t& zn, const size_t& z0, const size_t& z1) {
+
+	std::map<long,double> votes;
+	for (size_t p = 0; p < nxy; ++p) {
+		const long w = (long) floor ((out[zn*nxy+p] - out[zb*nxy+p]) / TWOPI + .5);
+		votes[w] += std::min (std::abs(in[zn*nxy+p]), std::abs(in[zb*nxy+p]));
+	}
+	long w = 0; double best = -1.;
+	for (std::map<long,double>::const_iterator i = votes.begin(); i != votes.end(); ++i)
+		if (i->second > best) {
+			best = i->second;
+			w    = i->first;
+		}
+	if (w == 0)
+		return;
+
+	const T   sh = TWOPI * w;
+	const long n0 = z0*nxy, n1 = z1*nxy;
+#pragma omp parallel for schedule (static)
+	for (long p = n0; p < n1; ++p)
+		out[p] += sh;
+
+}
+
+
+/**
+ * @brief       Block-wise region growing for large volumes<br/>
+ *              Each volume is cut into slabs along z, which are unwrapped in
+ *              parallel from their strongest voxel. Slabs are then joined
+ *              from the central slab outwards by the magnitude weighted
+ *              majority of the 2pi offsets across their common faces.
+ *
+ * @param  M    Complex data
+ * @param  nbl  # of slabs (default 0: # of threads)
+ * @param  nub  # of quality bins
+ * @return      Unwrapped phase
+ */
 template <class T> Matrix<T>
-unwrap3d (const Matrix<std::complex<T> >& M, const size_t nub = DEFAULT_NB) {
+unwrap3d_blockwise (const Matrix<std::complex<T> >& M, size_t nbl = 0,
+                    const size_t nub = DEFAULT_NB) {
+
+	size_t n[3];
+	const size_t nv = volumes (M, n), nxy = n[0]*n[1], nvox = nxy*n[2];
+	if (nbl == 0)
+		nbl = omp_get_max_threads();
+	nbl = std::max ((size_t)1, std::min (nbl, n[2]));
+
+	Matrix<T> ret (size(M));
+	Vector<size_t> z (nbl+1);
+	for (size_t b = 0; b <= nbl; ++b)
+		z[b] = b * n[2] / nbl;
+
+	for (size_t v = 0; v < nv; ++v) {
+
+		const std::complex<T>* in  = M.Ptr() + v*nvox;
+		T*                     out = ret.Ptr() + v*nvox;
+
+#pragma omp parallel if (nbl > 1)
+		{
+			Unwrapper<T> u (nub);
+#pragma omp for schedule (dynamic)
+			for (long b = 0; b < (long)nbl; ++b) {
+				const size_t nb[3] = {n[0], n[1], z[b+1] - z[b]}, off = z[b]*nxy;
+				size_t sp = 0;
+				for (size_t p = 1; p < nb[2]*nxy; ++p) // strongest voxel
+					if (std::abs(in[off+p]) > std::abs(in[off+sp]))
+						sp = p;
+				const size_t s[3] = {sp % n[0], (sp / n[0]) % n[1], sp / nxy};
+				u.Unwrap (in + off, nb, s, out + off);
+			}
+		}
+
+		// Join slabs from the centre outwards
+		const size_t c = nbl / 2;
+		for (size_t b = c+1; b < nbl; ++b)
+			join_slab (in, out, nxy, z[b], z[b]-1, z[b], z[b+1]);
+		for (size_t b = c; b-- > 0;)
+			join_slab (in, out, nxy, z[b+1]-1, z[b+1], z[b], z[b+1]);
+
+	}
+
+	return ret;
 
-    Matrix<size_t> seed (3,1);
-    for (size_t i = 0; i < 3; i++)
-        seed[i] = floor (.5 * (float)size(M,i)) -1;
-    return unwrap3d (M, seed, nub);
-   
 }
+
+
+template <class T> Matrix<T>
+unwrap3d_blockwise (const Matrix<T>& M, size_t nbl = 0, const size_t nub = DEFAULT_NB) {
+	return unwrap3d_blockwise (complex2(ones<T>(size(M)),M), nbl, nub);
+}
+
+#endif // __UNWRAP_HPP__
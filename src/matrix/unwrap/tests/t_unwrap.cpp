@@ -1,8 +1,48 @@
 #include "Unwrap.hpp"
-#include "IOContext.hpp"
+#include "Access.hpp"
+
+/**
+ * @brief Max deviation of u from phi up to a constant 2pi multiple
+ */
+template<class T> static T deviation (const Matrix<T>& u, const Matrix<T>& phi) {
+    const T c = TWOPI * floor ((u[0] - phi[0]) / TWOPI + .5);
+    T d = 0.;
+    for (size_t i = 0; i < numel(u); ++i)
+        d = std::max (d, (T) std::abs(u[i] - phi[i] - c));
+    return d;
+}
+
+template<class T> int check () {
+
+    // Smooth phase over several wraps, three echoes
+    const size_t n = 32, ne = 3;
+    Matrix<T> phi (n, n, n, ne);
+    Matrix<std::complex<T> > m (n, n, n, ne);
+    for (size_t e = 0; e < ne; ++e)
+        for (size_t z = 0; z < n; ++z)
+            for (size_t y = 0; y < n; ++y)
+                for (size_t x = 0; x < n; ++x) {
+                    T rx = (T)x/n - .5, ry = (T)y/n - .5, rz = (T)z/n - .5;
+                    phi(x,y,z,e) = (e+1) * 12. * (rx*rx + .5*ry + rz*rz - rx*rz);
+                    m(x,y,z,e) = std::polar ((T)(1. - rx*rx), phi(x,y,z,e));
+                }
+
+    Matrix<T> u = unwrap3d (m), b = unwrap3d_blockwise (m, 4);
+
+    int ret = 0;
+    for (size_t e = 0; e < ne; ++e) {
+        Matrix<T> pe = Volume (phi, e), ue = Volume (u, e), be = Volume (b, e);
+        T du = deviation (ue, pe), db = deviation (be, pe);
+        printf ("  echo %zu: deviation %.2e (blockwise %.2e)\n", e, du, db);
+        ret += (du > 1.e-3 || db > 1.e-3) ? 1 : 0;
+    }
+
+    return ret;
+
+}
 
 int main (int args, char** argv) {
 
-    return 0;
-    
+    return check<float>() + check<double>();
+
 }
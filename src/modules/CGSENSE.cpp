@@ -101,6 +101,16 @@ CGSENSE::Init() {
 	printf ("  Cartesian 3rd dimension: %d \n", m_3rd_dim_cart);
 	// --------------------------------------
 
+	// NuFFT flavour and CG -----------------
+
+	Attribute ("batched", &m_batched);
+	printf ("  batched multi-coil NuFFT: %d \n", m_batched);
+	Attribute ("toeplitz", &m_toeplitz);
+	printf ("  Toeplitz normal operator: %d \n", m_toeplitz);
+	Attribute ("warm_start", &m_warm_start);
+	printf ("  CG warm start: %d \n", m_warm_start);
+	// --------------------------------------
+
 	// Noise --------------------------------
 
 	Attribute ("noise",   &m_noise);
@@ -144,6 +154,9 @@ CGSENSE::Prepare () {
     cgp["threads"]       = m_nthreads;
     cgp["m"]             = m_m;
     cgp["3rd_dim_cart"]  = m_3rd_dim_cart;
+    cgp["batched"]       = m_batched;
+    cgp["toeplitz"]      = m_toeplitz;
+    cgp["warm_start"]    = m_warm_start;
 
 	m_ncs = NCSENSE<cxfl>(cgp);
 
@@ -46,7 +46,8 @@ namespace RRStrategy {
 		CGSENSE () : m_cgeps(1.0e-7), m_fteps(1.0e-3), m_cgmaxit(10),
 					 m_ftmaxit(3), m_noise(0.0), m_lambda(1.0e-6), m_testcase(0),
 					 m_verbose(0), m_nthreads (0), m_m(1), m_nk(1),
-					 m_test_case(false), m_3rd_dim_cart(false) {}
+					 m_test_case(false), m_3rd_dim_cart(false), m_batched(false),
+					 m_toeplitz(false), m_warm_start(false) {}
 		
 		/**
 		 * @brief Default destructor
@@ -91,6 +92,9 @@ namespace RRStrategy {
         int             m_m;
 
         bool            m_3rd_dim_cart; /**< 3rd NUFFT direction is Cartesian (stack(spirals/stars)) */
+        bool            m_batched;   /**< Batched multi-coil NuFFT instead of NFFT per channel */
+        bool            m_toeplitz;  /**< Toeplitz embedded normal operator in CG */
+        bool            m_warm_start; /**< CG starts from previous solution */
 		
 		float          m_noise;     /**< Add noise?                                          */
 		float          m_lambda;    /**< Tikhonov factor                                     */
@@ -1,4 +1,5 @@
 #include "CPUSimulator.hpp"
+#include "cycle.h"
 #include "Algos.hpp"
 #include "Creators.hpp"
 #include "linalg/Lapack.hpp"
@@ -107,7 +108,7 @@ SimulateAcq (const Matrix<cxfl>&  b1, const Matrix<float>&  gr, const Matrix<flo
 
 	Matrix<cxfl>      sig (nt,nc,np); /*<! Signal repository  */
 	
-#pragma omp parallel
+#pragma omp parallel num_threads (np)
     {
 		
 		Matrix<float> n   ( 3,1);  // Rotation axis
@@ -118,7 +119,6 @@ SimulateAcq (const Matrix<cxfl>&  b1, const Matrix<float>&  gr, const Matrix<flo
 		Matrix<cxfl>  ls  (nc,1);  // Local sensitivity
 		float         lb0;
 		
-        omp_set_num_threads(np);
 		
 #pragma omp for schedule (guided) 
 		
@@ -191,7 +191,7 @@ SimulateExc  (const Matrix<cxfl>&   b1, const Matrix<float>&  gr, const Matrix<
 	
     ticks             tic  = getticks();
 
-#pragma omp parallel default(shared)
+#pragma omp parallel default(shared) num_threads (np)
 	{
 		
 		Matrix<float> n   ( 3,1);  // Rotation axis
@@ -200,7 +200,6 @@ SimulateExc  (const Matrix<cxfl>&   b1, const Matrix<float>&  gr, const Matrix<
 		Matrix<cxfl>  ls  (nc,1);  // Local sensitivity
 		float         lb0;
 		
-		omp_set_num_threads(np);
 	
 #pragma omp for schedule (guided) 
 	
@@ -275,12 +274,29 @@ CPUSimulator::CPUSimulator (SimulationBundle* sb) {
 CPUSimulator::~CPUSimulator () {}
 
 
+void
+CPUSimulator::Acquire (const Matrix<float>& b0, const Matrix<cxfl>& mt0, const Matrix<float>& ml0,
+                       const bool& v, Matrix<cxfl>& rf) {
+
+	SimulateAcq (*(m_sb->b1), *(m_sb->g), *(m_sb->r), b0, mt0, ml0, m_ic, m_sb->np, m_sb->dt, v,
+	             m_nc, m_nt, m_gdt, rf);
+
+}
+
+
+void
+CPUSimulator::Excite (const Matrix<cxfl>& rf, const Matrix<float>& b0, const Matrix<cxfl>& mt0,
+                      const Matrix<float>& ml0, const bool& v, Matrix<cxfl>& mxy, Matrix<float>& mz) {
+
+	SimulateExc (*(m_sb->b1), *(m_sb->g), rf, *(m_sb->r), b0, mt0, ml0, *(m_sb->jac), m_sb->np,
+	             m_sb->dt, v, m_nc, m_nt, m_gdt, mxy, mz);
+
+}
+
+
 void 
 CPUSimulator::Simulate () {
 
-	Matrix<cxfl>&   b1 = *(m_sb->b1);
-	Matrix<float>&   g = *(m_sb->g);
-	Matrix<float>&  rv = *(m_sb->r);
 	Matrix<float>&  b0 = *(m_sb->b0);
 	Matrix<cxfl>& tmxy = *(m_sb->tmxy);
 	Matrix<float>& tmz = *(m_sb->tmz);
@@ -288,18 +304,15 @@ CPUSimulator::Simulate () {
 	Matrix<cxfl>& smxy = *(m_sb->smxy);
 	Matrix<float>& smz = *(m_sb->smz);
 	Matrix<float>& roi = *(m_sb->roi);
-	Matrix<float>& jac = *(m_sb->jac);
 	Matrix<cxfl>&  mxy = *(m_sb->mxy);
 	Matrix<float>&  mz = *(m_sb->mz);
 
-	int             np = m_sb->np;
-	float           dt = m_sb->dt;
 	float           tl = m_sb->lambda;
 	vector<float>  res;	
 
 	bool           cb0 = m_sb->cb0;
 
-	SimulateAcq (b1, g, rv, (cb0) ? b0 : zeros<float> (m_nr,1), tmxy, tmz, m_ic, np, dt, false, m_nc, m_nt, m_gdt, rf);
+	Acquire ((cb0) ? b0 : zeros<float> (m_nr,1), tmxy, tmz, false, rf);
 
 	if (m_sb->mode) {                                   // Optimise
 
@@ -322,8 +335,8 @@ CPUSimulator::Simulate () {
 			printf ("  %03i: CG residuum: %.9f\n", iters, res.at(iters));
 			if (res.at(iters) <= m_sb->cgeps) break;    // Convergence?
 
-			SimulateExc (b1, g, p, rv, b0, smxy, roi,  jac, np, dt, true, m_nc, m_nt, m_gdt, mxy, mz); // E^H
-			SimulateAcq (b1, g,    rv, b0,  mxy,  mz, m_ic, np, dt, true, m_nc, m_nt, m_gdt,       q); // E
+			Excite  (p, b0, smxy, roi, true, mxy, mz); // E^H
+			Acquire (   b0,  mxy,  mz, true,       q); // E
 			q += tl * p; // L_2 penalty on solution
 
 			rtmp = (rn / p.dotc(q));
@@ -338,7 +351,7 @@ CPUSimulator::Simulate () {
 		}
 
 		rf = a; // Final pulses
-		SimulateExc (b1, g, rf, rv, b0, smxy, smz, jac, np, dt, false, m_nc, m_nt, m_gdt, mxy, mz); // Excitation 
+		Excite (rf, b0, smxy, smz, false, mxy, mz); // Excitation 
 		
 	}
 
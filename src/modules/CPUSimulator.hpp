@@ -60,6 +60,39 @@ namespace RRStrategy {
 	protected:
 		
 
+		/**
+		 * @brief       Acquisition: Received signal of magnetisation (mt0,ml0)
+		 *              along the trajectory (E)
+		 *
+		 * @param  b0   Off resonance map
+		 * @param  mt0  Transverse magnetisation
+		 * @param  ml0  Longitudinal magnetisation
+		 * @param  v    Verbose
+		 * @param  rf   Signal (nt x nc)
+		 */
+		virtual void
+		Acquire        (const Matrix<float>& b0, const Matrix<cxfl>& mt0,
+		                const Matrix<float>& ml0, const bool& v, Matrix<cxfl>& rf);
+
+
+		/**
+		 * @brief       Excitation: Magnetisation after transmitting rf from
+		 *              (mt0,ml0) (E^H)
+		 *
+		 * @param  rf   Pulses (nt x nc)
+		 * @param  b0   Off resonance map
+		 * @param  mt0  Starting transverse magnetisation
+		 * @param  ml0  Starting longitudinal magnetisation
+		 * @param  v    Verbose
+		 * @param  mxy  Excited transverse magnetisation
+		 * @param  mz   Excited longitudinal magnetisation
+		 */
+		virtual void
+		Excite         (const Matrix<cxfl>& rf, const Matrix<float>& b0,
+		                const Matrix<cxfl>& mt0, const Matrix<float>& ml0,
+		                const bool& v, Matrix<cxfl>& mxy, Matrix<float>& mz);
+
+
 		float          m_gdt; /*<! \gamma*dt          */
 		float          m_rfsc; /*<! RF scale */
 		size_t         m_nt;  /*<! # timepoints       */
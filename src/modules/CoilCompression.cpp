@@ -22,9 +22,293 @@
 #include "Algos.hpp"
 #include "Lapack.hpp"
 #include "Print.hpp"
+#include "FFTN.hpp"
+#include "OMP.hpp"
 
 using namespace RRStrategy;
 static const char ECON = 'S';
+static const size_t CHUNK = 65536; /**< Samples per compression chunk */
+static const size_t BLOCK = 1024;  /**< Samples per covariance block */
+static const size_t GROUP = 8;     /**< Readout positions per geometric task */
+
+
+/**
+ * @brief       Gather samples [q0,q0+n) of all coils into blk (n x nc)<br/>
+ *              Sample q = i + inner*o of element (i,c,o) at i + inner*(c + nc*o)
+ */
+inline static void
+Gather (const cxfl* x, const size_t& inner, const size_t& nc, const size_t& q0,
+        const size_t& n, cxfl* blk) {
+	size_t i = q0 % inner, o = q0 / inner, r = 0;
+	while (r < n) {
+		const size_t run = std::min (n - r, inner - i);
+		for (size_t c = 0; c < nc; ++c) {
+			const cxfl* src = x + i + inner*(c + nc*o);
+			std::copy (src, src + run, blk + r + n*c);
+		}
+		r += run; i = 0; ++o;
+	}
+}
+
+
+/**
+ * @brief       Coil covariance X^H X over all samples
+ */
+static Matrix<cxfl>
+Covariance (const cxfl* x, const size_t& inner, const size_t& nc, const size_t& outer) {
+
+	const size_t nq = inner*outer, nb = (nq + BLOCK - 1) / BLOCK;
+	Vector<cxdb> acc (nc*nc);
+
+#pragma omp parallel
+	{
+		Vector<cxdb> lacc (nc*nc);
+		Matrix<cxfl> blk (BLOCK, nc);
+#pragma omp for schedule (static)
+		for (long b = 0; b < (long)nb; ++b) {
+			const size_t q0 = b*BLOCK, n = std::min (BLOCK, nq - q0);
+			if (n < BLOCK)
+				blk = Matrix<cxfl> (n, nc);
+			Gather (x, inner, nc, q0, n, blk.Ptr());
+			Matrix<cxfl> c = gemm (blk, blk, 'C', 'N');
+			for (size_t j = 0; j < nc*nc; ++j)
+				lacc[j] += c[j];
+		}
+#pragma omp critical
+		for (size_t j = 0; j < nc*nc; ++j)
+			acc[j] += lacc[j];
+	}
+
+	Matrix<cxfl> C (nc, nc);
+	for (size_t j = 0; j < nc*nc; ++j)
+		C[j] = cxfl (acc[j]);
+	return C;
+
+}
+
+
+/**
+ * @brief       Coil covariances per readout position x (inner = nx*m)
+ */
+static Vector<Matrix<cxfl> >
+Covariances (const cxfl* x, const size_t& nx, const size_t& inner, const size_t& nc,
+             const size_t& outer) {
+
+	const size_t m = inner / nx, nq = m*outer, ng = (nx + GROUP - 1) / GROUP;
+	Vector<Matrix<cxfl> > C (nx);
+
+#pragma omp parallel
+	{
+		Vector<Matrix<cxfl> > blk (GROUP);
+		Vector<Vector<cxdb> > acc (GROUP);
+#pragma omp for schedule (dynamic)
+		for (long g = 0; g < (long)ng; ++g) {
+			const size_t x0 = g*GROUP, gx = std::min (GROUP, nx - x0);
+			for (size_t p = 0; p < gx; ++p) {
+				blk[p] = Matrix<cxfl> (BLOCK, nc);
+				acc[p] = Vector<cxdb> (nc*nc);
+			}
+			for (size_t q0 = 0; q0 < nq; q0 += BLOCK) {
+				const size_t n = std::min (BLOCK, nq - q0);
+				if (n < BLOCK)
+					for (size_t p = 0; p < gx; ++p)
+						blk[p] = Matrix<cxfl> (n, nc);
+				// Contiguous runs of gx positions
+				for (size_t r = 0; r < n; ++r) {
+					const size_t u = (q0 + r) % m, o = (q0 + r) / m;
+					for (size_t c = 0; c < nc; ++c) {
+						const cxfl* src = x + x0 + nx*(u + m*(c + nc*o));
+						for (size_t p = 0; p < gx; ++p)
+							blk[p][r + n*c] = src[p];
+					}
+				}
+				for (size_t p = 0; p < gx; ++p) {
+					Matrix<cxfl> c = gemm (blk[p], blk[p], 'C', 'N');
+					for (size_t j = 0; j < nc*nc; ++j)
+						acc[p][j] += c[j];
+				}
+			}
+			for (size_t p = 0; p < gx; ++p) {
+				C[x0+p] = Matrix<cxfl> (nc, nc);
+				for (size_t j = 0; j < nc*nc; ++j)
+					C[x0+p][j] = cxfl (acc[p][j]);
+			}
+		}
+	}
+
+	return C;
+
+}
+
+
+/**
+ * @brief       Dominant k eigenvectors of covariance (nc x k)
+ *
+ * @param  C    Covariance
+ * @param  k    # of virtual coils
+ * @param  e    Retained fraction of energy
+ */
+static Matrix<cxfl>
+Principal (const Matrix<cxfl>& C, const size_t& k, float& e) {
+	const size_t nc = C.Dim(0);
+	eig_t<cxfl> ev = eigs (C); // ascending
+	Matrix<cxfl> V (nc, k);
+	double all = 0., kept = 0.;
+	for (size_t j = 0; j < nc; ++j) {
+		all += std::max (0.f, ev.ev[j].real());
+		if (j >= nc - k)
+			kept += std::max (0.f, ev.ev[j].real());
+	}
+	for (size_t j = 0; j < k; ++j)
+		std::copy (ev.lv.Ptr() + (nc-1-j)*nc, ev.lv.Ptr() + (nc-j)*nc, V.Ptr() + j*nc);
+	e = (all > 0.) ? kept/all : 1.f;
+	return V;
+}
+
+
+/**
+ * @brief       Mix coils of samples [i0,i0+n) of slab into y (n x k)<br/>
+ *              W[(c + nc*j)*npos + p] is the weight of coil c for virtual
+ *              coil j at readout position p (npos = 1 or nx, n multiple of npos)
+ */
+inline static void
+Mix (const cxfl* slab, const size_t& inner, const size_t& i0, const size_t& n,
+     const size_t& nc, const size_t& k, const cxfl* W, const size_t& npos, cxfl* y) {
+	for (size_t j = 0; j < k; ++j) {
+		cxfl* yj = y + n*j;
+		std::fill (yj, yj + n, cxfl(0.f));
+		for (size_t c = 0; c < nc; ++c) {
+			const cxfl* xc = slab + inner*c + i0;
+			const cxfl* w  = W + (c + nc*j)*npos;
+			if (npos == 1) {
+				const cxfl wc = w[0];
+				for (size_t r = 0; r < n; ++r)
+					yj[r] += xc[r] * wc;
+			} else {
+				for (size_t r = 0; r < n; r += npos)
+					for (size_t p = 0; p < npos; ++p)
+						yj[r+p] += xc[r+p] * w[p];
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief       Compress (i,c,o) to (i,j,o) in place<br/>
+ *              Output of sample (i,o) only overwrites input of slabs up to o
+ *              at the same i. Large slabs are processed in chunks of i, each
+ *              chunk running through all slabs in order. Small slabs are
+ *              processed in groups, each group completed before it is written.
+ */
+static void
+Compress (cxfl* x, const size_t& inner, const size_t& nc, const size_t& outer,
+          const Vector<cxfl>& W, const size_t& npos, const size_t& k) {
+
+	if (inner >= CHUNK) {
+
+		const size_t ic = std::max (npos, (CHUNK / npos) * npos), ni = (inner + ic - 1) / ic;
+#pragma omp parallel
+		{
+			Vector<cxfl> y (ic*k);
+#pragma omp for schedule (dynamic)
+			for (long b = 0; b < (long)ni; ++b) {
+				const size_t i0 = b*ic, n = std::min (ic, inner - i0);
+				for (size_t o = 0; o < outer; ++o) {
+					Mix (x + inner*nc*o, inner, i0, n, nc, k, &W[0], npos, &y[0]);
+					for (size_t j = 0; j < k; ++j)
+						std::copy (&y[n*j], &y[n*j] + n, x + i0 + inner*(j + k*o));
+				}
+			}
+		}
+
+	} else {
+
+		const size_t G = CHUNK / inner;
+		Vector<cxfl> y (G*inner*k);
+		for (size_t o0 = 0; o0 < outer; o0 += G) {
+			const size_t g = std::min (G, outer - o0);
+#pragma omp parallel for schedule (static)
+			for (long o = 0; o < (long)g; ++o)
+				Mix (x + inner*nc*(o0+o), inner, 0, inner, nc, k, &W[0], npos, &y[inner*k*o]);
+			std::copy (&y[0], &y[0] + g*inner*k, x + inner*k*o0);
+		}
+
+	}
+
+}
+
+
+void CoilCompression::Covariance (Matrix<cxfl>& meas, const bool& geom,
+                                  const Matrix<cxfl>& C) const {
+
+	typedef TUPLE<Matrix<cxfl>,Matrix<float>,Matrix<cxfl> > svd_t;
+
+	Vector<size_t> dims = size(meas);
+	const size_t nc = dims[_coil_dimension], k = _coils_left, nx = dims[0];
+	size_t inner = 1, outer = 1;
+	for (size_t d = 0; d < _coil_dimension; ++d)
+		inner *= dims[d];
+	for (size_t d = _coil_dimension+1; d < dims.size(); ++d)
+		outer *= dims[d];
+	std::cout << "  Incoming: " << dims << std::endl;
+	std::cout << "  #Coils: " << nc << std::endl;
+
+	assert (!geom || _coil_dimension > 0);
+
+	const size_t npos = geom ? nx : 1;
+	Vector<cxfl> W (nc*k*npos);
+	float e;
+
+	if (geom) {
+
+		// Hybrid space along readout
+		codeare::matrix::fftn (meas.Ptr(), dims, Vector<size_t>(1,0), false, false);
+
+		std::cout << "  Accumulating " << nx << " covariances ..." << std::endl;
+		Vector<Matrix<cxfl> > C = Covariances (meas.Ptr(), nx, inner, nc, outer);
+		Vector<Matrix<cxfl> > V (nx);
+		float emin = 1.f;
+		for (size_t p = 0; p < nx; ++p) {
+			V[p] = Principal (C[p], k, e);
+			emin = std::min (emin, e);
+			if (p > 0) { // Align to neighbour: V_p U W^H with U S W^H = svd(V_p^H V_p-1)
+				svd_t usw = svd2 (gemm (V[p], V[p-1], 'C', 'N'), ECON);
+				V[p] = gemm (V[p], gemm (GET<0>(usw), GET<2>(usw), 'N', 'C'));
+			}
+			for (size_t j = 0; j < k; ++j)
+				for (size_t c = 0; c < nc; ++c)
+					W[(c + nc*j)*nx + p] = V[p](c,j);
+		}
+		std::cout << "  Retained energy: >= " << 100.f*emin << "%" << std::endl;
+
+	} else {
+
+		Matrix<cxfl> V;
+		if (C.Size() == nc*nc) {
+			std::cout << "  Covariance from streamed lines" << std::endl;
+			V = Principal (C, k, e);
+		} else {
+			std::cout << "  Accumulating covariance ..." << std::endl;
+			V = Principal (::Covariance (meas.Ptr(), inner, nc, outer), k, e);
+		}
+		std::copy (V.Begin(), V.End(), W.begin());
+		std::cout << "  Retained energy: " << 100.f*e << "%" << std::endl;
+
+	}
+
+	std::cout << "  Recombining virtual coils ..." << std::endl;
+	Compress (meas.Ptr(), inner, nc, outer, W, npos, k);
+	dims[_coil_dimension] = k;
+	meas.Reshape (dims);
+
+	if (geom) // Back to k-space
+		codeare::matrix::fftn (meas.Ptr(), dims, Vector<size_t>(1,0), false, true, 1.f/nx);
+
+	std::cout << "  Outgoing: " << size(meas) << std::endl;
+
+}
+
 
 codeare::error_code CoilCompression::Init () {
 
@@ -35,6 +319,17 @@ codeare::error_code CoilCompression::Init () {
 	try {
         _coils_left = GetAttr<size_t>("coils_remaining");
 	} catch (const TinyXMLQueryException&) {}
+	if (_coils_left == 0) {
+		printf ("  Need at least one remaining coil.\n");
+		return codeare::UNSUPPORTED_DIMENSION;
+	}
+
+	if (Attribute ("method"))
+		_method = std::string (Attribute ("method"));
+	if (_method != "svd" && _method != "covariance" && _method != "geometric") {
+		printf ("  Unknown compression method %s, using svd.\n", _method.c_str());
+		_method = "svd";
+	}
         
 	return codeare::OK;
 }
@@ -51,6 +346,18 @@ codeare::error_code CoilCompression::Process () {
 	Matrix<float> S;
 	meas = squeeze(meas);
 
+	if (_coil_dimension >= ndims(meas) || _coils_left > size(meas,_coil_dimension)) {
+		printf ("  Cannot compress %zu coils along dimension %zu to %zu.\n",
+				(_coil_dimension < ndims(meas)) ? size(meas,_coil_dimension) : 0,
+				_coil_dimension, _coils_left);
+		return codeare::UNSUPPORTED_DIMENSION;
+	}
+
+	if (_method != "svd") {
+		Covariance (meas, _method == "geometric", Streamed (meas));
+		return codeare::OK;
+	}
+
 	// Permute coils to outermost dimension
 	Vector<size_t> dims = size(meas), order(dims.size());
 	std::iota(order.begin(), order.end(), 0);
@@ -69,9 +376,9 @@ codeare::error_code CoilCompression::Process () {
 	svd_t usv = svd2 (meas, ECON); V = GET<2>(usv);
 	std::cout << "  Recombining virtual coils ..." << std::endl;
 
-	// Recombine compressed data
-	V = V(CR(),CR(0,_coils_left-1));
-	meas = meas->*V;
+	// Recombine compressed data: svd2 returns V^H, dominant right singular vectors are its first rows
+	V = V(CR(0,_coils_left-1),CR());
+	meas = gemm (meas, V, 'N', 'C');
 
 	// Resize data
 	dims.back() = _coils_left;
@@ -81,6 +388,70 @@ codeare::error_code CoilCompression::Process () {
 	return codeare::OK;
 }
 
+codeare::error_code CoilCompression::ProcessChunk (const std::string& stream, const size_t& first,
+                                                   const std::vector<AcqLine>& lines) {
+
+	if (stream != "meas" || _method != "covariance" || Exists<cxfl> (stream) != codeare::OK)
+		return codeare::OK;
+
+	const Vector<size_t>& dims = global->Stream(stream)->dims;
+	const Matrix<cxfl>& meas = Get<cxfl> (stream);
+	const size_t ns = dims[0], nc = dims[1];
+
+	if (first == 0) { // New stream
+		_cov      = Vector<cxdb> (nc*nc);
+		_slots.assign (numel(meas) / (ns*nc), false);
+		_streamed = 0;
+		_once     = true;
+	}
+
+	// Lines are (ns x nc) column-major at their slots
+#pragma omp parallel
+	{
+		Vector<cxdb> lacc (nc*nc);
+		Matrix<cxfl> blk (ns, nc);
+#pragma omp for schedule (static)
+		for (long l = 0; l < (long)lines.size(); ++l) {
+			const cxfl* x = meas.Ptr() + lines[l].slot;
+			std::copy (x, x + ns*nc, blk.Begin());
+			Matrix<cxfl> c = gemm (blk, blk, 'C', 'N');
+			for (size_t j = 0; j < nc*nc; ++j)
+				lacc[j] += c[j];
+		}
+#pragma omp critical
+		for (size_t j = 0; j < nc*nc; ++j)
+			_cov[j] += lacc[j];
+	}
+
+	for (size_t l = 0; l < lines.size(); ++l) {
+		const size_t s = lines[l].slot / (ns*nc);
+		_once    &= !_slots[s];
+		_slots[s] = true;
+	}
+	_streamed += lines.size();
+
+	return codeare::OK;
+
+}
+
+
+Matrix<cxfl> CoilCompression::Streamed (const Matrix<cxfl>& meas) const {
+
+	const AcqStream* as = global->Stream ("meas");
+	if (_method != "covariance" || _coil_dimension != 1 || !as || !as->done || as->ring ||
+		!_once || _streamed == 0 || _streamed != as->lines || as->emitted != as->lines ||
+		size(meas,0) != as->dims[0] || size(meas,1) != as->dims[1] ||
+		_cov.size() != as->dims[1] * as->dims[1])
+		return Matrix<cxfl>();
+
+	const size_t nc = as->dims[1];
+	Matrix<cxfl> C (nc, nc);
+	for (size_t j = 0; j < nc*nc; ++j)
+		C[j] = cxfl (_cov[j]);
+	return C;
+
+}
+
 // the class factories
 extern "C" DLLEXPORT ReconStrategy* create  ()                  {
     return new CoilCompression;
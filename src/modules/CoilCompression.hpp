@@ -39,7 +39,7 @@ namespace RRStrategy {
 		/**
 		 * @brief Default constructor
 		 */
-		CoilCompression () : _coil_dimension(1), _coils_left(10) {}
+		CoilCompression () : _coil_dimension(1), _coils_left(10), _method("svd"), _streamed(0), _once(true) {}
 		
 		/**
 		 * @brief Default destructor
@@ -62,6 +62,14 @@ namespace RRStrategy {
 		 */
 		virtual codeare::error_code	Process ();
 		
+		/**
+		 * @brief Accumulate the coil covariance of streamed "meas" lines, so
+		 *        that covariance compression needs no second pass over the
+		 *        data once the stream is complete
+		 */
+		virtual codeare::error_code	ProcessChunk (const std::string& stream, const size_t& first,
+		                                          const std::vector<AcqLine>& lines);
+		
 		/**
 		 * @brief Do nothing 
 		 */
@@ -70,8 +78,35 @@ namespace RRStrategy {
 		}
 		
 	private:
+
+		/**
+		 * @brief Compress from coil covariance in place<br/>
+		 *        Covariance is accumulated in one parallel pass over the data
+		 *        without permutation, the virtual coils are the dominant
+		 *        eigenvectors. Geometric compression computes one compression
+		 *        per readout position (first dimension, hybrid space) aligned
+		 *        to its neighbour.
+		 *
+		 * @param  meas  Measurement data, compressed on return
+		 * @param  geom  Geometric (per readout position) compression
+		 * @param  C     Coil covariance of meas if known (empty: accumulate)
+		 */
+		void Covariance (Matrix<cxfl>& meas, const bool& geom,
+		                 const Matrix<cxfl>& C = Matrix<cxfl>()) const;
+
+		/**
+		 * @brief Streamed covariance if it covers every line of "meas" once
+		 */
+		Matrix<cxfl> Streamed (const Matrix<cxfl>& meas) const;
+
 		size_t _coil_dimension;
 		size_t _coils_left;
+		std::string _method; /**< @brief svd, covariance or geometric */
+
+		Vector<cxdb>      _cov;      /**< @brief Coil covariance of streamed lines */
+		std::vector<bool> _slots;    /**< @brief Line slots accumulated */
+		size_t            _streamed; /**< @brief Lines accumulated */
+		bool              _once;     /**< @brief No slot accumulated twice */
 
 	};
 
@@ -129,6 +129,22 @@ codeare::error_code CompressedSensing::Init () {
     ft_params["cgconv"] = RHSAttribute<float>("cgconv");
     ft_params["lsiter"] = RHSAttribute<int>("lsiter");
     ft_params["ft"] = RHSAttribute<int>("ft");
+    if (Attribute("linesearch"))  // NLCG: 0 backtrack, 1 batch, 2 interpolate
+        ft_params["linesearch"] = RHSAttribute<int>("linesearch");
+    if (Attribute("mu"))        // Proximal solvers (nlopt 2-4)
+        ft_params["mu"] = RHSAttribute<float>("mu");
+    if (Attribute("xiter"))
+        ft_params["xiter"] = RHSAttribute<int>("xiter");
+    if (Attribute("sbinner"))
+        ft_params["sbinner"] = RHSAttribute<int>("sbinner");
+    if (Attribute("proxiter"))
+        ft_params["proxiter"] = RHSAttribute<int>("proxiter");
+    if (Attribute("relax"))
+        ft_params["relax"] = RHSAttribute<float>("relax");
+    if (Attribute("adaptive"))
+        ft_params["adaptive"] = RHSAttribute<bool>("adaptive");
+    if (Attribute("lipschitz"))
+        ft_params["lipschitz"] = RHSAttribute<float>("lipschitz");
     csx = new CS_XSENSE<cxfl>(ft_params);
 	std::cout << *csx << std::endl;
 
@@ -29,9 +29,8 @@ DirectMethod::Init () {
     printf ("\nIntialising DirectMethod ...\n");
     
     m_verbose     = false;                  // verbose?
-    m_np          = omp_get_num_threads();  // # procs
+    m_np          = ExecutionContext::Instance().Threads(); // # procs
     m_dt          = 1e-6;                   // seconds 
-	m_np          = 8;
 
     Attribute ("dt",      &m_dt);
     printf ("  delta t: %.6f \n", m_dt);
@@ -57,6 +56,9 @@ DirectMethod::Init () {
     Attribute ("mode", &m_mode);
     printf ("  mode: %s \n", (m_mode) ? "true": "false");
 
+    Attribute ("simd", &m_simd);
+    printf ("  simd: %s \n", (m_simd) ? "true": "false");
+
     m_initialised = true;
 
     printf ("... done.\n");
@@ -119,6 +121,7 @@ DirectMethod::Process     () {
 	sb.cgit   = m_cgiter;
 	sb.lambda = m_lambda;
 	sb.cb0    = m_cb0;
+	sb.simd   = m_simd;
 
     // Outgoing
 
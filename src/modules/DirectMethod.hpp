@@ -23,6 +23,7 @@
 
 #include "ReconStrategy.hpp"
 #include "SimulationContext.hpp"
+#include "ExecutionContext.hpp"
 
 /**
  * @brief Reconstruction startegies
@@ -45,7 +46,8 @@ namespace RRStrategy {
             m_np (1),
             m_verbose (true),
             m_dt (1.0),
-            m_mode (0)
+            m_mode (0),
+            m_simd (true)
         {};
         
 
@@ -89,6 +91,7 @@ namespace RRStrategy {
 		double             m_cgeps;
 		int                m_cgiter;
 		bool               m_cb0;  
+		bool               m_simd;     /*!< @brief SIMD simulator (default) or scalar reference */
 		double             m_lambda;
 
     };
@@ -31,6 +31,19 @@ DummyRecon::Process     () {
 
 }
 
+codeare::error_code
+DummyRecon::ProcessChunk (const std::string& stream, const size_t& first,
+                          const std::vector<AcqLine>& lines) {
+
+    std::cout << "  " << stream << ": lines [" << first << "," << first+lines.size() << ")";
+    if (!lines.empty())
+        std::cout << " at offsets [" << lines.front().slot << " .. " << lines.back().slot << "]";
+    std::cout << std::endl;
+
+	return codeare::OK;
+
+}
+
 // the class factories
 extern "C" DLLEXPORT ReconStrategy* create  ()                  {
     return new DummyRecon;
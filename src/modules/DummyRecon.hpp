@@ -54,6 +54,13 @@ namespace RRStrategy {
 		virtual codeare::error_code
 		Process ();
 		
+		/**
+		 * @brief Report streamed chunk
+		 */
+		virtual codeare::error_code
+		ProcessChunk (const std::string& stream, const size_t& first,
+		              const std::vector<AcqLine>& lines);
+		
 		/**
 		 * @brief Do nothing 
 		 */
@@ -87,25 +87,8 @@ codeare::error_code EstimateSensitivitiesRadialVIBE::Process () {
 	std::cout << "  Incoming: " << size(meas) << std::endl;
 	size_t nk = size(meas,0), nv = size(meas,1), nz = size(meas,2), nc = size(meas,3);
 
-	// Permute for slice FFT [2 0 1 3] & FFT
-	Vector<size_t> perm(4);
-	perm[0]=2; perm[1]=0; perm[2]=1; perm[3]=3;
-	meas = permute(meas,perm);
-	std::cout << "  Permuted for slice FFT: " << size(meas) << std::endl;
-
-	// Slice FFT
-	std::cout << "  Performing slice FFT ..." << std::endl;
-	meas = ifft(meas,0,true);
-
-	// Removing top and bottom slices
-    meas = meas(CR(_margin_top,nz-1-_margin_bottom),CR(),CR(),CR()); nz = size(meas,0);
-    _image_space_dims[2] = nz; 
-	std::cout << "  Slice direction reduced: " << size(meas) << std::endl;
-
-	// Permute for global coil nufft [1 2 0 3]
-	perm[0]=1; perm[1]=2; perm[2]=0; perm[3]=3;
-	meas = permute(meas, perm);
-	std::cout << "  Permuted for channel NuFFTs: " << size(meas) << std::endl;
+	// Slice FFT is done by the NuFFT (3rd_dim_cart), unitary instead of 1/nz
+	meas *= 1.0f/sqrt((float)nz);
 	meas = resize(meas,nv*nk,nz,nc);
 	std::cout << "  Collapsed samples and views dimensions: " << size(meas) << std::endl;
 
@@ -115,22 +98,28 @@ codeare::error_code EstimateSensitivitiesRadialVIBE::Process () {
 
 	// FT operator
 	std::cout << "  Building NuFFT operator(s) ..." << std::endl;
-	Vector<size_t> sens_dims = _image_space_dims;
+	Vector<size_t> ft_dims = _image_space_dims, sens_dims;
+	ft_dims[2] = nz;
+	_image_space_dims[2] = nz - _margin_top - _margin_bottom;
+	sens_dims = _image_space_dims;
 	sens_dims.push_back(nc);
 	sensitivities = Matrix<cxfl>(sens_dims);
 	Matrix<float> density_comp = zeros<float>(nk,1);
 	Params p;
-	p["nk"] = nv*nk; p["imsz"] = _image_space_dims; p["3rd_dim_cart"] = true;
+	p["nk"] = nv*nk; p["imsz"] = ft_dims; p["3rd_dim_cart"] = true;
 	p["m"] = (size_t)1; p["alpha"] = 1.0f; p["epsilon"]=7.e-4f; p["maxit"]=(size_t)1;
 	NFFT<cxfl> ft(p);
     ft.KSpace(kspace);
     ft.Weights(weights);
 	std::cout << ft << std::endl;
     
-	// Channel NuFFTs
+	// Channel NuFFTs, top and bottom slices removed
 	std::cout << "  NuFFTing ..." << std::endl;
-    for (size_t i = 0; i < nc; ++i) 
-        sensitivities (R(),R(),R(),R(i)) = ft ->* meas(CR(),CR(),CR(i));
+    for (size_t i = 0; i < nc; ++i) {
+        Matrix<cxfl> img = ft ->* meas(CR(),CR(),CR(i));
+        sensitivities (R(),R(),R(),R(i)) = img(CR(),CR(),CR(_margin_top,nz-1-_margin_bottom));
+    }
+	std::cout << "  Slice direction reduced: " << size(sensitivities) << std::endl;
 
     sos = sum(abs(sensitivities),3)+1.e-9;
     
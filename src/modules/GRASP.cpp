@@ -116,6 +116,9 @@ codeare::error_code GRASP::Init () {
 	try {
 		ft_params["ft"] = GetAttr<int>("ft");
 	} catch (const TinyXMLQueryException&) {}
+	try {
+		ft_params["batched"] = GetAttr<bool>("batched");
+	} catch (const TinyXMLQueryException&) {}
 	try {
 		_tf = GetAttr<size_t>("frame_duration");
 	} catch (const TinyXMLQueryException&) {}
@@ -20,6 +20,7 @@
 
 #include "KTPoints.hpp"
 #include "PTXINIFile.hpp"
+#include "CGLS.hpp"
 
 #ifdef _MSC_VER
 std::string ofstr = "    %04Iu %.6f";
@@ -89,60 +90,6 @@ inline static void PhaseCorrection (Matrix<cxfl>& target, const Matrix<cxfl>& re
 }
 
 
-/**
- * @brief           STA integral
- *
- * @param  ks       k
- * @param  r        r
- * @param  b1       b1 map
- * @param  b0       b0 map
- * @param  nc       # of transmit channels
- * @param  nk       # of kspace positions
- * @param  ns       # of spatial positions
- * @param  gd       Gradient duration
- * @param  pd       Pulse durations
- *
- * @return          STA matrix
- */
-inline static Matrix<cxfl>
-STA (const Matrix<float>& ks, const Matrix<float>& r, const Matrix<cxfl>& b1, const Matrix<float>& b0, 
-     const size_t nc, const size_t nk, const size_t ns, const size_t gd, const Matrix<float>& pd, const size_t n) {
-
-    Vector<float> d (nk);
-	Matrix<cxfl>  m (ns,nc*nk);
-
-    printf ("  Computing STA encoding matrix ..."); 
-    fflush (stdout);
-    
-    for (size_t i = 0; i< nk; i++)
-        d[i] = (i==0) ? pd[i] + gd : d[i-1] + pd[i] + gd;
-
-    std::reverse (d.begin(), d.end());
-
-    for (size_t i = 0; i < nk-1; i++)
-        d[i] = 1.0e-5 * d[i+1] + 1.0e-5 * pd[i]/2;
-
-    d[nk-1] = 1.0e-5 * pd[nk-1] / 2;
-
-    cxfl pgd (0.f, 10.f*TWOPI*GAMMA);
-
-#pragma omp parallel for default (shared)
-    for (int k = 0; k < (int)nk; k++) {
-        float tpdk = TWOPI * d[k];
-        for (size_t s = 0; s < ns; s++) {
-            cxfl eikr = pgd * std::polar (1.f, ks(0,k)*r(0,s) + ks(1,k)*r(1,s) + ks(2,k)*r(2,s) + tpdk * b0(s));
-            for (size_t c = 0; c < nc; c++)
-                m(s,c*nk+k) =  b1(s,c) * eikr;
-        }
-    }
-    
-	printf ("  ... done.\n");
-
-	return m;
-
-}
-
-
 /**
  * @brief Construct actual pulses
  *
@@ -233,21 +180,45 @@ static inline void PTXTiming (const Matrix<cxfl>& solution, const Matrix<float>&
 
 
 
-static inline void KTPSolve (const Matrix<cxfl>& m, Matrix<cxfl>& target, Matrix<cxfl>& final,
-     Matrix<cxfl>& solution, const double& lambda, const size_t& mxit,  const float& conv,
-	 const bool& breakearly, size_t& gc, Matrix<float>& res) {
+/**
+ * @brief           Variable exchange method
+ *
+ * @param  E        STA encoding
+ * @param  mf       Matrix free: Warm started CGLS on E instead of dense regularised inverse
+ * @param  cgiter   CGLS iterations (matrix free)
+ * @param  cgeps    CGLS convergence (matrix free)
+ */
+static inline void KTPSolve (const STA& E, const bool& mf, const size_t& cgiter, const float& cgeps,
+     Matrix<cxfl>& target, Matrix<cxfl>& final, Matrix<cxfl>& solution, const double& lambda,
+     const size_t& mxit,  const float& conv, const bool& breakearly, size_t& gc, Matrix<float>& res) {
+
+    Matrix<cxfl> m, minv;
+    codeare::optimisation::CGLS<cxfl> cg (cgiter, cgeps, lambda);
+    cg.WarmStart (true);
 
-    Matrix<cxfl> minv;
+    if (!mf) {
 
-    // Regularised inverse (E^H*E)^-1*E^H
-    minv  = pinv(m.mult(m) + lambda*eye<cxfl>(size(m,1))).mul(m, 'N', 'C');
+        printf ("  Computing STA encoding matrix ..."); 
+        fflush (stdout);
+        m = E.Dense();
+        printf ("  ... done.\n");
+
+        // Regularised inverse (E^H*E)^-1*E^H
+        minv  = pinv(m.mult(m) + lambda*eye<cxfl>(size(m,1))).mul(m, 'N', 'C');
+
+    }
     
     size_t j = 0;
 
     // Variable exchange method --------------
     while (gc < mxit) {
-        solution = gemm(minv,target);
-        final    = gemm(m,solution);
+        if (mf) {
+            solution = cg.Solve (E, target);
+            final    = E * solution;
+        } else {
+            solution = gemm(minv,target);
+            final    = gemm(m,solution);
+        }
         
         res[gc]  = NRMSE (target, final);
         PhaseCorrection  (target, final);
@@ -319,7 +290,8 @@ inline static bool CheckAmps (const Matrix<cxfl>& solution, Matrix<float>& pd, c
 
 
 KTPoints::KTPoints  () : m_verbose(false), m_rflim(1.0), m_conv(1.0e-6), m_lambda(1.0e-6),
-        m_breakearly(true), m_gd(10), m_max_rf(0), m_maxiter(1000), ns(0), nk(0), nc(0) {}
+        m_breakearly(true), m_gd(10), m_max_rf(0), m_maxiter(1000), ns(0), nk(0), nc(0),
+        m_matrixfree(0), m_cgiter(20), m_cgeps(1.0e-6) {}
 
 
 KTPoints::~KTPoints () {}
@@ -374,6 +346,15 @@ codeare::error_code KTPoints::Init () {
     Attribute ("breakearly", &m_breakearly);
     printf ("  break early: %i \n", m_breakearly);
 
+    // Matrix free STA for large ROIs --------
+    Attribute ("matrixfree", &m_matrixfree);
+    printf ("  matrix free: %i \n", m_matrixfree);
+    if (m_matrixfree) {
+        Attribute ("cgiter", &m_cgiter);
+        Attribute ("cgeps",  &m_cgeps);
+        printf ("  CGLS iterations: %i, convergence: %.2e \n", m_cgiter, m_cgeps);
+    }
+
     // ----------------------------------------
     
     printf ("... done.\n\n");
@@ -430,8 +411,6 @@ codeare::error_code KTPoints::Process () {
     Matrix<cxfl>&   rf    = AddMatrix<cxfl> ("rf"); 
     Matrix<float>&  grad  = AddMatrix<float> ("grad");
 
-    Matrix<cxfl> m;// (ns, nk*nc); // STA system encoding matrix
-
     bool        amps_ok = false;
     size_t      gc    = 0;      // Global counter for VE iterations
 
@@ -440,11 +419,12 @@ codeare::error_code KTPoints::Process () {
 
     while (!amps_ok) {
         
-		// Compute SEM
-        m = STA (k, r, b1, b0, nc, nk, ns, m_gd, pd, gc);
+		// STA system encoding
+        STA E (k, r, b1, b0, m_gd, pd);
 
 		// Solve KTPoints
-        KTPSolve (m, target, final, solution, m_lambda, m_maxiter, m_conv, (m_breakearly>0), gc, res);
+        KTPSolve (E, (m_matrixfree>0), m_cgiter, m_cgeps, target, final, solution, m_lambda,
+                  m_maxiter, m_conv, (m_breakearly>0), gc, res);
 		if (is_nan(res(gc)))
 			break;
     
@@ -28,6 +28,7 @@
 #include "Algos.hpp"
 #include "Creators.hpp"
 #include "Lapack.hpp"
+#include "STA.hpp"
 
 /**
  * @brief Reconstruction startegies
@@ -52,6 +53,9 @@ namespace RRStrategy {
         int           m_maxiter;  /**< @brief # Variable exchange method iterations */
         int           m_verbose;  /**< @brief Verbose output. All intermediate results. */
         int           m_breakearly;  /**< @brief Break search with first diverging step */
+        int           m_matrixfree;  /**< @brief Apply STA matrix free with CGLS instead of dense inverse */
+        int           m_cgiter;   /**< @brief CGLS iterations (matrix free)  */
+        double        m_cgeps;    /**< @brief CGLS convergence (matrix free) */
 
         double        m_lambda;   /**< @brief Tikhonov parameter      */
         double        m_rflim;    /**< @brief Maximum rf amplitude    */
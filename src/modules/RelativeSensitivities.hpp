@@ -198,15 +198,16 @@ FTVolumes (Matrix<cxfl>& r) {
 	
 	// # threads plans and matrices ------
 
+	typedef FTTraits<cxfl>::T FTT;
 	std::vector<Matrix<cxfl> >mr(threads);
-	std::vector<fftwf_plan>	  p(threads); // Thread safety of plans
+	int n[3] = {(int)r.Dim(2), (int)r.Dim(1), (int)r.Dim(0)};
 	
-	for (int i = 0; i < threads; i++) {
+	for (int i = 0; i < threads; i++)
 		mr[i] = Matrix<cxfl>      (r.Dim(0), r.Dim(1), r.Dim(2));
-		p [i] = fftwf_plan_dft_3d (r.Dim(2), r.Dim(1), r.Dim(0), 
-								   (fftwf_complex*)&mr[i][0], (fftwf_complex*)&mr[i][0], 
-								   FFTW_BACKWARD, FFTW_MEASURE);
-	}
+
+	// One cached plan, executed on each thread's buffer (new-array execute)
+	FTTraits<cxfl>::Plan p = FTPlanCache<cxfl>::Instance().Get (3, n, 1, FFTW_BACKWARD,
+			(FTT*)mr[0].Ptr(), (FTT*)mr[0].Ptr(), 1);
 
 	// ------------------------------------
 	
@@ -223,7 +224,7 @@ FTVolumes (Matrix<cxfl>& r) {
 
 			mr[tid]  = fftshift(mr[tid]);
 			mr[tid] *= hann;
-			fftwf_execute(p[tid]);
+			FTTraits<cxfl>::Execute (p, (FTT*)mr[tid].Ptr(), (FTT*)mr[tid].Ptr());
 			mr[tid]  = fftshift(mr[tid]);
 
 			memcpy (&r[i*imsize], &mr[tid][0], imsize * sizeof(cxfl));
@@ -232,9 +233,6 @@ FTVolumes (Matrix<cxfl>& r) {
 		
 	}
 	
-	for (int i = 0; i < threads; i++)
-		fftwf_destroy_plan(p[i]);
-	
 //	printf ("done. (%.4f s)\n", elapsed(getticks(), tic) / Toolbox::Instance()->ClockRate());
 	
 	return codeare::OK;
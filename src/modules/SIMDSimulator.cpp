@@ -0,0 +1,253 @@
+#include "SIMDSimulator.hpp"
+#include "OMP.hpp"
+#include "arithmetic/Trigonometry.hpp"
+
+#include <vector>
+
+using namespace RRStrategy;
+using codeare::matrix::arithmetic::fast_sincos;
+
+
+/**
+ * @brief       Rotate magnetisation m around n (Cayley-Klein parameters)
+ *
+ * @see         CPUSimulator.cpp: Rotate
+ */
+inline static void
+Rotate (const float& nx, const float& ny, const float& nz, float& mx, float& my, float& mz) {
+
+	const float phi = std::sqrt (nx*nx + ny*ny + nz*nz);
+	float sh, ch;
+	fast_sincos (.5f * phi, sh, ch);
+	const float sp  = (phi > 0.f) ? sh / ((phi > 0.f) ? phi : 1.f) : .5f;
+
+	const float ar  =  ch;
+	const float ai  = -nz * sp;
+	const float br  =  ny * sp;
+	const float bi  = -nx * sp;
+
+	const float arar  = ar*ar,     aiai  = ai*ai;
+	const float brbr  = br*br,     bibi  = bi*bi;
+	const float arai2 = ar*ai*2.f, brbi2 = br*bi*2.f;
+	const float arbi2 = ar*bi*2.f, aibr2 = ai*br*2.f;
+	const float arbr2 = ar*br*2.f, aibi2 = ai*bi*2.f;
+	const float h1    = arar - aiai;
+	const float h2    = bibi - brbr;
+
+	const float x = mx, y = my, z = mz;
+	mx = (h1 + h2)       * x + (arai2 - brbi2) * y + (arbr2 + aibi2)               * z;
+	my = (-arai2 - brbi2) * x + (h1 - h2)      * y + (arbi2 - aibr2)               * z;
+	mz = (-arbr2 + aibi2) * x + (-aibr2 - arbi2) * y + (arar + aiai - brbr - bibi) * z;
+
+}
+
+
+SIMDSimulator::SIMDSimulator (SimulationBundle* sb) : CPUSimulator (sb) {
+
+	m_g = *(m_sb->g) * m_gdt;
+
+}
+
+
+SIMDSimulator::~SIMDSimulator () {}
+
+
+void
+SIMDSimulator::Acquire (const Matrix<float>& b0, const Matrix<cxfl>& mt0, const Matrix<float>& ml0,
+                        const bool& v, Matrix<cxfl>& rf) {
+
+	const size_t       L   = lanes;
+	const size_t       nr  = m_nr, nt = m_nt, nc = m_nc, nb = (nr + L - 1) / L;
+	const int          np  = std::max (1, m_sb->np);
+	const float        nrs = (float) nr, gdt = m_gdt;
+	const Matrix<cxfl>&  b1 = *(m_sb->b1);
+	const Matrix<float>& r  = *(m_sb->r);
+	const float*       g   = m_g.Ptr();
+
+	double             tic = omp_get_wtime();
+
+	Matrix<float>      sig (2*nc*nt, np); /*<! Thread local signal (re,im) x nc x nt */
+
+#pragma omp parallel num_threads (np)
+	{
+
+		float* ls = &sig[omp_get_thread_num() * 2*nc*nt];
+
+		float mx[L], my[L], ax[L], ay[L], rx[L], ry[L], rz[L], ob[L];
+		std::vector<float> cr (nc*L), ci (nc*L); // Conjugate sensitivities
+
+#pragma omp for schedule (guided)
+		for (long b = 0; b < (long)nb; ++b) {
+
+			bool any = false;
+			for (size_t l = 0; l < L; ++l) {
+				const size_t pos = b*L + l;
+				const bool   on  = (pos < nr) &&
+					((mt0[pos].real() + mt0[pos].imag() + ml0[pos]) * m_ic[pos] > 0.f);
+				mx[l] = on ? mt0[pos].real() * m_ic[pos] : 0.f;
+				my[l] = on ? mt0[pos].imag() * m_ic[pos] : 0.f;
+				rx[l] = on ? r[pos*3  ] : 0.f;
+				ry[l] = on ? r[pos*3+1] : 0.f;
+				rz[l] = on ? r[pos*3+2] : 0.f;
+				ob[l] = on ? gdt * b0[pos] * TWOPI : 0.f;
+				for (size_t c = 0; c < nc; ++c) {
+					cr[c*L+l] = on ?  b1(pos,c).real() : 0.f;
+					ci[c*L+l] = on ? -b1(pos,c).imag() : 0.f;
+				}
+				any = any || on;
+			}
+
+			if (!any)
+				continue;
+
+			// Run over time points
+			size_t t = nt;
+			while (t--) {
+
+				const float gx = g[3*t], gy = g[3*t+1], gz = g[3*t+2];
+
+				// Free precession: rotation around z only
+#pragma omp simd
+				for (size_t l = 0; l < L; ++l) {
+					float s, c;
+					fast_sincos (ob[l] - (gx*rx[l] + gy*ry[l] + gz*rz[l]), s, c);
+					const float nx = c*mx[l] - s*my[l];
+					const float ny = s*mx[l] + c*my[l];
+					ax[l] = .5f * (mx[l] + nx);
+					ay[l] = .5f * (my[l] + ny);
+					mx[l] = nx;
+					my[l] = ny;
+				}
+
+				// Weighted contribution to all coils
+				float* st = ls + 2*nc*t;
+				for (size_t c = 0; c < nc; ++c) {
+					const float* sr = &cr[c*L];
+					const float* si = &ci[c*L];
+					float re = 0.f, im = 0.f;
+#pragma omp simd reduction (+:re,im)
+					for (size_t l = 0; l < L; ++l) {
+						re += sr[l]*ax[l] - si[l]*ay[l];
+						im += sr[l]*ay[l] + si[l]*ax[l];
+					}
+					st[2*c  ] += re;
+					st[2*c+1] += im;
+				}
+
+			}
+
+		}
+
+#pragma omp for schedule (static)
+		for (long i = 0; i < (long)(nt*nc); ++i) {
+			const size_t t = i % nt, c = i / nt, k = 2*(t*nc + c);
+			float re = 0.f, im = 0.f;
+			for (int p = 0; p < np; ++p) {
+				re += sig[p*2*nc*nt + k];
+				im += sig[p*2*nc*nt + k + 1];
+			}
+			rf[i] = cxfl (re, im) / nrs;
+		}
+
+	}
+
+	if (v) printf ("(a: %.4fs)", omp_get_wtime() - tic); fflush(stdout);
+
+}
+
+
+void
+SIMDSimulator::Excite (const Matrix<cxfl>& rf, const Matrix<float>& b0, const Matrix<cxfl>& mt0,
+                       const Matrix<float>& ml0, const bool& v, Matrix<cxfl>& mxy, Matrix<float>& mz) {
+
+	const size_t       L   = lanes;
+	const size_t       nr  = m_nr, nt = m_nt, nc = m_nc, nb = (nr + L - 1) / L;
+	const int          np  = std::max (1, m_sb->np);
+	const float        gdt = m_gdt;
+	const Matrix<cxfl>&  b1  = *(m_sb->b1);
+	const Matrix<float>& r   = *(m_sb->r);
+	const Matrix<float>& jac = *(m_sb->jac);
+	const float*       g   = m_g.Ptr();
+
+	double             tic = omp_get_wtime();
+
+	// Scaled pulses (re,im) x nc x nt
+	std::vector<float> prf (2*nc*nt);
+	for (size_t t = 0; t < nt; ++t)
+		for (size_t c = 0; c < nc; ++c) {
+			const cxfl s = rf(t,c) * jac[t] * gdt * 1.0e-3f;
+			prf[2*(t*nc+c)  ] = s.real();
+			prf[2*(t*nc+c)+1] = s.imag();
+		}
+
+#pragma omp parallel num_threads (np)
+	{
+
+		float mx[L], my[L], mzl[L], ur[L], ui[L], rx[L], ry[L], rz[L], ob[L];
+		bool  on[L];
+		std::vector<float> cr (nc*L), ci (nc*L); // Sensitivities
+
+#pragma omp for schedule (guided)
+		for (long b = 0; b < (long)nb; ++b) {
+
+			// Start with equilibrium
+			bool any = false;
+			for (size_t l = 0; l < L; ++l) {
+				const size_t pos = b*L + l;
+				on[l]  = (pos < nr) && (mt0[pos].real() + mt0[pos].imag() + ml0[pos] > 0.f);
+				mx[l]  = on[l] ? mt0[pos].real() : 0.f;
+				my[l]  = on[l] ? mt0[pos].imag() : 0.f;
+				mzl[l] = on[l] ? ml0[pos] : 0.f;
+				rx[l]  = on[l] ? r[pos*3  ] : 0.f;
+				ry[l]  = on[l] ? r[pos*3+1] : 0.f;
+				rz[l]  = on[l] ? r[pos*3+2] : 0.f;
+				ob[l]  = on[l] ? gdt * b0[pos] * TWOPI : 0.f;
+				for (size_t c = 0; c < nc; ++c) {
+					cr[c*L+l] = on[l] ? b1(pos,c).real() : 0.f;
+					ci[c*L+l] = on[l] ? b1(pos,c).imag() : 0.f;
+				}
+				any = any || on[l];
+			}
+
+			if (!any)
+				continue;
+
+			// Time points
+			for (size_t t = 0; t < nt; ++t) {
+
+				const float* pt = &prf[2*nc*t];
+				const float  gx = g[3*t], gy = g[3*t+1], gz = g[3*t+2];
+
+				for (size_t l = 0; l < L; ++l)
+					ur[l] = ui[l] = 0.f;
+				for (size_t c = 0; c < nc; ++c) {
+					const float  pr = pt[2*c], pi = pt[2*c+1];
+					const float* sr = &cr[c*L];
+					const float* si = &ci[c*L];
+#pragma omp simd
+					for (size_t l = 0; l < L; ++l) {
+						ur[l] += pr*sr[l] - pi*si[l];
+						ui[l] += pr*si[l] + pi*sr[l];
+					}
+				}
+
+#pragma omp simd
+				for (size_t l = 0; l < L; ++l)
+					Rotate (-ui[l], ur[l], gx*rx[l] + gy*ry[l] + gz*rz[l] - ob[l],
+					        mx[l], my[l], mzl[l]);
+
+			}
+
+			for (size_t l = 0; l < L; ++l)
+				if (on[l]) {
+					mxy[b*L+l] = cxfl (mx[l], my[l]);
+					mz [b*L+l] = mzl[l];
+				}
+
+		}
+
+	}
+
+	if (v) printf ("(e: %.4fs)", omp_get_wtime() - tic); fflush(stdout);
+
+}
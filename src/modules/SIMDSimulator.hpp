@@ -0,0 +1,92 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __SIMD_SIMULATOR_HPP__
+#define __SIMD_SIMULATOR_HPP__
+
+#include "CPUSimulator.hpp"
+#include "SIMDTraits.hpp"
+
+namespace RRStrategy {
+
+	/**
+	 * @brief Time equidistant bloch simulator on blocks of spins<br/>
+	 *        Spatial positions are processed in groups of two SIMD registers
+	 *        (16 spins with AVX, 8 with SSE) kept in structure of arrays
+	 *        layout. Rotations use a vectorised sincos and stay in the lane
+	 *        block for the whole time loop, coil signals are accumulated in
+	 *        thread local buffers and reduced once. Same model and CG
+	 *        iteration as CPUSimulator.
+ 	 */
+	class SIMDSimulator : public CPUSimulator {
+
+
+	public:
+
+
+		/**
+		 * @brief       # of spins simulated together
+		 */
+		static const size_t lanes = 2 * VecTraits<float>::stride;
+
+
+		/**
+		 * @brief       Clean up and destroy
+		 */
+		virtual
+		~SIMDSimulator  ();
+
+
+		/**
+		 * @brief       Construct with bundle
+		 *
+		 * @param  sb   Sumulation bundle
+		 */
+		SIMDSimulator   (SimulationBundle* sb);
+
+
+	protected:
+
+
+		/**
+		 * @see         CPUSimulator::Acquire
+		 */
+		virtual void
+		Acquire        (const Matrix<float>& b0, const Matrix<cxfl>& mt0,
+		                const Matrix<float>& ml0, const bool& v, Matrix<cxfl>& rf);
+
+
+		/**
+		 * @see         CPUSimulator::Excite
+		 */
+		virtual void
+		Excite         (const Matrix<cxfl>& rf, const Matrix<float>& b0,
+		                const Matrix<cxfl>& mt0, const Matrix<float>& ml0,
+		                const bool& v, Matrix<cxfl>& mxy, Matrix<float>& mz);
+
+
+		Matrix<float>  m_g;   /*<! \gamma*dt scaled gradients (3 x nt) */
+
+
+	};
+
+}
+
+#endif // __SIMD_SIMULATOR_HPP__
@@ -0,0 +1,348 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef __STA_HPP__
+#define __STA_HPP__
+
+#include "Matrix.hpp"
+#include "Operator.hpp"
+#include "OMP.hpp"
+#include "arithmetic/Trigonometry.hpp"
+
+namespace RRStrategy {
+
+	/**
+	 * @brief Small tip angle encoding of kt-points pulses<br/>
+	 *        E(s,c*nk+k) = i 10 2pi gamma b1(s,c) exp(i (k_k r_s + 2pi d_k b0_s))<br/>
+	 *        Phases are evaluated on tiles of spatial positions with a
+	 *        vectorised sincos. Dense() assembles E tile by tile with
+	 *        contiguous column blocks. Forward, adjoint and normal operator
+	 *        apply E without storing it, for ROIs whose encoding matrix does
+	 *        not fit in memory.
+	 */
+	class STA : public Operator<cxfl> {
+
+	public:
+
+		/**
+		 * @brief       # of spatial positions per tile
+		 */
+		static const size_t tile = 256;
+
+
+		/**
+		 * @brief       Construct with k-space positions and maps<br/>
+		 *              r, b1 and b0 are referenced, not copied: they must
+		 *              outlive the operator and stay unchanged while it is used.
+		 *
+		 * @param  ks   k-space positions (3 x nk)
+		 * @param  r    Spatial positions (3 x ns)
+		 * @param  b1   Transmit sensitivities (ns x nc)
+		 * @param  b0   Off-resonance map in Hz (ns)
+		 * @param  gd   Gradient blip duration (10us)
+		 * @param  pd   Pulse durations (10us, nk)
+		 */
+		STA (const Matrix<float>& ks, const Matrix<float>& r, const Matrix<cxfl>& b1,
+		     const Matrix<float>& b0, const size_t& gd, const Matrix<float>& pd) :
+			m_r (r), m_b1 (b1), m_b0 (b0), m_ns (r.Dim(1)), m_nc (b1.Dim(1)),
+			m_nk (ks.Dim(1)), m_pgd (10.f*TWOPI*GAMMA) {
+
+			m_kx.resize(m_nk); m_ky.resize(m_nk); m_kz.resize(m_nk); m_tpd.resize(m_nk);
+			for (size_t k = 0; k < m_nk; ++k) {
+				m_kx[k] = ks(0,k);
+				m_ky[k] = ks(1,k);
+				m_kz[k] = ks(2,k);
+			}
+
+			// Time from centre of each sub-pulse to end of pulse
+			Vector<float> d (m_nk);
+			for (size_t i = 0; i < m_nk; i++)
+				d[i] = (i==0) ? pd[i] + gd : d[i-1] + pd[i] + gd;
+			std::reverse (d.begin(), d.end());
+			for (size_t i = 0; i < m_nk-1; i++)
+				d[i] = 1.0e-5 * d[i+1] + 1.0e-5 * pd[i]/2;
+			d[m_nk-1] = 1.0e-5 * pd[m_nk-1] / 2;
+			for (size_t k = 0; k < m_nk; ++k)
+				m_tpd[k] = TWOPI * d[k];
+
+		}
+
+
+		virtual ~STA () {}
+
+
+		/**
+		 * @brief       Dense encoding matrix (ns x nc*nk)
+		 */
+		inline Matrix<cxfl> Dense () const {
+
+			Matrix<cxfl> m (m_ns, m_nc*m_nk);
+			const long   nt = (long) ((m_ns + tile - 1) / tile);
+
+#pragma omp parallel if (nt > 1)
+			{
+				Vector<float> er (m_nk*tile), ei (m_nk*tile);
+#pragma omp for schedule (static)
+				for (long t = 0; t < nt; ++t) {
+					const size_t s0 = t*tile, n = std::min ((size_t) tile, m_ns - s0);
+					Phases (s0, n, &er[0], &ei[0]);
+					for (size_t c = 0; c < m_nc; ++c) {
+						const float* b = (const float*) &m_b1[c*m_ns + s0];
+						for (size_t k = 0; k < m_nk; ++k) {
+							const float* pr = &er[k*tile];
+							const float* pi = &ei[k*tile];
+							float*       col = (float*) &m[(c*m_nk + k)*m_ns + s0];
+#pragma omp simd
+							for (size_t i = 0; i < n; ++i) { // i pgd b1 e
+								col[2*i  ] = -m_pgd * (b[2*i]*pi[i] + b[2*i+1]*pr[i]);
+								col[2*i+1] =  m_pgd * (b[2*i]*pr[i] - b[2*i+1]*pi[i]);
+							}
+						}
+					}
+				}
+			}
+
+			return m;
+
+		}
+
+
+		/**
+		 * @brief       Excitation pattern E x
+		 *
+		 * @param  x    Pulse weights (nc*nk)
+		 * @return      Pattern (ns)
+		 */
+		virtual Matrix<cxfl> operator* (const MatrixType<cxfl>& x) const {
+
+			Vector<cxfl> xb;
+			const float* xp = Data (x, xb);
+			Matrix<cxfl> y (m_ns, 1);
+			const long   nt = (long) ((m_ns + tile - 1) / tile);
+
+#pragma omp parallel if (nt > 1)
+			{
+				Vector<float> er (m_nk*tile), ei (m_nk*tile), yr (tile), yi (tile);
+#pragma omp for schedule (static)
+				for (long t = 0; t < nt; ++t) {
+					const size_t s0 = t*tile, n = std::min ((size_t) tile, m_ns - s0);
+					Phases (s0, n, &er[0], &ei[0]);
+					Forward (s0, n, xp, &er[0], &ei[0], &yr[0], &yi[0]);
+					for (size_t i = 0; i < n; ++i)
+						y[s0+i] = cxfl (-m_pgd * yi[i], m_pgd * yr[i]);
+				}
+			}
+
+			return y;
+
+		}
+
+
+		/**
+		 * @brief       Adjoint E^H y
+		 *
+		 * @param  y    Pattern (ns)
+		 * @return      Pulse weights (nc*nk)
+		 */
+		virtual Matrix<cxfl> operator/ (const MatrixType<cxfl>& y) const {
+
+			Vector<cxfl> yb;
+			const float* yp = Data (y, yb);
+			Vector<double> acc (2*m_nc*m_nk);
+			const long   nt = (long) ((m_ns + tile - 1) / tile);
+
+#pragma omp parallel if (nt > 1)
+			{
+				Vector<float>  er (m_nk*tile), ei (m_nk*tile);
+				Vector<double> lacc (2*m_nc*m_nk);
+#pragma omp for schedule (static)
+				for (long t = 0; t < nt; ++t) {
+					const size_t s0 = t*tile, n = std::min ((size_t) tile, m_ns - s0);
+					Phases (s0, n, &er[0], &ei[0]);
+					Backward (s0, n, yp + 2*s0, &er[0], &ei[0], &lacc[0]);
+				}
+#pragma omp critical
+				for (size_t j = 0; j < acc.size(); ++j)
+					acc[j] += lacc[j];
+			}
+
+			return Weights (acc, cxfl (0.f, -m_pgd));
+
+		}
+
+
+		/**
+		 * @brief       E^H E x in one pass over the tiles
+		 */
+		virtual Matrix<cxfl> Normal (const MatrixType<cxfl>& x) const {
+
+			Vector<cxfl> xb;
+			const float* xp = Data (x, xb);
+			Vector<double> acc (2*m_nc*m_nk);
+			const long   nt = (long) ((m_ns + tile - 1) / tile);
+
+#pragma omp parallel if (nt > 1)
+			{
+				Vector<float>  er (m_nk*tile), ei (m_nk*tile), yr (tile), yi (tile), y (2*tile);
+				Vector<double> lacc (2*m_nc*m_nk);
+#pragma omp for schedule (static)
+				for (long t = 0; t < nt; ++t) {
+					const size_t s0 = t*tile, n = std::min ((size_t) tile, m_ns - s0);
+					Phases (s0, n, &er[0], &ei[0]);
+					Forward (s0, n, xp, &er[0], &ei[0], &yr[0], &yi[0]);
+					for (size_t i = 0; i < n; ++i) {
+						y[2*i  ] = yr[i];
+						y[2*i+1] = yi[i];
+					}
+					Backward (s0, n, &y[0], &er[0], &ei[0], &lacc[0]);
+				}
+#pragma omp critical
+				for (size_t j = 0; j < acc.size(); ++j)
+					acc[j] += lacc[j];
+			}
+
+			return Weights (acc, cxfl (m_pgd*m_pgd, 0.f)); // (-i pgd) (i pgd)
+
+		}
+
+
+		virtual std::ostream& Print (std::ostream& os) const {
+			Operator<cxfl>::Print(os);
+			os << "    sites(" << m_ns << ") channels(" << m_nc << ") kt-points(" << m_nk << ")";
+			return os;
+		}
+
+
+	private:
+
+		/**
+		 * @brief       Phases of tile [s0,s0+n) for all k: e_ki = er[k*tile+i] + i ei[k*tile+i]
+		 */
+		inline void Phases (const size_t& s0, const size_t& n, float* er, float* ei) const {
+			const float* r  = &m_r[3*s0];
+			const float* b0 = &m_b0[s0];
+			for (size_t k = 0; k < m_nk; ++k) {
+				const float kx = m_kx[k], ky = m_ky[k], kz = m_kz[k], tpd = m_tpd[k];
+				float* pr = er + k*tile;
+				float* pi = ei + k*tile;
+#pragma omp simd
+				for (size_t i = 0; i < n; ++i)
+					codeare::matrix::arithmetic::fast_sincos (
+						kx*r[3*i] + ky*r[3*i+1] + kz*r[3*i+2] + tpd*b0[i], pi[i], pr[i]);
+			}
+		}
+
+
+		/**
+		 * @brief       y_i = sum_k e_ki sum_c b1_ic x_ck on tile (without i pgd)
+		 */
+		inline void Forward (const size_t& s0, const size_t& n, const float* x,
+		                     const float* er, const float* ei, float* yr, float* yi) const {
+			float wr[tile], wi[tile];
+			for (size_t i = 0; i < n; ++i)
+				yr[i] = yi[i] = 0.f;
+			for (size_t k = 0; k < m_nk; ++k) {
+				for (size_t i = 0; i < n; ++i)
+					wr[i] = wi[i] = 0.f;
+				for (size_t c = 0; c < m_nc; ++c) {
+					const float  xr = x[2*(c*m_nk+k)], xi = x[2*(c*m_nk+k)+1];
+					const float* b  = (const float*) &m_b1[c*m_ns + s0];
+#pragma omp simd
+					for (size_t i = 0; i < n; ++i) {
+						wr[i] += b[2*i]*xr - b[2*i+1]*xi;
+						wi[i] += b[2*i]*xi + b[2*i+1]*xr;
+					}
+				}
+				const float* pr = er + k*tile;
+				const float* pi = ei + k*tile;
+#pragma omp simd
+				for (size_t i = 0; i < n; ++i) {
+					yr[i] += pr[i]*wr[i] - pi[i]*wi[i];
+					yi[i] += pr[i]*wi[i] + pi[i]*wr[i];
+				}
+			}
+		}
+
+
+		/**
+		 * @brief       acc_ck += sum_i conj(b1_ic e_ki) y_i on tile (without -i pgd)
+		 */
+		inline void Backward (const size_t& s0, const size_t& n, const float* y,
+		                      const float* er, const float* ei, double* acc) const {
+			float vr[tile], vi[tile];
+			for (size_t k = 0; k < m_nk; ++k) {
+				const float* pr = er + k*tile;
+				const float* pi = ei + k*tile;
+#pragma omp simd
+				for (size_t i = 0; i < n; ++i) {
+					vr[i] = pr[i]*y[2*i]   + pi[i]*y[2*i+1];
+					vi[i] = pr[i]*y[2*i+1] - pi[i]*y[2*i];
+				}
+				for (size_t c = 0; c < m_nc; ++c) {
+					const float* b = (const float*) &m_b1[c*m_ns + s0];
+					float sr = 0.f, si = 0.f;
+#pragma omp simd reduction (+:sr,si)
+					for (size_t i = 0; i < n; ++i) {
+						sr += b[2*i]*vr[i] + b[2*i+1]*vi[i];
+						si += b[2*i]*vi[i] - b[2*i+1]*vr[i];
+					}
+					acc[2*(c*m_nk+k)  ] += sr;
+					acc[2*(c*m_nk+k)+1] += si;
+				}
+			}
+		}
+
+
+		/**
+		 * @brief       f acc as pulse weights (nc*nk)
+		 */
+		inline Matrix<cxfl> Weights (const Vector<double>& acc, const cxfl& f) const {
+			Matrix<cxfl> x (m_nc*m_nk, 1);
+			for (size_t j = 0; j < x.Size(); ++j)
+				x[j] = f * cxfl ((float) acc[2*j], (float) acc[2*j+1]);
+			return x;
+		}
+
+
+		/**
+		 * @brief       Interleaved (re,im) storage of operand
+		 */
+		inline static const float* Data (const MatrixType<cxfl>& m, Vector<cxfl>& buf) {
+			if (const Matrix<cxfl>* p = dynamic_cast<const Matrix<cxfl>*>(&m))
+				return (const float*) p->Ptr();
+			buf.resize(m.Size());
+			for (size_t i = 0; i < buf.size(); ++i)
+				buf[i] = m[i];
+			return (const float*) &buf[0];
+		}
+
+
+		const Matrix<float>& m_r;   /**< @brief Spatial positions (3 x ns), referenced */
+		const Matrix<cxfl>&  m_b1;  /**< @brief Transmit sensitivities (ns x nc), referenced */
+		const Matrix<float>& m_b0;  /**< @brief Off-resonance (ns), referenced */
+		size_t         m_ns, m_nc, m_nk;
+		float          m_pgd;       /**< @brief 10 2pi gamma */
+		Vector<float>  m_kx, m_ky, m_kz, m_tpd;
+
+	};
+
+}
+
+#endif // __STA_HPP__
@@ -22,6 +22,7 @@
 #define __SIMULATION_CONTEXT_HPP__
 
 #include "CPUSimulator.hpp"
+#include "SIMDSimulator.hpp"
 
 #undef HAVE_OPENCL_HEADERS
 
@@ -47,9 +48,13 @@ namespace RRStrategy {
 #if defined HAVE_OPENCL_HEADERS
 			m_strategy    = (SimulationStrategy*) (HaveGPU()) ? 
 				(SimulationStrategy*) new GPUSimulator (sb): 
+				(sb->simd) ?
+				(SimulationStrategy*) new SIMDSimulator (sb):
 				(SimulationStrategy*) new CPUSimulator (sb);
 #else
-			m_strategy    = (SimulationStrategy*) new CPUSimulator (sb);
+			m_strategy    = (sb->simd) ?
+				(SimulationStrategy*) new SIMDSimulator (sb):
+				(SimulationStrategy*) new CPUSimulator (sb);
 #endif
 
 		}
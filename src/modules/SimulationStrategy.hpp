@@ -65,6 +65,7 @@ namespace RRStrategy {
 		
 		bool                    v;  /**<! verbose                          */
 		bool                  cb0;  /**<! correct b0?                      */
+		bool                 simd;  /**<! SIMD simulator (CPU)             */
 		
 		// Outgoing
 		boost::shared_ptr<Matrix<cxfl> >    rf;  /**<! RF pulses                         */
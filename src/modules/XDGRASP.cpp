@@ -83,6 +83,9 @@ codeare::error_code XDGRASP::Init () {
     ft_params["cgconv"] = RHSAttribute<float>("cgconv");
     ft_params["lsiter"] = RHSAttribute<int>("lsiter");
     ft_params["ft"] = RHSAttribute<int>("ft");
+    try {
+        ft_params["batched"] = GetAttr<bool>("batched");
+    } catch (const TinyXMLQueryException&) {}
 
 	try {
 		_ntres = GetAttr<size_t>("nt_resp");
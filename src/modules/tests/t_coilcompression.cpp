@@ -0,0 +1,166 @@
+/*
+ * t_coilcompression.cpp
+ *
+ *  Covariance against SVD coil compression and in-place recombination
+ */
+
+#include "CoilCompression.hpp"
+#include "Algos.hpp"
+#include "Creators.hpp"
+#include "Lapack.hpp"
+
+using namespace RRStrategy;
+
+const size_t nv = 3;
+
+/**
+ * @brief Samples (inner,nc,outer) as rows of (inner*outer x nc)
+ */
+inline static Matrix<cxfl> Rows (const Matrix<cxfl>& m, const size_t& inner, const size_t& nc) {
+	const size_t outer = numel(m) / (inner*nc);
+	Matrix<cxfl> x (inner*outer, nc);
+	for (size_t o = 0; o < outer; ++o)
+		for (size_t c = 0; c < nc; ++c)
+			for (size_t i = 0; i < inner; ++i)
+				x(i + inner*o, c) = m[i + inner*(c + nc*o)];
+	return x;
+}
+
+inline static codeare::error_code Compress (const Matrix<cxfl>& data, const size_t& cdim,
+                                            const size_t& k, const char* method, Matrix<cxfl>& y) {
+	CoilCompression cc;
+	cc.WSpace (&Workspace::Instance());
+	cc.SetAttribute ("coil_dimension", cdim);
+	cc.SetAttribute ("coils_remaining", k);
+	cc.SetAttribute ("method", method);
+	codeare::error_code e = cc.Init();
+	if (e != codeare::OK)
+		return e;
+	cc.AddMatrix<cxfl> ("meas") = data;
+	if ((e = cc.Process()) == codeare::OK)
+		y = cc.Get<cxfl> ("meas");
+	return e;
+}
+
+/**
+ * @brief max ||y - x (x^+ y)|| / ||y|| over columns, 0 if y lies in span(x)
+ */
+inline static float OffSpan (const Matrix<cxfl>& x, const Matrix<cxfl>& y) {
+	Matrix<cxfl> p = y - gemm (x, gemm (pinv (gemm (x, x, 'C')), gemm (x, y, 'C')));
+	return norm (p) / norm (y);
+}
+
+/**
+ * @brief Rank nv coil data with noise: (d0, ..., nc, ...) with nc at cdim
+ */
+inline static bool check (const Vector<size_t>& dims, const size_t& cdim) {
+
+	const size_t nc = dims[cdim];
+	size_t inner = 1;
+	for (size_t d = 0; d < cdim; ++d)
+		inner *= dims[d];
+	const size_t nq = numel(Matrix<cxfl>(dims)) / nc, outer = nq / inner;
+
+	Matrix<cxfl> s = randn<cxfl> (nq, nv), mix = randn<cxfl> (nv, nc);
+	Matrix<cxfl> x = gemm (s, mix) + 1.e-1f * randn<cxfl> (nq, nc), data (dims);
+	for (size_t o = 0; o < outer; ++o)
+		for (size_t c = 0; c < nc; ++c)
+			for (size_t i = 0; i < inner; ++i)
+				data[i + inner*(c + nc*o)] = x(i + inner*o, c);
+
+	// SVD puts coils last, samples keep their order
+	Matrix<cxfl> ys, yc;
+	if (Compress (data, cdim, nv, "svd", ys) != codeare::OK ||
+		Compress (data, cdim, nv, "covariance", yc) != codeare::OK ||
+		numel(ys) != nq*nv || numel(yc) != nq*nv)
+		return false;
+	ys = resize (ys, nq, nv);
+	yc = Rows (yc, inner, nv);
+
+	// Same subspace as SVD, and each virtual coil a mix of input coils only
+	float dsub = std::max (OffSpan (ys, yc), OffSpan (yc, ys));
+	float dmix = OffSpan (x, yc);
+	printf ("  %zu x %zu coils x %zu: subspace %.2e, out-of-place %.2e\n",
+			inner, nc, outer, dsub, dmix);
+
+	// Geometric: per readout position unitary, keeps the energy of rank nv data
+	Matrix<cxfl> yg;
+	float dgeo = 1.f;
+	if (cdim > 0 && Compress (data, cdim, nv, "geometric", yg) == codeare::OK && numel(yg) == nq*nv)
+		dgeo = 1.f - norm (yg) / norm (gemm (s, mix));
+	else if (cdim == 0)
+		dgeo = 0.f;
+	printf ("  %zu x %zu coils x %zu: geometric energy loss %.2e\n", inner, nc, outer, dgeo);
+
+	Matrix<cxfl> y;
+	return dsub < 1.e-3f && dmix < 1.e-3f && std::abs (dgeo) < 1.e-2f &&  // Too many and no virtual coils
+		Compress (data, cdim, nc+1, "covariance", y) != codeare::OK &&
+		Compress (data, cdim, 0, "svd", y) != codeare::OK;
+
+}
+
+/**
+ * @brief Covariance accumulated over streamed chunks against the batch pass.
+ *        Lines (ns x nc) arrive in reverse order, chunk lines at a time.
+ */
+inline static bool stream (const size_t& ns, const size_t& nc, const size_t& nl,
+                           const size_t& chunk) {
+
+	Vector<size_t> dims (3);
+	dims[0] = ns; dims[1] = nc; dims[2] = nl;
+	Matrix<cxfl> x = gemm (randn<cxfl> (ns*nl, nv), randn<cxfl> (nv, nc)) +
+		1.e-1f * randn<cxfl> (ns*nl, nc), data (dims);
+	for (size_t l = 0; l < nl; ++l)
+		for (size_t c = 0; c < nc; ++c)
+			for (size_t i = 0; i < ns; ++i)
+				data[i + ns*(c + nc*l)] = x(i + ns*l, c);
+
+	Matrix<cxfl> yb, ys;
+	if (Compress (data, 1, nv, "covariance", yb) != codeare::OK)
+		return false;
+
+	CoilCompression cc;
+	Workspace& ws = Workspace::Instance();
+	cc.WSpace (&ws);
+	cc.SetAttribute ("coil_dimension", 1);
+	cc.SetAttribute ("coils_remaining", nv);
+	cc.SetAttribute ("method", "covariance");
+	if (cc.Init() != codeare::OK)
+		return false;
+
+	size_t first;
+	std::vector<AcqLine> lines;
+	ws.OpenStream<cxfl> ("meas", dims, chunk);
+	for (size_t l = nl; l-- > 0; ) {
+		const uint16_t lc = (uint16_t) l;
+		ws.AppendLine ("meas", &lc, 1, data.Ptr() + ns*nc*l, ns);
+		while (ws.NextChunk ("meas", first, lines))
+			cc.ProcessChunk ("meas", first, lines);
+	}
+	ws.CloseStream ("meas");
+	while (ws.NextChunk ("meas", first, lines))
+		cc.ProcessChunk ("meas", first, lines);
+	if (cc.Process() != codeare::OK)
+		return false;
+	ys = cc.Get<cxfl> ("meas");
+	ws.EraseStream ("meas");
+
+	// Same virtual coils as the batch pass
+	yb = Rows (yb, ns, nv);
+	ys = Rows (ys, ns, nv);
+	float d = std::max (OffSpan (yb, ys), OffSpan (ys, yb));
+	printf ("  %zu x %zu coils x %zu lines in chunks of %zu: streamed %.2e\n", ns, nc, nl, chunk, d);
+
+	return d < 1.e-3f;
+
+}
+
+int main (int args, char** argv) {
+
+	Vector<size_t> small (3), large (4);
+	small[0] = 48;  small[1] = 8;   small[2] = 40;               // Grouped slabs
+	large[0] = 256; large[1] = 260; large[2] = 6; large[3] = 2;  // Chunked slabs
+
+	return (check (small, 1) && check (large, 2) && stream (64, 8, 45, 7)) ? 0 : 1;
+
+}
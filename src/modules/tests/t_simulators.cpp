@@ -0,0 +1,81 @@
+/*
+ * t_simulators.cpp
+ *
+ *  SIMD against scalar reference Bloch simulator on a small bundle
+ */
+
+#include "CPUSimulator.hpp"
+#include "SIMDSimulator.hpp"
+#include "Creators.hpp"
+
+using namespace RRStrategy;
+
+const size_t nr = 37, nc = 3, nt = 48; // nr not a multiple of the SIMD lanes
+
+/**
+ * @brief Expose E and E^H of a simulator
+ */
+template<class S> class Probe : public S {
+public:
+	Probe (SimulationBundle* sb) : S (sb) {}
+	void E (const Matrix<cxfl>& mt0, const Matrix<float>& ml0, Matrix<cxfl>& rf) {
+		this->Acquire (*(this->m_sb->b0), mt0, ml0, false, rf);
+	}
+	void EH (const Matrix<cxfl>& rf, Matrix<cxfl>& mxy, Matrix<float>& mz) {
+		this->Excite (rf, *(this->m_sb->b0), *(this->m_sb->smxy), *(this->m_sb->smz), false, mxy, mz);
+	}
+};
+
+template<class T> inline static float
+rdiff (const Matrix<T>& a, const Matrix<T>& b) {
+	float d = 0.f, n = 0.f;
+	for (size_t i = 0; i < a.Size(); ++i) {
+		d = std::max (d, (float)std::abs(a[i]-b[i]));
+		n = std::max (n, (float)std::abs(a[i]));
+	}
+	return d / n;
+}
+
+int main (int args, char** argv) {
+
+	SimulationBundle sb;
+
+	sb.b1   = boost::shared_ptr<Matrix<cxfl> > (new Matrix<cxfl> (randn<cxfl> (nr,nc)));
+	sb.g    = boost::shared_ptr<Matrix<float> > (new Matrix<float> (randn<float> (3,nt)));
+	sb.r    = boost::shared_ptr<Matrix<float> > (new Matrix<float> (randn<float> (3,nr)));
+	sb.b0   = boost::shared_ptr<Matrix<float> > (new Matrix<float> (randn<float> (nr,1)));
+	sb.tmxy = boost::shared_ptr<Matrix<cxfl> > (new Matrix<cxfl> (nr,1));
+	sb.tmz  = boost::shared_ptr<Matrix<float> > (new Matrix<float> (nr,1));
+	sb.smxy = boost::shared_ptr<Matrix<cxfl> > (new Matrix<cxfl> (nr,1));
+	sb.smz  = boost::shared_ptr<Matrix<float> > (new Matrix<float> (ones<float> (nr,1)));
+	sb.roi  = boost::shared_ptr<Matrix<float> > (new Matrix<float> (1,1));
+	sb.jac  = boost::shared_ptr<Matrix<float> > (new Matrix<float> (ones<float> (nt,1)));
+
+	*(sb.g)  *= 1.e+1f;
+	*(sb.r)  *= 1.e-1f;
+	*(sb.b0) *= 1.e+1f;
+	Matrix<cxfl>& tmxy = *(sb.tmxy);
+	for (size_t i = 0; i < nr; ++i)
+		tmxy[i] = (i%5) ? cxfl (std::sin(.3f*i), .5f) : cxfl (0.f); // Some spins off
+
+	sb.np = 2; sb.mode = 0; sb.dt = 1.e-5f; sb.cgeps = 1.e-6f; sb.lambda = 0.f; sb.cgit = 0;
+	sb.v  = false; sb.cb0 = true; sb.simd = true;
+
+	Probe<CPUSimulator>  cpu (&sb);
+	Probe<SIMDSimulator> simd (&sb);
+
+	Matrix<cxfl> rfc (nt,nc), rfs (nt,nc), rf = 1.e4f * randn<cxfl> (nt,nc);
+	Matrix<cxfl> mxyc (nr,1), mxys (nr,1);
+	Matrix<float> mzc (nr,1), mzs (nr,1);
+
+	cpu.E  (tmxy, *(sb.tmz), rfc);
+	simd.E (tmxy, *(sb.tmz), rfs);
+	cpu.EH  (rf, mxyc, mzc);
+	simd.EH (rf, mxys, mzs);
+
+	float da = rdiff (rfc, rfs), dm = std::max (rdiff (mxyc, mxys), rdiff (mzc, mzs));
+	printf ("  acquisition: %.2e excitation: %.2e\n", da, dm);
+
+	return (da < 1.e-4f && dm < 1.e-4f) ? 0 : 1;
+
+}
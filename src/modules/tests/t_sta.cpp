@@ -0,0 +1,48 @@
+/*
+ * t_sta.cpp
+ *
+ *  Tiled and matrix free STA encoding against its dense matrix
+ */
+
+#include "STA.hpp"
+#include "CGLS.hpp"
+#include "Creators.hpp"
+#include "linalg/Lapack.hpp"
+
+using namespace RRStrategy;
+
+const size_t ns = 600, nc = 4, nk = 5; // ns not a multiple of the tile
+
+inline static float rdiff (const Matrix<cxfl>& a, const Matrix<cxfl>& b) {
+	return norm (a-b) / norm (a);
+}
+
+int main (int args, char** argv) {
+
+	Matrix<float> ks = randn<float> (3,nk), r = randn<float> (3,ns), b0 = 10.f * randn<float> (ns,1);
+	Matrix<cxfl>  b1 = randn<cxfl> (ns,nc);
+	Matrix<float> pd = ones<float> (nk,1) * 20.f;
+
+	STA E (ks, r, b1, b0, 10, pd);
+	Matrix<cxfl> m = E.Dense(), x = randn<cxfl> (nc*nk,1), y = randn<cxfl> (ns,1);
+
+	Matrix<cxfl> Ex = E * x, EHy = E / y;
+	float dfw = rdiff (gemm (m, x), Ex);                // Dense E == E*
+	float dbw = rdiff (gemm (m, y, 'C'), EHy);          // Dense E^H == E/
+	float dno = rdiff (E / Ex, E.Normal (x));           // E^H E == Normal
+
+	cxfl  lhs = Ex.dotc (y), rhs = x.dotc (EHy);        // <Ex,y> == <x,E^H y>
+	float dad = std::abs (lhs - rhs) / std::abs (lhs);
+
+	// Matrix free CGLS against dense Tikhonov solution
+	const float lambda = 1.e-2f * real (m.dotc (m)) / (nc*nk);
+	codeare::optimisation::CGLS<cxfl> cg (50, 1.e-12f, lambda);
+	Matrix<cxfl> xd = gemm (pinv (gemm (m, m, 'C') + lambda * eye<cxfl> (nc*nk)), gemm (m, y, 'C'));
+	float dcg = rdiff (xd, cg.Solve (E, y));
+
+	printf ("  forward: %.2e adjoint: %.2e normal: %.2e <Ex,y>-<x,E^Hy>: %.2e cgls: %.2e\n",
+	        dfw, dbw, dno, dad, dcg);
+
+	return (dfw < 1.e-5f && dbw < 1.e-5f && dno < 1.e-5f && dad < 1.e-5f && dcg < 1.e-3f) ? 0 : 1;
+
+}
@@ -0,0 +1,10 @@
+#include "ADMM.hpp"
+
+namespace codeare {
+    namespace optimisation{
+
+template class ADMM<float>;
+template class ADMM<double>;
+template class ADMM<std::complex<float> >;
+template class ADMM<std::complex<double> >;
+    }}
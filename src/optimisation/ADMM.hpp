@@ -0,0 +1,133 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef _ADMM_HPP_
+#define _ADMM_HPP_
+
+#include <Proximal.hpp>
+
+#ifdef _MSC_VER
+static const char* admmfstr = "    %02Iu - primal: %1.4e, dual: %1.4e, mu: %1.2e, dxnrm: %0.4f\n";
+#else
+static const char* admmfstr = "    %02zu - primal: %1.4e, dual: %1.4e, mu: %1.2e, dxnrm: %0.4f\n";
+#endif
+
+namespace codeare {
+    namespace optimisation {
+
+        /**
+         * @brief Scaled form ADMM (Boyd et al. 2011) for
+         *        ||E x - b||^2 + sum_i w_i ||S_i x||_1 with constraints
+         *        S_i x = d_i<br/>
+         *        Over-relaxation (relax in [1,1.8]) and residual balancing of
+         *        the penalty mu (adaptive).
+         */
+        template<class T>
+        class ADMM : public Proximal<T> {
+
+            typedef typename Proximal<T>::RT RT;
+
+        public:
+            ADMM () : _relax(1.), _adaptive(false) {};
+            ADMM (const Params& p) : Proximal<T>::Proximal (p) {
+                _relax    = try_to_fetch<float> (p, "relax", 1.0f);
+                _adaptive = try_to_fetch<bool> (p, "adaptive", true);
+            };
+            virtual ~ADMM() {};
+
+            inline virtual void Minimise (Operator<T>* A, Matrix<T>& x) {
+
+                const size_t nt = A->Terms();
+                Matrix<T> b = A->AdjointData(), rhs, s, xo;
+                Vector<Matrix<T> > d (nt), u (nt), dd (nt);
+                for (size_t i = 0; i < nt; ++i) {
+                    d[i] = A->Sparse(i, x);
+                    u[i] = Matrix<T>(d[i].Dim());
+                }
+                b *= (RT)2.;
+                RT mu = this->_mu;
+
+                this->Start();
+                for (size_t k = 0; k < this->_nliter; ++k) {
+
+                    xo  = x;
+                    rhs = b;
+                    for (size_t i = 0; i < nt; ++i)
+                        rhs += mu * lazy(A->SparseAdjoint(i, d[i] - u[i]));
+                    this->XStep (A, rhs, x, mu);
+
+                    RT r = 0.;
+                    for (size_t i = 0; i < nt; ++i) {
+                        s     = A->Sparse(i, x);
+                        r    += real(Dot (s - d[i]));
+                        if (_relax != 1.)
+                            s = _relax * lazy(s) + (1. - _relax) * lazy(d[i]);
+                        dd[i] = d[i];
+                        d[i]  = shrink (s + u[i], A->TermWeight(i)/mu);
+                        u[i] += lazy(s) - lazy(d[i]);
+                        dd[i] = lazy(d[i]) - lazy(dd[i]);
+                    }
+                    r = sqrt(r);
+                    RT q = nt ? mu * norm(this->Dual(A, dd)) : 0.;
+
+                    if (_adaptive && r > 10. * q) {
+                        mu *= 2.;
+                        for (size_t i = 0; i < nt; ++i)
+                            u[i] *= (RT).5;
+                    } else if (_adaptive && q > 10. * r) {
+                        mu *= .5;
+                        for (size_t i = 0; i < nt; ++i)
+                            u[i] *= (RT)2.;
+                    }
+
+                    this->Record(x);
+                    RT dxn = this->Change (x, xo);
+                    if (this->_verbose) {
+                        printf (admmfstr, k, r, q, mu, dxn); fflush (stdout);
+                    }
+                    if (dxn < this->_conv)
+                        break;
+
+                }
+
+            }
+
+            virtual std::ostream& Print (std::ostream& os) const {
+                Proximal<T>::Print(os);
+                os << " relax(" << _relax << ") adaptive(" << (_adaptive ? "true" : "false")
+                   << ") CG(" << this->_xiter << ")";
+                return os;
+            }
+
+        private:
+
+            /**
+             * @brief ||v||^2
+             */
+            inline static T Dot (const Matrix<T>& v) { return v.dotc(v); }
+
+            RT _relax;
+            bool _adaptive;
+
+        };
+
+    }}
+
+#endif // _ADMM_HPP_
@@ -11,62 +11,223 @@
 #include <Linear.hpp>
 #include <Lapack.hpp>
 #include <CX.hpp>
+#include <OMP.hpp>
 
 namespace codeare {
 namespace optimisation {
 
+/**
+ * @brief Tikhonov regularised CGNR: (A^H A + lambda I) x = A^H b<br/>
+ *        Krylov vectors are allocated once per problem size and reused by
+ *        subsequent solves. Updates and their inner products run in fused
+ *        parallel passes. Optional warm start from the previous solution.
+ *        Per-iteration relative residuals and wall times are available after
+ *        each solve through Residuals() and Timings().
+ */
 template<class T> class CGLS : public Linear<T> {
 
   typedef typename TypeTraits<T>::RT RT;
+  typedef typename VecTraits<RT>::reg_type reg_type;
 
 public:
   CGLS (const size_t& maxit = 10, const RT& epsilon = 1.0e-6,
         const RT& lambda = 1.0e-6, const int& verbosity = 0) :
     Linear<T>::Linear(verbosity), _verbosity(verbosity), _nrows(1),
-    _ncols(1), _maxit(maxit), _epsilon(epsilon), _lambda(lambda) {}
-    
+    _ncols(1), _maxit(maxit), _epsilon(epsilon), _lambda(lambda),
+    _warm(false), _have_x(false) {}
+
   virtual ~CGLS () {}
 
-  inline virtual Matrix<T> Solve (const Operator<T>& A, const MatrixType<T>& x) {
-    _p = A/x;
+  /**
+   * @brief       Solve from previous solution if warm start is enabled and
+   *              sizes match, from zero otherwise
+   *
+   * @param  A    Operator (A/ adjoint, Normal)
+   * @param  b    Data
+   * @return      Solution
+   */
+  inline virtual Matrix<T> Solve (const Operator<T>& A, const MatrixType<T>& b) {
+    return Iterate (A, b, _warm && _have_x);
+  }
+
+  /**
+   * @brief       Solve from initial guess
+   *
+   * @param  A    Operator (A/ adjoint, Normal)
+   * @param  b    Data
+   * @param  x0   Initial guess
+   * @return      Solution
+   */
+  inline virtual Matrix<T> Solve (const Operator<T>& A, const MatrixType<T>& b,
+                                  const Matrix<T>& x0) {
+    _x = x0;
+    return Iterate (A, b, true);
+  }
+
+  /**
+   * @brief       Start subsequent solves from the last solution
+   */
+  inline void WarmStart (const bool& warm) { _warm = warm; }
+  inline bool WarmStart () const { return _warm; }
+
+  /**
+   * @brief       Relative residuals ||r_i||^2/||A^H b||^2 of last solve
+   */
+  inline const Vector<RT>& Residuals () const { return _res; }
+
+  /**
+   * @brief       Wall time of each iteration of last solve in seconds
+   */
+  inline const Vector<double>& Timings () const { return _time; }
+
+  /**
+   * @brief       Number of iterations of last solve
+   */
+  inline size_t Iterations () const { return _time.size(); }
+
+protected:
+
+  /**
+   * @brief       CGNR iterations on workspace
+   */
+  inline Matrix<T> Iterate (const Operator<T>& A, const MatrixType<T>& b, bool warm) {
+
+    _res.clear();
+    _time.clear();
+
+    _r = A/b;
     if (_maxit == 0)
-      return _p;
-    _r  = _p;
-    _rn = _xn = std::real(dotc(_r,_p));
-    Matrix<T> ret;
+      return _r;
+
+    const size_t n = _r.Size(), m = n * sizeof(T)/sizeof(RT);
+    _xn = Dot ((const RT*)_r.Ptr(), (const RT*)_r.Ptr(), m);
+
+    if (warm && _x.Size() == n) { // r = A^H b - (A^H A + l) x0
+      _q  = A.Normal(_x);
+      if (_lambda)
+        _q += _lambda * lazy(_x);
+      _r -= _q;
+    } else {
+      if (_x.Dim() != _r.Dim())
+        _x = Matrix<T>(_r.Dim());
+      _x = (T)0.;
+    }
+    _p  = _r;
+    _rn = Dot ((const RT*)_r.Ptr(), (const RT*)_r.Ptr(), m);
+
     for (size_t i = 0; i < _maxit; i++) {
       _res.push_back(_rn/_xn);
-      if (i==0)
-        ret = zeros<T>(size(_p));
-      if (boost::math::isnan(_res[i]) || _res[i] <= _epsilon) {
-        printf ("    %03zu %.7f\n", i, _res[i]);
+      if (boost::math::isnan(_res[i]) || _res[i] <= _epsilon)
         break;
-      }
-      if (_verbosity)
-        printf ("    %03zu %.7f\n", i, _res[i]);
-      _q  = A/(A*_p);
-      if (_lambda)
-        _q += _lambda * _p;
-      _ts  = _rn / std::real(dotc(_p,_q));
-      ret += _ts * _p;
-      _r  -= _ts * _q;
+      double t = omp_get_wtime();
+      _q   = A.Normal(_p);
+      _ts  = _rn / AxpyDot (_lambda, (const RT*)_p.Ptr(), (RT*)_q.Ptr(), m);
       _rno = _rn;
-      _rn  = std::real(dotc(_r,_r));
-      _p  *= _rn / _rno;
-      _p  += _r;
+      _rn  = Update (_ts, (const RT*)_p.Ptr(), (const RT*)_q.Ptr(), (RT*)_x.Ptr(),
+                     (RT*)_r.Ptr(), m);
+      _p   = lazy(_r) + (_rn / _rno) * lazy(_p);
+      _time.push_back(omp_get_wtime() - t);
     }
-    return ret;// * m_ic;
+
+    _have_x = true;
+    return _x;
+
   }
-  
-protected:
+
+  /**
+   * @brief       Real part of <a,b> over m real numbers
+   */
+  inline static RT Dot (const RT* a, const RT* b, const size_t& m) {
+    const long np = (long)(m/VecTraits<RT>::stride);
+    RT s = 0.;
+#pragma omp parallel reduction (+:s) if (m >= EXPR_PARALLEL_THRESHOLD)
+    {
+      reg_type acc = VecTraits<RT>::setp(0.);
+#pragma omp for schedule (static)
+      for (long i = 0; i < np; ++i)
+        acc = VecTraits<RT>::plus (acc, VecTraits<RT>::multiplies (
+          ((const reg_type*)a)[i], ((const reg_type*)b)[i]));
+      s += Sum (acc);
+    }
+    for (size_t i = np*VecTraits<RT>::stride; i < m; ++i)
+      s += a[i]*b[i];
+    return s;
+  }
+
+  /**
+   * @brief       q += l p, returns Re<p,q>
+   */
+  inline static RT AxpyDot (const RT& l, const RT* p, RT* q, const size_t& m) {
+    const long np = (long)(m/VecTraits<RT>::stride);
+    const reg_type vl = VecTraits<RT>::setp(l);
+    RT s = 0.;
+#pragma omp parallel reduction (+:s) if (m >= EXPR_PARALLEL_THRESHOLD)
+    {
+      reg_type acc = VecTraits<RT>::setp(0.);
+#pragma omp for schedule (static)
+      for (long i = 0; i < np; ++i) {
+        const reg_type vp = ((const reg_type*)p)[i];
+        reg_type vq = VecTraits<RT>::plus (((reg_type*)q)[i], VecTraits<RT>::multiplies (vl, vp));
+        ((reg_type*)q)[i] = vq;
+        acc = VecTraits<RT>::plus (acc, VecTraits<RT>::multiplies (vp, vq));
+      }
+      s += Sum (acc);
+    }
+    for (size_t i = np*VecTraits<RT>::stride; i < m; ++i) {
+      q[i] += l*p[i];
+      s += p[i]*q[i];
+    }
+    return s;
+  }
+
+  /**
+   * @brief       x += ts p, r -= ts q, returns ||r||^2
+   */
+  inline static RT Update (const RT& ts, const RT* p, const RT* q, RT* x, RT* r,
+                           const size_t& m) {
+    const long np = (long)(m/VecTraits<RT>::stride);
+    const reg_type vt = VecTraits<RT>::setp(ts);
+    RT s = 0.;
+#pragma omp parallel reduction (+:s) if (m >= EXPR_PARALLEL_THRESHOLD)
+    {
+      reg_type acc = VecTraits<RT>::setp(0.);
+#pragma omp for schedule (static)
+      for (long i = 0; i < np; ++i) {
+        ((reg_type*)x)[i] = VecTraits<RT>::plus (((reg_type*)x)[i],
+          VecTraits<RT>::multiplies (vt, ((const reg_type*)p)[i]));
+        reg_type vr = VecTraits<RT>::minus (((reg_type*)r)[i],
+          VecTraits<RT>::multiplies (vt, ((const reg_type*)q)[i]));
+        ((reg_type*)r)[i] = vr;
+        acc = VecTraits<RT>::plus (acc, VecTraits<RT>::multiplies (vr, vr));
+      }
+      s += Sum (acc);
+    }
+    for (size_t i = np*VecTraits<RT>::stride; i < m; ++i) {
+      x[i] += ts*p[i];
+      r[i] -= ts*q[i];
+      s += r[i]*r[i];
+    }
+    return s;
+  }
+
+  /**
+   * @brief       Horizontal sum of packed register
+   */
+  inline static RT Sum (const reg_type& v) {
+    RT b[VecTraits<RT>::stride];
+    VecTraits<RT>::storeu (b, v);
+    return std::accumulate (b, b + VecTraits<RT>::stride, (RT)0.);
+  }
+
   size_t _nrows, _ncols, _maxit;
   RT _epsilon, _rel_mat_err, _rel_rhs_err, _lambda, _ts;
   RT _rn, _xn, _rno;
-  Matrix<T> _p, _r, _q;
-  Vector<Matrix<cxfl> > vc;
-  Vector<RT> _res;
+  Matrix<T> _x, _p, _r, _q;     /**< Krylov workspace */
+  Vector<RT> _res;              /**< Relative residuals of last solve */
+  Vector<double> _time;         /**< Iteration times of last solve */
+  bool _warm, _have_x;
   int _verbosity;
-  
+
 };
 }}
 
@@ -0,0 +1,10 @@
+#include "FISTA.hpp"
+
+namespace codeare {
+    namespace optimisation{
+
+template class FISTA<float>;
+template class FISTA<double>;
+template class FISTA<std::complex<float> >;
+template class FISTA<std::complex<double> >;
+    }}
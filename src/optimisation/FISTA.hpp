@@ -0,0 +1,120 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef _FISTA_HPP_
+#define _FISTA_HPP_
+
+#include <Proximal.hpp>
+
+#ifdef _MSC_VER
+static const char* fistafstr = "    %02Iu - dxnrm: %0.4f\n";
+#else
+static const char* fistafstr = "    %02zu - dxnrm: %0.4f\n";
+#endif
+
+namespace codeare {
+    namespace optimisation {
+
+        /**
+         * @brief FISTA (Beck & Teboulle 2009) for
+         *        ||E x - b||^2 + sum_i w_i ||S_i x||_1<br/>
+         *        Gradient steps 1/L on the data term, L = 2 ||E^H E|| from
+         *        power iterations unless given (lipschitz). The proximal map
+         *        of the L1 terms is exact for a single unitary transform and
+         *        computed on the dual (proxiter iterations) otherwise.
+         */
+        template<class T>
+        class FISTA : public Proximal<T> {
+
+            typedef typename Proximal<T>::RT RT;
+
+        public:
+            FISTA () : _lipschitz(0.), _poweriter(10) {};
+            FISTA (const Params& p) : Proximal<T>::Proximal (p) {
+                _lipschitz = try_to_fetch<float> (p, "lipschitz", 0.0f);
+                _poweriter = try_to_fetch<int> (p, "poweriter", 10);
+            };
+            virtual ~FISTA() {};
+
+            inline virtual void Minimise (Operator<T>* A, Matrix<T>& x) {
+
+                Matrix<T> b = A->AdjointData(), y = x, xo, g;
+                Vector<Matrix<T> > p;
+                RT L = (_lipschitz > 0.) ? _lipschitz : Lipschitz (A, b), t = 1., to;
+
+                this->Start();
+                for (size_t k = 0; k < this->_nliter; ++k) {
+
+                    xo = x;
+                    g  = A->NormalData(y);
+                    g  = lazy(y) - ((RT)2./L) * (lazy(g) - lazy(b));
+                    x  = this->Prox (A, g, (RT)1./L, p);
+
+                    to = t;
+                    t  = .5 * (1. + sqrt(1. + 4.*t*t));
+                    y  = lazy(x) + ((to - 1.)/t) * (lazy(x) - lazy(xo));
+
+                    this->Record(x);
+                    RT dxn = this->Change (x, xo);
+                    if (this->_verbose) {
+                        printf (fistafstr, k, dxn); fflush (stdout);
+                    }
+                    if (dxn < this->_conv)
+                        break;
+
+                }
+
+            }
+
+            virtual std::ostream& Print (std::ostream& os) const {
+                Proximal<T>::Print(os);
+                os << " L(" << ((_lipschitz > 0.) ? _lipschitz : (RT)0.) << ") prox("
+                   << this->_proxiter << ")";
+                return os;
+            }
+
+        private:
+
+            /**
+             * @brief 2 ||E^H E|| by power iterations from E^H b, with 5% margin
+             */
+            inline RT Lipschitz (const Operator<T>* A, const Matrix<T>& b) const {
+                Matrix<T> v = b;
+                RT l = norm(v);
+                if (l == 0.)
+                    return 2.;
+                for (size_t i = 0; i < _poweriter; ++i) {
+                    v /= l;
+                    v  = A->NormalData(v);
+                    l  = norm(v);
+                    if (l == 0.)
+                        return 2.;
+                }
+                return 2.1 * l;
+            }
+
+            RT _lipschitz;
+            size_t _poweriter;
+
+        };
+
+    }}
+
+#endif // _FISTA_HPP_
@@ -18,6 +18,15 @@ std::string ofstr = "    %02zu - nrms: %1.4e, l-search: %d, ";
 
 namespace codeare {
     namespace optimisation {
+
+/**
+ * @brief Line search strategies
+ */
+enum ls_mode {
+	LS_BACKTRACK,    /**< @brief t0 lsb^(i+1) one objective evaluation at a time */
+	LS_BATCH,        /**< @brief All lsiter candidates t0 lsb^(i+1) in one batched evaluation */
+	LS_INTERPOLATE   /**< @brief Quadratic, then cubic interpolation of the objective */
+};
         
 template<class T> class NLCG : public NonLinear<T> {
 
@@ -32,6 +41,7 @@ public:
         _lsa = try_to_fetch<float> (p, "lsa", 0.0f);
         _lsb = try_to_fetch<float> (p, "lsb", 0.0f);
         _pls = try_to_fetch<bool> (p, "parallel_linesearch", false);
+        _lsmode = (ls_mode) try_to_fetch<int> (p, "linesearch", _pls ? LS_BATCH : LS_BACKTRACK);
     }
     
 	virtual ~NLCG() {};
@@ -50,26 +60,59 @@ public:
         return i;
     }
 
-    inline virtual size_t LineSearchParallel (const Operator<T>* A, const Matrix<T>& x, const real_t& t0,
-                                              const real_t& f0, real_t& rmse, real_t& t) const {
-        Vector<real_t> rmses (_lsiter);
-        Vector<real_t> ts (_lsiter);
-        Vector<real_t> f1s (_lsiter);
+    /**
+     * @brief  Armijo backtracking over all candidates t0 lsb^(i+1) at once.
+     *         Operators with cached projections evaluate the objective at all
+     *         step sizes in a single pass.
+     */
+    inline virtual size_t LineSearchBatch (const Operator<T>* A, const Matrix<T>& x, const real_t& t0,
+                                           const real_t& f0, real_t& rmse, real_t& t) const {
+        Vector<real_t> ts (_lsiter), rmses;
         real_t g0dx = abs(_g0.dotc(_dx));
-        int li = -1;
-#pragma omp parallel for default(shared) schedule(static,1) num_threads(_lsiter)
-        for (size_t i = 0; i < _lsiter; ++i) {
+        for (size_t i = 0; i < _lsiter; ++i)
             ts[i] = t0 * pow(_lsb,i+1);
-            f1s[i] = A->obj (x, _dx, ts[i], rmses[i]);
-        }
+        Vector<real_t> f1s = A->obj (x, _dx, ts, rmses);
         for (size_t i = 0; i < _lsiter; ++i)
-            if (f1s[i] <= f0 - _lsa * t * g0dx) {
-                li = i;
-                break;
+            if (f1s[i] <= f0 - _lsa * ts[i] * g0dx) {
+                t = ts[i];
+                rmse = rmses[i];
+                return i;
             }
-        t = ts[li];
-        rmse = rmses[li];
-        return (li>-1) ? li : _lsiter;
+        return _lsiter;
+    }
+
+    /**
+     * @brief  Armijo line search with safeguarded interpolation: t0 lsb, then
+     *         the minimiser of the quadratic through f0, f'0 and the first
+     *         trial, then cubic fits through the last two trials. Typically
+     *         accepts after at most two objective evaluations.
+     */
+    inline virtual size_t LineSearchInterpolate (const Operator<T>* A, const Matrix<T>& x, const real_t& t0,
+                                                 const real_t& f0, real_t& rmse, real_t& t) const {
+        const real_t d0 = -abs(_g0.dotc(_dx));
+        real_t t1 = t0 * _lsb, f1 = A->obj (x, _dx, t1, rmse), t2, f2;
+        if (_lsiter == 0 || f1 <= f0 + _lsa * t1 * d0) {
+            t = t1;
+            return 0;
+        }
+        t2 = Safeguard (-d0 * t1 * t1 / (2. * (f1 - f0 - d0 * t1)), t1);
+        for (size_t i = 1; i < _lsiter; ++i) {
+            f2 = A->obj (x, _dx, t2, rmse);
+            if (f2 <= f0 + _lsa * t2 * d0) {
+                t = t2;
+                return i;
+            }
+            const real_t r1 = f1 - f0 - d0 * t1, r2 = f2 - f0 - d0 * t2;
+            const real_t dn = t1 * t1 * t2 * t2 * (t2 - t1);
+            const real_t a = (t1 * t1 * r2 - t2 * t2 * r1) / dn;
+            const real_t b = (t2 * t2 * t2 * r1 - t1 * t1 * t1 * r2) / dn;
+            real_t tn = (a == 0.) ? -d0 / (2. * b) :
+                (-b + sqrt(std::max((real_t)(b * b - 3. * a * d0), (real_t)0.))) / (3. * a);
+            t1 = t2;
+            f1 = f2;
+            t2 = Safeguard (tn, t2);
+        }
+        return _lsiter;
     }
 
     inline virtual void Minimise (Operator<T>* A, Matrix<T>& x) {
@@ -78,6 +121,7 @@ public:
         Vector<real_t> rms(_lsiter);
         Vector<size_t> pos(_lsiter);
 
+        this->Start();
         _g0  = A->df(x);
 
         _dx  = -_g0;
@@ -88,8 +132,9 @@ public:
         
             f0 = A->obj (x, _dx, z, rmse);
 
-            size_t li = _pls ?
-                LineSearchParallel (A, x, t0, f0, rmse, t) :
+            size_t li = (_lsmode == LS_BATCH) ?
+                LineSearchBatch (A, x, t0, f0, rmse, t) : (_lsmode == LS_INTERPOLATE) ?
+                LineSearchInterpolate (A, x, t0, f0, rmse, t) :
                 LineSearch (A, x, t0, f0, rmse, t);
             printf (ofstr.c_str(), k, rmse, li); fflush (stdout);
             if (li == _lsiter) {
@@ -102,6 +147,7 @@ public:
 
             // Update image
             x  += _dx * t;
+            this->Record(x);
         
             // CG computation
             _g1 =  A->df (x);
@@ -123,15 +169,24 @@ public:
 		NonLinear<T>::Print(os);
         os << "    Iterations: (" << _nliter << ") LS(" << _lsiter << ")" << std::endl;
         os << "    Conv: CG(" << _cgconv << ")" << std::endl;
-        os << "    LS (" << (_pls ? "parallel" : "linear") << ")" << std::endl; 
+        os << "    LS (" << ((_lsmode == LS_BATCH) ? "batch" : (_lsmode == LS_INTERPOLATE) ?
+                                "interpolate" : "backtrack") << ")" << std::endl;
         os << "    LS brackets: lsa(" << _lsa << ") lsb(" << _lsb << ")";
 		return os;
     }
     
 private:    
 
+    /**
+     * @brief  Interpolated step clamped to [.1 t, .5 t]
+     */
+    inline static real_t Safeguard (const real_t& tn, const real_t& t) {
+        return (tn == tn) ? std::min(std::max(tn, (real_t).1 * t), (real_t).5 * t) : (real_t).5 * t;
+    }
+
     Matrix<T> _dx, _g0, _g1;
     bool _pls;
+    ls_mode _lsmode;
     typename TypeTraits<T>::RT _cgconv, _lsa, _lsb;
     size_t _lsiter, _nliter;
     
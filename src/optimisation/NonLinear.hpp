@@ -13,6 +13,7 @@
 #include "Params.hpp"
 #include "Lapack.hpp"
 #include "Demangle.hpp"
+#include "OMP.hpp"
 
 namespace codeare {
     namespace optimisation {
@@ -20,6 +21,8 @@ namespace codeare {
     	template <class T>
         class NonLinear {
             
+            typedef typename TypeTraits<T>::RT RT;
+
         public:
             NonLinear () {}
             NonLinear (const Params& params) {}
@@ -33,8 +36,51 @@ namespace codeare {
             friend std::ostream& operator<< (std::ostream& os, const NonLinear<T>& oper) {
                 return oper.Print(os);
             }
+
+            /**
+             * @brief Track relative error to reference and wall time of
+             *        subsequent minimisations per iteration
+             */
+            inline void Reference (const Matrix<T>& ref) { _ref = ref; }
+
+            /**
+             * @brief Relative errors ||x_i - ref||/||ref|| of last minimisation
+             */
+            inline const Vector<RT>& Errors () const { return _err; }
+
+            /**
+             * @brief Wall times in seconds after each iteration of last minimisation
+             */
+            inline const Vector<double>& Timings () const { return _time; }
+
         protected:
+
+            /**
+             * @brief Start trace of a minimisation
+             */
+            inline void Start () {
+                _err.clear();
+                _time.clear();
+                _t0 = omp_get_wtime();
+            }
+
+            /**
+             * @brief Record iterate. Time spent here is not accounted.
+             */
+            inline void Record (const Matrix<T>& x) {
+                if (_ref.Size() == 0 || _ref.Size() != x.Size())
+                    return;
+                double t = omp_get_wtime();
+                _time.push_back(t - _t0);
+                _err.push_back(norm(x - _ref) / norm(_ref));
+                _t0 += omp_get_wtime() - t;
+            }
+
             size_t _iterations;
+            Matrix<T> _ref;          /**< Reference for trace */
+            Vector<RT> _err;         /**< Relative errors of last minimisation */
+            Vector<double> _time;    /**< Wall times of last minimisation */
+            double _t0;
             
         };
         
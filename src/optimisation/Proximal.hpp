@@ -0,0 +1,186 @@
+/*
+ *  codeare Copyright (C) 2007-2010 Kaveh Vahedipour
+ *                               Forschungszentrum Juelich, Germany
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301  USA
+ */
+
+#ifndef _PROXIMAL_HPP_
+#define _PROXIMAL_HPP_
+
+#include <NonLinear.hpp>
+#include <Expression.hpp>
+#include <ExecutionContext.hpp>
+
+/**
+ * @brief Soft thresholding: max(|x|-t,0) x/|x|
+ */
+template<class T> inline static Matrix<T>
+shrink(const Matrix<T>& rhs, const typename TypeTraits<T>::RT& t) {
+    typedef typename TypeTraits<T>::RT RT;
+    Matrix<T> ret (rhs.Dim());
+    const long n = (long)rhs.Size();
+#pragma omp parallel for schedule (static) if (n >= EXPR_PARALLEL_THRESHOLD) \
+    num_threads (ExecutionContext::Instance().Threads())
+    for (long i = 0; i < n; ++i) {
+        RT rhsa = std::abs(rhs[i]);
+        ret[i] = (rhsa > t) ? ((RT)1. - t/rhsa) * rhs[i] : T(0.);
+    }
+    return ret;
+}
+
+/**
+ * @brief Projection onto l_inf ball: x min(1, t/|x|)
+ */
+template<class T> inline static Matrix<T>
+clip(const Matrix<T>& rhs, const typename TypeTraits<T>::RT& t) {
+    typedef typename TypeTraits<T>::RT RT;
+    Matrix<T> ret (rhs.Dim());
+    const long n = (long)rhs.Size();
+#pragma omp parallel for schedule (static) if (n >= EXPR_PARALLEL_THRESHOLD) \
+    num_threads (ExecutionContext::Instance().Threads())
+    for (long i = 0; i < n; ++i) {
+        RT rhsa = std::abs(rhs[i]);
+        ret[i] = (rhsa > t) ? (t/rhsa) * rhs[i] : rhs[i];
+    }
+    return ret;
+}
+
+
+namespace codeare {
+    namespace optimisation {
+
+        /**
+         * @brief Base of proximal solvers for ||E x - b||^2 + sum_i w_i ||S_i x||_1
+         *        on the splitting interface of Operator (NormalData, AdjointData,
+         *        Terms, Sparse, SparseAdjoint). Provides the quadratic x-update
+         *        by warm started CG and the proximal map of the L1 terms.
+         */
+        template<class T>
+        class Proximal : public NonLinear<T> {
+
+        protected:
+
+            typedef typename TypeTraits<T>::RT RT;
+
+        public:
+
+            Proximal () : _nliter(0), _xiter(5), _proxiter(10), _mu(1.), _conv(0.), _verbose(0) {}
+            Proximal (const Params& p) : NonLinear<T>::NonLinear (p) {
+                _nliter   = try_to_fetch<int> (p, "nliter", 0);
+                _xiter    = try_to_fetch<int> (p, "xiter", 5);
+                _proxiter = try_to_fetch<int> (p, "proxiter", 10);
+                _mu       = try_to_fetch<float> (p, "mu", 1.0f);
+                _conv     = try_to_fetch<float> (p, "cgconv", 0.0f);
+                _verbose  = try_to_fetch<int> (p, "verbose", 0);
+            }
+            virtual ~Proximal () {}
+
+            virtual std::ostream& Print (std::ostream& os) const {
+                NonLinear<T>::Print(os);
+                os << "    Iterations: (" << _nliter << ") mu(" << _mu << ") Conv(" << _conv << ")";
+                return os;
+            }
+
+        protected:
+
+            /**
+             * @brief   (2 E^H E + mu sum_i S_i^H S_i) x
+             */
+            inline Matrix<T> System (const Operator<T>* A, const Matrix<T>& x, const RT& mu) const {
+                Matrix<T> y = A->NormalData(x);
+                y *= (RT)2.;
+                for (size_t i = 0; i < A->Terms(); ++i)
+                    y += mu * lazy(A->SparseAdjoint(i, A->Sparse(i, x)));
+                return y;
+            }
+
+            /**
+             * @brief   Solve System(x) = rhs with _xiter CG iterations from x
+             */
+            inline void XStep (const Operator<T>* A, const Matrix<T>& rhs, Matrix<T>& x,
+                               const RT& mu) const {
+                Matrix<T> r = rhs - System (A, x, mu), p = r, q;
+                RT rn = real(r.dotc(r)), rno;
+                for (size_t j = 0; j < _xiter && rn > 0.; ++j) {
+                    q    = System (A, p, mu);
+                    RT a = rn / real(p.dotc(q));
+                    x   += a * lazy(p);
+                    r   -= a * lazy(q);
+                    rno  = rn;
+                    rn   = real(r.dotc(r));
+                    p    = lazy(r) + (rn/rno) * lazy(p);
+                }
+            }
+
+            /**
+             * @brief   Proximal map of tau sum_i w_i ||S_i .||_1 at v<br/>
+             *          Closed form for a single term with unitary S, projected
+             *          gradient on the dual otherwise. Dual variables p are kept
+             *          for warm starts.
+             */
+            inline Matrix<T> Prox (const Operator<T>* A, const Matrix<T>& v, const RT& tau,
+                                   Vector<Matrix<T> >& p) const {
+                const size_t nt = A->Terms();
+                if (nt == 0)
+                    return v;
+                if (nt == 1 && A->TermNorm(0) == 1.)
+                    return A->SparseAdjoint(0, shrink(A->Sparse(0, v), tau * A->TermWeight(0)));
+                RT lp = 0.;
+                for (size_t i = 0; i < nt; ++i)
+                    lp += A->TermNorm(i);
+                if (p.size() != nt) {
+                    p.resize(nt);
+                    for (size_t i = 0; i < nt; ++i)
+                        p[i] = Matrix<T>(A->Sparse(i, v).Dim());
+                }
+                for (size_t j = 0; j < _proxiter; ++j) {
+                    Matrix<T> z = v - Dual (A, p);
+                    for (size_t i = 0; i < nt; ++i) {
+                        p[i] += ((RT)1./lp) * lazy(A->Sparse(i, z));
+                        p[i]  = clip (p[i], tau * A->TermWeight(i));
+                    }
+                }
+                return v - Dual (A, p);
+            }
+
+            /**
+             * @brief   sum_i S_i^H p_i
+             */
+            inline Matrix<T> Dual (const Operator<T>* A, const Vector<Matrix<T> >& p) const {
+                Matrix<T> y = A->SparseAdjoint(0, p[0]);
+                for (size_t i = 1; i < p.size(); ++i)
+                    y += A->SparseAdjoint(i, p[i]);
+                return y;
+            }
+
+            /**
+             * @brief   Relative update ||x - xo||/||x||
+             */
+            inline static RT Change (const Matrix<T>& x, const Matrix<T>& xo) {
+                RT xn = norm(x);
+                return (xn > 0.) ? norm(x - xo)/xn : 0.;
+            }
+
+            size_t _nliter, _xiter, _proxiter;
+            RT _mu, _conv;
+            int _verbose;           /**< Report every iteration */
+
+        };
+
+    }}
+
+#endif // _PROXIMAL_HPP_
@@ -8,34 +8,85 @@
 #ifndef _SPLIT_BREGMAN_HPP_
 #define _SPLIT_BREGMAN_HPP_
 
-#include <NonLinear.hpp>
-
-template<class T> inline static Matrix<T>
-shrink(const Matrix<T>& rhs, const typename TypeTraits<T>::RT& t) {
-    Matrix<T> ret = rhs;
-    typename TypeTraits<T>::RT rhsa = 0.;
-    for (size_t i = 0; i < rhs.Size(); ++i) {
-        rhsa = std::abs(rhs[i]);
-        ret[i] = (rhsa > t) ? (1.0 - t/rhsa) * rhs[i] : T(0.); 
-    }
-    return ret;
-}
+#include <Proximal.hpp>
 
+#ifdef _MSC_VER
+static const char* sbfstr = "    %02Iu - dxnrm: %0.4f\n";
+#else
+static const char* sbfstr = "    %02zu - dxnrm: %0.4f\n";
+#endif
 
 namespace codeare {
     namespace optimisation {
         
+        /**
+         * @brief Split Bregman (Goldstein & Osher 2009) for
+         *        ||E x - b||^2 + sum_i w_i ||S_i x||_1<br/>
+         *        Inner loop: d_i = S_i x split off by Bregman iterations with
+         *        penalty mu. Outer loop: residual E^H (b - E x) added back to
+         *        the data.
+         */
         template<class T>
-        class SplitBregman : public NonLinear<T> {
+        class SplitBregman : public Proximal<T> {
             
+            typedef typename Proximal<T>::RT RT;
+
         public:
-            SplitBregman () {};
-            SplitBregman (const Params& p) : NonLinear<T>::NonLinear (p) {};
+            SplitBregman () : _inner(1) {};
+            SplitBregman (const Params& p) : Proximal<T>::Proximal (p) {
+                _inner = try_to_fetch<int> (p, "sbinner", 1);
+            };
             SplitBregman (const SplitBregman& tocopy) {};            
-            inline virtual void Minimise (Operator<T>* A, Matrix<T>& x) {};
+
+            inline virtual void Minimise (Operator<T>* A, Matrix<T>& x) {
+
+                const size_t nt = A->Terms();
+                Matrix<T> b = A->AdjointData(), c = b, rhs, s, xo;
+                Vector<Matrix<T> > d (nt), u (nt);
+                for (size_t i = 0; i < nt; ++i) {
+                    d[i] = A->Sparse(i, x);
+                    u[i] = Matrix<T>(d[i].Dim());
+                }
+
+                this->Start();
+                for (size_t k = 0; k < this->_nliter; ++k) {
+                    xo = x;
+                    for (size_t n = 0; n < _inner; ++n) {
+                        rhs = c;
+                        rhs *= (RT)2.;
+                        for (size_t i = 0; i < nt; ++i)
+                            rhs += this->_mu * lazy(A->SparseAdjoint(i, d[i] - u[i]));
+                        this->XStep (A, rhs, x, this->_mu);
+                        for (size_t i = 0; i < nt; ++i) {
+                            s    = A->Sparse(i, x);
+                            d[i] = shrink (s + u[i], A->TermWeight(i)/this->_mu);
+                            u[i] += lazy(s) - lazy(d[i]);
+                        }
+                    }
+                    c += lazy(b) - lazy(A->NormalData(x));
+                    this->Record(x);
+                    RT dxn = this->Change (x, xo);
+                    if (this->_verbose) {
+                        printf (sbfstr, k, dxn); fflush (stdout);
+                    }
+                    if (dxn < this->_conv)
+                        break;
+                }
+
+            }
+
             virtual ~SplitBregman() {};
+
+            virtual std::ostream& Print (std::ostream& os) const {
+                Proximal<T>::Print(os);
+                os << " inner(" << _inner << ") CG(" << this->_xiter << ")";
+                return os;
+            }
+
         private:
             
+            size_t _inner;
+
         };
         
     }}